@@ -130,6 +130,9 @@ typedef struct
 {
   GList *results;
   GESAsset *asset;
+
+  /* Link in lru_entries, %NULL for the assets GES registers itself */
+  GList *lru_link;
 } GESAssetCacheEntry;
 
 /* Also protect all the entries in the cache */
@@ -157,6 +160,15 @@ static GMutex asset_cache_lock;
  * different extractable types.
  **/
 static GHashTable *type_entries_table = NULL;
+
+/* The entries that can be evicted from the cache, most recently used
+ * first, and the maximum number of such entries (0 means no limit) */
+static GQueue lru_entries = G_QUEUE_INIT;
+static guint max_cached_assets = 0;
+static gboolean cache_initializing = FALSE;
+/* IDs of the assets other assets are proxied to, with the number of
+ * assets proxied to each of them, those are never evicted */
+static GHashTable *proxy_targets = NULL;
 #define LOCK_CACHE   (g_mutex_lock (&asset_cache_lock))
 #define UNLOCK_CACHE (g_mutex_unlock (&asset_cache_lock))
 
@@ -223,7 +235,7 @@ async_initable_init_async (GAsyncInitable * initable, gint io_priority,
   simple = g_simple_async_result_new (G_OBJECT (asset),
       callback, user_data, ges_asset_request_async);
 
-  ges_asset_cache_put (asset, simple);
+  ges_asset_cache_put (gst_object_ref (asset), simple);
   switch (GES_ASSET_GET_CLASS (asset)->start_loading (asset, &error)) {
     case GES_ASSET_LOADING_ERROR:
     {
@@ -424,9 +436,72 @@ _lookup_entry (GType extractable_type, const gchar * id)
 static void
 _free_entries (gpointer entry)
 {
+  GESAssetCacheEntry *cache_entry = entry;
+
+  if (cache_entry->lru_link)
+    g_queue_delete_link (&lru_entries, cache_entry->lru_link);
+
   g_slice_free (GESAssetCacheEntry, entry);
 }
 
+static inline void
+_entry_used (GESAssetCacheEntry * entry)
+{
+  if (entry->lru_link && entry->lru_link != lru_entries.head) {
+    g_queue_unlink (&lru_entries, entry->lru_link);
+    g_queue_push_head_link (&lru_entries, entry->lru_link);
+  }
+}
+
+/* An asset can only be evicted when nothing but the cache references it
+ * and when no other asset depends on it being in the cache */
+static inline gboolean
+_entry_is_evictable (GESAssetCacheEntry * entry)
+{
+  GESAssetPrivate *priv = entry->asset->priv;
+
+  if (priv->state != ASSET_INITIALIZED &&
+      priv->state != ASSET_INITIALIZED_WITH_ERROR)
+    return FALSE;
+
+  if (entry->results || priv->parent ||
+      g_hash_table_lookup (proxy_targets, priv->id))
+    return FALSE;
+
+  return g_atomic_int_get (&G_OBJECT (entry->asset)->ref_count) == 1;
+}
+
+/* Removes the least recently used unreferenced entries until there are
+ * at most max_cached_assets of them, and returns their assets, which
+ * should be unrefed without the cache lock held */
+static GList *
+_evict_unlocked (void)
+{
+  GList *tmp, *prev, *evicted = NULL;
+
+  if (max_cached_assets == 0)
+    return NULL;
+
+  for (tmp = lru_entries.tail; tmp && lru_entries.length > max_cached_assets;
+      tmp = prev) {
+    GHashTable *entries_table;
+    GESAssetCacheEntry *entry = tmp->data;
+    GESAsset *asset = entry->asset;
+
+    prev = tmp->prev;
+    if (!_entry_is_evictable (entry))
+      continue;
+
+    GST_DEBUG_OBJECT (asset, "Evicting %s from the cache", asset->priv->id);
+    entries_table = g_hash_table_lookup (type_entries_table,
+        _extractable_type_name (asset->priv->extractable_type));
+    g_hash_table_remove (entries_table, asset->priv->id);
+    evicted = g_list_prepend (evicted, asset);
+  }
+
+  return evicted;
+}
+
 /**
  * ges_asset_cache_lookup:
  *
@@ -434,7 +509,10 @@ _free_entries (gpointer entry)
  *
  * Looks for asset with specified id in cache and it's completely loaded.
  *
- * Returns: (transfer none): The #GESAsset found or %NULL
+ * The reference is taken while the cache is locked, so the asset can not be
+ * evicted and freed before the caller gets it.
+ *
+ * Returns: (transfer full): The #GESAsset found or %NULL
  */
 GESAsset *
 ges_asset_cache_lookup (GType extractable_type, const gchar * id)
@@ -446,8 +524,10 @@ ges_asset_cache_lookup (GType extractable_type, const gchar * id)
 
   LOCK_CACHE;
   entry = _lookup_entry (extractable_type, id);
-  if (entry)
-    asset = entry->asset;
+  if (entry) {
+    asset = gst_object_ref (entry->asset);
+    _entry_used (entry);
+  }
   UNLOCK_CACHE;
 
   return asset;
@@ -463,6 +543,12 @@ ges_asset_cache_append_result (GType extractable_type,
   if ((entry = _lookup_entry (extractable_type, id)))
     entry->results = g_list_append (entry->results, res);
   UNLOCK_CACHE;
+
+  if (entry == NULL) {
+    GST_WARNING ("Type %s ID: %s not in cache anymore, dropping result",
+        g_type_name (extractable_type), id);
+    g_object_unref (res);
+  }
 }
 
 gboolean
@@ -503,13 +589,11 @@ ges_asset_cache_set_loaded (GType extractable_type, const gchar * id,
       g_simple_async_result_set_from_error (G_SIMPLE_ASYNC_RESULT (tmp->data),
           error);
       g_simple_async_result_complete (G_SIMPLE_ASYNC_RESULT (tmp->data));
-      /* FIXME: ASSET_NEEDS_RELOAD don't work with that */
-#if 0
-      gst_object_unref (tmp->data);
-#endif
     }
 
-    g_list_free (results);
+    /* The results were detached from the entry, so a reload started from
+     * one of the callbacks only ever sees its own new results */
+    g_list_free_full (results, g_object_unref);
     return TRUE;
   } else {
     asset->priv->state = ASSET_INITIALIZED;
@@ -530,6 +614,7 @@ ges_asset_cache_put (GESAsset * asset, GSimpleAsyncResult * res)
   GType extractable_type;
   const gchar *asset_id;
   GESAssetCacheEntry *entry;
+  GList *evicted = NULL;
 
   /* Needing to work with the cache, taking the lock */
   asset_id = ges_asset_get_id (asset);
@@ -556,6 +641,12 @@ ges_asset_cache_put (GESAsset * asset, GSimpleAsyncResult * res)
       entry->results = g_list_prepend (entry->results, res);
     g_hash_table_insert (entries_table, (gpointer) g_strdup (asset_id),
         (gpointer) entry);
+
+    if (!cache_initializing) {
+      g_queue_push_head (&lru_entries, entry);
+      entry->lru_link = lru_entries.head;
+      evicted = _evict_unlocked ();
+    }
   } else {
     if (res) {
       GST_DEBUG ("%s already in cache, adding result %p", asset_id, res);
@@ -563,6 +654,8 @@ ges_asset_cache_put (GESAsset * asset, GSimpleAsyncResult * res)
     }
   }
   UNLOCK_CACHE;
+
+  g_list_free_full (evicted, gst_object_unref);
 }
 
 void
@@ -571,9 +664,14 @@ ges_asset_cache_init (void)
   g_mutex_init (&asset_cache_lock);
   type_entries_table = g_hash_table_new_full (g_str_hash, g_str_equal,
       NULL, (GDestroyNotify) g_hash_table_unref);
+  proxy_targets = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+      NULL);
 
+  /* Those are always kept around */
+  cache_initializing = TRUE;
   _init_formatter_assets ();
   _init_standard_transition_assets ();
+  cache_initializing = FALSE;
 }
 
 gboolean
@@ -584,6 +682,18 @@ ges_asset_request_id_update (GESAsset * asset, gchar ** proposed_id,
       error);
 }
 
+static void
+_proxy_target_unref (const gchar * id)
+{
+  guint n_proxies = GPOINTER_TO_UINT (g_hash_table_lookup (proxy_targets, id));
+
+  if (n_proxies > 1)
+    g_hash_table_insert (proxy_targets, g_strdup (id),
+        GUINT_TO_POINTER (n_proxies - 1));
+  else
+    g_hash_table_remove (proxy_targets, id);
+}
+
 gboolean
 ges_asset_set_proxy (GESAsset * asset, const gchar * new_id)
 {
@@ -599,11 +709,18 @@ ges_asset_set_proxy (GESAsset * asset, const gchar * new_id)
     return FALSE;
   }
 
-  if (asset->priv->proxied_asset_id)
+  LOCK_CACHE;
+  if (asset->priv->proxied_asset_id) {
+    _proxy_target_unref (asset->priv->proxied_asset_id);
     g_free (asset->priv->proxied_asset_id);
+  }
 
   asset->priv->state = ASSET_PROXIED;
   asset->priv->proxied_asset_id = g_strdup (new_id);
+  g_hash_table_insert (proxy_targets, g_strdup (new_id),
+      GUINT_TO_POINTER (GPOINTER_TO_UINT (g_hash_table_lookup (proxy_targets,
+                  new_id)) + 1));
+  UNLOCK_CACHE;
 
   class = GES_ASSET_GET_CLASS (asset);
   if (class->inform_proxy)
@@ -677,14 +794,16 @@ ges_asset_set_id (GESAsset * asset, const gchar * id)
   UNLOCK_CACHE;
 }
 
-static GESAsset *
+static void
 _unsure_material_for_wrong_id (const gchar * wrong_id, GType extractable_type,
     GError * error)
 {
   GESAsset *asset;
 
-  if ((asset = ges_asset_cache_lookup (extractable_type, wrong_id)))
-    return asset;
+  if ((asset = ges_asset_cache_lookup (extractable_type, wrong_id))) {
+    gst_object_unref (asset);
+    return;
+  }
 
   /* It is a dummy GESAsset, we just bruteforce its creation */
   asset = g_object_new (GES_TYPE_ASSET, "id", wrong_id,
@@ -692,8 +811,6 @@ _unsure_material_for_wrong_id (const gchar * wrong_id, GType extractable_type,
 
   ges_asset_cache_put (asset, NULL);
   ges_asset_cache_set_loaded (extractable_type, wrong_id, error);
-
-  return asset;
 }
 
 /**********************************
@@ -755,17 +872,21 @@ ges_asset_request (GType extractable_type, const gchar * id, GError ** error)
   asset = ges_asset_cache_lookup (extractable_type, real_id);
   if (asset) {
     while (TRUE) {
+      GESAsset *proxied;
+
       switch (asset->priv->state) {
         case ASSET_INITIALIZED:
-          gst_object_ref (asset);
           goto done;
         case ASSET_INITIALIZING:
+          gst_object_unref (asset);
           asset = NULL;
           goto done;
         case ASSET_PROXIED:
-          asset =
+          proxied =
               ges_asset_cache_lookup (asset->priv->extractable_type,
               asset->priv->proxied_asset_id);
+          gst_object_unref (asset);
+          asset = proxied;
           if (asset == NULL) {
             GST_ERROR ("Asset against a asset we do not"
                 " have in cache, something massively screwed");
@@ -782,6 +903,7 @@ ges_asset_request (GType extractable_type, const gchar * id, GError ** error)
           GST_WARNING_OBJECT (asset, "Initialized with error, not returning");
           if (error)
             *error = g_error_copy (asset->priv->error);
+          gst_object_unref (asset);
           asset = NULL;
           goto done;
         default:
@@ -867,8 +989,9 @@ ges_asset_request_async (GType extractable_type,
     gpointer user_data)
 {
   gchar *real_id;
-  GESAsset *asset;
+  GESAsset *asset = NULL;
   GError *error = NULL;
+  GSimpleAsyncResult *simple = NULL;
 
   g_return_if_fail (g_type_is_a (extractable_type, G_TYPE_OBJECT));
   g_return_if_fail (g_type_is_a (extractable_type, GES_TYPE_EXTRACTABLE));
@@ -886,20 +1009,20 @@ ges_asset_request_async (GType extractable_type,
   /* Check if we already have a asset for this ID */
   asset = ges_asset_cache_lookup (extractable_type, real_id);
   if (asset) {
-    GSimpleAsyncResult *simple = g_simple_async_result_new (G_OBJECT (asset),
-        callback, user_data, ges_asset_request_async);
+    simple = g_simple_async_result_new (G_OBJECT (asset), callback, user_data,
+        ges_asset_request_async);
 
     /* In the case of proxied asset, we will loop until we find the
      * last asset of the chain of proxied asset */
     while (TRUE) {
+      GESAsset *proxied;
+
       switch (asset->priv->state) {
         case ASSET_INITIALIZED:
-          gst_object_ref (asset);
-
           GST_DEBUG_OBJECT (asset, "Asset in cache and initialized, "
               "using it");
 
-          /* Takes its own references to @asset */
+          /* Takes its own references to @simple and its source object */
           g_simple_async_result_complete_in_idle (simple);
 
           goto done;
@@ -907,12 +1030,15 @@ ges_asset_request_async (GType extractable_type,
           GST_DEBUG_OBJECT (asset, "Asset in cache and but not "
               "initialized, setting a new callback");
           ges_asset_cache_append_result (extractable_type, real_id, simple);
+          simple = NULL;
 
           goto done;
         case ASSET_PROXIED:
-          asset =
+          proxied =
               ges_asset_cache_lookup (asset->priv->extractable_type,
               asset->priv->proxied_asset_id);
+          gst_object_unref (asset);
+          asset = proxied;
           if (asset == NULL) {
             GST_ERROR ("Asset proxied against a asset we do not"
                 " have in cache, something massively screwed");
@@ -923,6 +1049,7 @@ ges_asset_request_async (GType extractable_type,
         case ASSET_NEEDS_RELOAD:
           GST_DEBUG_OBJECT (asset, "Asset in cache and needs reload");
           ges_asset_cache_append_result (extractable_type, real_id, simple);
+          simple = NULL;
           GES_ASSET_GET_CLASS (asset)->start_loading (asset, &error);
 
           goto done;
@@ -935,7 +1062,7 @@ ges_asset_request_async (GType extractable_type,
           goto done;
         default:
           GST_WARNING ("Case %i not handle, returning", asset->priv->state);
-          return;
+          goto done;
       }
     }
   }
@@ -944,6 +1071,10 @@ ges_asset_request_async (GType extractable_type,
       (extractable_type), G_PRIORITY_DEFAULT, cancellable, callback, user_data,
       "id", real_id, "extractable-type", extractable_type, NULL);
 done:
+  if (simple)
+    g_object_unref (simple);
+  if (asset)
+    gst_object_unref (asset);
   if (real_id)
     g_free (real_id);
 }
@@ -972,6 +1103,7 @@ ges_asset_needs_reload (GType extractable_type, const gchar * id)
         "Asset with id %s switch state to ASSET_NEEDS_RELOAD",
         ges_asset_get_id (asset));
     asset->priv->state = ASSET_NEEDS_RELOAD;
+    gst_object_unref (asset);
     return TRUE;
   }
 
@@ -1096,3 +1228,52 @@ ges_list_assets (GType filter)
 
   return ret;
 }
+
+/**
+ * ges_asset_cache_set_max_size:
+ * @max_assets: The maximum number of assets to keep in the cache, or 0 for
+ * no limit
+ *
+ * Limits the number of #GESAsset-s kept in the cache of GES. Once the limit
+ * is reached, the least recently requested assets that are not referenced
+ * anymore (by a #GESProject, a #GESExtractable extracted from them, or
+ * anything else) are dropped from the cache, and will be loaded again if
+ * they are requested later on. The assets GES registers itself, like the
+ * formatter and standard transition assets, are always kept and are not
+ * taken into account.
+ *
+ * By default, the cache is not limited.
+ */
+void
+ges_asset_cache_set_max_size (guint max_assets)
+{
+  GList *evicted;
+
+  LOCK_CACHE;
+  max_cached_assets = max_assets;
+  evicted = _evict_unlocked ();
+  UNLOCK_CACHE;
+
+  g_list_free_full (evicted, gst_object_unref);
+}
+
+/**
+ * ges_asset_cache_get_max_size:
+ *
+ * Gets the maximum number of assets kept in the cache, as set with
+ * #ges_asset_cache_set_max_size
+ *
+ * Returns: The maximum number of assets kept in the cache, 0 meaning no
+ * limit
+ */
+guint
+ges_asset_cache_get_max_size (void)
+{
+  guint max_assets;
+
+  LOCK_CACHE;
+  max_assets = max_cached_assets;
+  UNLOCK_CACHE;
+
+  return max_assets;
+}
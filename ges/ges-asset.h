@@ -100,5 +100,8 @@ GESExtractable * ges_asset_extract   (GESAsset * self,
                                       GError **error);
 GList * ges_list_assets              (GType filter);
 
+void ges_asset_cache_set_max_size    (guint max_assets);
+guint ges_asset_cache_get_max_size   (void);
+
 G_END_DECLS
 #endif /* _GES_ASSET */
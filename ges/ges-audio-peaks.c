@@ -0,0 +1,583 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Multi-resolution audio peaks used to draw waveforms.
+ *
+ * The audio of a file is decoded once, downmixed to mono at PEAKS_RATE and
+ * reduced into blocks of PEAKS_BASE_BLOCK frames, each keeping the minimum,
+ * maximum and RMS value of the block. Coarser levels are then built by
+ * merging PEAKS_LEVEL_FACTOR blocks of the previous level, so any time range
+ * can be drawn at any zoom level by reading a bounded number of blocks.
+ *
+ * The result is stored in the GES cache directory (see
+ * ges_get_cache_directory()), keyed on the URI (and
+ * the size and modification time of local files) so that it only has to be
+ * computed once per file. */
+
+#include <string.h>
+#include <math.h>
+#include <gst/audio/audio.h>
+
+#include "ges-internal.h"
+
+#define PEAKS_RATE 48000
+#define PEAKS_BASE_BLOCK 256
+#define PEAKS_LEVEL_FACTOR 8
+#define PEAKS_N_LEVELS 4
+
+#define PEAKS_MAGIC "GESPEAKS"
+#define PEAKS_VERSION 1
+
+/* Each block is stored as a (min, max, rms) triplet */
+#define PEAK_MIN(p, i) ((p)[(i) * 3])
+#define PEAK_MAX(p, i) ((p)[(i) * 3 + 1])
+#define PEAK_RMS(p, i) ((p)[(i) * 3 + 2])
+
+/* Number of independent accumulators used while reducing a block, this lets
+ * the compiler keep them in vector registers */
+#define REDUCE_LANES 8
+
+struct _GESAudioPeaks
+{
+  guint64 n_peaks[PEAKS_N_LEVELS];
+  gint16 *peaks[PEAKS_N_LEVELS];
+};
+
+typedef struct
+{
+  GArray *base;                 /* gint16 triplets */
+
+  gfloat pending[PEAKS_BASE_BLOCK];
+  guint n_pending;
+
+  GstElement *convert;
+} PeaksBuilder;
+
+typedef struct
+{
+  guint32 version;
+  guint32 rate;
+  guint32 base_block;
+  guint32 level_factor;
+  guint32 n_levels;
+} PeaksHeader;
+
+static inline gint16
+_quantize (gfloat value)
+{
+  return (gint16) CLAMP (value * G_MAXINT16, -G_MAXINT16, G_MAXINT16);
+}
+
+static void
+_reduce_block (const gfloat * samples, guint n_samples, gint16 * peak)
+{
+  gfloat lo[REDUCE_LANES], hi[REDUCE_LANES], acc[REDUCE_LANES];
+  gfloat min, max, sum;
+  guint i, j, n_vectors = n_samples / REDUCE_LANES;
+
+  for (j = 0; j < REDUCE_LANES; j++) {
+    lo[j] = hi[j] = samples[0];
+    acc[j] = 0;
+  }
+
+  for (i = 0; i < n_vectors; i++) {
+    const gfloat *v = samples + i * REDUCE_LANES;
+
+    for (j = 0; j < REDUCE_LANES; j++) {
+      lo[j] = v[j] < lo[j] ? v[j] : lo[j];
+      hi[j] = v[j] > hi[j] ? v[j] : hi[j];
+      acc[j] += v[j] * v[j];
+    }
+  }
+
+  /* Trailing samples of a last incomplete block */
+  for (i = n_vectors * REDUCE_LANES; i < n_samples; i++) {
+    lo[0] = MIN (lo[0], samples[i]);
+    hi[0] = MAX (hi[0], samples[i]);
+    acc[0] += samples[i] * samples[i];
+  }
+
+  min = lo[0];
+  max = hi[0];
+  sum = acc[0];
+  for (j = 1; j < REDUCE_LANES; j++) {
+    min = MIN (min, lo[j]);
+    max = MAX (max, hi[j]);
+    sum += acc[j];
+  }
+
+  peak[0] = _quantize (min);
+  peak[1] = _quantize (max);
+  peak[2] = _quantize (sqrtf (sum / n_samples));
+}
+
+static void
+_builder_push_block (PeaksBuilder * builder, const gfloat * samples,
+    guint n_samples)
+{
+  gint16 peak[3];
+
+  _reduce_block (samples, n_samples, peak);
+  g_array_append_vals (builder->base, peak, 3);
+}
+
+static void
+_handoff_cb (GstElement * sink, GstBuffer * buffer, GstPad * pad,
+    PeaksBuilder * builder)
+{
+  GstMapInfo map;
+  const gfloat *samples;
+  guint n_samples;
+
+  if (!gst_buffer_map (buffer, &map, GST_MAP_READ))
+    return;
+
+  samples = (const gfloat *) map.data;
+  n_samples = map.size / sizeof (gfloat);
+
+  /* Complete the block started by the previous buffer */
+  if (builder->n_pending) {
+    guint n = MIN (n_samples, PEAKS_BASE_BLOCK - builder->n_pending);
+
+    memcpy (builder->pending + builder->n_pending, samples,
+        n * sizeof (gfloat));
+    builder->n_pending += n;
+    samples += n;
+    n_samples -= n;
+
+    if (builder->n_pending == PEAKS_BASE_BLOCK) {
+      _builder_push_block (builder, builder->pending, PEAKS_BASE_BLOCK);
+      builder->n_pending = 0;
+    }
+  }
+
+  /* Reduce full blocks straight from the buffer */
+  while (n_samples >= PEAKS_BASE_BLOCK) {
+    _builder_push_block (builder, samples, PEAKS_BASE_BLOCK);
+    samples += PEAKS_BASE_BLOCK;
+    n_samples -= PEAKS_BASE_BLOCK;
+  }
+
+  if (n_samples) {
+    memcpy (builder->pending, samples, n_samples * sizeof (gfloat));
+    builder->n_pending = n_samples;
+  }
+
+  gst_buffer_unmap (buffer, &map);
+}
+
+static void
+_pad_added_cb (GstElement * decodebin, GstPad * pad, PeaksBuilder * builder)
+{
+  GstPad *sinkpad = gst_element_get_static_pad (builder->convert, "sink");
+
+  /* We only draw the first audio stream */
+  if (!gst_pad_is_linked (sinkpad) &&
+      gst_pad_link (pad, sinkpad) != GST_PAD_LINK_OK)
+    GST_WARNING_OBJECT (decodebin, "Could not link %" GST_PTR_FORMAT, pad);
+
+  gst_object_unref (sinkpad);
+}
+
+static GESAudioPeaks *
+_peaks_new_from_base (GArray * base)
+{
+  guint level;
+  guint64 i, j;
+  GESAudioPeaks *peaks = g_slice_new0 (GESAudioPeaks);
+
+  peaks->n_peaks[0] = base->len / 3;
+  peaks->peaks[0] = (gint16 *) g_array_free (base, FALSE);
+
+  for (level = 1; level < PEAKS_N_LEVELS; level++) {
+    const gint16 *prev = peaks->peaks[level - 1];
+    guint64 n_prev = peaks->n_peaks[level - 1];
+    guint64 n = (n_prev + PEAKS_LEVEL_FACTOR - 1) / PEAKS_LEVEL_FACTOR;
+    gint16 *cur = g_new (gint16, MAX (n, 1) * 3);
+
+    for (i = 0; i < n; i++) {
+      guint64 first = i * PEAKS_LEVEL_FACTOR;
+      guint64 last = MIN (first + PEAKS_LEVEL_FACTOR, n_prev);
+      gint16 min = G_MAXINT16, max = -G_MAXINT16;
+      gdouble sum = 0;
+
+      for (j = first; j < last; j++) {
+        min = MIN (min, PEAK_MIN (prev, j));
+        max = MAX (max, PEAK_MAX (prev, j));
+        sum += (gdouble) PEAK_RMS (prev, j) * PEAK_RMS (prev, j);
+      }
+
+      PEAK_MIN (cur, i) = min;
+      PEAK_MAX (cur, i) = max;
+      PEAK_RMS (cur, i) = (gint16) sqrt (sum / (last - first));
+    }
+
+    peaks->n_peaks[level] = n;
+    peaks->peaks[level] = cur;
+  }
+
+  return peaks;
+}
+
+static gchar *
+_get_cache_filename (const gchar * uri)
+{
+  gchar *key, *checksum, *basename, *directory, *filename;
+  GFile *file = g_file_new_for_uri (uri);
+  GFileInfo *info = NULL;
+
+  /* Make sure we do not use stale peaks when a local file gets modified */
+  if (g_file_is_native (file))
+    info = g_file_query_info (file, G_FILE_ATTRIBUTE_STANDARD_SIZE ","
+        G_FILE_ATTRIBUTE_TIME_MODIFIED, G_FILE_QUERY_INFO_NONE, NULL, NULL);
+
+  if (info) {
+    key = g_strdup_printf ("%s:%" G_GUINT64_FORMAT ":%" G_GUINT64_FORMAT, uri,
+        (guint64) g_file_info_get_size (info),
+        g_file_info_get_attribute_uint64 (info,
+            G_FILE_ATTRIBUTE_TIME_MODIFIED));
+    g_object_unref (info);
+  } else {
+    key = g_strdup (uri);
+  }
+
+  checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA1, key, -1);
+  basename = g_strdup_printf ("%s.peaks", checksum);
+  directory = ges_get_cache_directory ("peaks");
+  filename = g_build_filename (directory, basename, NULL);
+
+  g_object_unref (file);
+  g_free (directory);
+  g_free (basename);
+  g_free (checksum);
+  g_free (key);
+
+  return filename;
+}
+
+/**
+ * ges_audio_peaks_compute:
+ * @uri: The URI of the media to compute peaks for
+ * @cancellable: (allow-none): optional #GCancellable object, %NULL to ignore
+ * @error: (allow-none): An error to be set in case something wrong happens
+ *
+ * Decodes the first audio stream of @uri and computes its peaks. This blocks
+ * until the whole stream has been decoded and is meant to be called from a
+ * worker thread.
+ *
+ * Returns: The newly computed #GESAudioPeaks, or %NULL on error
+ */
+GESAudioPeaks *
+ges_audio_peaks_compute (const gchar * uri, GCancellable * cancellable,
+    GError ** error)
+{
+  GstBus *bus;
+  GstCaps *caps;
+  GstMessage *msg;
+  PeaksBuilder builder;
+  gboolean done = FALSE, eos = FALSE;
+  GstElement *pipeline, *decodebin, *resample, *filter, *sink;
+
+  pipeline = gst_pipeline_new ("audio-peaks");
+  decodebin = gst_element_factory_make ("uridecodebin", NULL);
+  builder.convert = gst_element_factory_make ("audioconvert", NULL);
+  resample = gst_element_factory_make ("audioresample", NULL);
+  filter = gst_element_factory_make ("capsfilter", NULL);
+  sink = gst_element_factory_make ("fakesink", NULL);
+
+  if (!decodebin || !builder.convert || !resample || !filter || !sink) {
+    g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_MISSING_PLUGIN,
+        "Missing elements to compute audio peaks");
+    gst_object_unref (pipeline);
+    if (decodebin)
+      gst_object_unref (decodebin);
+    if (builder.convert)
+      gst_object_unref (builder.convert);
+    if (resample)
+      gst_object_unref (resample);
+    if (filter)
+      gst_object_unref (filter);
+    if (sink)
+      gst_object_unref (sink);
+
+    return NULL;
+  }
+
+  builder.base = g_array_new (FALSE, FALSE, sizeof (gint16));
+  builder.n_pending = 0;
+
+  caps = gst_caps_new_simple ("audio/x-raw", "format", G_TYPE_STRING,
+      GST_AUDIO_NE (F32), "layout", G_TYPE_STRING, "interleaved",
+      "channels", G_TYPE_INT, 1, "rate", G_TYPE_INT, PEAKS_RATE, NULL);
+  g_object_set (filter, "caps", caps, NULL);
+  gst_caps_unref (caps);
+
+  caps = gst_caps_new_empty_simple ("audio/x-raw");
+  g_object_set (decodebin, "uri", uri, "caps", caps, "expose-all-streams",
+      FALSE, NULL);
+  gst_caps_unref (caps);
+
+  g_object_set (sink, "sync", FALSE, "signal-handoffs", TRUE, NULL);
+  g_signal_connect (sink, "handoff", G_CALLBACK (_handoff_cb), &builder);
+  g_signal_connect (decodebin, "pad-added", G_CALLBACK (_pad_added_cb),
+      &builder);
+
+  gst_bin_add_many (GST_BIN (pipeline), decodebin, builder.convert, resample,
+      filter, sink, NULL);
+  gst_element_link_many (builder.convert, resample, filter, sink, NULL);
+
+  bus = gst_pipeline_get_bus (GST_PIPELINE (pipeline));
+  if (gst_element_set_state (pipeline, GST_STATE_PLAYING) ==
+      GST_STATE_CHANGE_FAILURE) {
+    g_set_error (error, GST_STREAM_ERROR, GST_STREAM_ERROR_FAILED,
+        "Could not start decoding %s", uri);
+    done = TRUE;
+  }
+
+  while (!done) {
+    if (g_cancellable_set_error_if_cancelled (cancellable, error))
+      break;
+
+    msg = gst_bus_timed_pop_filtered (bus, 100 * GST_MSECOND,
+        GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+    if (msg == NULL)
+      continue;
+
+    if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR)
+      gst_message_parse_error (msg, error, NULL);
+    else
+      eos = TRUE;
+
+    gst_message_unref (msg);
+    done = TRUE;
+  }
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (bus);
+  gst_object_unref (pipeline);
+
+  if (!eos) {
+    g_array_free (builder.base, TRUE);
+
+    return NULL;
+  }
+
+  if (builder.n_pending)
+    _builder_push_block (&builder, builder.pending, builder.n_pending);
+
+  return _peaks_new_from_base (builder.base);
+}
+
+/**
+ * ges_audio_peaks_load:
+ * @uri: The URI of the media to load the peaks of
+ *
+ * Loads the peaks of @uri from the on-disk cache.
+ *
+ * Returns: The cached #GESAudioPeaks, or %NULL if they have not been
+ * computed yet
+ */
+GESAudioPeaks *
+ges_audio_peaks_load (const gchar * uri)
+{
+  gsize length;
+  gchar *contents;
+  const gchar *data;
+  PeaksHeader header;
+  guint level;
+  guint64 n_peaks[PEAKS_N_LEVELS], expected;
+  GESAudioPeaks *peaks = NULL;
+  gchar *filename = _get_cache_filename (uri);
+
+  if (!g_file_get_contents (filename, &contents, &length, NULL))
+    goto done;
+
+  expected = strlen (PEAKS_MAGIC) + sizeof (header) + sizeof (n_peaks);
+  if (length < expected || memcmp (contents, PEAKS_MAGIC, strlen (PEAKS_MAGIC)))
+    goto invalid;
+
+  data = contents + strlen (PEAKS_MAGIC);
+  memcpy (&header, data, sizeof (header));
+  data += sizeof (header);
+  if (header.version != PEAKS_VERSION || header.rate != PEAKS_RATE ||
+      header.base_block != PEAKS_BASE_BLOCK ||
+      header.level_factor != PEAKS_LEVEL_FACTOR ||
+      header.n_levels != PEAKS_N_LEVELS)
+    goto invalid;
+
+  memcpy (n_peaks, data, sizeof (n_peaks));
+  data += sizeof (n_peaks);
+  for (level = 0; level < PEAKS_N_LEVELS; level++) {
+    /* Do not let corrupted counts wrap the expected size around */
+    if (n_peaks[level] > (length - expected) / (3 * sizeof (gint16)))
+      goto invalid;
+
+    expected += n_peaks[level] * 3 * sizeof (gint16);
+  }
+  if (length != expected)
+    goto invalid;
+
+  peaks = g_slice_new0 (GESAudioPeaks);
+  for (level = 0; level < PEAKS_N_LEVELS; level++) {
+    gsize size = n_peaks[level] * 3 * sizeof (gint16);
+
+    peaks->n_peaks[level] = n_peaks[level];
+    peaks->peaks[level] = g_malloc (MAX (size, 1));
+    memcpy (peaks->peaks[level], data, size);
+    data += size;
+  }
+
+  GST_DEBUG ("Loaded peaks of %s from %s", uri, filename);
+  g_free (contents);
+
+done:
+  g_free (filename);
+
+  return peaks;
+
+invalid:
+  GST_INFO ("Ignoring invalid peaks cache file %s", filename);
+  g_free (contents);
+  goto done;
+}
+
+/**
+ * ges_audio_peaks_save:
+ * @peaks: The #GESAudioPeaks to store
+ * @uri: The URI of the media @peaks have been computed for
+ * @error: (allow-none): An error to be set in case something wrong happens
+ *
+ * Stores @peaks in the on-disk cache so ges_audio_peaks_load() can find them
+ * later on.
+ *
+ * Returns: %TRUE if @peaks could be written, %FALSE otherwise
+ */
+gboolean
+ges_audio_peaks_save (GESAudioPeaks * peaks, const gchar * uri,
+    GError ** error)
+{
+  guint level;
+  gboolean ret;
+  gchar *filename;
+  PeaksHeader header = { PEAKS_VERSION, PEAKS_RATE, PEAKS_BASE_BLOCK,
+    PEAKS_LEVEL_FACTOR, PEAKS_N_LEVELS
+  };
+  GByteArray *contents = g_byte_array_new ();
+
+  g_byte_array_append (contents, (const guint8 *) PEAKS_MAGIC,
+      strlen (PEAKS_MAGIC));
+  g_byte_array_append (contents, (const guint8 *) &header, sizeof (header));
+  g_byte_array_append (contents, (const guint8 *) peaks->n_peaks,
+      sizeof (peaks->n_peaks));
+  for (level = 0; level < PEAKS_N_LEVELS; level++)
+    g_byte_array_append (contents, (const guint8 *) peaks->peaks[level],
+        peaks->n_peaks[level] * 3 * sizeof (gint16));
+
+  filename = _get_cache_filename (uri);
+  ret = g_file_set_contents (filename, (const gchar *) contents->data,
+      contents->len, error);
+
+  g_byte_array_unref (contents);
+  g_free (filename);
+
+  return ret;
+}
+
+/**
+ * ges_audio_peaks_get_range:
+ * @peaks: A #GESAudioPeaks
+ * @start: The position in the media of the first peak to get
+ * @duration: The duration covered by the @n_peaks peaks
+ * @n_peaks: The number of peaks to get
+ * @mins: (allow-none): Array of @n_peaks values to fill with the minimums
+ * @maxs: (allow-none): Array of @n_peaks values to fill with the maximums
+ * @rms: (allow-none): Array of @n_peaks values to fill with the RMS values
+ *
+ * Fills the arrays with @n_peaks peaks evenly covering the given range, using
+ * the coarsest resolution that still has at least one block per peak.
+ * Values are normalized between -1.0 and 1.0, the parts of the range past
+ * the end of the media are filled with silence.
+ *
+ * Returns: The number of peaks that have been filled
+ */
+guint
+ges_audio_peaks_get_range (GESAudioPeaks * peaks, GstClockTime start,
+    GstClockTime duration, guint n_peaks, gfloat * mins, gfloat * maxs,
+    gfloat * rms)
+{
+  guint i, level = 0;
+  guint64 block, block_frames = PEAKS_BASE_BLOCK;
+  GstClockTime block_duration, peak_duration;
+
+  if (n_peaks == 0 || duration == 0)
+    return 0;
+
+  peak_duration = duration / n_peaks;
+  while (level + 1 < PEAKS_N_LEVELS &&
+      gst_util_uint64_scale (block_frames * PEAKS_LEVEL_FACTOR, GST_SECOND,
+          PEAKS_RATE) <= peak_duration) {
+    block_frames *= PEAKS_LEVEL_FACTOR;
+    level++;
+  }
+  block_duration = gst_util_uint64_scale (block_frames, GST_SECOND,
+      PEAKS_RATE);
+
+  for (i = 0; i < n_peaks; i++) {
+    const gint16 *data = peaks->peaks[level];
+    GstClockTime pstart = start + gst_util_uint64_scale (i, duration, n_peaks);
+    GstClockTime pend = start + gst_util_uint64_scale (i + 1, duration,
+        n_peaks);
+    guint64 first = pstart / block_duration;
+    guint64 last = MAX (first + 1,
+        (pend + block_duration - 1) / block_duration);
+    gint16 min = G_MAXINT16, max = -G_MAXINT16;
+    gdouble sum = 0;
+
+    last = MIN (last, peaks->n_peaks[level]);
+    if (first >= last) {
+      min = max = 0;
+    } else {
+      for (block = first; block < last; block++) {
+        min = MIN (min, PEAK_MIN (data, block));
+        max = MAX (max, PEAK_MAX (data, block));
+        sum += (gdouble) PEAK_RMS (data, block) * PEAK_RMS (data, block);
+      }
+      sum /= (last - first);
+    }
+
+    if (mins)
+      mins[i] = (gfloat) min / G_MAXINT16;
+    if (maxs)
+      maxs[i] = (gfloat) max / G_MAXINT16;
+    if (rms)
+      rms[i] = (gfloat) (sqrt (sum) / G_MAXINT16);
+  }
+
+  return n_peaks;
+}
+
+void
+ges_audio_peaks_free (GESAudioPeaks * peaks)
+{
+  guint level;
+
+  for (level = 0; level < PEAKS_N_LEVELS; level++)
+    g_free (peaks->peaks[level]);
+
+  g_slice_free (GESAudioPeaks, peaks);
+}
@@ -36,8 +36,8 @@ static guint auto_transition_signals[LAST_SIGNAL] = { 0 };
 G_DEFINE_TYPE (GESAutoTransition, ges_auto_transition, G_TYPE_OBJECT);
 
 static void
-neighbour_changed_cb (GESClip * clip, GParamSpec * arg G_GNUC_UNUSED,
-    GESAutoTransition * self)
+neighbour_changed_cb (GESTimelineElement * element,
+    GESTimingFlags changed G_GNUC_UNUSED, GESAutoTransition * self)
 {
   gint64 new_duration;
 
@@ -100,10 +100,10 @@ ges_auto_transition_finalize (GObject * object)
 {
   GESAutoTransition *self = GES_AUTO_TRANSITION (object);
 
-  g_signal_handlers_disconnect_by_func (self->previous_source,
-      neighbour_changed_cb, self);
-  g_signal_handlers_disconnect_by_func (self->next_source, neighbour_changed_cb,
-      self);
+  ges_timeline_element_remove_timing_observer (GES_TIMELINE_ELEMENT
+      (self->previous_source), (GESTimingObserver) neighbour_changed_cb, self);
+  ges_timeline_element_remove_timing_observer (GES_TIMELINE_ELEMENT
+      (self->next_source), (GESTimingObserver) neighbour_changed_cb, self);
   g_signal_handlers_disconnect_by_func (self->previous_clip,
       _height_changed_cb, self);
   g_signal_handlers_disconnect_by_func (self->next_source, _track_changed_cb,
@@ -144,18 +144,14 @@ ges_auto_transition_new (GESTrackElement * transition,
   self->next_clip = GES_CLIP (GES_TIMELINE_ELEMENT_PARENT (next_source));
   self->transition_clip = GES_CLIP (GES_TIMELINE_ELEMENT_PARENT (transition));
 
-  g_signal_connect (previous_source, "notify::start",
-      G_CALLBACK (neighbour_changed_cb), self);
-  g_signal_connect (previous_source, "notify::priority",
-      G_CALLBACK (neighbour_changed_cb), self);
-  g_signal_connect (next_source, "notify::start",
-      G_CALLBACK (neighbour_changed_cb), self);
-  g_signal_connect (next_source, "notify::priority",
-      G_CALLBACK (neighbour_changed_cb), self);
-  g_signal_connect (previous_source, "notify::duration",
-      G_CALLBACK (neighbour_changed_cb), self);
-  g_signal_connect (next_source, "notify::duration",
-      G_CALLBACK (neighbour_changed_cb), self);
+  ges_timeline_element_add_timing_observer (GES_TIMELINE_ELEMENT
+      (previous_source),
+      GES_TIMING_START | GES_TIMING_DURATION | GES_TIMING_PRIORITY, FALSE,
+      (GESTimingObserver) neighbour_changed_cb, self);
+  ges_timeline_element_add_timing_observer (GES_TIMELINE_ELEMENT
+      (next_source),
+      GES_TIMING_START | GES_TIMING_DURATION | GES_TIMING_PRIORITY, FALSE,
+      (GESTimingObserver) neighbour_changed_cb, self);
   g_signal_connect (self->previous_clip, "notify::height",
       G_CALLBACK (_height_changed_cb), self);
 
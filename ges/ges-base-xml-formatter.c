@@ -18,6 +18,8 @@
  * Boston, MA 02111-1307, USA.
  */
 
+#include <string.h>
+
 #include "ges.h"
 #include "ges-internal.h"
 
@@ -114,8 +116,18 @@ struct _GESBaseXmlFormatterPrivate
   PendingClip *current_pending_clip;
 
   gboolean timeline_auto_transition;
+
+  /* Time spent in each phase of the load, and end of the last parsing
+   * or asset callback, the time spent waiting for the assets is counted
+   * from there */
+  GESProjectLoadTimings timings;
+  GstClockTime last_activity;
 };
 
+/* Time spent in the element handlers, which is not part of the parsing */
+#define HANDLERS_TIME(priv) ((priv)->timings.asset_resolution + \
+    (priv)->timings.clip_creation + (priv)->timings.track_element_creation)
+
 static void
 _free_layer_entry (LayerEntry * entry)
 {
@@ -138,14 +150,68 @@ enum
 static guint signals[LAST_SIGNAL];
 */
 
+/* Size of the chunks of the file fed to the parser */
+#define PARSE_CHUNK_SIZE 65536
+
+/* Projects saved to URIs with that suffix are compressed */
+#define COMPRESSED_SUFFIX ".gz"
+
+static const guint8 gzip_magic[] = { 0x1f, 0x8b };
+
+/* Opens @file, decompressing it on the fly if it is a gzip file */
+static GInputStream *
+open_input_stream (GFile * file, GError ** error)
+{
+  gsize available;
+  const guint8 *head;
+  GInputStream *stream, *buffered;
+
+  stream = G_INPUT_STREAM (g_file_read (file, NULL, error));
+  if (stream == NULL)
+    return NULL;
+
+  buffered = g_buffered_input_stream_new (stream);
+  g_object_unref (stream);
+
+  if (g_buffered_input_stream_fill (G_BUFFERED_INPUT_STREAM (buffered),
+          sizeof (gzip_magic), NULL, error) < 0) {
+    g_object_unref (buffered);
+
+    return NULL;
+  }
+
+  head = g_buffered_input_stream_peek_buffer (G_BUFFERED_INPUT_STREAM
+      (buffered), &available);
+  if (available >= sizeof (gzip_magic) &&
+      memcmp (head, gzip_magic, sizeof (gzip_magic)) == 0) {
+    GZlibDecompressor *decompressor =
+        g_zlib_decompressor_new (G_ZLIB_COMPRESSOR_FORMAT_GZIP);
+
+    GST_DEBUG ("Reading gzip compressed file");
+    stream = g_converter_input_stream_new (buffered,
+        G_CONVERTER (decompressor));
+    g_object_unref (decompressor);
+    g_object_unref (buffered);
+
+    return stream;
+  }
+
+  return buffered;
+}
+
 static GMarkupParseContext *
 create_parser_context (GESBaseXmlFormatter * self, const gchar * uri,
     GError ** error)
 {
-  gsize xmlsize;
+  gssize read;
+  gsize total = 0;
+  gboolean parsed;
   GFile *file = NULL;
-  gchar *xmlcontent = NULL;
+  gchar *buffer = NULL;
+  GInputStream *stream = NULL;
   GMarkupParseContext *parsecontext = NULL;
+  GstClockTime start, handlers;
+  GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
   GESBaseXmlFormatterClass *self_class =
       GES_BASE_XML_FORMATTER_GET_CLASS (self);
 
@@ -155,22 +221,48 @@ create_parser_context (GESBaseXmlFormatter * self, const gchar * uri,
     goto wrong_uri;
 
   /* TODO Handle GCancellable */
-  if (!g_file_load_contents (file, NULL, &xmlcontent, &xmlsize, NULL, &err))
-    goto failed;
-
-  if (g_strcmp0 (xmlcontent, "") == 0)
+  start = gst_util_get_timestamp ();
+  stream = open_input_stream (file, &err);
+  priv->timings.read += gst_util_get_timestamp () - start;
+  if (stream == NULL)
     goto failed;
 
   parsecontext = g_markup_parse_context_new (&self_class->content_parser,
       G_MARKUP_TREAT_CDATA_AS_TEXT, self, NULL);
 
-  if (g_markup_parse_context_parse (parsecontext, xmlcontent, xmlsize,
-          &err) == FALSE)
+  /* Parse the file as it is read, so it never is entirely in memory */
+  buffer = g_malloc (PARSE_CHUNK_SIZE);
+  while (TRUE) {
+    start = gst_util_get_timestamp ();
+    read = g_input_stream_read (stream, buffer, PARSE_CHUNK_SIZE, NULL, &err);
+    priv->timings.read += gst_util_get_timestamp () - start;
+    if (read <= 0)
+      break;
+
+    total += read;
+    handlers = HANDLERS_TIME (priv);
+    start = gst_util_get_timestamp ();
+    parsed = g_markup_parse_context_parse (parsecontext, buffer, read, &err);
+    priv->timings.parse += gst_util_get_timestamp () - start -
+        (HANDLERS_TIME (priv) - handlers);
+    if (parsed == FALSE)
+      goto failed;
+  }
+
+  if (read < 0)
     goto failed;
 
+  if (total == 0) {
+    g_set_error (&err, G_MARKUP_ERROR, G_MARKUP_ERROR_EMPTY, "%s is empty",
+        uri);
+    goto failed;
+  }
+
 done:
-  if (xmlcontent)
-    g_free (xmlcontent);
+  g_free (buffer);
+
+  if (stream)
+    g_object_unref (stream);
 
   if (file)
     gst_object_unref (file);
@@ -232,6 +324,8 @@ _load_from_uri (GESFormatter * self, GESTimeline * timeline, const gchar * uri,
   if (!priv->parsecontext)
     return FALSE;
 
+  priv->last_activity = gst_util_get_timestamp ();
+
   return TRUE;
 }
 
@@ -261,6 +355,16 @@ _save_to_uri (GESFormatter * formatter, GESTimeline * timeline,
       goto failed_opening_file;
   }
 
+  if (g_str_has_suffix (uri, COMPRESSED_SUFFIX)) {
+    GOutputStream *base = stream;
+    GZlibCompressor *compressor =
+        g_zlib_compressor_new (G_ZLIB_COMPRESSOR_FORMAT_GZIP, -1);
+
+    stream = g_converter_output_stream_new (base, G_CONVERTER (compressor));
+    g_object_unref (compressor);
+    g_object_unref (base);
+  }
+
   str = GES_BASE_XML_FORMATTER_GET_CLASS (formatter)->save (formatter,
       timeline, error);
 
@@ -362,6 +466,8 @@ ges_base_xml_formatter_init (GESBaseXmlFormatter * self)
   priv->current_clip = NULL;
   priv->current_pending_clip = NULL;
   priv->timeline_auto_transition = FALSE;
+  memset (&priv->timings, 0, sizeof (priv->timings));
+  priv->last_activity = GST_CLOCK_TIME_NONE;
 }
 
 static void
@@ -416,6 +522,7 @@ _loading_done (GESFormatter * self)
       priv->timeline_auto_transition);
 
   g_hash_table_foreach (priv->layers, (GHFunc) _set_auto_transition, NULL);
+  ges_project_set_load_timings (self->project, &priv->timings);
   ges_project_set_loaded (self->project, self);
 }
 
@@ -448,16 +555,35 @@ _add_object_to_layer (GESBaseXmlFormatterPrivate * priv, const gchar * id,
     GESTrackType track_types, const gchar * metadatas,
     GstStructure * properties)
 {
-  GESClip *clip = ges_layer_add_asset (layer,
-      asset, start, inpoint, duration, track_types);
+  GESClip *clip;
+  GstClockTime begin, added;
+
+  /* Same as ges_layer_add_asset() but telling the creation of the clip
+   * from the creation of its track elements, done when adding it */
+  begin = gst_util_get_timestamp ();
+  clip = GES_CLIP (ges_asset_extract (asset, NULL));
+  if (clip == NULL)
+    goto failed;
 
-  if (clip == NULL) {
-    GST_WARNING_OBJECT (clip, "Could not add object from asset: %s",
-        ges_asset_get_id (asset));
+  _set_start0 (GES_TIMELINE_ELEMENT (clip), start);
+  _set_inpoint0 (GES_TIMELINE_ELEMENT (clip), inpoint);
+  if (track_types != GES_TRACK_TYPE_UNKNOWN)
+    ges_clip_set_supported_formats (clip, track_types);
+  if (GST_CLOCK_TIME_IS_VALID (duration))
+    _set_duration0 (GES_TIMELINE_ELEMENT (clip), duration);
 
-    return NULL;
+  added = gst_util_get_timestamp ();
+  priv->timings.clip_creation += added - begin;
+  if (!ges_layer_add_clip (layer, clip)) {
+    gst_object_unref (clip);
+    priv->timings.track_element_creation += gst_util_get_timestamp () - added;
+
+    goto failed;
   }
 
+  begin = gst_util_get_timestamp ();
+  priv->timings.track_element_creation += begin - added;
+
   if (metadatas)
     ges_meta_container_add_metas_from_string (GES_META_CONTAINER (clip),
         metadatas);
@@ -467,7 +593,15 @@ _add_object_to_layer (GESBaseXmlFormatterPrivate * priv, const gchar * id,
         (GstStructureForeachFunc) set_property_foreach, clip);
 
   g_hash_table_insert (priv->clips, g_strdup (id), gst_object_ref (clip));
+  priv->timings.clip_creation += gst_util_get_timestamp () - begin;
+
   return clip;
+
+failed:
+  GST_WARNING ("Could not add object from asset: %s",
+      ges_asset_get_id (asset));
+
+  return NULL;
 }
 
 static void
@@ -565,7 +699,15 @@ new_asset_cb (GESAsset * source, GAsyncResult * res, PendingAsset * passet)
   GESFormatter *self = passet->formatter;
   const gchar *id = ges_asset_get_id (source);
   GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
-  GESAsset *asset = ges_asset_request_finish (res, &error);
+  GstClockTime begin = gst_util_get_timestamp ();
+  GstClockTime created = priv->timings.clip_creation +
+      priv->timings.track_element_creation;
+  GESAsset *asset;
+
+  /* Until now, we were waiting for the asset */
+  if (GST_CLOCK_TIME_IS_VALID (priv->last_activity))
+    priv->timings.asset_resolution += begin - priv->last_activity;
+  asset = ges_asset_request_finish (res, &error);
 
   if (error) {
     GST_LOG_OBJECT (self, "Error %s creating asset id: %s", error->message, id);
@@ -578,7 +720,11 @@ new_asset_cb (GESAsset * source, GAsyncResult * res, PendingAsset * passet)
       GType extractable_type = ges_asset_get_extractable_type (asset);
       GESAsset *parent =
           ges_asset_cache_lookup (extractable_type, passet->parent_id);
-      ges_asset_set_parent (asset, parent);
+
+      if (parent) {
+        ges_asset_set_parent (asset, parent);
+        gst_object_unref (parent);
+      }
     }
     if (passet->properties)
       gst_structure_foreach (passet->properties,
@@ -626,6 +772,7 @@ new_asset_cb (GESAsset * source, GAsyncResult * res, PendingAsset * passet)
   for (tmp = pendings; tmp; tmp = tmp->next) {
     GList *tmpeffect;
     GESClip *clip;
+    GstClockTime start;
     PendingClip *pend = (PendingClip *) tmp->data;
 
     clip =
@@ -636,6 +783,7 @@ new_asset_cb (GESAsset * source, GAsyncResult * res, PendingAsset * passet)
     if (clip == NULL)
       continue;
 
+    start = gst_util_get_timestamp ();
     _add_pending_bindings (priv, pend->pending_bindings, clip);
 
     GST_DEBUG_OBJECT (self, "Adding %i effect to new object",
@@ -647,6 +795,7 @@ new_asset_cb (GESAsset * source, GAsyncResult * res, PendingAsset * passet)
       _add_track_element (self, clip, gst_object_ref (peffect->trackelement),
           peffect->track_id, peffect->children_properties, peffect->properties);
     }
+    priv->timings.track_element_creation += gst_util_get_timestamp () - start;
     _free_pending_clip (priv, pend);
   }
 
@@ -667,6 +816,12 @@ done:
     g_list_free (pendings);
   }
 
+  /* What was not spent creating the clips was spent resolving the asset */
+  priv->last_activity = gst_util_get_timestamp ();
+  priv->timings.asset_resolution += priv->last_activity - begin -
+      (priv->timings.clip_creation + priv->timings.track_element_creation -
+      created);
+
   if (g_hash_table_size (priv->assetid_pendingclips) == 0 &&
       priv->pending_assets == NULL)
     _loading_done (self);
@@ -722,12 +877,14 @@ ges_base_xml_formatter_add_asset (GESBaseXmlFormatter * self,
     const gchar * id, const gchar * parent_id, GType extractable_type,
     GstStructure * properties, const gchar * metadatas, GError ** error)
 {
+  GstClockTime start;
   PendingAsset *passet;
   GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
 
   if (priv->check_only)
     return;
 
+  start = gst_util_get_timestamp ();
   passet = g_slice_new0 (PendingAsset);
   passet->metadatas = g_strdup (metadatas);
   passet->formatter = gst_object_ref (self);
@@ -736,11 +893,25 @@ ges_base_xml_formatter_add_asset (GESBaseXmlFormatter * self,
   if (properties)
     passet->properties = gst_structure_copy (properties);
 
+  if (properties && extractable_type == GES_TYPE_URI_CLIP &&
+      ges_project_get_trust_saved_metadata (GES_FORMATTER (self)->project)) {
+    GESAsset *asset = ges_uri_clip_asset_new_trusted (id, properties,
+        metadatas);
+
+    /* The request will then complete without discovering the file */
+    if (asset) {
+      ges_project_add_unvalidated_asset (GES_FORMATTER (self)->project,
+          asset);
+      gst_object_unref (asset);
+    }
+  }
+
   ges_asset_request_async (extractable_type, id, NULL,
       (GAsyncReadyCallback) new_asset_cb, passet);
   ges_project_add_loading_asset (GES_FORMATTER (self)->project,
       extractable_type, id);
   priv->pending_assets = g_list_prepend (priv->pending_assets, passet);
+  priv->timings.asset_resolution += gst_util_get_timestamp () - start;
 }
 
 void
@@ -753,6 +924,7 @@ ges_base_xml_formatter_add_clip (GESBaseXmlFormatter * self,
   GESAsset *asset;
   GESClip *nclip;
   LayerEntry *entry;
+  GstClockTime begin;
   GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
 
   if (priv->check_only)
@@ -771,7 +943,9 @@ ges_base_xml_formatter_add_clip (GESBaseXmlFormatter * self,
     gst_structure_remove_fields (properties, "supported-formats",
         "inpoint", "start", "duration", NULL);
 
+  begin = gst_util_get_timestamp ();
   asset = ges_asset_request (type, asset_id, NULL);
+  priv->timings.asset_resolution += gst_util_get_timestamp () - begin;
   if (asset == NULL) {
     gchar *real_id;
     PendingClip *pclip;
@@ -971,6 +1145,7 @@ ges_base_xml_formatter_add_control_binding (GESBaseXmlFormatter * self,
 
   if (!g_strcmp0 (source_type, "interpolation")) {
     GstControlSource *source;
+    GstClockTime start = gst_util_get_timestamp ();
 
     source = gst_interpolation_control_source_new ();
     ges_track_element_set_control_source (element, source,
@@ -980,6 +1155,7 @@ ges_base_xml_formatter_add_control_binding (GESBaseXmlFormatter * self,
 
     gst_timed_value_control_source_set_from_list (GST_TIMED_VALUE_CONTROL_SOURCE
         (source), timed_values);
+    priv->timings.track_element_creation += gst_util_get_timestamp () - start;
   } else
     GST_WARNING ("This interpolation type is not supported\n");
 }
@@ -992,6 +1168,7 @@ ges_base_xml_formatter_add_track_element (GESBaseXmlFormatter * self,
 {
   GESTrackElement *trackelement;
 
+  GstClockTime start;
   GError *err = NULL;
   GESAsset *asset = NULL;
   GESBaseXmlFormatterPrivate *priv = _GET_PRIV (self);
@@ -999,6 +1176,7 @@ ges_base_xml_formatter_add_track_element (GESBaseXmlFormatter * self,
   if (priv->check_only)
     return;
 
+  start = gst_util_get_timestamp ();
   if (g_type_is_a (track_element_type, GES_TYPE_TRACK_ELEMENT) == FALSE) {
     GST_DEBUG_OBJECT (self, "%s is not a TrackElement, can not create it",
         g_type_name (track_element_type));
@@ -1062,7 +1240,7 @@ out:
   if (err)
     g_error_free (err);
 
-  return;
+  priv->timings.track_element_creation += gst_util_get_timestamp () - start;
 }
 
 void
@@ -21,6 +21,12 @@
  * SECTION:ges-effect
  * @short_description: adds an effect build from a parse-launch style 
  * bin description to a stream in a #GESSourceClip or a #GESLayer
+ *
+ * An effect can be bypassed with ges_effect_set_bypass(), which makes its
+ * data flow around the effect inside of its own bin. Contrary to
+ * ges_track_element_set_active(), this does not require the composition to
+ * be updated, so effects can be switched on and off during playback
+ * without any seek.
  */
 
 #include "ges-internal.h"
@@ -44,12 +50,20 @@ static GstElement *ges_effect_create_element (GESTrackElement * self);
 struct _GESEffectPrivate
 {
   gchar *bin_description;
+
+  gboolean bypass;
+  /* The output-selector sending the data either through the effect or
+   * around it, and its pads for each of those */
+  GstElement *selector;
+  GstPad *effect_pad;
+  GstPad *bypass_pad;
 };
 
 enum
 {
   PROP_0,
   PROP_BIN_DESCRIPTION,
+  PROP_BYPASS,
 };
 
 static gchar *
@@ -103,6 +117,9 @@ ges_effect_get_property (GObject * object,
     case PROP_BIN_DESCRIPTION:
       g_value_set_string (value, priv->bin_description);
       break;
+    case PROP_BYPASS:
+      g_value_set_boolean (value, priv->bypass);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
   }
@@ -118,6 +135,9 @@ ges_effect_set_property (GObject * object,
     case PROP_BIN_DESCRIPTION:
       self->priv->bin_description = g_value_dup_string (value);
       break;
+    case PROP_BYPASS:
+      ges_effect_set_bypass (self, g_value_get_boolean (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
   }
@@ -154,6 +174,16 @@ ges_effect_class_init (GESEffectClass * klass)
           "bin description",
           "Bin description of the effect",
           NULL, G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+
+  /**
+   * GESEffect:bypass:
+   *
+   * Whether the data flows around the effect instead of through it. It can
+   * be changed during playback without the composition being updated.
+   */
+  g_object_class_install_property (object_class, PROP_BYPASS,
+      g_param_spec_boolean ("bypass", "Bypass",
+          "Whether the effect is bypassed", FALSE, G_PARAM_READWRITE));
 }
 
 static void
@@ -166,6 +196,12 @@ ges_effect_init (GESEffect * self)
 static void
 ges_effect_dispose (GObject * object)
 {
+  GESEffectPrivate *priv = GES_EFFECT (object)->priv;
+
+  gst_object_replace ((GstObject **) & priv->selector, NULL);
+  gst_object_replace ((GstObject **) & priv->effect_pad, NULL);
+  gst_object_replace ((GstObject **) & priv->bypass_pad, NULL);
+
   G_OBJECT_CLASS (ges_effect_parent_class)->dispose (object);
 }
 
@@ -180,6 +216,37 @@ ges_effect_finalize (GObject * object)
   G_OBJECT_CLASS (ges_effect_parent_class)->finalize (object);
 }
 
+/* Keeps the pads of the selector leading to the effect and around it */
+static gboolean
+get_selector_pads (GESEffect * self, GstElement * effect)
+{
+  GList *tmp;
+  GESEffectPrivate *priv = self->priv;
+  GstElement *selector = gst_bin_get_by_name (GST_BIN (effect),
+      "bypass-selector");
+  GstElement *funnel = gst_bin_get_by_name (GST_BIN (effect), "bypass-funnel");
+
+  GST_OBJECT_LOCK (selector);
+  for (tmp = selector->srcpads; tmp; tmp = tmp->next) {
+    GstPad *pad = tmp->data, *peer = gst_pad_get_peer (pad);
+
+    if (peer == NULL)
+      continue;
+
+    if (GST_OBJECT_PARENT (peer) == GST_OBJECT (funnel))
+      gst_object_replace ((GstObject **) & priv->bypass_pad, GST_OBJECT (pad));
+    else
+      gst_object_replace ((GstObject **) & priv->effect_pad, GST_OBJECT (pad));
+    gst_object_unref (peer);
+  }
+  GST_OBJECT_UNLOCK (selector);
+
+  gst_object_unref (funnel);
+  priv->selector = selector;
+
+  return priv->bypass_pad && priv->effect_pad;
+}
+
 static GstElement *
 ges_effect_create_element (GESTrackElement * object)
 {
@@ -198,14 +265,18 @@ ges_effect_create_element (GESTrackElement * object)
     return NULL;
   }
 
+  /* The output-selector sends the data either through the effect or
+   * directly to the funnel, which is how the effect gets bypassed */
   if (track->type == GES_TRACK_TYPE_VIDEO) {
-    bin_desc = g_strconcat ("videoconvert name=pre_video_convert ! ",
-        self->priv->bin_description, " ! videoconvert name=post_video_convert",
-        NULL);
+    bin_desc = g_strdup_printf ("videoconvert name=pre_video_convert ! "
+        "output-selector name=bypass-selector pad-negotiation-mode=active ! "
+        "%s ! funnel name=bypass-funnel ! videoconvert name=post_video_convert "
+        "bypass-selector. ! bypass-funnel.", self->priv->bin_description);
   } else if (track->type == GES_TRACK_TYPE_AUDIO) {
-    bin_desc =
-        g_strconcat ("audioconvert ! audioresample !",
-        self->priv->bin_description, NULL);
+    bin_desc = g_strdup_printf ("audioconvert ! audioresample ! "
+        "output-selector name=bypass-selector pad-negotiation-mode=active ! "
+        "%s ! funnel name=bypass-funnel ! audioconvert "
+        "bypass-selector. ! bypass-funnel.", self->priv->bin_description);
   } else {
     GST_DEBUG ("Track type not supported");
     return NULL;
@@ -222,6 +293,15 @@ ges_effect_create_element (GESTrackElement * object)
     return NULL;
   }
 
+  if (!get_selector_pads (self, effect)) {
+    GST_ERROR_OBJECT (self, "Could not find the bypass path of the effect");
+    gst_object_unref (effect);
+    return NULL;
+  }
+
+  g_object_set (self->priv->selector, "active-pad", self->priv->bypass ?
+      self->priv->bypass_pad : self->priv->effect_pad, NULL);
+
   GST_DEBUG ("Created effect %p", effect);
 
   ges_track_element_add_children_props (object, effect, wanted_categories,
@@ -256,3 +336,51 @@ ges_effect_new (const gchar * bin_description)
 
   return effect;
 }
+
+/**
+ * ges_effect_set_bypass:
+ * @effect: a #GESEffect
+ * @bypass: whether to bypass @effect
+ *
+ * Makes the data flow around @effect instead of through it, or back through
+ * it. This takes effect right away, even during playback, and does not
+ * require the timeline to be committed.
+ */
+void
+ges_effect_set_bypass (GESEffect * effect, gboolean bypass)
+{
+  GESEffectPrivate *priv;
+
+  g_return_if_fail (GES_IS_EFFECT (effect));
+
+  priv = effect->priv;
+  if (priv->bypass == bypass)
+    return;
+
+  GST_DEBUG_OBJECT (effect, "%s the effect", bypass ? "Bypassing" :
+      "Restoring");
+  priv->bypass = bypass;
+  if (priv->selector)
+    g_object_set (priv->selector, "active-pad", bypass ? priv->bypass_pad :
+        priv->effect_pad, NULL);
+
+  /* What the timeline renders changes even though the composition does
+   * not need to be commited */
+  ges_track_element_content_changed (GES_TRACK_ELEMENT (effect));
+
+  g_object_notify (G_OBJECT (effect), "bypass");
+}
+
+/**
+ * ges_effect_get_bypass:
+ * @effect: a #GESEffect
+ *
+ * Returns: %TRUE if @effect is bypassed, %FALSE otherwise
+ */
+gboolean
+ges_effect_get_bypass (GESEffect * effect)
+{
+  g_return_val_if_fail (GES_IS_EFFECT (effect), FALSE);
+
+  return effect->priv->bypass;
+}
@@ -78,5 +78,10 @@ GType ges_effect_get_type (void);
 GESEffect*
 ges_effect_new (const gchar * bin_description);
 
+void
+ges_effect_set_bypass (GESEffect * effect, gboolean bypass);
+gboolean
+ges_effect_get_bypass (GESEffect * effect);
+
 G_END_DECLS
 #endif /* _GES_EFFECT */
@@ -346,6 +346,26 @@ typedef enum {
 
 GType ges_pipeline_flags_get_type (void);
 
+/**
+ * GESPreviewQuality:
+ * @GES_PREVIEW_QUALITY_FULL: preview at the size of the track restriction caps
+ * @GES_PREVIEW_QUALITY_HALF: preview at half the size in each dimension
+ * @GES_PREVIEW_QUALITY_QUARTER: preview at a quarter of the size in each
+ * dimension
+ *
+ * The resolutions at which a #GESPipeline can preview video. The values are
+ * the factor by which the width and height of the video are divided.
+ */
+typedef enum {
+  GES_PREVIEW_QUALITY_FULL    = 1,
+  GES_PREVIEW_QUALITY_HALF    = 2,
+  GES_PREVIEW_QUALITY_QUARTER = 4
+} GESPreviewQuality;
+
+#define GES_TYPE_PREVIEW_QUALITY ges_preview_quality_get_type()
+
+GType ges_preview_quality_get_type (void);
+
 /**
  * GESEditMode:
  * @GES_EDIT_MODE_NORMAL: The object is edited the normal way (default).
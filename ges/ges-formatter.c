@@ -164,8 +164,11 @@ _get_extension (const gchar * uri)
   if (uri == NULL)
     goto no_uri;
 
-  /* find the extension on the uri, this is everything after a '.' */
+  /* find the extension on the uri, this is everything after a '.', not
+   * taking into account the suffix of compressed files */
   len = strlen (uri);
+  if (g_str_has_suffix (uri, ".gz"))
+    len -= 3;
   find = len - 1;
 
   while (find >= 0) {
@@ -176,7 +179,7 @@ _get_extension (const gchar * uri)
   if (find < 0)
     goto no_extension;
 
-  result = g_strdup (&uri[find + 1]);
+  result = g_strndup (&uri[find + 1], len - find - 1);
 
   GST_DEBUG ("found extension %s", result);
 
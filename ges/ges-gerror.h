@@ -39,12 +39,15 @@ G_BEGIN_DECLS
  * @GES_ERROR_ASSET_WRONG_ID: The ID passed is malformed
  * @GES_ERROR_ASSET_LOADING: An error happened while loading the asset
  * @GES_ERROR_FORMATTER_MALFORMED_INPUT_FILE: The formatted files was malformed
+ * @GES_ERROR_ASSET_METADATA_MISMATCH: The metadatas an asset has been
+ * created from did not match the file, the asset has been updated
  */
 typedef enum
 {
   GES_ERROR_ASSET_WRONG_ID,
   GES_ERROR_ASSET_LOADING,
   GES_ERROR_FORMATTER_MALFORMED_INPUT_FILE,
+  GES_ERROR_ASSET_METADATA_MISMATCH,
 } GESError;
 
 G_END_DECLS
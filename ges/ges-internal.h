@@ -91,6 +91,26 @@ void
 timeline_remove_group          (GESTimeline *timeline,
                                 GESGroup *group);
 
+G_GNUC_INTERNAL GESTimeline *
+timeline_copy                  (GESTimeline *timeline,
+                                GESTrackType track_types,
+                                GstClockTime start,
+                                GstClockTime stop);
+
+G_GNUC_INTERNAL void
+timeline_add_render_cache      (GESTimeline *timeline,
+                                GESRenderCache *cache);
+G_GNUC_INTERNAL void
+timeline_remove_render_cache   (GESTimeline *timeline,
+                                GESRenderCache *cache);
+G_GNUC_INTERNAL void
+timeline_set_use_cached_media  (GESTimeline *timeline,
+                                gboolean use);
+
+G_GNUC_INTERNAL void
+timeline_element_changed       (GESTimeline *timeline,
+                                GESTimelineElement *element);
+
 G_GNUC_INTERNAL void
 ges_asset_cache_init (void);
 
@@ -122,6 +142,22 @@ G_GNUC_INTERNAL gboolean
 ges_asset_request_id_update (GESAsset *asset, gchar **proposed_id,
     GError *error);
 
+/* GESUriClipAsset internal methods */
+G_GNUC_INTERNAL GESAsset *
+ges_uri_clip_asset_new_trusted     (const gchar *uri,
+                                    const GstStructure *properties,
+                                    const gchar *metadatas);
+
+G_GNUC_INTERNAL void
+ges_uri_clip_asset_validate_async  (GESUriClipAsset *self,
+                                    GAsyncReadyCallback callback,
+                                    gpointer user_data);
+
+G_GNUC_INTERNAL gboolean
+ges_uri_clip_asset_validate_finish (GESUriClipAsset *self,
+                                    GAsyncResult *res,
+                                    GError **error);
+
 /* GESExtractable internall methods
  *
  * FIXME Check if that should be public later
@@ -172,6 +208,22 @@ G_GNUC_INTERNAL  gchar * ges_project_try_updating_id              (GESProject *s
 G_GNUC_INTERNAL  void ges_project_add_loading_asset               (GESProject *project,
                                                                    GType extractable_type,
                                                                    const gchar *id);
+G_GNUC_INTERNAL  void ges_project_add_unvalidated_asset           (GESProject *project,
+                                                                   GESAsset *asset);
+
+/* Time spent in each phase of the last load of a project */
+typedef struct
+{
+  GstClockTime read;
+  GstClockTime parse;
+  GstClockTime asset_resolution;
+  GstClockTime clip_creation;
+  GstClockTime track_element_creation;
+  GstClockTime first_commit;
+} GESProjectLoadTimings;
+
+G_GNUC_INTERNAL  void ges_project_set_load_timings                (GESProject *project,
+                                                                   const GESProjectLoadTimings *timings);
 
 /************************************************
  *                                              *
@@ -255,6 +307,7 @@ G_GNUC_INTERNAL void _init_standard_transition_assets        (void);
 G_GNUC_INTERNAL void _init_formatter_assets                  (void);
 
 /* Utilities */
+G_GNUC_INTERNAL gchar * ges_get_cache_directory            (const gchar * subdir);
 G_GNUC_INTERNAL gint element_start_compare                (GESTimelineElement * a,
                                                            GESTimelineElement * b);
 G_GNUC_INTERNAL gint element_end_compare                  (GESTimelineElement * a,
@@ -266,6 +319,35 @@ ges_base_xml_formatter_set_timeline_properties(GESBaseXmlFormatter * self,
 					       const gchar *properties,
 					       const gchar *metadatas);
 
+/****************************************************
+ *              GESTimelineElement                  *
+ ****************************************************/
+typedef enum
+{
+  GES_TIMING_START    = 1 << 0,
+  GES_TIMING_INPOINT  = 1 << 1,
+  GES_TIMING_DURATION = 1 << 2,
+  GES_TIMING_PRIORITY = 1 << 3,
+} GESTimingFlags;
+
+#define GES_TIMING_ALL (GES_TIMING_START | GES_TIMING_INPOINT | \
+    GES_TIMING_DURATION | GES_TIMING_PRIORITY)
+
+/* Called after the notify signals of @element have been emitted, with the
+ * fields that changed */
+typedef void (*GESTimingObserver) (GESTimelineElement *element,
+                                   GESTimingFlags changed,
+                                   gpointer user_data);
+
+G_GNUC_INTERNAL void ges_timeline_element_add_timing_observer    (GESTimelineElement *self,
+                                                                  GESTimingFlags fields,
+                                                                  gboolean after,
+                                                                  GESTimingObserver func,
+                                                                  gpointer user_data);
+G_GNUC_INTERNAL void ges_timeline_element_remove_timing_observer (GESTimelineElement *self,
+                                                                  GESTimingObserver func,
+                                                                  gpointer user_data);
+
 /****************************************************
  *              GESContainer                        *
  ****************************************************/
@@ -289,15 +371,90 @@ GList*            ges_clip_create_track_elements  (GESClip *clip, GESTrackType t
 #define         GNL_OBJECT_TRACK_ELEMENT_QUARK                  (g_quark_from_string ("gnl_object_track_element_quark"))
 G_GNUC_INTERNAL gboolean  ges_track_element_set_track           (GESTrackElement * object, GESTrack * track);
 G_GNUC_INTERNAL guint32   _ges_track_element_get_layer_priority (GESTrackElement * element);
+G_GNUC_INTERNAL void      ges_track_element_sync_gnlobject      (GESTrackElement * object);
+G_GNUC_INTERNAL void      ges_track_element_content_changed     (GESTrackElement * object);
 G_GNUC_INTERNAL void ges_track_element_copy_properties          (GESTimelineElement * element,
                                                                  GESTimelineElement * elementcopy);
 
 G_GNUC_INTERNAL void ges_track_element_split_bindings (GESTrackElement *element,
 						       GESTrackElement *new_element,
 						       guint64 position);
+G_GNUC_INTERNAL void ges_track_element_copy_bindings  (GESTrackElement *element,
+						       GESTrackElement *new_element);
 
 G_GNUC_INTERNAL GstElement *ges_source_create_topbin (const gchar * bin_name, GstElement * sub_element, ...);
 
-G_GNUC_INTERNAL void ges_track_set_caps (GESTrack *track, const GstCaps *caps);
+/****************************************************
+ *              GESTrack                            *
+ ****************************************************/
+G_GNUC_INTERNAL void      ges_track_set_caps             (GESTrack *track, const GstCaps *caps);
+G_GNUC_INTERNAL GESTrack* ges_track_copy                 (GESTrack *track);
+G_GNUC_INTERNAL gboolean  ges_track_add_cached_media     (GESTrack *track,
+                                                          GstElement *gnlobject,
+                                                          GstClockTime start,
+                                                          GstClockTime duration);
+G_GNUC_INTERNAL void      ges_track_remove_cached_media  (GESTrack *track,
+                                                          GstElement *gnlobject);
+G_GNUC_INTERNAL void      ges_track_set_use_cached_media (GESTrack *track,
+                                                          gboolean use);
+G_GNUC_INTERNAL void      ges_track_update_element_activity (GESTrack *track,
+                                                            GESTrackElement *element);
+G_GNUC_INTERNAL void      ges_track_content_changed      (GESTrack *track,
+                                                          GESTrackElement *element);
+/* Not internal so the unit tests can use it */
+gboolean                  ges_track_is_source_silent     (GESTrack *track,
+                                                          GESTrackElement *source);
+G_GNUC_INTERNAL void      ges_track_set_preview_scale    (GESTrack *track,
+                                                          guint scale);
+G_GNUC_INTERNAL guint     ges_track_get_preview_scale    (GESTrack *track);
+G_GNUC_INTERNAL void      ges_track_queue_gnlobject_update (GESTrack *track,
+                                                            GESTrackElement *element);
+
+/****************************************************
+ *              GESNestedTimelineSource             *
+ ****************************************************/
+G_GNUC_INTERNAL void ges_nested_timeline_source_update_content (GESNestedTimelineSource *self);
+
+/****************************************************
+ *              GESRenderCache                      *
+ ****************************************************/
+G_GNUC_INTERNAL gchar *   ges_render_cache_get_cached_uri (GESRenderCache *cache,
+                                                           GESTrackType track_type,
+                                                           GstClockTime start,
+                                                           GstClockTime stop);
+
+/****************************************************
+ *              GESAudioPeaks                       *
+ ****************************************************/
+typedef struct _GESAudioPeaks GESAudioPeaks;
+
+G_GNUC_INTERNAL GESAudioPeaks * ges_audio_peaks_compute   (const gchar *uri,
+                                                           GCancellable *cancellable,
+                                                           GError **error);
+G_GNUC_INTERNAL GESAudioPeaks * ges_audio_peaks_load      (const gchar *uri);
+G_GNUC_INTERNAL gboolean        ges_audio_peaks_save      (GESAudioPeaks *peaks,
+                                                           const gchar *uri,
+                                                           GError **error);
+G_GNUC_INTERNAL guint           ges_audio_peaks_get_range (GESAudioPeaks *peaks,
+                                                           GstClockTime start,
+                                                           GstClockTime duration,
+                                                           guint n_peaks,
+                                                           gfloat *mins,
+                                                           gfloat *maxs,
+                                                           gfloat *rms);
+G_GNUC_INTERNAL void            ges_audio_peaks_free      (GESAudioPeaks *peaks);
+
+/****************************************************
+ *              GESTimelineSnapshot                 *
+ ****************************************************/
+G_GNUC_INTERNAL GHashTable *   ges_timeline_snapshot_new_clip_cache (void);
+G_GNUC_INTERNAL GESTimelineSnapshot *
+ges_timeline_snapshot_new                (GESTimeline *timeline,
+                                          GHashTable **clip_cache);
+G_GNUC_INTERNAL gboolean
+ges_timeline_snapshot_is_animated        (GESTimelineSnapshot *snapshot);
+G_GNUC_INTERNAL gboolean
+ges_timeline_snapshot_shares_clips       (GESTimelineSnapshot *snapshot,
+                                          GESTimelineSnapshot *other);
 
 #endif /* __GES_INTERNAL_H__ */
@@ -102,6 +102,14 @@ G_BEGIN_DECLS
  */
 #define GES_META_VOLUME_DEFAULT                       1.0
 
+/**
+ * GES_META_FILE_SIZE:
+ *
+ * The size in bytes of the file of a #GESUriClipAsset (guint64), used to
+ * find the file back if it has been moved
+ */
+#define GES_META_FILE_SIZE                           "file-size"
+
 typedef struct _GESMetaContainer          GESMetaContainer;
 typedef struct _GESMetaContainerInterface GESMetaContainerInterface;
 
@@ -0,0 +1,534 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:ges-nested-timeline-clip
+ * @short_description: Use a #GESTimeline as a clip of another timeline
+ *
+ * A #GESNestedTimelineClip places a whole #GESTimeline, usually extracted
+ * from a #GESProject, on a #GESLayer of another timeline. It creates a
+ * #GESNestedTimelineSource for each type of track the nested timeline has.
+ *
+ * By default the nested timeline is evaluated live: every source plays its
+ * own copy of it, which is refreshed every time the nested timeline is
+ * commited. When a #GESRenderCache of the nested timeline is set with
+ * ges_nested_timeline_clip_set_render_cache(), the nested timeline is
+ * rendered once in the background, and all the clips sharing that cache,
+ * in any number of timelines, then play the rendered media instead.
+ *
+ * The ID of the #GESAsset of a #GESNestedTimelineClip is the URI of the
+ * #GESProject of the nested timeline, so a timeline nesting projects that
+ * have been saved to, or loaded from, a file can itself be serialized. All
+ * the clips extracted from the same asset share the same nested timeline.
+ * A timeline can not be nested, directly or not, in itself.
+ */
+
+#include "ges-internal.h"
+#include "ges-nested-timeline-clip.h"
+#include "ges-nested-timeline-source.h"
+#include "ges-render-cache.h"
+#include "ges-extractable.h"
+
+static void ges_extractable_interface_init (GESExtractableInterface * iface);
+
+G_DEFINE_TYPE_WITH_CODE (GESNestedTimelineClip, ges_nested_timeline_clip,
+    GES_TYPE_SOURCE_CLIP,
+    G_IMPLEMENT_INTERFACE (GES_TYPE_EXTRACTABLE,
+        ges_extractable_interface_init));
+
+/* The nested timeline shared by the clips extracted from a project, set on
+ * the project without holding a reference */
+static GQuark nested_timeline_quark;
+
+struct _GESNestedTimelineClipPrivate
+{
+  GESTimeline *timeline;
+  GESRenderCache *render_cache;
+};
+
+enum
+{
+  PROP_0,
+  PROP_NESTED_TIMELINE,
+  PROP_RENDER_CACHE,
+  PROP_LAST
+};
+
+static GParamSpec *properties[PROP_LAST];
+
+static void
+_update_sources (GESNestedTimelineClip * self)
+{
+  GList *tmp;
+
+  for (tmp = GES_CONTAINER_CHILDREN (self); tmp; tmp = tmp->next) {
+    if (GES_IS_NESTED_TIMELINE_SOURCE (tmp->data))
+      ges_nested_timeline_source_update_content (tmp->data);
+  }
+}
+
+static void
+_nested_timeline_commited_cb (GESTimeline * timeline,
+    GESNestedTimelineClip * self)
+{
+  GstClockTime duration = ges_timeline_get_duration (timeline);
+
+  ges_timeline_element_set_max_duration (GES_TIMELINE_ELEMENT (self),
+      duration);
+
+  if (self->priv->render_cache && duration)
+    ges_render_cache_add_range (self->priv->render_cache, 0, duration);
+
+  _update_sources (self);
+}
+
+static void
+_range_cached_cb (GESRenderCache * cache, guint64 start, guint64 duration,
+    GESNestedTimelineClip * self)
+{
+  _update_sources (self);
+}
+
+static GESTrackType
+_get_track_types (GESTimeline * timeline)
+{
+  GList *tmp;
+  GESTrackType types = GES_TRACK_TYPE_UNKNOWN;
+
+  for (tmp = timeline->tracks; tmp; tmp = tmp->next) {
+    if (types == GES_TRACK_TYPE_UNKNOWN)
+      types = GES_TRACK (tmp->data)->type;
+    else
+      types |= GES_TRACK (tmp->data)->type;
+  }
+
+  return types;
+}
+
+static gboolean
+_nests_timeline (GESTimeline * nested, GESTimeline * timeline,
+    GHashTable * visited)
+{
+  GList *layers, *clips, *tmp;
+  gboolean ret = FALSE;
+
+  if (nested == timeline)
+    return TRUE;
+
+  if (g_hash_table_contains (visited, nested))
+    return FALSE;
+  g_hash_table_add (visited, nested);
+
+  for (layers = nested->layers; layers && !ret; layers = layers->next) {
+    clips = ges_layer_get_clips (layers->data);
+    for (tmp = clips; tmp && !ret; tmp = tmp->next) {
+      if (GES_IS_NESTED_TIMELINE_CLIP (tmp->data) &&
+          GES_NESTED_TIMELINE_CLIP (tmp->data)->priv->timeline)
+        ret = _nests_timeline (GES_NESTED_TIMELINE_CLIP (tmp->data)->
+            priv->timeline, timeline, visited);
+    }
+    g_list_free_full (clips, gst_object_unref);
+  }
+
+  return ret;
+}
+
+static void
+_nested_timeline_finalized_cb (GESAsset * project, GObject * timeline)
+{
+  if (g_object_get_qdata (G_OBJECT (project), nested_timeline_quark) ==
+      timeline)
+    g_object_set_qdata (G_OBJECT (project), nested_timeline_quark, NULL);
+}
+
+/* Makes sure @timeline has a project and is the timeline shared by the clips
+ * extracted from it */
+static void
+_register_nested_timeline (GESTimeline * timeline)
+{
+  GESAsset *project = ges_extractable_get_asset (GES_EXTRACTABLE (timeline));
+
+  if (project == NULL) {
+    project = GES_ASSET (ges_project_new (NULL));
+    ges_extractable_set_asset (GES_EXTRACTABLE (timeline), project);
+    gst_object_unref (project);
+  }
+
+  if (g_object_get_qdata (G_OBJECT (project), nested_timeline_quark))
+    return;
+
+  g_object_set_qdata (G_OBJECT (project), nested_timeline_quark, timeline);
+  g_object_weak_ref (G_OBJECT (timeline),
+      (GWeakNotify) _nested_timeline_finalized_cb, project);
+}
+
+/* GESExtractable implementation */
+static gchar *
+extractable_check_id (GType type, const gchar * id, GError ** error)
+{
+  if (id == NULL) {
+    g_set_error (error, GES_ERROR, GES_ERROR_ASSET_WRONG_ID,
+        "A nested timeline clip needs the ID of the nested project");
+
+    return NULL;
+  }
+
+  return g_strdup (id);
+}
+
+static GParameter *
+extractable_get_parameters_from_id (const gchar * id, guint * n_params)
+{
+  GESAsset *project;
+  GESTimeline *timeline;
+  GParameter *params = g_new0 (GParameter, 2);
+
+  if (gst_uri_is_valid (id))
+    project = GES_ASSET (ges_project_new (id));
+  else
+    project = ges_asset_request (GES_TYPE_TIMELINE, id, NULL);
+
+  params[0].name = "nested-timeline";
+  g_value_init (&params[0].value, GES_TYPE_TIMELINE);
+
+  if (project) {
+    timeline = g_object_get_qdata (G_OBJECT (project), nested_timeline_quark);
+
+    if (timeline) {
+      g_value_set_object (&params[0].value, timeline);
+    } else {
+      timeline = GES_TIMELINE (ges_asset_extract (project, NULL));
+      if (timeline)
+        g_value_take_object (&params[0].value, gst_object_ref_sink (timeline));
+    }
+
+    gst_object_unref (project);
+  }
+
+  *n_params = 1;
+
+  return params;
+}
+
+static gchar *
+extractable_get_id (GESExtractable * self)
+{
+  gchar *uri;
+  GESAsset *project;
+  GESTimeline *timeline = GES_NESTED_TIMELINE_CLIP (self)->priv->timeline;
+
+  if (timeline == NULL ||
+      !(project = ges_extractable_get_asset (GES_EXTRACTABLE (timeline))))
+    return NULL;
+
+  /* Saved projects are found back from their URI */
+  uri = ges_project_get_uri (GES_PROJECT (project));
+  if (uri)
+    return uri;
+
+  return g_strdup (ges_asset_get_id (project));
+}
+
+static void
+extractable_set_asset (GESExtractable * self, GESAsset * asset)
+{
+  GES_TIMELINE_ELEMENT (self)->asset = asset;
+}
+
+static void
+ges_extractable_interface_init (GESExtractableInterface * iface)
+{
+  iface->check_id = (GESExtractableCheckId) extractable_check_id;
+  iface->get_parameters_from_id = extractable_get_parameters_from_id;
+  iface->get_id = extractable_get_id;
+  iface->set_asset = extractable_set_asset;
+}
+
+/* GESClip VMethod */
+static GESTrackElement *
+ges_nested_timeline_clip_create_track_element (GESClip * clip,
+    GESTrackType type)
+{
+  GHashTable *visited;
+  gboolean nests_itself;
+  GESTimeline *timeline = GES_TIMELINE_ELEMENT_TIMELINE (clip);
+  GESNestedTimelineClipPrivate *priv = GES_NESTED_TIMELINE_CLIP (clip)->priv;
+
+  if (priv->timeline == NULL || !(_get_track_types (priv->timeline) & type))
+    return NULL;
+
+  if (timeline) {
+    visited = g_hash_table_new (g_direct_hash, g_direct_equal);
+    nests_itself = _nests_timeline (priv->timeline, timeline, visited);
+    g_hash_table_unref (visited);
+
+    if (nests_itself) {
+      GST_ERROR_OBJECT (clip, "Can not nest a timeline in itself");
+
+      return NULL;
+    }
+  }
+
+  GST_DEBUG_OBJECT (clip, "Creating a GESNestedTimelineSource for type: %s",
+      ges_track_type_name (type));
+
+  return g_object_new (GES_TYPE_NESTED_TIMELINE_SOURCE, "track-type", type,
+      NULL);
+}
+
+/* GObject VMethods */
+static void
+ges_nested_timeline_clip_get_property (GObject * object, guint property_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GESNestedTimelineClipPrivate *priv = GES_NESTED_TIMELINE_CLIP (object)->priv;
+
+  switch (property_id) {
+    case PROP_NESTED_TIMELINE:
+      g_value_set_object (value, priv->timeline);
+      break;
+    case PROP_RENDER_CACHE:
+      g_value_set_object (value, priv->render_cache);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+  }
+}
+
+static void
+ges_nested_timeline_clip_set_property (GObject * object, guint property_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GESNestedTimelineClip *self = GES_NESTED_TIMELINE_CLIP (object);
+
+  switch (property_id) {
+    case PROP_NESTED_TIMELINE:
+      self->priv->timeline = g_value_dup_object (value);
+      break;
+    case PROP_RENDER_CACHE:
+      ges_nested_timeline_clip_set_render_cache (self,
+          g_value_get_object (value));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+  }
+}
+
+static void
+ges_nested_timeline_clip_constructed (GObject * object)
+{
+  GstClockTime duration;
+  GESNestedTimelineClipPrivate *priv = GES_NESTED_TIMELINE_CLIP (object)->priv;
+
+  if (priv->timeline) {
+    _register_nested_timeline (priv->timeline);
+    duration = ges_timeline_get_duration (priv->timeline);
+
+    ges_clip_set_supported_formats (GES_CLIP (object),
+        _get_track_types (priv->timeline));
+
+    /* A nested project still being loaded gets its duration once commited */
+    if (duration) {
+      ges_timeline_element_set_max_duration (GES_TIMELINE_ELEMENT (object),
+          duration);
+      if (_DURATION (object) == 0)
+        _set_duration0 (GES_TIMELINE_ELEMENT (object), duration);
+    }
+
+    g_signal_connect (priv->timeline, "commited",
+        G_CALLBACK (_nested_timeline_commited_cb), object);
+  }
+
+  G_OBJECT_CLASS (ges_nested_timeline_clip_parent_class)->constructed (object);
+}
+
+static void
+ges_nested_timeline_clip_dispose (GObject * object)
+{
+  GESNestedTimelineClipPrivate *priv = GES_NESTED_TIMELINE_CLIP (object)->priv;
+
+  if (priv->render_cache) {
+    g_signal_handlers_disconnect_by_func (priv->render_cache,
+        _range_cached_cb, object);
+    g_clear_object (&priv->render_cache);
+  }
+
+  if (priv->timeline) {
+    g_signal_handlers_disconnect_by_func (priv->timeline,
+        _nested_timeline_commited_cb, object);
+    gst_object_unref (priv->timeline);
+    priv->timeline = NULL;
+  }
+
+  G_OBJECT_CLASS (ges_nested_timeline_clip_parent_class)->dispose (object);
+}
+
+static void
+ges_nested_timeline_clip_class_init (GESNestedTimelineClipClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GESClipClass *clip_class = GES_CLIP_CLASS (klass);
+
+  g_type_class_add_private (klass, sizeof (GESNestedTimelineClipPrivate));
+
+  nested_timeline_quark =
+      g_quark_from_static_string ("ges-nested-timeline-clip-timeline");
+
+  object_class->get_property = ges_nested_timeline_clip_get_property;
+  object_class->set_property = ges_nested_timeline_clip_set_property;
+  object_class->constructed = ges_nested_timeline_clip_constructed;
+  object_class->dispose = ges_nested_timeline_clip_dispose;
+
+  /**
+   * GESNestedTimelineClip:nested-timeline:
+   *
+   * The nested #GESTimeline
+   */
+  properties[PROP_NESTED_TIMELINE] = g_param_spec_object ("nested-timeline",
+      "Nested timeline", "The nested timeline", GES_TYPE_TIMELINE,
+      G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY);
+  g_object_class_install_property (object_class, PROP_NESTED_TIMELINE,
+      properties[PROP_NESTED_TIMELINE]);
+
+  /**
+   * GESNestedTimelineClip:render-cache:
+   *
+   * The #GESRenderCache in which the nested timeline is rendered, or %NULL
+   * to evaluate the nested timeline live.
+   */
+  properties[PROP_RENDER_CACHE] = g_param_spec_object ("render-cache",
+      "Render cache", "The render cache of the nested timeline",
+      GES_TYPE_RENDER_CACHE, G_PARAM_READWRITE);
+  g_object_class_install_property (object_class, PROP_RENDER_CACHE,
+      properties[PROP_RENDER_CACHE]);
+
+  clip_class->create_track_element =
+      ges_nested_timeline_clip_create_track_element;
+}
+
+static void
+ges_nested_timeline_clip_init (GESNestedTimelineClip * self)
+{
+  self->priv = G_TYPE_INSTANCE_GET_PRIVATE (self,
+      GES_TYPE_NESTED_TIMELINE_CLIP, GESNestedTimelineClipPrivate);
+
+  self->priv->timeline = NULL;
+  self->priv->render_cache = NULL;
+  GES_TIMELINE_ELEMENT (self)->duration = 0;
+}
+
+/**
+ * ges_nested_timeline_clip_new:
+ * @timeline: The #GESTimeline to nest
+ *
+ * Creates a new #GESNestedTimelineClip playing @timeline. Its duration is
+ * initially the duration of @timeline. @timeline should not be modified
+ * from several threads, and can not contain the timeline the clip is added
+ * to.
+ *
+ * Returns: The newly created #GESNestedTimelineClip
+ */
+GESNestedTimelineClip *
+ges_nested_timeline_clip_new (GESTimeline * timeline)
+{
+  g_return_val_if_fail (GES_IS_TIMELINE (timeline), NULL);
+
+  return g_object_new (GES_TYPE_NESTED_TIMELINE_CLIP, "nested-timeline",
+      timeline, NULL);
+}
+
+/**
+ * ges_nested_timeline_clip_get_timeline:
+ * @self: a #GESNestedTimelineClip
+ *
+ * Returns: (transfer none): The #GESTimeline nested in @self
+ */
+GESTimeline *
+ges_nested_timeline_clip_get_timeline (GESNestedTimelineClip * self)
+{
+  g_return_val_if_fail (GES_IS_NESTED_TIMELINE_CLIP (self), NULL);
+
+  return self->priv->timeline;
+}
+
+/**
+ * ges_nested_timeline_clip_set_render_cache:
+ * @self: a #GESNestedTimelineClip
+ * @cache: (allow-none): a #GESRenderCache of the nested timeline, or %NULL
+ *
+ * Makes @self play the media @cache renders for the nested timeline instead
+ * of evaluating the nested timeline live. The whole nested timeline is
+ * added to @cache, and until it has been rendered, the nested timeline is
+ * played live. Sharing @cache between all the clips nesting the same
+ * timeline makes it rendered only once.
+ */
+void
+ges_nested_timeline_clip_set_render_cache (GESNestedTimelineClip * self,
+    GESRenderCache * cache)
+{
+  GESTimeline *cache_timeline = NULL;
+  GESNestedTimelineClipPrivate *priv;
+  GstClockTime duration;
+
+  g_return_if_fail (GES_IS_NESTED_TIMELINE_CLIP (self));
+  g_return_if_fail (cache == NULL || GES_IS_RENDER_CACHE (cache));
+
+  priv = self->priv;
+  if (cache) {
+    g_object_get (cache, "timeline", &cache_timeline, NULL);
+    if (cache_timeline)
+      gst_object_unref (cache_timeline);
+
+    g_return_if_fail (cache_timeline == priv->timeline);
+  }
+
+  if (priv->render_cache) {
+    g_signal_handlers_disconnect_by_func (priv->render_cache,
+        _range_cached_cb, self);
+    g_clear_object (&priv->render_cache);
+  }
+
+  if (cache) {
+    priv->render_cache = g_object_ref (cache);
+    g_signal_connect (cache, "range-cached", G_CALLBACK (_range_cached_cb),
+        self);
+
+    duration = ges_timeline_get_duration (priv->timeline);
+    if (duration)
+      ges_render_cache_add_range (cache, 0, duration);
+  }
+
+  _update_sources (self);
+
+  g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_RENDER_CACHE]);
+}
+
+/**
+ * ges_nested_timeline_clip_get_render_cache:
+ * @self: a #GESNestedTimelineClip
+ *
+ * Returns: (transfer none): The #GESRenderCache used by @self, or %NULL if
+ * the nested timeline is evaluated live
+ */
+GESRenderCache *
+ges_nested_timeline_clip_get_render_cache (GESNestedTimelineClip * self)
+{
+  g_return_val_if_fail (GES_IS_NESTED_TIMELINE_CLIP (self), NULL);
+
+  return self->priv->render_cache;
+}
@@ -0,0 +1,87 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef _GES_NESTED_TIMELINE_CLIP
+#define _GES_NESTED_TIMELINE_CLIP
+
+#include <glib-object.h>
+#include <ges/ges-types.h>
+#include <ges/ges-source-clip.h>
+
+G_BEGIN_DECLS
+
+#define GES_TYPE_NESTED_TIMELINE_CLIP ges_nested_timeline_clip_get_type()
+
+#define GES_NESTED_TIMELINE_CLIP(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST ((obj), GES_TYPE_NESTED_TIMELINE_CLIP, GESNestedTimelineClip))
+
+#define GES_NESTED_TIMELINE_CLIP_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST ((klass), GES_TYPE_NESTED_TIMELINE_CLIP, GESNestedTimelineClipClass))
+
+#define GES_IS_NESTED_TIMELINE_CLIP(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GES_TYPE_NESTED_TIMELINE_CLIP))
+
+#define GES_IS_NESTED_TIMELINE_CLIP_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE ((klass), GES_TYPE_NESTED_TIMELINE_CLIP))
+
+#define GES_NESTED_TIMELINE_CLIP_GET_CLASS(obj) \
+  (G_TYPE_INSTANCE_GET_CLASS ((obj), GES_TYPE_NESTED_TIMELINE_CLIP, GESNestedTimelineClipClass))
+
+typedef struct _GESNestedTimelineClipPrivate GESNestedTimelineClipPrivate;
+
+/**
+ * GESNestedTimelineClip:
+ *
+ * A #GESSourceClip playing another #GESTimeline
+ */
+struct _GESNestedTimelineClip {
+  GESSourceClip parent;
+
+  /*< private >*/
+  GESNestedTimelineClipPrivate *priv;
+
+  /* Padding for API extension */
+  gpointer _ges_reserved[GES_PADDING];
+};
+
+/**
+ * GESNestedTimelineClipClass:
+ */
+struct _GESNestedTimelineClipClass {
+  /*< private >*/
+  GESSourceClipClass parent_class;
+
+  /* Padding for API extension */
+  gpointer _ges_reserved[GES_PADDING];
+};
+
+GType ges_nested_timeline_clip_get_type (void);
+
+GESNestedTimelineClip *
+ges_nested_timeline_clip_new                  (GESTimeline *timeline);
+GESTimeline *
+ges_nested_timeline_clip_get_timeline         (GESNestedTimelineClip *self);
+void
+ges_nested_timeline_clip_set_render_cache     (GESNestedTimelineClip *self,
+                                               GESRenderCache *cache);
+GESRenderCache *
+ges_nested_timeline_clip_get_render_cache     (GESNestedTimelineClip *self);
+
+G_END_DECLS
+
+#endif /* _GES_NESTED_TIMELINE_CLIP */
@@ -0,0 +1,428 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:ges-nested-timeline-source
+ * @short_description: outputs the content of a nested #GESTimeline
+ *
+ * The #GESTrackElement created by #GESNestedTimelineClip. It plays a copy
+ * of the nested timeline restricted to the type of its track, or the media
+ * the #GESRenderCache of its clip rendered for it.
+ *
+ * When what it plays changes while the pipeline is running, the current
+ * content is blocked before being replaced, and the new content is seeked
+ * to where the source was last seeked. The replacement happens from the
+ * default main context, which therefore has to be running.
+ */
+
+#include "ges-internal.h"
+#include "ges-nested-timeline-source.h"
+#include "ges-nested-timeline-clip.h"
+#include "ges-render-cache.h"
+
+G_DEFINE_TYPE (GESNestedTimelineSource, ges_nested_timeline_source,
+    GES_TYPE_SOURCE);
+
+struct _GESNestedTimelineSourcePrivate
+{
+  /* The bin inside our topbin, its content is either a copy of the nested
+   * timeline or a decodebin reading cached media */
+  GstElement *bin;
+  GstPad *ghost;
+  GstElement *content;
+
+  /* The cached media currently played, %NULL when playing the timeline */
+  gchar *uri;
+
+  /* The content replacing the current one once it is blocked, protected by
+   * the object lock */
+  GstElement *pending;
+  gchar *pending_uri;
+  gboolean swap_scheduled;
+  gulong block_probe;
+
+  /* The last seek we got, replayed on new content while running, protected
+   * by the object lock */
+  GstEvent *seek;
+  gboolean needs_seek;
+};
+
+static GstPadProbeReturn
+_seek_probe_cb (GstPad * pad, GstPadProbeInfo * info,
+    GESNestedTimelineSource * self)
+{
+  GstEvent *event = GST_PAD_PROBE_INFO_EVENT (info);
+
+  if (GST_EVENT_TYPE (event) == GST_EVENT_SEEK) {
+    GST_OBJECT_LOCK (self);
+    gst_event_replace (&self->priv->seek, event);
+    GST_OBJECT_UNLOCK (self);
+  }
+
+  return GST_PAD_PROBE_OK;
+}
+
+/* Seeks the new content where the previous one was */
+static gboolean
+_send_seek_idle (GESNestedTimelineSource * self)
+{
+  GstEvent *seek = NULL;
+  GstPad *target = gst_ghost_pad_get_target (GST_GHOST_PAD (self->priv->ghost));
+
+  GST_OBJECT_LOCK (self);
+  if (self->priv->needs_seek && self->priv->seek)
+    seek = gst_event_ref (self->priv->seek);
+  self->priv->needs_seek = FALSE;
+  GST_OBJECT_UNLOCK (self);
+
+  if (target && seek) {
+    GST_DEBUG_OBJECT (self, "Seeking new content");
+    if (!gst_pad_send_event (target, seek))
+      GST_WARNING_OBJECT (self, "Could not seek new content");
+  } else if (seek) {
+    gst_event_unref (seek);
+  }
+
+  if (target)
+    gst_object_unref (target);
+  gst_object_unref (self);
+
+  return FALSE;
+}
+
+static void
+_decodebin_pad_added_cb (GstElement * decodebin, GstPad * pad,
+    GESNestedTimelineSource * self)
+{
+  if (gst_pad_get_direction (pad) != GST_PAD_SRC)
+    return;
+
+  gst_ghost_pad_set_target (GST_GHOST_PAD (self->priv->ghost), pad);
+
+  /* We are in a streaming thread, seek from the main context */
+  GST_OBJECT_LOCK (self);
+  if (self->priv->needs_seek)
+    g_idle_add ((GSourceFunc) _send_seek_idle, gst_object_ref (self));
+  GST_OBJECT_UNLOCK (self);
+}
+
+static GstPad *
+_get_timeline_srcpad (GESTimeline * timeline)
+{
+  GValue item = { 0, };
+  GstPad *pad = NULL;
+  GstIterator *it = gst_element_iterate_src_pads (GST_ELEMENT (timeline));
+
+  /* The copy only has the track we are interested in */
+  if (gst_iterator_next (it, &item) == GST_ITERATOR_OK) {
+    pad = g_value_dup_object (&item);
+    g_value_unset (&item);
+  }
+  gst_iterator_free (it);
+
+  return pad;
+}
+
+static GstElement *
+_create_content (GESNestedTimelineSource * self, GESNestedTimelineClip * clip,
+    GESTrack * track, gchar * uri)
+{
+  GstElement *content;
+  GESTimeline *copy;
+
+  if (uri) {
+    content = gst_element_factory_make ("uridecodebin", NULL);
+    g_object_set (content, "caps", ges_track_get_caps (track),
+        "expose-all-streams", FALSE, "uri", uri, NULL);
+    g_signal_connect (content, "pad-added",
+        G_CALLBACK (_decodebin_pad_added_cb), self);
+
+    return content;
+  }
+
+  copy = timeline_copy (ges_nested_timeline_clip_get_timeline (clip),
+      track->type, 0, G_MAXUINT64);
+  ges_timeline_commit (copy);
+
+  return GST_ELEMENT (copy);
+}
+
+/* Replaces the content of our bin by @content, taking @uri */
+static void
+_set_content (GESNestedTimelineSource * self, GstElement * content,
+    gchar * uri, gboolean running)
+{
+  GstPad *srcpad = NULL;
+  GESNestedTimelineSourcePrivate *priv = self->priv;
+
+  GST_DEBUG_OBJECT (self, "Now playing %s", uri ? uri : "the timeline");
+
+  if (priv->content) {
+    gst_ghost_pad_set_target (GST_GHOST_PAD (priv->ghost), NULL);
+    gst_element_set_state (priv->content, GST_STATE_NULL);
+    gst_bin_remove (GST_BIN (priv->bin), priv->content);
+  }
+
+  GST_OBJECT_LOCK (self);
+  priv->needs_seek = running;
+  GST_OBJECT_UNLOCK (self);
+
+  g_free (priv->uri);
+  priv->uri = uri;
+  priv->content = content;
+  gst_bin_add (GST_BIN (priv->bin), content);
+
+  if (GES_IS_TIMELINE (content))
+    srcpad = _get_timeline_srcpad (GES_TIMELINE (content));
+
+  if (srcpad)
+    gst_ghost_pad_set_target (GST_GHOST_PAD (priv->ghost), srcpad);
+
+  gst_element_sync_state_with_parent (content);
+
+  /* Decodebin content is seeked once its pad is exposed */
+  if (srcpad) {
+    if (running)
+      _send_seek_idle (gst_object_ref (self));
+    gst_object_unref (srcpad);
+  }
+}
+
+static void
+_swap_pending (GESNestedTimelineSource * self, gboolean running)
+{
+  gchar *uri;
+  gulong probe;
+  GstElement *content;
+  GstPad *blocked = NULL;
+  GESNestedTimelineSourcePrivate *priv = self->priv;
+
+  GST_OBJECT_LOCK (self);
+  content = priv->pending;
+  uri = priv->pending_uri;
+  probe = priv->block_probe;
+  priv->pending = NULL;
+  priv->pending_uri = NULL;
+  priv->block_probe = 0;
+  priv->swap_scheduled = FALSE;
+  GST_OBJECT_UNLOCK (self);
+
+  if (probe)
+    blocked = gst_ghost_pad_get_target (GST_GHOST_PAD (priv->ghost));
+
+  /* Setting the old content to NULL flushes its blocked streaming thread */
+  if (content) {
+    _set_content (self, content, uri, running);
+    gst_object_unref (content);
+  }
+
+  if (blocked) {
+    gst_pad_remove_probe (blocked, probe);
+    gst_object_unref (blocked);
+  }
+}
+
+static gboolean
+_swap_pending_idle (GESNestedTimelineSource * self)
+{
+  _swap_pending (self, TRUE);
+  gst_object_unref (self);
+
+  return FALSE;
+}
+
+static GstPadProbeReturn
+_content_blocked_cb (GstPad * pad, GstPadProbeInfo * info,
+    GESNestedTimelineSource * self)
+{
+  /* Streaming thread, the old content can not be stopped from here. It
+   * stays blocked until it is */
+  GST_OBJECT_LOCK (self);
+  if (!self->priv->swap_scheduled) {
+    self->priv->swap_scheduled = TRUE;
+    g_idle_add ((GSourceFunc) _swap_pending_idle, gst_object_ref (self));
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  return GST_PAD_PROBE_OK;
+}
+
+/* Makes sure we play the cached media of our clip if there is one, and an
+ * up to date copy of the nested timeline otherwise */
+void
+ges_nested_timeline_source_update_content (GESNestedTimelineSource * self)
+{
+  gulong probe;
+  gchar *uri = NULL;
+  GstPad *target;
+  GESRenderCache *cache;
+  GstElement *content;
+  GESNestedTimelineClip *clip;
+  GESNestedTimelineSourcePrivate *priv = self->priv;
+  GESTrack *track = ges_track_element_get_track (GES_TRACK_ELEMENT (self));
+
+  if (priv->bin == NULL || track == NULL ||
+      !GES_IS_NESTED_TIMELINE_CLIP (GES_TIMELINE_ELEMENT_PARENT (self)))
+    return;
+
+  clip = GES_NESTED_TIMELINE_CLIP (GES_TIMELINE_ELEMENT_PARENT (self));
+  cache = ges_nested_timeline_clip_get_render_cache (clip);
+  if (cache)
+    uri = ges_render_cache_get_cached_uri (cache, track->type, 0,
+        ges_timeline_get_duration (ges_nested_timeline_clip_get_timeline
+            (clip)));
+
+  /* Nothing changed for us */
+  if (uri && priv->content && !priv->pending && !g_strcmp0 (uri, priv->uri)) {
+    g_free (uri);
+
+    return;
+  }
+
+  /* A newer content replaces the one that might be waiting */
+  content = _create_content (self, clip, track, uri);
+  GST_OBJECT_LOCK (self);
+  if (priv->pending) {
+    gst_object_unref (priv->pending);
+    g_free (priv->pending_uri);
+  }
+  priv->pending = gst_object_ref_sink (content);
+  priv->pending_uri = uri;
+  GST_OBJECT_UNLOCK (self);
+
+  if (priv->content == NULL || GST_STATE (priv->bin) < GST_STATE_PAUSED) {
+    _swap_pending (self, FALSE);
+
+    return;
+  }
+
+  /* Data is flowing through the current content, replace it once it is
+   * blocked */
+  if (priv->block_probe)
+    return;
+
+  target = gst_ghost_pad_get_target (GST_GHOST_PAD (priv->ghost));
+  if (target == NULL) {
+    _swap_pending (self, TRUE);
+
+    return;
+  }
+
+  GST_DEBUG_OBJECT (self, "Blocking current content before replacing it");
+  probe = gst_pad_add_probe (target, GST_PAD_PROBE_TYPE_BLOCK_DOWNSTREAM,
+      (GstPadProbeCallback) _content_blocked_cb, gst_object_ref (self),
+      gst_object_unref);
+  GST_OBJECT_LOCK (self);
+  priv->block_probe = probe;
+  GST_OBJECT_UNLOCK (self);
+  gst_object_unref (target);
+}
+
+/* GESTrackElement VMethod */
+static GstElement *
+ges_nested_timeline_source_create_element (GESTrackElement * element)
+{
+  GESNestedTimelineSource *self = GES_NESTED_TIMELINE_SOURCE (element);
+  GESNestedTimelineSourcePrivate *priv = self->priv;
+  GESTrackType type = ges_track_element_get_track_type (element);
+
+  priv->bin = gst_bin_new (NULL);
+  priv->ghost = gst_ghost_pad_new_no_target ("src", GST_PAD_SRC);
+  gst_pad_set_active (priv->ghost, TRUE);
+  gst_element_add_pad (priv->bin, priv->ghost);
+  gst_pad_add_probe (priv->ghost, GST_PAD_PROBE_TYPE_EVENT_UPSTREAM,
+      (GstPadProbeCallback) _seek_probe_cb, self, NULL);
+
+  ges_nested_timeline_source_update_content (self);
+
+  if (type == GES_TRACK_TYPE_VIDEO)
+    return ges_source_create_topbin ("nestedvideosrcbin", priv->bin,
+        gst_element_factory_make ("videoconvert", NULL),
+        gst_element_factory_make ("videoscale", NULL), NULL);
+  else if (type == GES_TRACK_TYPE_AUDIO)
+    return ges_source_create_topbin ("nestedaudiosrcbin", priv->bin,
+        gst_element_factory_make ("audioconvert", NULL),
+        gst_element_factory_make ("audioresample", NULL), NULL);
+
+  return ges_source_create_topbin ("nestedsrcbin", priv->bin, NULL);
+}
+
+/* GObject VMethods */
+static void
+ges_nested_timeline_source_finalize (GObject * object)
+{
+  GESNestedTimelineSourcePrivate *priv =
+      GES_NESTED_TIMELINE_SOURCE (object)->priv;
+
+  g_free (priv->uri);
+  g_free (priv->pending_uri);
+  if (priv->pending)
+    gst_object_unref (priv->pending);
+  if (priv->seek)
+    gst_event_unref (priv->seek);
+
+  G_OBJECT_CLASS (ges_nested_timeline_source_parent_class)->finalize (object);
+}
+
+static void
+ges_nested_timeline_source_class_init (GESNestedTimelineSourceClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GESTrackElementClass *track_class = GES_TRACK_ELEMENT_CLASS (klass);
+
+  g_type_class_add_private (klass, sizeof (GESNestedTimelineSourcePrivate));
+
+  object_class->finalize = ges_nested_timeline_source_finalize;
+
+  track_class->create_element = ges_nested_timeline_source_create_element;
+}
+
+static void
+ges_nested_timeline_source_init (GESNestedTimelineSource * self)
+{
+  self->priv = G_TYPE_INSTANCE_GET_PRIVATE (self,
+      GES_TYPE_NESTED_TIMELINE_SOURCE, GESNestedTimelineSourcePrivate);
+
+  self->priv->bin = NULL;
+  self->priv->ghost = NULL;
+  self->priv->content = NULL;
+  self->priv->uri = NULL;
+  self->priv->pending = NULL;
+  self->priv->pending_uri = NULL;
+  self->priv->swap_scheduled = FALSE;
+  self->priv->block_probe = 0;
+  self->priv->seek = NULL;
+  self->priv->needs_seek = FALSE;
+}
+
+/**
+ * ges_nested_timeline_source_is_cached:
+ * @self: a #GESNestedTimelineSource
+ *
+ * Checks whether @self plays media rendered by the #GESRenderCache of its
+ * clip or the nested timeline itself.
+ *
+ * Returns: %TRUE if @self plays cached media, %FALSE otherwise.
+ */
+gboolean
+ges_nested_timeline_source_is_cached (GESNestedTimelineSource * self)
+{
+  g_return_val_if_fail (GES_IS_NESTED_TIMELINE_SOURCE (self), FALSE);
+
+  return self->priv->uri != NULL;
+}
@@ -0,0 +1,77 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef _GES_NESTED_TIMELINE_SOURCE
+#define _GES_NESTED_TIMELINE_SOURCE
+
+#include <glib-object.h>
+#include <ges/ges-types.h>
+#include <ges/ges-source.h>
+
+G_BEGIN_DECLS
+
+#define GES_TYPE_NESTED_TIMELINE_SOURCE ges_nested_timeline_source_get_type()
+
+#define GES_NESTED_TIMELINE_SOURCE(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST ((obj), GES_TYPE_NESTED_TIMELINE_SOURCE, GESNestedTimelineSource))
+
+#define GES_NESTED_TIMELINE_SOURCE_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST ((klass), GES_TYPE_NESTED_TIMELINE_SOURCE, GESNestedTimelineSourceClass))
+
+#define GES_IS_NESTED_TIMELINE_SOURCE(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GES_TYPE_NESTED_TIMELINE_SOURCE))
+
+#define GES_IS_NESTED_TIMELINE_SOURCE_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE ((klass), GES_TYPE_NESTED_TIMELINE_SOURCE))
+
+#define GES_NESTED_TIMELINE_SOURCE_GET_CLASS(obj) \
+  (G_TYPE_INSTANCE_GET_CLASS ((obj), GES_TYPE_NESTED_TIMELINE_SOURCE, GESNestedTimelineSourceClass))
+
+typedef struct _GESNestedTimelineSourcePrivate GESNestedTimelineSourcePrivate;
+
+/**
+ * GESNestedTimelineSource:
+ *
+ * The #GESTrackElement outputting the content of the timeline of a
+ * #GESNestedTimelineClip in a #GESTrack
+ */
+struct _GESNestedTimelineSource {
+  /*< private >*/
+  GESSource parent;
+
+  GESNestedTimelineSourcePrivate *priv;
+
+  /* Padding for API extension */
+  gpointer _ges_reserved[GES_PADDING];
+};
+
+struct _GESNestedTimelineSourceClass {
+  /*< private >*/
+  GESSourceClass parent_class;
+
+  /* Padding for API extension */
+  gpointer _ges_reserved[GES_PADDING];
+};
+
+GType ges_nested_timeline_source_get_type (void);
+
+gboolean ges_nested_timeline_source_is_cached (GESNestedTimelineSource *self);
+
+G_END_DECLS
+
+#endif /* _GES_NESTED_TIMELINE_SOURCE */
@@ -36,6 +36,27 @@
 #include "ges-screenshot.h"
 
 #define DEFAULT_TIMELINE_MODE  TIMELINE_MODE_PREVIEW
+#define DEFAULT_PREVIEW_QUALITY GES_PREVIEW_QUALITY_FULL
+
+/* Number of QoS messages after which an adaptive preview lowers its
+ * resolution */
+#define QOS_MESSAGES_BEFORE_DEGRADING 10
+
+/* Additional render output, see ges_pipeline_add_render_settings() */
+typedef struct
+{
+  GstElement *encodebin;
+  GstElement *urisink;
+  GstEncodingProfile *profile;
+} RenderOutput;
+
+/* Link between the tee of an OutputChain and a RenderOutput */
+typedef struct
+{
+  RenderOutput *output;
+  GstElement *converter;        /* queue and scaling elements */
+  GstPad *encodebinpad;
+} OutputBranch;
 
 /* Structure corresponding to a timeline - sink link */
 
@@ -46,6 +67,7 @@ typedef struct
   GstPad *srcpad;               /* Timeline source pad */
   GstPad *playsinkpad;
   GstPad *encodebinpad;
+  GList *branches;              /* OutputBranch to the additional outputs */
   GstPad *blocked_pad;
   gulong probe_id;
 } OutputChain;
@@ -65,6 +87,17 @@ struct _GESPipelinePrivate
   GList *chains;
 
   GstEncodingProfile *profile;
+
+  /* RenderOutput fed from the same tees as encodebin */
+  GList *outputs;
+
+  /* Preview resolution management, protected by the object lock along
+   * with the mode as they are read from streaming threads */
+  GESPreviewQuality preview_quality;
+  GESPreviewQuality current_quality;
+  gboolean adaptive_quality;
+  guint n_qos_messages;
+  guint degrade_quality_id;
 };
 
 enum
@@ -74,6 +107,8 @@ enum
   PROP_VIDEO_SINK,
   PROP_TIMELINE,
   PROP_MODE,
+  PROP_PREVIEW_QUALITY,
+  PROP_ADAPTIVE_PREVIEW_QUALITY,
   PROP_LAST
 };
 
@@ -81,6 +116,8 @@ static GParamSpec *properties[PROP_LAST];
 
 static GstStateChangeReturn ges_pipeline_change_state (GstElement *
     element, GstStateChange transition);
+static void ges_pipeline_handle_message (GstBin * bin, GstMessage * message);
+static void update_tracks_activity (GESPipeline * self);
 
 static OutputChain *get_output_chain_for_track (GESPipeline * self,
     GESTrack * track);
@@ -162,6 +199,12 @@ ges_pipeline_get_property (GObject * object, guint property_id,
     case PROP_MODE:
       g_value_set_flags (value, self->priv->mode);
       break;
+    case PROP_PREVIEW_QUALITY:
+      g_value_set_enum (value, self->priv->preview_quality);
+      break;
+    case PROP_ADAPTIVE_PREVIEW_QUALITY:
+      g_value_set_boolean (value, self->priv->adaptive_quality);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
   }
@@ -189,11 +232,32 @@ ges_pipeline_set_property (GObject * object, guint property_id,
     case PROP_MODE:
       ges_pipeline_set_mode (GES_PIPELINE (object), g_value_get_flags (value));
       break;
+    case PROP_PREVIEW_QUALITY:
+      ges_pipeline_preview_set_quality (GES_PIPELINE (object),
+          g_value_get_enum (value));
+      break;
+    case PROP_ADAPTIVE_PREVIEW_QUALITY:
+      ges_pipeline_preview_set_adaptive_quality (GES_PIPELINE (object),
+          g_value_get_boolean (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
   }
 }
 
+static void
+render_output_free (RenderOutput * output)
+{
+  if (output->encodebin)
+    gst_object_unref (output->encodebin);
+  if (output->urisink)
+    gst_object_unref (output->urisink);
+  if (output->profile)
+    gst_encoding_profile_unref (output->profile);
+
+  g_free (output);
+}
+
 static void
 ges_pipeline_dispose (GObject * object)
 {
@@ -220,6 +284,9 @@ ges_pipeline_dispose (GObject * object)
     self->priv->profile = NULL;
   }
 
+  g_list_free_full (self->priv->outputs, (GDestroyNotify) render_output_free);
+  self->priv->outputs = NULL;
+
   G_OBJECT_CLASS (ges_pipeline_parent_class)->dispose (object);
 }
 
@@ -228,6 +295,7 @@ ges_pipeline_class_init (GESPipelineClass * klass)
 {
   GObjectClass *object_class = G_OBJECT_CLASS (klass);
   GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+  GstBinClass *bin_class = GST_BIN_CLASS (klass);
 
   g_type_class_add_private (klass, sizeof (GESPipelinePrivate));
 
@@ -283,7 +351,36 @@ ges_pipeline_class_init (GESPipelineClass * klass)
   g_object_class_install_property (object_class, PROP_MODE,
       properties[PROP_MODE]);
 
+  /**
+   * GESPipeline:preview-quality:
+   *
+   * The resolution at which video is previewed. See
+   * ges_pipeline_preview_set_quality() for more info.
+   */
+  properties[PROP_PREVIEW_QUALITY] =
+      g_param_spec_enum ("preview-quality", "Preview quality",
+      "The resolution at which video is previewed",
+      GES_TYPE_PREVIEW_QUALITY, DEFAULT_PREVIEW_QUALITY,
+      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+  g_object_class_install_property (object_class, PROP_PREVIEW_QUALITY,
+      properties[PROP_PREVIEW_QUALITY]);
+
+  /**
+   * GESPipeline:adaptive-preview-quality:
+   *
+   * Whether the preview resolution is lowered when the pipeline can not
+   * keep up. See ges_pipeline_preview_set_adaptive_quality() for more info.
+   */
+  properties[PROP_ADAPTIVE_PREVIEW_QUALITY] =
+      g_param_spec_boolean ("adaptive-preview-quality",
+      "Adaptive preview quality",
+      "Lower the preview resolution when the pipeline can not keep up",
+      FALSE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+  g_object_class_install_property (object_class,
+      PROP_ADAPTIVE_PREVIEW_QUALITY, properties[PROP_ADAPTIVE_PREVIEW_QUALITY]);
+
   element_class->change_state = GST_DEBUG_FUNCPTR (ges_pipeline_change_state);
+  bin_class->handle_message = GST_DEBUG_FUNCPTR (ges_pipeline_handle_message);
 
   /* TODO : Add state_change handlers
    * Don't change state if we don't have a timeline */
@@ -296,6 +393,12 @@ ges_pipeline_init (GESPipeline * self)
   self->priv = G_TYPE_INSTANCE_GET_PRIVATE (self,
       GES_TYPE_PIPELINE, GESPipelinePrivate);
 
+  self->priv->preview_quality = DEFAULT_PREVIEW_QUALITY;
+  self->priv->current_quality = DEFAULT_PREVIEW_QUALITY;
+  self->priv->adaptive_quality = FALSE;
+  self->priv->n_qos_messages = 0;
+  self->priv->degrade_quality_id = 0;
+
   self->priv->playsink =
       gst_element_factory_make ("playsink", "internal-sinks");
   self->priv->encodebin =
@@ -413,6 +516,77 @@ ges_pipeline_update_caps (GESPipeline * self)
   return TRUE;
 }
 
+static void
+_apply_preview_quality (GESPipeline * self, GESPreviewQuality quality)
+{
+  GList *tmp;
+  guint scale = quality;
+
+  /* Rendering always happens at full resolution */
+  if (self->priv->mode & (TIMELINE_MODE_RENDER | TIMELINE_MODE_SMART_RENDER))
+    scale = GES_PREVIEW_QUALITY_FULL;
+
+  GST_OBJECT_LOCK (self);
+  self->priv->current_quality = quality;
+  self->priv->n_qos_messages = 0;
+  GST_OBJECT_UNLOCK (self);
+
+  if (self->priv->timeline == NULL)
+    return;
+
+  GST_DEBUG_OBJECT (self, "Previewing video downscaled by %u", scale);
+
+  for (tmp = self->priv->timeline->tracks; tmp; tmp = tmp->next) {
+    if (GES_TRACK (tmp->data)->type == GES_TRACK_TYPE_VIDEO)
+      ges_track_set_preview_scale (GES_TRACK (tmp->data), scale);
+  }
+}
+
+static gboolean
+_degrade_preview_quality_idle (GESPipeline * self)
+{
+  GESPreviewQuality quality;
+
+  GST_OBJECT_LOCK (self);
+  self->priv->degrade_quality_id = 0;
+  quality = self->priv->current_quality;
+  GST_OBJECT_UNLOCK (self);
+
+  if (quality < GES_PREVIEW_QUALITY_QUARTER) {
+    GST_INFO_OBJECT (self, "Can not keep up, lowering preview resolution");
+    _apply_preview_quality (self, quality * 2);
+  }
+
+  return FALSE;
+}
+
+static void
+ges_pipeline_handle_message (GstBin * bin, GstMessage * message)
+{
+  GESPipeline *self = GES_PIPELINE (bin);
+
+  /* Elements post QoS messages when they drop late buffers */
+  if (GST_MESSAGE_TYPE (message) == GST_MESSAGE_QOS) {
+    GST_OBJECT_LOCK (self);
+    if (self->priv->adaptive_quality &&
+        (self->priv->mode & TIMELINE_MODE_PREVIEW_VIDEO) &&
+        ++self->priv->n_qos_messages >= QOS_MESSAGES_BEFORE_DEGRADING &&
+        self->priv->current_quality < GES_PREVIEW_QUALITY_QUARTER &&
+        self->priv->degrade_quality_id == 0) {
+      self->priv->n_qos_messages = 0;
+
+      /* Do not reconfigure the tracks from a streaming thread */
+      self->priv->degrade_quality_id =
+          g_idle_add_full (G_PRIORITY_DEFAULT_IDLE,
+          (GSourceFunc) _degrade_preview_quality_idle, gst_object_ref (self),
+          gst_object_unref);
+    }
+    GST_OBJECT_UNLOCK (self);
+  }
+
+  GST_BIN_CLASS (ges_pipeline_parent_class)->handle_message (bin, message);
+}
+
 static GstStateChangeReturn
 ges_pipeline_change_state (GstElement * element, GstStateChange transition)
 {
@@ -437,7 +611,15 @@ ges_pipeline_change_state (GstElement * element, GstStateChange transition)
         ret = GST_STATE_CHANGE_FAILURE;
         goto done;
       }
-      /* Set caps on all tracks according to profile if present */
+      /* Previews start at the requested resolution, renders at full one */
+      _apply_preview_quality (self, self->priv->preview_quality);
+      update_tracks_activity (self);
+      break;
+    case GST_STATE_CHANGE_PLAYING_TO_PAUSED:
+      /* Go back to the requested quality when we stop playing */
+      if (self->priv->adaptive_quality &&
+          self->priv->current_quality != self->priv->preview_quality)
+        _apply_preview_quality (self, self->priv->preview_quality);
       break;
     default:
       break;
@@ -543,6 +725,332 @@ no_pad:
   }
 }
 
+/* Returns a sink pad of @encodebin to which @pad can be linked */
+static GstPad *
+get_encodebin_pad (GstElement * encodebin, GstPad * pad)
+{
+  GstPad *sinkpad;
+
+  /* Check for unused static pads */
+  sinkpad = get_compatible_unlinked_pad (encodebin, pad);
+
+  if (sinkpad == NULL) {
+    GstCaps *caps = gst_pad_query_caps (pad, NULL);
+
+    /* If no compatible static pad is available, request a pad */
+    g_signal_emit_by_name (encodebin, "request-pad", caps, &sinkpad);
+    gst_caps_unref (caps);
+  }
+
+  return sinkpad;
+}
+
+/* Looks for the stream profile of @profile matching @type, and gets its
+ * restriction caps if any and @restriction is not %NULL */
+static gboolean
+get_profile_restriction (GstEncodingProfile * profile, GESTrackType type,
+    GstCaps ** restriction)
+{
+  const GList *tmp;
+
+  if (!GST_IS_ENCODING_CONTAINER_PROFILE (profile)) {
+    if (!TRACK_COMPATIBLE_PROFILE (type, profile))
+      return FALSE;
+
+    if (restriction)
+      *restriction = gst_encoding_profile_get_restriction (profile);
+    return TRUE;
+  }
+
+  for (tmp = gst_encoding_container_profile_get_profiles (
+          (GstEncodingContainerProfile *) profile); tmp; tmp = tmp->next) {
+    if (TRACK_COMPATIBLE_PROFILE (type, tmp->data)) {
+      if (restriction)
+        *restriction = gst_encoding_profile_get_restriction (tmp->data);
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/* Whether the output of @track is consumed in the current mode */
+static gboolean
+track_is_used (GESPipeline * self, GESTrack * track)
+{
+  GList *tmp;
+  GESPipelineFlags mode = self->priv->mode;
+
+  /* Only audio and video tracks can be left aside */
+  if (track->type != GES_TRACK_TYPE_AUDIO &&
+      track->type != GES_TRACK_TYPE_VIDEO)
+    return TRUE;
+
+  if ((track->type == GES_TRACK_TYPE_VIDEO &&
+          (mode & TIMELINE_MODE_PREVIEW_VIDEO)) ||
+      (track->type == GES_TRACK_TYPE_AUDIO &&
+          (mode & TIMELINE_MODE_PREVIEW_AUDIO)))
+    return TRUE;
+
+  if (!(mode & (TIMELINE_MODE_RENDER | TIMELINE_MODE_SMART_RENDER)))
+    return FALSE;
+
+  if (self->priv->profile == NULL ||
+      get_profile_restriction (self->priv->profile, track->type, NULL))
+    return TRUE;
+
+  for (tmp = self->priv->outputs; tmp; tmp = tmp->next) {
+    RenderOutput *output = tmp->data;
+
+    if (get_profile_restriction (output->profile, track->type, NULL))
+      return TRUE;
+  }
+
+  return FALSE;
+}
+
+/* Keeps the tracks whose output is not consumed in the current mode in the
+ * NULL state, so that their composition and decoders do not run, and
+ * reactivates them when they are needed again */
+static void
+update_tracks_activity (GESPipeline * self)
+{
+  GList *tmp, *tracks;
+
+  if (self->priv->timeline == NULL)
+    return;
+
+  tracks = ges_timeline_get_tracks (self->priv->timeline);
+  for (tmp = tracks; tmp; tmp = tmp->next) {
+    GstElement *track = tmp->data;
+    gboolean used = track_is_used (self, tmp->data);
+
+    if (used && gst_element_is_locked_state (track)) {
+      GST_DEBUG_OBJECT (self, "Reactivating %" GST_PTR_FORMAT, track);
+      gst_element_set_locked_state (track, FALSE);
+      gst_element_sync_state_with_parent (track);
+    } else if (!used && !gst_element_is_locked_state (track)) {
+      GST_DEBUG_OBJECT (self, "%" GST_PTR_FORMAT " is not used, deactivating",
+          track);
+      gst_element_set_locked_state (track, TRUE);
+      gst_element_set_state (track, GST_STATE_NULL);
+    }
+
+    gst_object_unref (track);
+  }
+  g_list_free (tracks);
+}
+
+/* Creates the elements decoupling an additional render output from the
+ * others, and scaling raw streams to its restriction caps */
+static GstElement *
+create_branch_converter (GESTrackType type, GstCaps * restriction,
+    gboolean smart)
+{
+  GstElement *converter, *capsfilter;
+  const gchar *desc = "queue";
+  GError *err = NULL;
+
+  if (!smart && type == GES_TRACK_TYPE_VIDEO)
+    desc = "queue ! videoconvert ! videoscale ! capsfilter name=restriction";
+  else if (!smart && type == GES_TRACK_TYPE_AUDIO)
+    desc = "queue ! audioconvert ! audioresample ! capsfilter name=restriction";
+
+  converter = gst_parse_bin_from_description (desc, TRUE, &err);
+  if (G_UNLIKELY (converter == NULL)) {
+    GST_ERROR ("Could not create '%s': %s", desc,
+        err ? err->message : "unknown error");
+    g_clear_error (&err);
+
+    return NULL;
+  }
+
+  if (restriction && !gst_caps_is_any (restriction) &&
+      (capsfilter = gst_bin_get_by_name (GST_BIN (converter), "restriction"))) {
+    g_object_set (capsfilter, "caps", restriction, NULL);
+    gst_object_unref (capsfilter);
+  }
+
+  return converter;
+}
+
+static void
+release_output_branch (GESPipeline * self, OutputChain * chain,
+    OutputBranch * branch)
+{
+  GstPad *sinkpad, *peer;
+
+  if (branch->encodebinpad) {
+    peer = gst_pad_get_peer (branch->encodebinpad);
+    if (peer) {
+      gst_pad_unlink (peer, branch->encodebinpad);
+      gst_object_unref (peer);
+    }
+    gst_element_release_request_pad (branch->output->encodebin,
+        branch->encodebinpad);
+    gst_object_unref (branch->encodebinpad);
+  }
+
+  if (branch->converter) {
+    sinkpad = gst_element_get_static_pad (branch->converter, "sink");
+    peer = gst_pad_get_peer (sinkpad);
+    if (peer) {
+      gst_pad_unlink (peer, sinkpad);
+      gst_element_release_request_pad (chain->tee, peer);
+      gst_object_unref (peer);
+    }
+    gst_object_unref (sinkpad);
+
+    gst_element_set_state (branch->converter, GST_STATE_NULL);
+    gst_bin_remove (GST_BIN_CAST (self), branch->converter);
+  }
+
+  g_free (branch);
+}
+
+/* Links the tee of @chain to the encodebin of @output, the track is
+ * composited once whatever the number of outputs */
+static OutputBranch *
+link_output_branch (GESPipeline * self, OutputChain * chain,
+    RenderOutput * output)
+{
+  OutputBranch *branch;
+  GstCaps *restriction = NULL;
+  GstPad *tmppad, *sinkpad, *srcpad;
+  GstPadLinkReturn ret;
+
+  if (!get_profile_restriction (output->profile, chain->track->type,
+          &restriction)) {
+    GST_DEBUG_OBJECT (self, "%" GST_PTR_FORMAT " has no stream for track %"
+        GST_PTR_FORMAT ", not linking", output->urisink, chain->track);
+    return NULL;
+  }
+
+  branch = g_new0 (OutputBranch, 1);
+  branch->output = output;
+  branch->converter = create_branch_converter (chain->track->type,
+      restriction, ! !(self->priv->mode & TIMELINE_MODE_SMART_RENDER));
+  if (restriction)
+    gst_caps_unref (restriction);
+
+  if (G_UNLIKELY (branch->converter == NULL))
+    goto error;
+
+  gst_bin_add (GST_BIN_CAST (self), branch->converter);
+  gst_element_sync_state_with_parent (branch->converter);
+
+  tmppad = gst_element_get_request_pad (chain->tee, "src_%u");
+  sinkpad = gst_element_get_static_pad (branch->converter, "sink");
+  ret = gst_pad_link_full (tmppad, sinkpad, GST_PAD_LINK_CHECK_NOTHING);
+  gst_object_unref (sinkpad);
+  if (G_UNLIKELY (ret != GST_PAD_LINK_OK)) {
+    gst_element_release_request_pad (chain->tee, tmppad);
+    gst_object_unref (tmppad);
+    goto error;
+  }
+  gst_object_unref (tmppad);
+
+  srcpad = gst_element_get_static_pad (branch->converter, "src");
+  branch->encodebinpad = get_encodebin_pad (output->encodebin, srcpad);
+  if (G_UNLIKELY (branch->encodebinpad == NULL ||
+          gst_pad_link_full (srcpad, branch->encodebinpad,
+              GST_PAD_LINK_CHECK_NOTHING) != GST_PAD_LINK_OK)) {
+    gst_object_unref (srcpad);
+    goto error;
+  }
+  gst_object_unref (srcpad);
+
+  return branch;
+
+error:
+  GST_ERROR_OBJECT (self, "Couldn't link track %" GST_PTR_FORMAT " to %"
+      GST_PTR_FORMAT, chain->track, output->urisink);
+  release_output_branch (self, chain, branch);
+
+  return NULL;
+}
+
+/* Links the tee of @chain to the encodebin and to the additional render
+ * outputs, the main profile not having a stream for the track not
+ * preventing the additional outputs from getting it */
+static gboolean
+link_render_chain (GESPipeline * self, OutputChain * chain)
+{
+  GList *tmp;
+  GstPad *tmppad;
+
+  GST_DEBUG_OBJECT (self, "Connecting to encodebin");
+
+  if (!chain->encodebinpad) {
+    if (self->priv->profile && !get_profile_restriction (self->priv->profile,
+            chain->track->type, NULL))
+      GST_DEBUG_OBJECT (self, "The profile has no stream for track %"
+          GST_PTR_FORMAT ", not linking it to encodebin", chain->track);
+    else if (G_UNLIKELY ((chain->encodebinpad =
+                get_encodebin_pad (self->priv->encodebin,
+                    chain->srcpad)) == NULL))
+      GST_WARNING_OBJECT (self, "Couldn't get a pad from encodebin for "
+          "track %" GST_PTR_FORMAT, chain->track);
+  }
+
+  if (chain->encodebinpad) {
+    tmppad = gst_element_get_request_pad (chain->tee, "src_%u");
+    if (G_UNLIKELY (gst_pad_link_full (tmppad, chain->encodebinpad,
+                GST_PAD_LINK_CHECK_NOTHING) != GST_PAD_LINK_OK)) {
+      GST_WARNING_OBJECT (self, "Couldn't link track pad to encodebin");
+      gst_element_release_request_pad (chain->tee, tmppad);
+      gst_element_release_request_pad (self->priv->encodebin,
+          chain->encodebinpad);
+      gst_object_unref (chain->encodebinpad);
+      chain->encodebinpad = NULL;
+    }
+    gst_object_unref (tmppad);
+  }
+
+  /* Branch the additional outputs after the composition */
+  for (tmp = self->priv->outputs; tmp; tmp = tmp->next) {
+    OutputBranch *branch = link_output_branch (self, chain, tmp->data);
+
+    if (branch)
+      chain->branches = g_list_append (chain->branches, branch);
+  }
+
+  if (chain->encodebinpad == NULL && chain->branches == NULL) {
+    GST_ERROR_OBJECT (self, "Track %" GST_PTR_FORMAT " is not rendered to "
+        "any output", chain->track);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/* Unlinks @chain from the encodebin and the additional render outputs,
+ * releasing the pads it got from them */
+static void
+unlink_render_chain (GESPipeline * self, OutputChain * chain)
+{
+  GList *tmp;
+  GstPad *peer;
+
+  for (tmp = chain->branches; tmp; tmp = tmp->next)
+    release_output_branch (self, chain, tmp->data);
+  g_list_free (chain->branches);
+  chain->branches = NULL;
+
+  if (chain->encodebinpad) {
+    peer = gst_pad_get_peer (chain->encodebinpad);
+    if (peer) {
+      gst_pad_unlink (peer, chain->encodebinpad);
+      gst_element_release_request_pad (chain->tee, peer);
+      gst_object_unref (peer);
+    }
+    gst_element_release_request_pad (self->priv->encodebin,
+        chain->encodebinpad);
+    gst_object_unref (chain->encodebinpad);
+    chain->encodebinpad = NULL;
+  }
+}
+
 static GstPadProbeReturn
 pad_blocked (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
 {
@@ -575,17 +1083,10 @@ pad_added_cb (GstElement * timeline, GstPad * pad, GESPipeline * self)
   }
 
   /* Don't connect track if it's not going to be used */
-  if (track->type == GES_TRACK_TYPE_VIDEO &&
-      !(self->priv->mode & TIMELINE_MODE_PREVIEW_VIDEO) &&
-      !(self->priv->mode & TIMELINE_MODE_RENDER) &&
-      !(self->priv->mode & TIMELINE_MODE_SMART_RENDER)) {
-    GST_DEBUG_OBJECT (self, "Video track... but we don't need it. Not linking");
-  }
-  if (track->type == GES_TRACK_TYPE_AUDIO &&
-      !(self->priv->mode & TIMELINE_MODE_PREVIEW_AUDIO) &&
-      !(self->priv->mode & TIMELINE_MODE_RENDER) &&
-      !(self->priv->mode & TIMELINE_MODE_SMART_RENDER)) {
-    GST_DEBUG_OBJECT (self, "Audio track... but we don't need it. Not linking");
+  if (!track_is_used (self, track)) {
+    GST_DEBUG_OBJECT (self, "%" GST_PTR_FORMAT " isn't needed. Not linking",
+        track);
+    return;
   }
 
   /* Get an existing chain or create it */
@@ -658,38 +1159,11 @@ pad_added_cb (GstElement * timeline, GstPad * pad, GESPipeline * self)
 
   /* Connect to encodebin */
   if (self->priv->mode & (TIMELINE_MODE_RENDER | TIMELINE_MODE_SMART_RENDER)) {
-    GstPad *tmppad;
-    GST_DEBUG_OBJECT (self, "Connecting to encodebin");
-
-    if (!chain->encodebinpad) {
-      /* Check for unused static pads */
-      sinkpad = get_compatible_unlinked_pad (self->priv->encodebin, pad);
-
-      if (sinkpad == NULL) {
-        GstCaps *caps = gst_pad_query_caps (pad, NULL);
-
-        /* If no compatible static pad is available, request a pad */
-        g_signal_emit_by_name (self->priv->encodebin, "request-pad", caps,
-            &sinkpad);
-        gst_caps_unref (caps);
-
-        if (G_UNLIKELY (sinkpad == NULL)) {
-          GST_ERROR_OBJECT (self, "Couldn't get a pad from encodebin !");
-          goto error;
-        }
-      }
-      chain->encodebinpad = sinkpad;
-    }
-
-    tmppad = gst_element_get_request_pad (chain->tee, "src_%u");
-    if (G_UNLIKELY (gst_pad_link_full (tmppad,
-                chain->encodebinpad,
-                GST_PAD_LINK_CHECK_NOTHING) != GST_PAD_LINK_OK)) {
-      GST_WARNING_OBJECT (self, "Couldn't link track pad to playsink");
+    if (!link_render_chain (self, chain)) {
+      /* Only the playsink pad is still owned at this point */
+      sinkpad = chain->playsinkpad;
       goto error;
     }
-    gst_object_unref (tmppad);
-
   }
 
   /* If chain wasn't already present, insert it in list */
@@ -730,14 +1204,8 @@ pad_removed_cb (GstElement * timeline, GstPad * pad, GESPipeline * self)
     return;
   }
 
-  /* Unlink encodebin */
-  if (chain->encodebinpad) {
-    peer = gst_pad_get_peer (chain->encodebinpad);
-    gst_pad_unlink (peer, chain->encodebinpad);
-    gst_object_unref (peer);
-    gst_element_release_request_pad (self->priv->encodebin,
-        chain->encodebinpad);
-  }
+  /* Unlink encodebin and the additional outputs */
+  unlink_render_chain (self, chain);
 
   /* Unlink playsink */
   if (chain->playsinkpad) {
@@ -814,6 +1282,9 @@ ges_pipeline_add_timeline (GESPipeline * pipeline, GESTimeline * timeline)
     return FALSE;
   }
   pipeline->priv->timeline = timeline;
+  timeline_set_use_cached_media (timeline,
+      !(pipeline->priv->mode & (TIMELINE_MODE_RENDER |
+              TIMELINE_MODE_SMART_RENDER)));
 
   /* Connect to pipeline */
   g_signal_connect (timeline, "pad-added", (GCallback) pad_added_cb, pipeline);
@@ -891,6 +1362,85 @@ ges_pipeline_set_render_settings (GESPipeline * pipeline,
   return TRUE;
 }
 
+/**
+ * ges_pipeline_add_render_settings:
+ * @pipeline: a #GESPipeline
+ * @output_uri: another URI to which the timeline will be rendered
+ * @profile: the #GstEncodingProfile to use for that URI
+ *
+ * Adds an output to which the timeline will be rendered along with the one
+ * specified with ges_pipeline_set_render_settings(). The tracks are only
+ * composited once, their output being fed to the encoders of all the
+ * outputs. Raw streams are scaled and converted to the restriction caps of
+ * the stream profiles of @profile, and tracks for which @profile has no
+ * stream profile are not rendered to @output_uri, so that, for example, an
+ * audio only master can be rendered at the same time as video deliverables.
+ *
+ * A copy of @output_uri will be done internally and a reference on @profile
+ * will be taken.
+ *
+ * As ges_pipeline_set_render_settings(), this method must be called before
+ * setting the pipeline mode to #TIMELINE_MODE_RENDER.
+ *
+ * Returns: %TRUE if the output could be added, else %FALSE
+ */
+gboolean
+ges_pipeline_add_render_settings (GESPipeline * pipeline,
+    const gchar * output_uri, GstEncodingProfile * profile)
+{
+  GError *err = NULL;
+  RenderOutput *output;
+
+  g_return_val_if_fail (GES_IS_PIPELINE (pipeline), FALSE);
+  g_return_val_if_fail (GST_IS_ENCODING_PROFILE (profile), FALSE);
+
+  if (pipeline->priv->mode &
+      (TIMELINE_MODE_RENDER | TIMELINE_MODE_SMART_RENDER)) {
+    GST_ERROR_OBJECT (pipeline, "Can't add a render output while rendering");
+    return FALSE;
+  }
+
+  output = g_new0 (RenderOutput, 1);
+  output->urisink =
+      gst_element_make_from_uri (GST_URI_SINK, output_uri, NULL, &err);
+  if (G_UNLIKELY (output->urisink == NULL)) {
+    GST_ERROR_OBJECT (pipeline, "Couldn't not create sink for URI %s: '%s'",
+        output_uri, ((err
+                && err->message) ? err->message : "failed to create element"));
+    g_clear_error (&err);
+    goto error;
+  }
+  gst_object_ref_sink (output->urisink);
+
+  output->encodebin = gst_element_factory_make ("encodebin", NULL);
+  if (G_UNLIKELY (output->encodebin == NULL)) {
+    GST_ERROR_OBJECT (pipeline, "Can't create encodebin instance !");
+    goto error;
+  }
+  gst_object_ref_sink (output->encodebin);
+
+  /* The streams are decoupled by the queue of each branch */
+  g_object_set (output->encodebin, "queue-buffers-max", (guint) 1,
+      "queue-bytes-max", (guint) 0, "queue-time-max", (guint64) 0,
+      "profile", profile, NULL);
+  g_object_get (output->encodebin, "profile", &output->profile, NULL);
+
+  if (output->profile == NULL) {
+    GST_ERROR_OBJECT (pipeline, "Profile %" GST_PTR_FORMAT " could no be set",
+        profile);
+    goto error;
+  }
+
+  pipeline->priv->outputs = g_list_append (pipeline->priv->outputs, output);
+
+  return TRUE;
+
+error:
+  render_output_free (output);
+
+  return FALSE;
+}
+
 /**
  * ges_pipeline_get_mode:
  * @pipeline: a #GESPipeline
@@ -920,6 +1470,8 @@ ges_pipeline_get_mode (GESPipeline * pipeline)
 gboolean
 ges_pipeline_set_mode (GESPipeline * pipeline, GESPipelineFlags mode)
 {
+  GList *tmp;
+
   g_return_val_if_fail (GES_IS_PIPELINE (pipeline), FALSE);
 
   GST_DEBUG_OBJECT (pipeline, "current mode : %d, mode : %d",
@@ -947,7 +1499,6 @@ ges_pipeline_set_mode (GESPipeline * pipeline, GESPipelineFlags mode)
   if ((pipeline->priv->mode &
           (TIMELINE_MODE_RENDER | TIMELINE_MODE_SMART_RENDER)) &&
       !(mode & (TIMELINE_MODE_RENDER | TIMELINE_MODE_SMART_RENDER))) {
-    GList *tmp;
     GstCaps *caps;
 
     for (tmp = pipeline->priv->timeline->tracks; tmp; tmp = tmp->next) {
@@ -964,12 +1515,25 @@ ges_pipeline_set_mode (GESPipeline * pipeline, GESPipelineFlags mode)
       gst_caps_unref (caps);
     }
 
+    /* The chains are linked again if going back to a render mode, the
+     * encodebins must not keep pads from this configuration */
+    for (tmp = pipeline->priv->chains; tmp; tmp = tmp->next)
+      unlink_render_chain (pipeline, tmp->data);
+
     /* Disable render bin */
     GST_DEBUG ("Disabling rendering bin");
     gst_object_ref (pipeline->priv->encodebin);
     gst_object_ref (pipeline->priv->urisink);
     gst_bin_remove_many (GST_BIN_CAST (pipeline),
         pipeline->priv->encodebin, pipeline->priv->urisink, NULL);
+
+    /* We keep our own references to the additional outputs */
+    for (tmp = pipeline->priv->outputs; tmp; tmp = tmp->next) {
+      RenderOutput *output = tmp->data;
+
+      gst_bin_remove_many (GST_BIN_CAST (pipeline), output->encodebin,
+          output->urisink, NULL);
+    }
   }
 
   /* Add new elements */
@@ -1006,6 +1570,39 @@ ges_pipeline_set_mode (GESPipeline * pipeline, GESPipelineFlags mode)
 
     gst_element_link_pads_full (pipeline->priv->encodebin, "src",
         pipeline->priv->urisink, "sink", GST_PAD_LINK_CHECK_NOTHING);
+
+    for (tmp = pipeline->priv->outputs; tmp; tmp = tmp->next) {
+      RenderOutput *output = tmp->data;
+
+      if (!gst_bin_add (GST_BIN_CAST (pipeline), output->encodebin) ||
+          !gst_bin_add (GST_BIN_CAST (pipeline), output->urisink)) {
+        GST_ERROR_OBJECT (pipeline, "Couldn't add render output %"
+            GST_PTR_FORMAT, output->urisink);
+        return FALSE;
+      }
+      g_object_set (output->encodebin, "avoid-reencoding",
+          ! !(mode & TIMELINE_MODE_SMART_RENDER), NULL);
+
+      gst_element_link_pads_full (output->encodebin, "src",
+          output->urisink, "sink", GST_PAD_LINK_CHECK_NOTHING);
+    }
+  }
+
+  /* Link the tracks which already have been exposed, pad_added_cb does it
+   * for the ones to come */
+  if (!(pipeline->priv->mode &
+          (TIMELINE_MODE_RENDER | TIMELINE_MODE_SMART_RENDER)) &&
+      (mode & (TIMELINE_MODE_RENDER | TIMELINE_MODE_SMART_RENDER))) {
+    /* So the branches are created for the right mode */
+    GST_OBJECT_LOCK (pipeline);
+    pipeline->priv->mode = mode;
+    GST_OBJECT_UNLOCK (pipeline);
+
+    for (tmp = pipeline->priv->chains; tmp; tmp = tmp->next) {
+      if (!link_render_chain (pipeline, tmp->data))
+        GST_ERROR_OBJECT (pipeline, "Could not link %" GST_PTR_FORMAT
+            " to the render outputs", ((OutputChain *) tmp->data)->track);
+    }
   }
 
   /* FIXUPS */
@@ -1013,7 +1610,14 @@ ges_pipeline_set_mode (GESPipeline * pipeline, GESPipelineFlags mode)
    * If we are rendering, set playsink to sync=False,
    * If we are NOT rendering, set playsink to sync=TRUE */
 
+  /* Renders are made from the original content, not from cached previews */
+  if (pipeline->priv->timeline)
+    timeline_set_use_cached_media (pipeline->priv->timeline,
+        !(mode & (TIMELINE_MODE_RENDER | TIMELINE_MODE_SMART_RENDER)));
+
+  GST_OBJECT_LOCK (pipeline);
   pipeline->priv->mode = mode;
+  GST_OBJECT_UNLOCK (pipeline);
 
   return TRUE;
 }
@@ -1226,3 +1830,91 @@ ges_pipeline_preview_set_audio_sink (GESPipeline * self, GstElement * sink)
 
   g_object_set (self->priv->playsink, "audio-sink", sink, NULL);
 };
+
+/**
+ * ges_pipeline_preview_set_quality:
+ * @self: a #GESPipeline
+ * @quality: the #GESPreviewQuality to preview video at
+ *
+ * Sets the resolution at which video is previewed, relative to the
+ * restriction caps of the video tracks. Lowering the resolution makes the
+ * video sources scale their frames down before they get composited, which
+ * reduces the cost of the whole processing chain. Renders always happen at
+ * full resolution.
+ *
+ * If #GESPipeline:adaptive-preview-quality is %TRUE, @quality is the best
+ * resolution the pipeline will use.
+ */
+void
+ges_pipeline_preview_set_quality (GESPipeline * self,
+    GESPreviewQuality quality)
+{
+  g_return_if_fail (GES_IS_PIPELINE (self));
+  g_return_if_fail (quality == GES_PREVIEW_QUALITY_FULL ||
+      quality == GES_PREVIEW_QUALITY_HALF ||
+      quality == GES_PREVIEW_QUALITY_QUARTER);
+
+  self->priv->preview_quality = quality;
+  _apply_preview_quality (self, quality);
+
+  g_object_notify_by_pspec (G_OBJECT (self),
+      properties[PROP_PREVIEW_QUALITY]);
+}
+
+/**
+ * ges_pipeline_preview_get_quality:
+ * @self: a #GESPipeline
+ *
+ * Gets the resolution at which video is previewed, as set with
+ * ges_pipeline_preview_set_quality().
+ *
+ * Returns: The requested #GESPreviewQuality of @self
+ */
+GESPreviewQuality
+ges_pipeline_preview_get_quality (GESPipeline * self)
+{
+  g_return_val_if_fail (GES_IS_PIPELINE (self), DEFAULT_PREVIEW_QUALITY);
+
+  return self->priv->preview_quality;
+}
+
+/**
+ * ges_pipeline_preview_set_adaptive_quality:
+ * @self: a #GESPipeline
+ * @adaptive: whether the preview resolution should adapt to the load
+ *
+ * When @adaptive is %TRUE, the preview resolution is automatically lowered,
+ * one step at a time, whenever the pipeline starts dropping late buffers
+ * while playing. The resolution set with ges_pipeline_preview_set_quality()
+ * is restored when the pipeline is paused.
+ */
+void
+ges_pipeline_preview_set_adaptive_quality (GESPipeline * self,
+    gboolean adaptive)
+{
+  g_return_if_fail (GES_IS_PIPELINE (self));
+
+  GST_OBJECT_LOCK (self);
+  self->priv->adaptive_quality = adaptive;
+  GST_OBJECT_UNLOCK (self);
+  if (!adaptive && self->priv->current_quality != self->priv->preview_quality)
+    _apply_preview_quality (self, self->priv->preview_quality);
+
+  g_object_notify_by_pspec (G_OBJECT (self),
+      properties[PROP_ADAPTIVE_PREVIEW_QUALITY]);
+}
+
+/**
+ * ges_pipeline_preview_get_adaptive_quality:
+ * @self: a #GESPipeline
+ *
+ * Returns: %TRUE if the preview resolution of @self adapts to the load,
+ * %FALSE otherwise.
+ */
+gboolean
+ges_pipeline_preview_get_adaptive_quality (GESPipeline * self)
+{
+  g_return_val_if_fail (GES_IS_PIPELINE (self), FALSE);
+
+  return self->priv->adaptive_quality;
+}
@@ -85,6 +85,9 @@ gboolean ges_pipeline_add_timeline (GESPipeline * pipeline,
 gboolean ges_pipeline_set_render_settings (GESPipeline *pipeline,
 						    const gchar * output_uri,
 						    GstEncodingProfile *profile);
+gboolean ges_pipeline_add_render_settings (GESPipeline *pipeline,
+					   const gchar * output_uri,
+					   GstEncodingProfile *profile);
 gboolean ges_pipeline_set_mode (GESPipeline *pipeline,
 					 GESPipelineFlags mode);
 
@@ -116,6 +119,20 @@ void
 ges_pipeline_preview_set_audio_sink (GESPipeline * self,
     GstElement * sink);
 
+void
+ges_pipeline_preview_set_quality (GESPipeline * self,
+    GESPreviewQuality quality);
+
+GESPreviewQuality
+ges_pipeline_preview_get_quality (GESPipeline * self);
+
+void
+ges_pipeline_preview_set_adaptive_quality (GESPipeline * self,
+    gboolean adaptive);
+
+gboolean
+ges_pipeline_preview_get_adaptive_quality (GESPipeline * self);
+
 G_END_DECLS
 
 #endif /* _GES_PIPELINE */
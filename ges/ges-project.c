@@ -43,6 +43,7 @@
  * a set of signals. Also it handles problem such as missing files/missing
  * #GstElement and lets you try to recover from those.
  */
+#include <string.h>
 #include "ges.h"
 #include "ges-internal.h"
 #include <glib/gstdio.h>
@@ -55,6 +56,9 @@ G_DEFINE_TYPE (GESProject, ges_project, GES_TYPE_ASSET);
 struct _GESProjectPrivate
 {
   GHashTable *assets;
+  /* Indexes of assets and proxies by extractable type, see _index_asset */
+  GHashTable *assets_by_type;
+  GHashTable *proxies_by_type;
   /* Set of asset ID being loaded */
   GHashTable *loading_assets;
   GHashTable *loaded_with_error;
@@ -78,8 +82,44 @@ struct _GESProjectPrivate
   gboolean proxies_created;
   gchar *proxy_uri;
   gchar *proxies_location;
+
+  /* Assets created from the saved metadatas, to be discovered once the
+   * project is loaded */
+  gboolean trust_saved_metadata;
+  GQueue unvalidated_assets;
+  gboolean validating_assets;
+
+  /* Directories (GFile) to look moved files in, and the index of their
+   * files built out of them in a thread */
+  GList *search_roots;
+  struct _RelocationIndex *relocation_index;
+
+  GESProjectLoadTimings load_timings;
 };
 
+typedef struct
+{
+  gchar *uri;
+  guint64 size;
+} RelocationCandidate;
+
+/* The files of the search roots, indexed by basename in a thread, shared
+ * by the project and that thread */
+typedef struct _RelocationIndex
+{
+  volatile gint refcount;
+
+  GMutex lock;
+  GCond cond;
+  gboolean done;
+
+  GCancellable *cancellable;
+  GList *roots;
+  /* basename -> RelocationCandidate list, only accessed by the indexing
+   * thread until done is set */
+  GHashTable *files;
+} RelocationIndex;
+
 typedef struct EmitLoadedInIdle
 {
   GESProject *project;
@@ -114,6 +154,7 @@ enum
 static GParamSpec *_properties[LAST_SIGNAL] = { 0 };
 
 static gboolean _transcode (GESProject * project, GESAsset * asset);
+static void _clear_relocation_index (GESProjectPrivate * priv);
 static gboolean _create_proxy_asset (GESProject * project, const gchar * id,
     GType extractable_type);
 
@@ -222,6 +263,7 @@ _load_project (GESProject * project, GESTimeline * timeline, GError ** error)
     goto failed;
   }
 
+  memset (&priv->load_timings, 0, sizeof (priv->load_timings));
   ges_project_add_formatter (GES_PROJECT (project), formatter);
   ges_formatter_load_from_uri (formatter, timeline, priv->uri, &lerr);
   if (lerr) {
@@ -274,6 +316,10 @@ _dispose (GObject * object)
 
   if (priv->assets)
     g_hash_table_unref (priv->assets);
+  if (priv->assets_by_type)
+    g_hash_table_unref (priv->assets_by_type);
+  if (priv->proxies_by_type)
+    g_hash_table_unref (priv->proxies_by_type);
   if (priv->loading_assets)
     g_hash_table_unref (priv->loading_assets);
   if (priv->loaded_with_error)
@@ -300,6 +346,11 @@ _dispose (GObject * object)
     g_list_free_full (priv->create_proxies, g_free);
   if (priv->timeline_proxies)
     g_list_free_full (priv->timeline_proxies, g_free);
+  g_queue_foreach (&priv->unvalidated_assets, (GFunc) gst_object_unref, NULL);
+  g_queue_clear (&priv->unvalidated_assets);
+  g_list_free_full (priv->search_roots, g_object_unref);
+  priv->search_roots = NULL;
+  _clear_relocation_index (priv);
 
   for (tmp = priv->formatters; tmp; tmp = tmp->next)
     ges_project_remove_formatter (GES_PROJECT (object), tmp->data);;
@@ -515,8 +566,17 @@ ges_project_init (GESProject * project)
   priv->proxy_parent = NULL;
   priv->create_proxies = NULL;
   priv->timeline_proxies = NULL;
+  priv->trust_saved_metadata = FALSE;
+  g_queue_init (&priv->unvalidated_assets);
+  priv->validating_assets = FALSE;
+  priv->search_roots = NULL;
+  priv->relocation_index = NULL;
   priv->assets = g_hash_table_new_full (g_str_hash, g_str_equal,
       g_free, gst_object_unref);
+  priv->assets_by_type = g_hash_table_new_full (g_direct_hash,
+      g_direct_equal, NULL, (GDestroyNotify) g_hash_table_unref);
+  priv->proxies_by_type = g_hash_table_new_full (g_direct_hash,
+      g_direct_equal, NULL, (GDestroyNotify) g_hash_table_unref);
   priv->loading_assets = g_hash_table_new_full (g_str_hash, g_str_equal,
       g_free, gst_object_unref);
   priv->loaded_with_error = g_hash_table_new_full (g_str_hash, g_str_equal,
@@ -527,6 +587,59 @@ ges_project_init (GESProject * project)
       g_free, gst_object_unref);
 }
 
+/* Indexes are mapping extractable types to the assets with that exact
+ * extractable type, by ID, so that listing the assets of some types only
+ * goes through those. They do not hold references on the assets */
+static void
+_index_asset (GHashTable * index, GESAsset * asset)
+{
+  GHashTable *assets;
+  gpointer type = GSIZE_TO_POINTER (ges_asset_get_extractable_type (asset));
+
+  assets = g_hash_table_lookup (index, type);
+  if (assets == NULL) {
+    assets = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    g_hash_table_insert (index, type, assets);
+  }
+
+  g_hash_table_insert (assets, g_strdup (ges_asset_get_id (asset)), asset);
+}
+
+static void
+_unindex_asset (GHashTable * index, GESAsset * asset)
+{
+  GHashTable *assets;
+  gpointer type = GSIZE_TO_POINTER (ges_asset_get_extractable_type (asset));
+
+  assets = g_hash_table_lookup (index, type);
+  if (assets == NULL)
+    return;
+
+  g_hash_table_remove (assets, ges_asset_get_id (asset));
+  if (g_hash_table_size (assets) == 0)
+    g_hash_table_remove (index, type);
+}
+
+static GList *
+_list_indexed_assets (GHashTable * index, GType filter)
+{
+  GList *ret = NULL;
+  GHashTableIter iter, aiter;
+  gpointer type, assets, key, value;
+
+  g_hash_table_iter_init (&iter, index);
+  while (g_hash_table_iter_next (&iter, &type, &assets)) {
+    if (!g_type_is_a (GPOINTER_TO_SIZE (type), filter))
+      continue;
+
+    g_hash_table_iter_init (&aiter, assets);
+    while (g_hash_table_iter_next (&aiter, &key, &value))
+      ret = g_list_prepend (ret, gst_object_ref (value));
+  }
+
+  return g_list_reverse (ret);
+}
+
 static void
 _send_error_loading_asset (GESProject * project, GESAsset * asset,
     GError * error)
@@ -540,6 +653,259 @@ _send_error_loading_asset (GESProject * project, GESAsset * asset,
       ges_asset_get_extractable_type (asset));
 }
 
+static void
+_free_relocation_candidates (GList * candidates)
+{
+  GList *tmp;
+
+  for (tmp = candidates; tmp; tmp = tmp->next) {
+    g_free (((RelocationCandidate *) tmp->data)->uri);
+    g_slice_free (RelocationCandidate, tmp->data);
+  }
+  g_list_free (candidates);
+}
+
+static void
+_relocation_index_unref (RelocationIndex * index)
+{
+  if (!g_atomic_int_dec_and_test (&index->refcount))
+    return;
+
+  g_mutex_clear (&index->lock);
+  g_cond_clear (&index->cond);
+  g_object_unref (index->cancellable);
+  g_list_free_full (index->roots, g_object_unref);
+  g_hash_table_unref (index->files);
+  g_slice_free (RelocationIndex, index);
+}
+
+static void
+_clear_relocation_index (GESProjectPrivate * priv)
+{
+  if (priv->relocation_index == NULL)
+    return;
+
+  /* The indexing thread drops its own reference once it notices */
+  g_cancellable_cancel (priv->relocation_index->cancellable);
+  _relocation_index_unref (priv->relocation_index);
+  priv->relocation_index = NULL;
+}
+
+/* Returns %FALSE if the directory with the @id file ID has already been
+ * visited */
+static gboolean
+_visit_directory (GHashTable * visited, const gchar * id)
+{
+  if (id == NULL)
+    return TRUE;
+
+  if (g_hash_table_contains (visited, id))
+    return FALSE;
+
+  g_hash_table_add (visited, g_strdup (id));
+
+  return TRUE;
+}
+
+/* Walks @root without recursing, following symbolic links but entering
+ * each directory only once so that link cycles are harmless */
+static void
+_index_directory (RelocationIndex * index, GFile * root, GHashTable * visited)
+{
+  GFileInfo *info;
+  const gchar *id;
+  gboolean walk = TRUE;
+  GQueue dirs = G_QUEUE_INIT;
+
+  /* The root might be under another one */
+  info = g_file_query_info (root, G_FILE_ATTRIBUTE_ID_FILE,
+      G_FILE_QUERY_INFO_NONE, index->cancellable, NULL);
+  if (info) {
+    id = g_file_info_get_attribute_string (info, G_FILE_ATTRIBUTE_ID_FILE);
+    walk = _visit_directory (visited, id);
+    g_object_unref (info);
+  }
+
+  if (walk)
+    g_queue_push_tail (&dirs, g_object_ref (root));
+
+  while (!g_queue_is_empty (&dirs)) {
+    GFileEnumerator *enumerator;
+    GFile *dir = g_queue_pop_head (&dirs);
+
+    if (g_cancellable_is_cancelled (index->cancellable)) {
+      g_object_unref (dir);
+      continue;
+    }
+
+    enumerator = g_file_enumerate_children (dir,
+        G_FILE_ATTRIBUTE_STANDARD_NAME "," G_FILE_ATTRIBUTE_STANDARD_TYPE ","
+        G_FILE_ATTRIBUTE_STANDARD_SIZE "," G_FILE_ATTRIBUTE_STANDARD_IS_SYMLINK
+        "," G_FILE_ATTRIBUTE_ID_FILE, G_FILE_QUERY_INFO_NONE,
+        index->cancellable, NULL);
+
+    while (enumerator && (info = g_file_enumerator_next_file (enumerator,
+                index->cancellable, NULL))) {
+      const gchar *name = g_file_info_get_name (info);
+      GFile *child = g_file_get_child (dir, name);
+
+      if (g_file_info_get_file_type (info) == G_FILE_TYPE_DIRECTORY) {
+        id = g_file_info_get_attribute_string (info, G_FILE_ATTRIBUTE_ID_FILE);
+
+        /* Without an ID, only follow real directories, those can not
+         * lead back to a parent */
+        if (id ? _visit_directory (visited, id) :
+            !g_file_info_get_is_symlink (info))
+          g_queue_push_tail (&dirs, g_object_ref (child));
+      } else if (g_file_info_get_file_type (info) == G_FILE_TYPE_REGULAR) {
+        GList *candidates;
+        RelocationCandidate *candidate = g_slice_new (RelocationCandidate);
+
+        candidate->uri = g_file_get_uri (child);
+        candidate->size = g_file_info_get_size (info);
+
+        /* The list is owned by the table, steal it to prepend to it */
+        candidates = g_hash_table_lookup (index->files, name);
+        if (candidates)
+          g_hash_table_steal (index->files, name);
+        g_hash_table_insert (index->files, g_strdup (name),
+            g_list_prepend (candidates, candidate));
+      }
+
+      g_object_unref (child);
+      g_object_unref (info);
+    }
+
+    if (enumerator)
+      g_object_unref (enumerator);
+    g_object_unref (dir);
+  }
+}
+
+static gpointer
+_index_thread (RelocationIndex * index)
+{
+  GList *tmp;
+  GHashTable *visited = g_hash_table_new_full (g_str_hash, g_str_equal,
+      g_free, NULL);
+
+  for (tmp = index->roots; tmp; tmp = tmp->next)
+    _index_directory (index, tmp->data, visited);
+  g_hash_table_unref (visited);
+
+  GST_DEBUG ("Indexed %u file names in the search roots",
+      g_hash_table_size (index->files));
+
+  g_mutex_lock (&index->lock);
+  index->done = TRUE;
+  g_cond_broadcast (&index->cond);
+  g_mutex_unlock (&index->lock);
+
+  _relocation_index_unref (index);
+
+  return NULL;
+}
+
+/* Indexes the search roots again, from scratch, in a thread */
+static void
+_start_relocation_index (GESProject * project)
+{
+  GThread *thread;
+  RelocationIndex *index;
+  GESProjectPrivate *priv = project->priv;
+
+  _clear_relocation_index (priv);
+
+  index = g_slice_new0 (RelocationIndex);
+  index->refcount = 1;
+  g_mutex_init (&index->lock);
+  g_cond_init (&index->cond);
+  index->cancellable = g_cancellable_new ();
+  index->roots = g_list_copy_deep (priv->search_roots,
+      (GCopyFunc) g_object_ref, NULL);
+  index->files = g_hash_table_new_full (g_str_hash, g_str_equal,
+      g_free, (GDestroyNotify) _free_relocation_candidates);
+  priv->relocation_index = index;
+
+  g_atomic_int_inc (&index->refcount);
+  thread = g_thread_new ("ges-search-roots", (GThreadFunc) _index_thread,
+      index);
+  g_thread_unref (thread);
+}
+
+static guint
+_common_suffix_length (const gchar * a, const gchar * b)
+{
+  guint n = 0;
+  const gchar *enda = a + strlen (a), *endb = b + strlen (b);
+
+  while (enda > a && endb > b && *(--enda) == *(--endb))
+    n++;
+
+  return n;
+}
+
+/* Looks for a file with the same name as the one of @asset in the search
+ * roots. The search roots are walked once and indexed by basename, so
+ * relocating many assets does not hit the file system for each of them */
+static gchar *
+_find_in_search_roots (GESProject * project, GESAsset * asset)
+{
+  guint64 size;
+  gboolean has_size;
+  gchar *basename;
+  GFile *file;
+  GList *tmp, *candidates;
+  RelocationCandidate *best = NULL;
+  guint best_score = 0;
+  GESProjectPrivate *priv = project->priv;
+  const gchar *id = ges_asset_get_id (asset);
+
+  if (priv->relocation_index == NULL)
+    return NULL;
+
+  /* The search roots have been indexing since they were added, usually
+   * while the project was loading */
+  g_mutex_lock (&priv->relocation_index->lock);
+  while (!priv->relocation_index->done)
+    g_cond_wait (&priv->relocation_index->cond,
+        &priv->relocation_index->lock);
+  g_mutex_unlock (&priv->relocation_index->lock);
+
+  file = g_file_new_for_uri (id);
+  basename = g_file_get_basename (file);
+  candidates = g_hash_table_lookup (priv->relocation_index->files, basename);
+  g_object_unref (file);
+  g_free (basename);
+
+  /* Files with another size are other files with the same name, and the
+   * more of the path matches, the more likely it is the same file */
+  has_size = ges_meta_container_get_uint64 (GES_META_CONTAINER (asset),
+      GES_META_FILE_SIZE, &size);
+  for (tmp = candidates; tmp; tmp = tmp->next) {
+    guint score;
+    RelocationCandidate *candidate = tmp->data;
+
+    if ((has_size && candidate->size != size) ||
+        g_strcmp0 (candidate->uri, id) == 0)
+      continue;
+
+    score = _common_suffix_length (candidate->uri, id);
+    if (best == NULL || score > best_score) {
+      best = candidate;
+      best_score = score;
+    }
+  }
+
+  if (best == NULL)
+    return NULL;
+
+  GST_DEBUG_OBJECT (project, "Found %s in the search roots for %s",
+      best->uri, id);
+
+  return g_strdup (best->uri);
+}
+
 gchar *
 ges_project_try_updating_id (GESProject * project, GESAsset * asset,
     GError * error)
@@ -561,6 +927,9 @@ ges_project_try_updating_id (GESProject * project, GESAsset * asset,
     return NULL;
   }
 
+  if (new_id == NULL)
+    new_id = _find_in_search_roots (project, asset);
+
   if (new_id == NULL) {
     GST_DEBUG_OBJECT (project, "Sending 'missing-uri' signal for %s", id);
     g_signal_emit (project, _signals[MISSING_URI_SIGNAL], 0, error, asset,
@@ -621,6 +990,7 @@ _add_proxy (GESProject * project, GESAsset * asset)
 
   g_hash_table_insert (project->priv->proxies,
       g_strdup (ges_asset_get_id (asset)), gst_object_ref (asset));
+  _index_asset (project->priv->proxies_by_type, asset);
 
   GST_DEBUG_OBJECT (project, "Proxy asset added: %s", ges_asset_get_id (asset));
 
@@ -892,17 +1262,19 @@ _transcode (GESProject * project, GESAsset * asset)
 static GList *
 _get_create_proxies_list (GESProject * project)
 {
-  GList *ret = NULL;
-  GHashTableIter iter;
-  gpointer key, value;
+  GList *tmp, *ret;
 
   g_return_val_if_fail (GES_IS_PROJECT (project), NULL);
 
-  g_hash_table_iter_init (&iter, project->priv->assets);
-  while (g_hash_table_iter_next (&iter, &key, &value)) {
-    if (GES_IS_URI_CLIP_ASSET (GES_ASSET (value))) {
-      ret = g_list_append (ret, gst_object_ref (value));
+  ret = _list_indexed_assets (project->priv->assets_by_type, GES_TYPE_URI_CLIP);
+  for (tmp = ret; tmp;) {
+    GList *next = tmp->next;
+
+    if (!GES_IS_URI_CLIP_ASSET (tmp->data)) {
+      gst_object_unref (tmp->data);
+      ret = g_list_delete_link (ret, tmp);
     }
+    tmp = next;
   }
 
   return ret;
@@ -956,6 +1328,70 @@ _create_proxies (GESProject * project)
   return TRUE;
 }
 
+static gboolean _validate_next_asset (GESProject * project);
+
+static void
+_asset_validated_cb (GESUriClipAsset * asset, GAsyncResult * res,
+    GESProject * project)
+{
+  GError *error = NULL;
+
+  if (!ges_uri_clip_asset_validate_finish (asset, res, &error)) {
+    GST_INFO_OBJECT (project, "Asset %s not validated: %s",
+        ges_asset_get_id (GES_ASSET (asset)), error->message);
+    g_signal_emit (project, _signals[ERROR_LOADING_ASSET], 0, error,
+        ges_asset_get_id (GES_ASSET (asset)), GES_TYPE_URI_CLIP);
+    g_error_free (error);
+  }
+
+  /* Passing our reference on to the next validation */
+  g_idle_add_full (G_PRIORITY_LOW, (GSourceFunc) _validate_next_asset,
+      project, gst_object_unref);
+}
+
+static gboolean
+_validate_next_asset (GESProject * project)
+{
+  GESAsset *asset = g_queue_pop_head (&project->priv->unvalidated_assets);
+
+  if (asset == NULL) {
+    GST_DEBUG_OBJECT (project, "All assets validated");
+    project->priv->validating_assets = FALSE;
+
+    return FALSE;
+  }
+
+  ges_uri_clip_asset_validate_async (GES_URI_CLIP_ASSET (asset),
+      (GAsyncReadyCallback) _asset_validated_cb, gst_object_ref (project));
+  gst_object_unref (asset);
+
+  return FALSE;
+}
+
+/* Discovers the assets created from the saved metadatas one after the
+ * other, at low priority, so that using the timeline is not slowed down */
+static void
+_start_assets_validation (GESProject * project)
+{
+  GESProjectPrivate *priv = project->priv;
+
+  if (priv->validating_assets || g_queue_is_empty (&priv->unvalidated_assets))
+    return;
+
+  priv->validating_assets = TRUE;
+  g_idle_add_full (G_PRIORITY_LOW, (GSourceFunc) _validate_next_asset,
+      gst_object_ref (project), gst_object_unref);
+}
+
+/* Called by the formatters when they created @asset from the metadatas
+ * saved in the project */
+void
+ges_project_add_unvalidated_asset (GESProject * project, GESAsset * asset)
+{
+  g_queue_push_tail (&project->priv->unvalidated_assets,
+      gst_object_ref (asset));
+}
+
 /**
  * ges_project_set_loaded:
  * @project: The #GESProject from which to emit the "project-loaded" signal
@@ -968,10 +1404,16 @@ _create_proxies (GESProject * project)
 gboolean
 ges_project_set_loaded (GESProject * project, GESFormatter * formatter)
 {
+  GstClockTime start;
+
   GST_INFO_OBJECT (project, "Emit project loaded");
+  start = gst_util_get_timestamp ();
   ges_timeline_commit (formatter->timeline);
+  project->priv->load_timings.first_commit = gst_util_get_timestamp () - start;
   g_signal_emit (project, _signals[LOADED_SIGNAL], 0, formatter->timeline);
 
+  _start_assets_validation (project);
+
   if (project->priv->proxies_created == FALSE) {
     _create_proxies (project);
   }
@@ -982,6 +1424,54 @@ ges_project_set_loaded (GESProject * project, GESFormatter * formatter)
   return TRUE;
 }
 
+void
+ges_project_set_load_timings (GESProject * project,
+    const GESProjectLoadTimings * timings)
+{
+  project->priv->load_timings = *timings;
+}
+
+/**
+ * ges_project_get_load_timings:
+ * @project: A #GESProject
+ *
+ * Gets the time spent in each phase of the last load of @project, as
+ * #GstClockTime fields of a "load-timings" #GstStructure:
+ *  - "read": reading the file
+ *  - "parse": parsing it, without the time spent handling its elements
+ *  - "asset-resolution": requesting the assets and waiting for them
+ *  - "clip-creation": creating the clips and setting their properties
+ *  - "track-element-creation": adding the clips to their layers, and adding
+ *    their effects and keyframes
+ *  - "first-commit": the timeline commit done before emitting
+ *    #GESProject::loaded
+ *
+ * The timings are filled by the formatter as it goes, and are complete once
+ * @project is loaded. They are all 0 if @project was never loaded.
+ *
+ * Returns: (transfer full): The timings of the last load of @project
+ *
+ * Since: 1.0.XX
+ */
+GstStructure *
+ges_project_get_load_timings (GESProject * project)
+{
+  GESProjectLoadTimings *timings;
+
+  g_return_val_if_fail (GES_IS_PROJECT (project), NULL);
+
+  timings = &project->priv->load_timings;
+
+  return gst_structure_new ("load-timings",
+      "read", G_TYPE_UINT64, timings->read,
+      "parse", G_TYPE_UINT64, timings->parse,
+      "asset-resolution", G_TYPE_UINT64, timings->asset_resolution,
+      "clip-creation", G_TYPE_UINT64, timings->clip_creation,
+      "track-element-creation", G_TYPE_UINT64,
+      timings->track_element_creation,
+      "first-commit", G_TYPE_UINT64, timings->first_commit, NULL);
+}
+
 void
 ges_project_add_loading_asset (GESProject * project, GType extractable_type,
     const gchar * id)
@@ -989,8 +1479,7 @@ ges_project_add_loading_asset (GESProject * project, GType extractable_type,
   GESAsset *asset;
 
   if ((asset = ges_asset_cache_lookup (extractable_type, id)))
-    g_hash_table_insert (project->priv->loading_assets, g_strdup (id),
-        gst_object_ref (asset));
+    g_hash_table_insert (project->priv->loading_assets, g_strdup (id), asset);
 }
 
 /**************************************
@@ -1057,6 +1546,7 @@ ges_project_add_asset (GESProject * project, GESAsset * asset)
 
   g_hash_table_insert (project->priv->assets,
       g_strdup (ges_asset_get_id (asset)), gst_object_ref (asset));
+  _index_asset (project->priv->assets_by_type, asset);
 
   g_hash_table_remove (project->priv->loading_assets, ges_asset_get_id (asset));
   GST_DEBUG_OBJECT (project, "Asset added: %s", ges_asset_get_id (asset));
@@ -1078,9 +1568,14 @@ gboolean
 ges_project_remove_asset (GESProject * project, GESAsset * asset)
 {
   gboolean ret;
+  GESAsset *stored;
 
   g_return_val_if_fail (GES_IS_PROJECT (project), FALSE);
 
+  stored = g_hash_table_lookup (project->priv->assets,
+      ges_asset_get_id (asset));
+  if (stored)
+    _unindex_asset (project->priv->assets_by_type, stored);
   ret = g_hash_table_remove (project->priv->assets, ges_asset_get_id (asset));
   g_signal_emit (project, _signals[ASSET_REMOVED_SIGNAL], 0, asset);
 
@@ -1131,20 +1626,9 @@ ges_project_get_asset (GESProject * project, const gchar * id,
 GList *
 ges_project_list_assets (GESProject * project, GType filter)
 {
-  GList *ret = NULL;
-  GHashTableIter iter;
-  gpointer key, value;
-
   g_return_val_if_fail (GES_IS_PROJECT (project), NULL);
 
-  g_hash_table_iter_init (&iter, project->priv->assets);
-  while (g_hash_table_iter_next (&iter, &key, &value)) {
-    if (g_type_is_a (ges_asset_get_extractable_type (GES_ASSET (value)),
-            filter))
-      ret = g_list_append (ret, gst_object_ref (value));
-  }
-
-  return ret;
+  return _list_indexed_assets (project->priv->assets_by_type, filter);
 }
 
 /**
@@ -1163,20 +1647,9 @@ ges_project_list_assets (GESProject * project, GType filter)
 GList *
 ges_project_list_proxies (GESProject * project, GType filter)
 {
-  GList *ret = NULL;
-  GHashTableIter iter;
-  gpointer key, value;
-
   g_return_val_if_fail (GES_IS_PROJECT (project), NULL);
 
-  g_hash_table_iter_init (&iter, project->priv->proxies);
-  while (g_hash_table_iter_next (&iter, &key, &value)) {
-    if (g_type_is_a (ges_asset_get_extractable_type (GES_ASSET (value)),
-            filter))
-      ret = g_list_append (ret, gst_object_ref (value));
-  }
-
-  return ret;
+  return _list_indexed_assets (project->priv->proxies_by_type, filter);
 }
 
 /**
@@ -1194,6 +1667,9 @@ ges_project_list_proxies (GESProject * project, GType filter)
  * is one of the timelines that have been extracted from @project
  * (using ges_asset_extract (@project);)
  *
+ * With the xml formatters, the project is gzip compressed if @uri ends
+ * with ".gz". Compressed projects are detected when loading them.
+ *
  * Returns: %TRUE if the project could be save, %FALSE otherwize
  */
 gboolean
@@ -1218,6 +1694,7 @@ ges_project_save (GESProject * project, GESTimeline * timeline,
     if (asset) {
       GST_WARNING_OBJECT (project, "Trying to save project to %s but we already"
           "have %" GST_PTR_FORMAT " for that uri, can not save", uri, asset);
+      gst_object_unref (asset);
       goto out;
     }
 
@@ -1315,6 +1792,91 @@ ges_project_load (GESProject * project, GESTimeline * timeline, GError ** error)
   return TRUE;
 }
 
+/**
+ * ges_project_set_trust_saved_metadata:
+ * @project: A #GESProject
+ * @trust: Whether to trust the metadatas saved in @project
+ *
+ * Sets whether the #GESUriClipAsset-s of @project should be created right
+ * away from the duration, streams and metadatas saved in it when loading
+ * it, instead of discovering their files first, so the timeline can be
+ * used as soon as it is loaded. The files are then discovered in the
+ * background, once @project is loaded, and the assets updated.
+ * #GESProject::error-loading-asset is emitted if a file could not be
+ * discovered, or with #GES_ERROR_ASSET_METADATA_MISMATCH if it did not
+ * match what was saved.
+ *
+ * It has to be set before calling ges_project_load().
+ */
+void
+ges_project_set_trust_saved_metadata (GESProject * project, gboolean trust)
+{
+  g_return_if_fail (GES_IS_PROJECT (project));
+
+  project->priv->trust_saved_metadata = trust;
+}
+
+/**
+ * ges_project_get_trust_saved_metadata:
+ * @project: A #GESProject
+ *
+ * Gets whether the metadatas saved in @project are trusted when loading it,
+ * see ges_project_set_trust_saved_metadata().
+ *
+ * Returns: %TRUE if the saved metadatas are trusted, %FALSE otherwise
+ */
+gboolean
+ges_project_get_trust_saved_metadata (GESProject * project)
+{
+  g_return_val_if_fail (GES_IS_PROJECT (project), FALSE);
+
+  return project->priv->trust_saved_metadata;
+}
+
+/**
+ * ges_project_add_search_root:
+ * @project: A #GESProject
+ * @uri: The URI of a directory
+ *
+ * Adds a directory in which to look for the files of the assets of @project
+ * that can not be found anymore, before emitting #GESProject::missing-uri.
+ * @uri and its subdirectories are walked in a background thread as soon as
+ * it is added, following symbolic links, and its files indexed by name, so
+ * many moved files are found at once. When several
+ * files have the same name, the one with the size recorded in the
+ * #GES_META_FILE_SIZE meta of the asset and the most of its path in common
+ * with the missing file is used.
+ *
+ * Once a moved file has been found, the other files of the directory it
+ * was in are directly looked for where it has been found.
+ *
+ * Returns: %TRUE if @uri could be added, %FALSE otherwise
+ */
+gboolean
+ges_project_add_search_root (GESProject * project, const gchar * uri)
+{
+  GFile *root;
+  GESProjectPrivate *priv;
+
+  g_return_val_if_fail (GES_IS_PROJECT (project), FALSE);
+  g_return_val_if_fail (uri, FALSE);
+
+  priv = project->priv;
+  root = g_file_new_for_uri (uri);
+  if (g_file_query_file_type (root, G_FILE_QUERY_INFO_NONE, NULL) !=
+      G_FILE_TYPE_DIRECTORY) {
+    GST_WARNING_OBJECT (project, "%s is not a directory", uri);
+    g_object_unref (root);
+
+    return FALSE;
+  }
+
+  priv->search_roots = g_list_append (priv->search_roots, root);
+  _start_relocation_index (project);
+
+  return TRUE;
+}
+
 /**
  * ges_project_get_uri:
  * @project: A #GESProject
@@ -93,8 +93,13 @@ gboolean  ges_project_save         (GESProject * project,
 gboolean  ges_project_load         (GESProject * project,
                                     GESTimeline * timeline,
                                     GError **error);
+void      ges_project_set_trust_saved_metadata (GESProject * project,
+                                                gboolean trust);
+gboolean  ges_project_get_trust_saved_metadata (GESProject * project);
 GESProject * ges_project_new       (const gchar *uri);
 gchar      * ges_project_get_uri   (GESProject *project);
+gboolean     ges_project_add_search_root (GESProject *project,
+                                          const gchar *uri);
 GESAsset   * ges_project_get_asset (GESProject * project,
                                     const gchar *id,
                                     GType extractable_type);
@@ -103,6 +108,7 @@ gboolean ges_project_create_asset  (GESProject * project,
                                     GType extractable_type);
 
 GList * ges_project_get_loading_assets          (GESProject * project);
+GstStructure * ges_project_get_load_timings     (GESProject * project);
 
 gboolean ges_project_add_encoding_profile       (GESProject *project,
                                                  GstEncodingProfile *profile);
@@ -0,0 +1,922 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:ges-render-cache
+ * @short_description: Pre-renders ranges of a #GESTimeline in the background
+ *
+ * Some parts of a timeline (stacked effects, many composited layers,
+ * titles...) can be too expensive to be played back in realtime. A
+ * #GESRenderCache renders such ranges of a #GESTimeline, in the background,
+ * into intermediate files and substitutes the resulting media to the
+ * original content when playing the timeline back.
+ *
+ * The ranges to cache are added with #ges_render_cache_add_range. A range
+ * is extended so that it completely contains every #GESTrackElement it
+ * overlaps, it is then rendered at idle priority in the default main context
+ * using a second #GESPipeline working on a copy of the range, and once done,
+ * the cached media is used in the tracks of the timeline whose type is
+ * present in the #GstEncodingProfile of the cache. The
+ * #GESRenderCache::range-cached signal is emitted at that point. The cached
+ * media being lossy, it is only used while previewing: a #GESPipeline
+ * rendering the timeline always uses the original content.
+ *
+ * The intermediate files go to the #GESRenderCache:directory, by default a
+ * subdirectory of the directory set in the GES_CACHE_DIRECTORY environment
+ * variable, or of the user cache directory if it is not set.
+ *
+ * Every time the timeline is commited, the ranges that have been modified
+ * since the previous commit are invalidated, and rendered again. Changes the
+ * timeline can not detect by itself (like changes made directly on the
+ * #GstElement-s of a #GESTrackElement rather than through
+ * #ges_track_element_set_child_property and friends) can be notified with
+ * #ges_render_cache_invalidate.
+ */
+
+#include <glib/gstdio.h>
+
+#include "ges-render-cache.h"
+#include "ges.h"
+#include "ges-internal.h"
+
+G_DEFINE_TYPE (GESRenderCache, ges_render_cache, G_TYPE_OBJECT);
+
+typedef enum
+{
+  RANGE_DIRTY,
+  RANGE_RENDERING,
+  RANGE_CACHED,
+  RANGE_FAILED
+} RangeState;
+
+/* A gnlobject we added to a track of the timeline */
+typedef struct
+{
+  GESTrack *track;
+  GstElement *gnlobject;
+} Substitution;
+
+typedef struct
+{
+  GstClockTime start;
+  GstClockTime stop;
+  RangeState state;
+
+  /* The file the range is rendered into */
+  gchar *location;
+
+  /* Only set while rendering */
+  GESPipeline *pipeline;
+  guint bus_watch_id;
+  gboolean seeked;
+
+  /* Only set when cached */
+  GList *substitutions;
+} CacheRange;
+
+struct _GESRenderCachePrivate
+{
+  GESTimeline *timeline;
+  GstEncodingProfile *profile;
+  gchar *directory;
+
+  /* The types of the tracks @profile can render */
+  GESTrackType track_types;
+
+  /* Sorted by start, ranges never overlap */
+  GList *ranges;
+
+  CacheRange *rendering;
+  guint idle_id;
+  guint n_renders;
+};
+
+enum
+{
+  PROP_0,
+  PROP_TIMELINE,
+  PROP_PROFILE,
+  PROP_DIRECTORY,
+  PROP_LAST
+};
+
+static GParamSpec *properties[PROP_LAST];
+
+enum
+{
+  RANGE_CACHED_SIGNAL,
+  LAST_SIGNAL
+};
+
+static guint ges_render_cache_signals[LAST_SIGNAL] = { 0 };
+
+static void _schedule_render (GESRenderCache * self);
+
+/****************************************************
+ *              Ranges management                   *
+ ****************************************************/
+static gint
+_compare_ranges (CacheRange * a, CacheRange * b)
+{
+  if (a->start < b->start)
+    return -1;
+  if (a->start > b->start)
+    return 1;
+
+  return 0;
+}
+
+static inline gboolean
+_range_overlaps (CacheRange * range, GstClockTime start, GstClockTime stop)
+{
+  return range->start < stop && range->stop > start;
+}
+
+static void
+_stop_rendering (GESRenderCache * self, CacheRange * range)
+{
+  if (range->pipeline == NULL)
+    return;
+
+  GST_DEBUG_OBJECT (self, "Stop rendering %" GST_TIME_FORMAT " -- %"
+      GST_TIME_FORMAT, GST_TIME_ARGS (range->start),
+      GST_TIME_ARGS (range->stop));
+
+  g_source_remove (range->bus_watch_id);
+  range->bus_watch_id = 0;
+
+  gst_element_set_state (GST_ELEMENT (range->pipeline), GST_STATE_NULL);
+  gst_object_unref (range->pipeline);
+  range->pipeline = NULL;
+
+  if (self->priv->rendering == range)
+    self->priv->rendering = NULL;
+}
+
+/* Returns: %TRUE if some tracks of the timeline need to be commited */
+static gboolean
+_clear_substitutions (CacheRange * range)
+{
+  gboolean needs_commit = (range->substitutions != NULL);
+
+  while (range->substitutions) {
+    Substitution *sub = range->substitutions->data;
+
+    ges_track_remove_cached_media (sub->track, sub->gnlobject);
+    gst_object_unref (sub->track);
+    g_slice_free (Substitution, sub);
+
+    range->substitutions = g_list_delete_link (range->substitutions,
+        range->substitutions);
+  }
+
+  return needs_commit;
+}
+
+/* Returns: %TRUE if some tracks of the timeline need to be commited */
+static gboolean
+_reset_range (GESRenderCache * self, CacheRange * range)
+{
+  gboolean needs_commit;
+
+  _stop_rendering (self, range);
+  needs_commit = _clear_substitutions (range);
+
+  if (range->location) {
+    g_unlink (range->location);
+    g_free (range->location);
+    range->location = NULL;
+  }
+
+  range->state = RANGE_DIRTY;
+
+  return needs_commit;
+}
+
+static void
+_free_range (CacheRange * range)
+{
+  g_slice_free (CacheRange, range);
+}
+
+static void
+_commit_tracks (GESRenderCache * self)
+{
+  GList *tmp;
+
+  for (tmp = self->priv->timeline->tracks; tmp; tmp = tmp->next) {
+    if (GES_TRACK (tmp->data)->type & self->priv->track_types)
+      ges_track_commit (GES_TRACK (tmp->data));
+  }
+}
+
+/* Makes sure @range fully contains all the TrackElement-s it overlaps in the
+ * tracks we render, so the cached media can replace them completely
+ *
+ * Returns: %TRUE if some tracks of the timeline need to be commited */
+static gboolean
+_expand_range (GESRenderCache * self, CacheRange * range)
+{
+  GList *tmp, *elements, *etmp;
+  GESRenderCachePrivate *priv = self->priv;
+  GstClockTime start = range->start;
+  gboolean expanded = TRUE, needs_commit = FALSE;
+
+  while (expanded) {
+    expanded = FALSE;
+
+    for (tmp = priv->timeline->tracks; tmp; tmp = tmp->next) {
+      GESTrack *track = GES_TRACK (tmp->data);
+
+      if (!(track->type & priv->track_types))
+        continue;
+
+      elements = ges_track_get_elements (track);
+      for (etmp = elements; etmp; etmp = etmp->next) {
+        GESTimelineElement *element = etmp->data;
+
+        if (!_range_overlaps (range, _START (element), _END (element)))
+          continue;
+
+        if (_START (element) < range->start) {
+          range->start = _START (element);
+          expanded = TRUE;
+        }
+
+        if (_END (element) > range->stop) {
+          range->stop = _END (element);
+          expanded = TRUE;
+        }
+      }
+      g_list_free_full (elements, gst_object_unref);
+    }
+
+    /* Ranges never overlap, merge the ones we now cover */
+    for (tmp = priv->ranges; tmp;) {
+      CacheRange *other = tmp->data;
+      GList *next = tmp->next;
+
+      if (other != range && _range_overlaps (other, range->start,
+              range->stop)) {
+        needs_commit |= _reset_range (self, other);
+
+        range->start = MIN (range->start, other->start);
+        range->stop = MAX (range->stop, other->stop);
+        priv->ranges = g_list_delete_link (priv->ranges, tmp);
+        _free_range (other);
+
+        expanded = TRUE;
+      }
+
+      tmp = next;
+    }
+  }
+
+  /* Moving its start might have moved it past other ranges */
+  if (range->start != start) {
+    priv->ranges = g_list_remove (priv->ranges, range);
+    priv->ranges = g_list_insert_sorted (priv->ranges, range,
+        (GCompareFunc) _compare_ranges);
+  }
+
+  return needs_commit;
+}
+
+/****************************************************
+ *              Rendering                           *
+ ****************************************************/
+static GESTrackType
+_get_profile_track_types (GstEncodingProfile * profile)
+{
+  const GList *tmp;
+  GESTrackType types = 0;
+
+  if (GST_IS_ENCODING_AUDIO_PROFILE (profile))
+    return GES_TRACK_TYPE_AUDIO;
+  else if (GST_IS_ENCODING_VIDEO_PROFILE (profile))
+    return GES_TRACK_TYPE_VIDEO;
+  else if (GST_IS_ENCODING_CONTAINER_PROFILE (profile)) {
+    for (tmp = gst_encoding_container_profile_get_profiles
+        (GST_ENCODING_CONTAINER_PROFILE (profile)); tmp; tmp = tmp->next)
+      types |= _get_profile_track_types (tmp->data);
+  }
+
+  return types;
+}
+
+static GstElement *
+_create_cached_source (GESTrack * track, const gchar * uri)
+{
+  GstElement *gnlsrc, *decodebin, *topbin;
+
+  decodebin = gst_element_factory_make ("uridecodebin", NULL);
+  g_object_set (decodebin, "caps", ges_track_get_caps (track),
+      "expose-all-streams", FALSE, "uri", uri, NULL);
+
+  if (track->type == GES_TRACK_TYPE_VIDEO)
+    topbin = ges_source_create_topbin ("cachedvideosrcbin", decodebin,
+        gst_element_factory_make ("videoconvert", NULL),
+        gst_element_factory_make ("videoscale", NULL), NULL);
+  else if (track->type == GES_TRACK_TYPE_AUDIO)
+    topbin = ges_source_create_topbin ("cachedaudiosrcbin", decodebin,
+        gst_element_factory_make ("audioconvert", NULL),
+        gst_element_factory_make ("audioresample", NULL), NULL);
+  else
+    topbin = ges_source_create_topbin ("cachedsrcbin", decodebin, NULL);
+
+  gnlsrc = gst_element_factory_make ("gnlsource", NULL);
+  gst_bin_add (GST_BIN (gnlsrc), topbin);
+
+  return gnlsrc;
+}
+
+static void
+_range_rendered (GESRenderCache * self, CacheRange * range)
+{
+  GList *tmp;
+  gchar *uri;
+  GESRenderCachePrivate *priv = self->priv;
+
+  _stop_rendering (self, range);
+
+  GST_INFO_OBJECT (self, "Rendered %" GST_TIME_FORMAT " -- %" GST_TIME_FORMAT
+      " into %s", GST_TIME_ARGS (range->start), GST_TIME_ARGS (range->stop),
+      range->location);
+
+  uri = gst_filename_to_uri (range->location, NULL);
+  for (tmp = priv->timeline->tracks; tmp; tmp = tmp->next) {
+    Substitution *sub;
+    GstElement *gnlobject;
+    GESTrack *track = GES_TRACK (tmp->data);
+
+    if (!(track->type & priv->track_types))
+      continue;
+
+    gnlobject = _create_cached_source (track, uri);
+    if (!ges_track_add_cached_media (track, gnlobject, range->start,
+            range->stop - range->start)) {
+      /* The content of the range changed and nobody told us, start again */
+      GST_WARNING_OBJECT (self, "Could not use cached media in %"
+          GST_PTR_FORMAT, track);
+      gst_object_unref (gnlobject);
+      _reset_range (self, range);
+
+      goto done;
+    }
+
+    sub = g_slice_new (Substitution);
+    sub->track = gst_object_ref (track);
+    sub->gnlobject = gnlobject;
+    range->substitutions = g_list_prepend (range->substitutions, sub);
+  }
+
+  range->state = RANGE_CACHED;
+
+  g_signal_emit (self, ges_render_cache_signals[RANGE_CACHED_SIGNAL], 0,
+      range->start, range->stop - range->start);
+
+done:
+  _commit_tracks (self);
+  g_free (uri);
+
+  _schedule_render (self);
+}
+
+static void
+_range_failed (GESRenderCache * self, CacheRange * range)
+{
+  _reset_range (self, range);
+  range->state = RANGE_FAILED;
+
+  _schedule_render (self);
+}
+
+static gboolean
+_bus_message_cb (GstBus * bus, GstMessage * message, GESRenderCache * self)
+{
+  CacheRange *range = self->priv->rendering;
+
+  if (G_UNLIKELY (range == NULL))
+    return TRUE;
+
+  switch (GST_MESSAGE_TYPE (message)) {
+    case GST_MESSAGE_ASYNC_DONE:
+      if (range->seeked)
+        break;
+
+      /* Prerolled, we can now render only what we are interested in */
+      range->seeked = TRUE;
+      if (!gst_element_seek (GST_ELEMENT (range->pipeline), 1.0,
+              GST_FORMAT_TIME, GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_ACCURATE,
+              GST_SEEK_TYPE_SET, range->start, GST_SEEK_TYPE_SET,
+              range->stop)) {
+        GST_WARNING_OBJECT (self, "Could not seek to %" GST_TIME_FORMAT,
+            GST_TIME_ARGS (range->start));
+        _range_failed (self, range);
+
+        break;
+      }
+
+      gst_element_set_state (GST_ELEMENT (range->pipeline),
+          GST_STATE_PLAYING);
+      break;
+    case GST_MESSAGE_EOS:
+      _range_rendered (self, range);
+      break;
+    case GST_MESSAGE_ERROR:
+    {
+      GError *err = NULL;
+      gchar *dbg_info = NULL;
+
+      gst_message_parse_error (message, &err, &dbg_info);
+      GST_WARNING_OBJECT (self, "Error rendering %" GST_TIME_FORMAT " -- %"
+          GST_TIME_FORMAT ": %s (%s)", GST_TIME_ARGS (range->start),
+          GST_TIME_ARGS (range->stop), err ? err->message : "unknown",
+          dbg_info ? dbg_info : "none");
+      g_clear_error (&err);
+      g_free (dbg_info);
+
+      _range_failed (self, range);
+      break;
+    }
+    default:
+      break;
+  }
+
+  return TRUE;
+}
+
+static void
+_render_range (GESRenderCache * self, CacheRange * range)
+{
+  GstBus *bus;
+  gchar *uri, *filename;
+  GESTimeline *copy;
+  GESRenderCachePrivate *priv = self->priv;
+
+  /* Cached media of the ranges we merged stop being used */
+  if (_expand_range (self, range))
+    _commit_tracks (self);
+
+  GST_DEBUG_OBJECT (self, "Rendering %" GST_TIME_FORMAT " -- %"
+      GST_TIME_FORMAT, GST_TIME_ARGS (range->start),
+      GST_TIME_ARGS (range->stop));
+
+  filename = g_strdup_printf ("ges-render-cache-%p-%u", self,
+      priv->n_renders++);
+  range->location = g_build_filename (priv->directory, filename, NULL);
+  uri = gst_filename_to_uri (range->location, NULL);
+  g_free (filename);
+
+  /* The pipeline takes its own reference */
+  copy = gst_object_ref_sink (timeline_copy (priv->timeline,
+          priv->track_types, range->start, range->stop));
+  range->pipeline = ges_pipeline_new ();
+  if (!ges_pipeline_add_timeline (range->pipeline, copy))
+    goto failed;
+
+  if (!ges_pipeline_set_render_settings (range->pipeline, uri, priv->profile)
+      || !ges_pipeline_set_mode (range->pipeline, TIMELINE_MODE_RENDER))
+    goto failed;
+
+  ges_timeline_commit (copy);
+
+  bus = gst_pipeline_get_bus (GST_PIPELINE (range->pipeline));
+  range->bus_watch_id = gst_bus_add_watch (bus, (GstBusFunc) _bus_message_cb,
+      self);
+  gst_object_unref (bus);
+
+  range->seeked = FALSE;
+  range->state = RANGE_RENDERING;
+  priv->rendering = range;
+
+  if (gst_element_set_state (GST_ELEMENT (range->pipeline),
+          GST_STATE_PAUSED) == GST_STATE_CHANGE_FAILURE)
+    goto failed;
+
+  gst_object_unref (copy);
+  g_free (uri);
+
+  return;
+
+failed:
+  {
+    GST_WARNING_OBJECT (self, "Could not render %" GST_TIME_FORMAT " -- %"
+        GST_TIME_FORMAT, GST_TIME_ARGS (range->start),
+        GST_TIME_ARGS (range->stop));
+
+    if (range->bus_watch_id == 0) {
+      gst_object_unref (range->pipeline);
+      range->pipeline = NULL;
+    }
+    gst_object_unref (copy);
+    g_free (uri);
+    _range_failed (self, range);
+  }
+}
+
+static gboolean
+_render_next_idle (GESRenderCache * self)
+{
+  GList *tmp;
+
+  self->priv->idle_id = 0;
+
+  for (tmp = self->priv->ranges; tmp; tmp = tmp->next) {
+    CacheRange *range = tmp->data;
+
+    if (range->state == RANGE_DIRTY) {
+      _render_range (self, range);
+
+      break;
+    }
+  }
+
+  return FALSE;
+}
+
+static void
+_schedule_render (GESRenderCache * self)
+{
+  GESRenderCachePrivate *priv = self->priv;
+
+  if (priv->idle_id || priv->rendering)
+    return;
+
+  priv->idle_id = g_idle_add_full (G_PRIORITY_LOW,
+      (GSourceFunc) _render_next_idle, self, NULL);
+}
+
+/****************************************************
+ *              GObject vmethods                    *
+ ****************************************************/
+static void
+ges_render_cache_get_property (GObject * object, guint property_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GESRenderCachePrivate *priv = GES_RENDER_CACHE (object)->priv;
+
+  switch (property_id) {
+    case PROP_TIMELINE:
+      g_value_set_object (value, priv->timeline);
+      break;
+    case PROP_PROFILE:
+      g_value_set_object (value, priv->profile);
+      break;
+    case PROP_DIRECTORY:
+      g_value_set_string (value, priv->directory);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+  }
+}
+
+static void
+ges_render_cache_set_property (GObject * object, guint property_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GESRenderCachePrivate *priv = GES_RENDER_CACHE (object)->priv;
+
+  switch (property_id) {
+    case PROP_TIMELINE:
+      priv->timeline = g_value_dup_object (value);
+      break;
+    case PROP_PROFILE:
+      priv->profile = g_value_dup_object (value);
+      break;
+    case PROP_DIRECTORY:
+      g_free (priv->directory);
+      priv->directory = g_value_dup_string (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+  }
+}
+
+static void
+ges_render_cache_constructed (GObject * object)
+{
+  GESRenderCache *self = GES_RENDER_CACHE (object);
+  GESRenderCachePrivate *priv = self->priv;
+
+  if (priv->directory == NULL)
+    priv->directory = ges_get_cache_directory ("render-cache");
+  else if (g_mkdir_with_parents (priv->directory, 0755))
+    GST_WARNING_OBJECT (self, "Could not create %s", priv->directory);
+
+  if (priv->profile)
+    priv->track_types = _get_profile_track_types (priv->profile);
+
+  if (priv->timeline)
+    timeline_add_render_cache (priv->timeline, self);
+
+  G_OBJECT_CLASS (ges_render_cache_parent_class)->constructed (object);
+}
+
+static void
+ges_render_cache_dispose (GObject * object)
+{
+  GList *tmp;
+  GESRenderCache *self = GES_RENDER_CACHE (object);
+  GESRenderCachePrivate *priv = self->priv;
+  gboolean needs_commit = FALSE;
+
+  if (priv->idle_id) {
+    g_source_remove (priv->idle_id);
+    priv->idle_id = 0;
+  }
+
+  for (tmp = priv->ranges; tmp; tmp = tmp->next)
+    needs_commit |= _reset_range (self, tmp->data);
+  g_list_free_full (priv->ranges, (GDestroyNotify) _free_range);
+  priv->ranges = NULL;
+
+  if (priv->timeline) {
+    timeline_remove_render_cache (priv->timeline, self);
+
+    if (needs_commit)
+      _commit_tracks (self);
+
+    gst_object_unref (priv->timeline);
+    priv->timeline = NULL;
+  }
+
+  if (priv->profile) {
+    gst_encoding_profile_unref (priv->profile);
+    priv->profile = NULL;
+  }
+
+  G_OBJECT_CLASS (ges_render_cache_parent_class)->dispose (object);
+}
+
+static void
+ges_render_cache_finalize (GObject * object)
+{
+  g_free (GES_RENDER_CACHE (object)->priv->directory);
+
+  G_OBJECT_CLASS (ges_render_cache_parent_class)->finalize (object);
+}
+
+static void
+ges_render_cache_class_init (GESRenderCacheClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  g_type_class_add_private (klass, sizeof (GESRenderCachePrivate));
+
+  object_class->get_property = ges_render_cache_get_property;
+  object_class->set_property = ges_render_cache_set_property;
+  object_class->constructed = ges_render_cache_constructed;
+  object_class->dispose = ges_render_cache_dispose;
+  object_class->finalize = ges_render_cache_finalize;
+
+  /**
+   * GESRenderCache:timeline:
+   *
+   * The #GESTimeline whose ranges are cached
+   */
+  properties[PROP_TIMELINE] = g_param_spec_object ("timeline", "Timeline",
+      "The timeline whose ranges are cached", GES_TYPE_TIMELINE,
+      G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY);
+  g_object_class_install_property (object_class, PROP_TIMELINE,
+      properties[PROP_TIMELINE]);
+
+  /**
+   * GESRenderCache:profile:
+   *
+   * The #GstEncodingProfile used to render the cached ranges. Only
+   * the tracks for which it has a stream profile use cached media.
+   */
+  properties[PROP_PROFILE] = g_param_spec_object ("profile", "Profile",
+      "The encoding profile used to render cached ranges",
+      GST_TYPE_ENCODING_PROFILE, G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY);
+  g_object_class_install_property (object_class, PROP_PROFILE,
+      properties[PROP_PROFILE]);
+
+  /**
+   * GESRenderCache:directory:
+   *
+   * The directory in which the cached ranges are rendered, defaults
+   * to a subdirectory of $GES_CACHE_DIRECTORY or of the user cache
+   * directory.
+   */
+  properties[PROP_DIRECTORY] = g_param_spec_string ("directory", "Directory",
+      "The directory in which cached ranges are rendered", NULL,
+      G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY);
+  g_object_class_install_property (object_class, PROP_DIRECTORY,
+      properties[PROP_DIRECTORY]);
+
+  /**
+   * GESRenderCache::range-cached:
+   * @cache: the #GESRenderCache
+   * @start: the start of the range that is now cached
+   * @duration: the duration of the range that is now cached
+   *
+   * Will be emitted once a range has been rendered and its cached media
+   * is used by the timeline.
+   */
+  ges_render_cache_signals[RANGE_CACHED_SIGNAL] =
+      g_signal_new ("range-cached", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST, 0, NULL, NULL, g_cclosure_marshal_generic,
+      G_TYPE_NONE, 2, G_TYPE_UINT64, G_TYPE_UINT64);
+}
+
+static void
+ges_render_cache_init (GESRenderCache * self)
+{
+  self->priv = G_TYPE_INSTANCE_GET_PRIVATE (self,
+      GES_TYPE_RENDER_CACHE, GESRenderCachePrivate);
+
+  self->priv->ranges = NULL;
+  self->priv->rendering = NULL;
+  self->priv->idle_id = 0;
+  self->priv->n_renders = 0;
+}
+
+/****************************************************
+ *              API implementation                  *
+ ****************************************************/
+
+/**
+ * ges_render_cache_new:
+ * @timeline: the #GESTimeline to cache ranges of
+ * @profile: the #GstEncodingProfile to use to render the ranges
+ * @directory: (allow-none): the directory to render the ranges into, or %NULL
+ * to use the default one
+ *
+ * Creates a new #GESRenderCache for @timeline.
+ *
+ * Returns: The newly created #GESRenderCache
+ */
+GESRenderCache *
+ges_render_cache_new (GESTimeline * timeline, GstEncodingProfile * profile,
+    const gchar * directory)
+{
+  g_return_val_if_fail (GES_IS_TIMELINE (timeline), NULL);
+  g_return_val_if_fail (GST_IS_ENCODING_PROFILE (profile), NULL);
+
+  return g_object_new (GES_TYPE_RENDER_CACHE, "timeline", timeline,
+      "profile", profile, "directory", directory, NULL);
+}
+
+/**
+ * ges_render_cache_add_range:
+ * @cache: a #GESRenderCache
+ * @start: the start of the range to cache
+ * @duration: the duration of the range to cache
+ *
+ * Adds a range of the timeline to be rendered in the background and
+ * replaced by the resulting media. The range will be extended so it
+ * fully contains every #GESTrackElement it overlaps.
+ *
+ * Returns: %TRUE if the range could be added, %FALSE if it overlaps a range
+ * that is already handled by @cache.
+ */
+gboolean
+ges_render_cache_add_range (GESRenderCache * cache, GstClockTime start,
+    GstClockTime duration)
+{
+  GList *tmp;
+  CacheRange *range;
+  GstClockTime stop;
+  GESRenderCachePrivate *priv;
+
+  g_return_val_if_fail (GES_IS_RENDER_CACHE (cache), FALSE);
+  g_return_val_if_fail (GST_CLOCK_TIME_IS_VALID (start), FALSE);
+  g_return_val_if_fail (GST_CLOCK_TIME_IS_VALID (duration), FALSE);
+  g_return_val_if_fail (duration > 0, FALSE);
+
+  priv = cache->priv;
+  stop = start + duration;
+
+  for (tmp = priv->ranges; tmp; tmp = tmp->next) {
+    if (_range_overlaps (tmp->data, start, stop)) {
+      GST_INFO_OBJECT (cache, "%" GST_TIME_FORMAT " -- %" GST_TIME_FORMAT
+          " is already cached", GST_TIME_ARGS (start), GST_TIME_ARGS (stop));
+
+      return FALSE;
+    }
+  }
+
+  range = g_slice_new0 (CacheRange);
+  range->start = start;
+  range->stop = stop;
+  range->state = RANGE_DIRTY;
+  priv->ranges = g_list_insert_sorted (priv->ranges, range,
+      (GCompareFunc) _compare_ranges);
+
+  _schedule_render (cache);
+
+  return TRUE;
+}
+
+/**
+ * ges_render_cache_invalidate:
+ * @cache: a #GESRenderCache
+ * @start: the start of the range that changed
+ * @duration: the duration of the range that changed
+ *
+ * Lets @cache know that the content of the timeline changed between @start
+ * and @start + @duration. The cached ranges overlapping it stop being used
+ * and will be rendered again. This is done automatically on
+ * #ges_timeline_commit for all changes the timeline knows about, the changes
+ * will take effect on the next commit of the timeline.
+ */
+void
+ges_render_cache_invalidate (GESRenderCache * cache, GstClockTime start,
+    GstClockTime duration)
+{
+  GList *tmp;
+  GstClockTime stop;
+  gboolean invalidated = FALSE;
+
+  g_return_if_fail (GES_IS_RENDER_CACHE (cache));
+  g_return_if_fail (GST_CLOCK_TIME_IS_VALID (start));
+
+  if (!GST_CLOCK_TIME_IS_VALID (duration))
+    stop = G_MAXUINT64;
+  else
+    stop = start + MAX (duration, 1);
+
+  for (tmp = cache->priv->ranges; tmp; tmp = tmp->next) {
+    CacheRange *range = tmp->data;
+
+    if (!_range_overlaps (range, start, stop))
+      continue;
+
+    GST_DEBUG_OBJECT (cache, "Invalidating %" GST_TIME_FORMAT " -- %"
+        GST_TIME_FORMAT, GST_TIME_ARGS (range->start),
+        GST_TIME_ARGS (range->stop));
+
+    _reset_range (cache, range);
+    invalidated = TRUE;
+  }
+
+  if (invalidated)
+    _schedule_render (cache);
+}
+
+/**
+ * ges_render_cache_is_cached:
+ * @cache: a #GESRenderCache
+ * @position: a position in the timeline
+ *
+ * Checks whether cached media is currently used at @position.
+ *
+ * Returns: %TRUE if @position is in a range that has been rendered and is
+ * in use, %FALSE otherwise.
+ */
+gboolean
+ges_render_cache_is_cached (GESRenderCache * cache, GstClockTime position)
+{
+  GList *tmp;
+
+  g_return_val_if_fail (GES_IS_RENDER_CACHE (cache), FALSE);
+
+  for (tmp = cache->priv->ranges; tmp; tmp = tmp->next) {
+    CacheRange *range = tmp->data;
+
+    if (range->state == RANGE_CACHED && range->start <= position &&
+        position < range->stop)
+      return TRUE;
+  }
+
+  return FALSE;
+}
+
+/* Returns the URI of the media @cache rendered for a range covering
+ * [@start, @stop[ or %NULL if no such range is currently cached */
+gchar *
+ges_render_cache_get_cached_uri (GESRenderCache * cache,
+    GESTrackType track_type, GstClockTime start, GstClockTime stop)
+{
+  GList *tmp;
+
+  if (!(cache->priv->track_types & track_type))
+    return NULL;
+
+  for (tmp = cache->priv->ranges; tmp; tmp = tmp->next) {
+    CacheRange *range = tmp->data;
+
+    if (range->state == RANGE_CACHED && range->start <= start &&
+        stop <= range->stop)
+      return gst_filename_to_uri (range->location, NULL);
+  }
+
+  return NULL;
+}
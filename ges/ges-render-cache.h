@@ -0,0 +1,66 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef GES_RENDER_CACHE_H
+#define GES_RENDER_CACHE_H
+
+#include <glib-object.h>
+#include <gst/gst.h>
+#include <gst/pbutils/encoding-profile.h>
+#include <ges/ges-types.h>
+
+G_BEGIN_DECLS
+
+#define GES_TYPE_RENDER_CACHE (ges_render_cache_get_type ())
+#define GES_RENDER_CACHE(obj) (G_TYPE_CHECK_INSTANCE_CAST ((obj), GES_TYPE_RENDER_CACHE, GESRenderCache))
+#define GES_RENDER_CACHE_CLASS(klass) (G_TYPE_CHECK_CLASS_CAST ((klass), GES_TYPE_RENDER_CACHE, GESRenderCacheClass))
+#define GES_IS_RENDER_CACHE(obj) (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GES_TYPE_RENDER_CACHE))
+#define GES_IS_RENDER_CACHE_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), GES_TYPE_RENDER_CACHE))
+#define GES_RENDER_CACHE_GET_CLASS(obj) (G_TYPE_INSTANCE_GET_CLASS ((obj), GES_TYPE_RENDER_CACHE, GESRenderCacheClass))
+
+typedef struct _GESRenderCachePrivate GESRenderCachePrivate;
+
+struct _GESRenderCache {
+  GObject parent;
+
+  /*< private >*/
+  GESRenderCachePrivate *priv;
+
+  gpointer _ges_reserved[GES_PADDING];
+};
+
+struct _GESRenderCacheClass {
+  GObjectClass parent_class;
+
+  gpointer _ges_reserved[GES_PADDING];
+};
+
+GType ges_render_cache_get_type            (void);
+GESRenderCache *ges_render_cache_new       (GESTimeline *timeline,
+                                            GstEncodingProfile *profile,
+                                            const gchar *directory);
+gboolean ges_render_cache_add_range        (GESRenderCache *cache,
+                                            GstClockTime start,
+                                            GstClockTime duration);
+void ges_render_cache_invalidate           (GESRenderCache *cache,
+                                            GstClockTime start,
+                                            GstClockTime duration);
+gboolean ges_render_cache_is_cached        (GESRenderCache *cache,
+                                            GstClockTime position);
+
+G_END_DECLS
+#endif /* GES_RENDER_CACHE_H */
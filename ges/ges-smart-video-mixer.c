@@ -40,18 +40,46 @@ static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink_%u",
     GST_STATIC_CAPS ("video/x-raw")
     );
 
+enum
+{
+  PROP_0,
+  PROP_N_THREADS,
+};
+
+/* An horizontal stripe of the output, blended by its own mixer */
+typedef struct _Stripe
+{
+  GstElement *mixer;
+  GstElement *capsfilter;       /* Restricts the mixer output to the stripe */
+  GstPad *final_pad;            /* Pad of the mixer stitching the stripes */
+  gint top;
+} Stripe;
+
+typedef struct _StripePad
+{
+  Stripe *stripe;
+  GstPad *mixer_pad;
+  gulong probe_id;
+} StripePad;
+
 typedef struct _PadInfos
 {
   GESSmartMixer *self;
   GstPad *mixer_pad;
   GstElement *bin;
   gulong probe_id;
+
+  /* StripePad-s, when compositing in stripes */
+  GList *stripe_pads;
 } PadInfos;
 
 static void
 destroy_pad (PadInfos * infos)
 {
-  gst_pad_remove_probe (infos->mixer_pad, infos->probe_id);
+  GList *tmp;
+
+  if (infos->mixer_pad)
+    gst_pad_remove_probe (infos->mixer_pad, infos->probe_id);
 
   if (G_LIKELY (infos->bin)) {
     gst_element_set_state (infos->bin, GST_STATE_NULL);
@@ -62,13 +90,24 @@ destroy_pad (PadInfos * infos)
   if (infos->mixer_pad)
     gst_element_release_request_pad (infos->self->mixer, infos->mixer_pad);
 
+  for (tmp = infos->stripe_pads; tmp; tmp = tmp->next) {
+    StripePad *spad = tmp->data;
+
+    gst_pad_remove_probe (spad->mixer_pad, spad->probe_id);
+    gst_element_release_request_pad (spad->stripe->mixer, spad->mixer_pad);
+    gst_object_unref (spad->mixer_pad);
+    g_slice_free (StripePad, spad);
+  }
+  g_list_free (infos->stripe_pads);
+
   g_slice_free (PadInfos, infos);
 }
 
 /* These metadata will get set by the upstream framepositionner element,
-   added in the video sources' bin */
+   added in the video sources' bin. When compositing in stripes, the
+   positions are made relative to the top of @stripe */
 static GstPadProbeReturn
-parse_metadata (GstPad * mixer_pad, GstPadProbeInfo * info, gpointer unused)
+parse_metadata (GstPad * mixer_pad, GstPadProbeInfo * info, Stripe * stripe)
 {
   GstFramePositionnerMeta *meta;
 
@@ -82,11 +121,182 @@ parse_metadata (GstPad * mixer_pad, GstPadProbeInfo * info, gpointer unused)
   }
 
   g_object_set (mixer_pad, "alpha", meta->alpha, "xpos", meta->posx, "ypos",
-      meta->posy, "zorder", meta->zorder, NULL);
+      meta->posy - (stripe ? stripe->top : 0), "zorder", meta->zorder, NULL);
 
   return GST_PAD_PROBE_OK;
 }
 
+/****************************************************
+ *              Stripes compositing                 *
+ ****************************************************/
+/* Gets the size of the output from the restriction caps of the track */
+static gboolean
+get_output_size (GESSmartMixer * self, gint * width, gint * height)
+{
+  guint scale;
+  GstCaps *caps = NULL;
+  gboolean ret = FALSE;
+
+  if (self->track == NULL)
+    return FALSE;
+
+  g_object_get (self->track, "restriction-caps", &caps, NULL);
+  if (caps && gst_caps_get_size (caps) > 0) {
+    GstStructure *structure = gst_caps_get_structure (caps, 0);
+
+    if (gst_structure_get_int (structure, "height", height)) {
+      if (!gst_structure_get_int (structure, "width", width))
+        *width = 0;
+
+      /* Follow the downscaling of preview pipelines */
+      scale = ges_track_get_preview_scale (self->track);
+      if (scale > 1) {
+        *height = MAX (*height / (gint) scale, 1);
+        if (*width > 0)
+          *width = MAX (*width / (gint) scale, 1);
+      }
+      ret = TRUE;
+    }
+  }
+
+  if (caps)
+    gst_caps_unref (caps);
+
+  return ret;
+}
+
+/* Called with the lock */
+static void
+update_stripes_layout (GESSmartMixer * self)
+{
+  guint i;
+  gint width, height, top, bottom;
+
+  if (!get_output_size (self, &width, &height)) {
+    GST_WARNING_OBJECT (self, "Output height unknown, keeping stripes as is");
+    return;
+  }
+
+  for (i = 0; i < self->stripes->len; i++) {
+    GstCaps *caps;
+    Stripe *stripe = g_ptr_array_index (self->stripes, i);
+
+    top = height * i / self->stripes->len;
+    bottom = height * (i + 1) / self->stripes->len;
+
+    caps = gst_caps_new_simple ("video/x-raw", "height", G_TYPE_INT,
+        MAX (bottom - top, 1), NULL);
+    if (width > 0)
+      gst_caps_set_simple (caps, "width", G_TYPE_INT, width, NULL);
+
+    GST_DEBUG_OBJECT (self, "Stripe %u from %d to %d", i, top, bottom);
+    stripe->top = top;
+    g_object_set (stripe->capsfilter, "caps", caps, NULL);
+    g_object_set (stripe->final_pad, "ypos", top, NULL);
+    gst_caps_unref (caps);
+  }
+}
+
+static void
+_restriction_changed_cb (GESTrack * track, GParamSpec * arg G_GNUC_UNUSED,
+    GESSmartMixer * self)
+{
+  LOCK (self);
+  update_stripes_layout (self);
+  UNLOCK (self);
+}
+
+/* Called with the lock, creates the mixers blending each stripe the first
+ * time a pad is requested */
+static void
+ensure_stripes (GESSmartMixer * self)
+{
+  guint i, n_stripes;
+  gint width, height;
+
+  if (self->stripes || self->n_threads < 2 ||
+      !get_output_size (self, &width, &height))
+    return;
+
+  n_stripes = MIN (self->n_threads, (guint) height);
+  GST_INFO_OBJECT (self, "Compositing in %u stripes", n_stripes);
+
+  self->stripes = g_ptr_array_new_with_free_func (g_free);
+  for (i = 0; i < n_stripes; i++) {
+    GstPad *srcpad;
+    Stripe *stripe = g_new0 (Stripe, 1);
+
+    stripe->mixer = gst_element_factory_make ("videomixer", NULL);
+    g_object_set (stripe->mixer, "background", 1, NULL);
+    stripe->capsfilter = gst_element_factory_make ("capsfilter", NULL);
+    gst_bin_add_many (GST_BIN (self), stripe->mixer, stripe->capsfilter,
+        NULL);
+    gst_element_link_pads_full (stripe->mixer, "src", stripe->capsfilter,
+        "sink", GST_PAD_LINK_CHECK_NOTHING);
+
+    stripe->final_pad = gst_element_get_request_pad (self->mixer, "sink_%u");
+    srcpad = gst_element_get_static_pad (stripe->capsfilter, "src");
+    gst_pad_link (srcpad, stripe->final_pad);
+    gst_object_unref (srcpad);
+
+    gst_element_sync_state_with_parent (stripe->capsfilter);
+    gst_element_sync_state_with_parent (stripe->mixer);
+    g_ptr_array_add (self->stripes, stripe);
+  }
+
+  update_stripes_layout (self);
+  self->restriction_changed_id = g_signal_connect (self->track,
+      "notify::restriction-caps", G_CALLBACK (_restriction_changed_cb), self);
+}
+
+/* Feeds the output of @convert to the mixer of each stripe, through a
+ * queue so that each stripe gets blended in its own thread */
+static void
+link_to_stripes (GESSmartMixer * self, PadInfos * infos, GstElement * convert)
+{
+  guint i;
+  GstPad *teepad, *pad, *ghost;
+  GstElement *tee = gst_element_factory_make ("tee", NULL);
+
+  gst_bin_add (GST_BIN (infos->bin), tee);
+  gst_element_link_pads_full (convert, "src", tee, "sink",
+      GST_PAD_LINK_CHECK_NOTHING);
+  gst_element_sync_state_with_parent (tee);
+
+  for (i = 0; i < self->stripes->len; i++) {
+    StripePad *spad = g_slice_new0 (StripePad);
+    GstElement *queue = gst_element_factory_make ("queue", NULL);
+
+    /* Frames can be big, the input is already decoupled upstream */
+    g_object_set (queue, "max-size-buffers", (guint) 2, "max-size-bytes",
+        (guint) 0, "max-size-time", (guint64) 0, NULL);
+    gst_bin_add (GST_BIN (infos->bin), queue);
+
+    teepad = gst_element_get_request_pad (tee, "src_%u");
+    pad = gst_element_get_static_pad (queue, "sink");
+    gst_pad_link (teepad, pad);
+    gst_object_unref (teepad);
+    gst_object_unref (pad);
+
+    pad = gst_element_get_static_pad (queue, "src");
+    ghost = gst_ghost_pad_new (NULL, pad);
+    gst_object_unref (pad);
+    gst_pad_set_active (ghost, TRUE);
+    gst_element_add_pad (infos->bin, ghost);
+    gst_element_sync_state_with_parent (queue);
+
+    spad->stripe = g_ptr_array_index (self->stripes, i);
+    spad->mixer_pad = gst_element_get_request_pad (spad->stripe->mixer,
+        "sink_%u");
+    gst_pad_link (ghost, spad->mixer_pad);
+    spad->probe_id = gst_pad_add_probe (spad->mixer_pad,
+        GST_PAD_PROBE_TYPE_BUFFER, (GstPadProbeCallback) parse_metadata,
+        spad->stripe, NULL);
+
+    infos->stripe_pads = g_list_append (infos->stripe_pads, spad);
+  }
+}
+
 /****************************************************
  *              GstElement vmetods                  *
  ****************************************************/
@@ -100,14 +310,21 @@ _request_new_pad (GstElement * element, GstPadTemplate * templ,
   GstPad *ghost;
   GstElement *videoconvert;
 
-  infos->mixer_pad = gst_element_request_pad (self->mixer,
-      gst_element_class_get_pad_template (GST_ELEMENT_GET_CLASS (self->mixer),
-          "sink_%u"), NULL, NULL);
+  LOCK (self);
+  ensure_stripes (self);
+  UNLOCK (self);
+
+  if (self->stripes == NULL) {
+    infos->mixer_pad = gst_element_request_pad (self->mixer,
+        gst_element_class_get_pad_template (GST_ELEMENT_GET_CLASS
+            (self->mixer), "sink_%u"), NULL, NULL);
 
-  if (infos->mixer_pad == NULL) {
-    GST_WARNING_OBJECT (element, "Could not get any pad from GstMixer");
+    if (infos->mixer_pad == NULL) {
+      GST_WARNING_OBJECT (element, "Could not get any pad from GstMixer");
+      g_slice_free (PadInfos, infos);
 
-    return NULL;
+      return NULL;
+    }
   }
 
   infos->self = self;
@@ -129,16 +346,20 @@ _request_new_pad (GstElement * element, GstPadTemplate * templ,
   if (!gst_element_add_pad (GST_ELEMENT (self), ghost))
     goto could_not_add;
 
-  videoconvert_srcpad = gst_element_get_static_pad (videoconvert, "src");
-  tmpghost = GST_PAD (gst_ghost_pad_new (NULL, videoconvert_srcpad));
-  gst_object_unref (videoconvert_srcpad);
-  gst_pad_set_active (tmpghost, TRUE);
-  gst_element_add_pad (GST_ELEMENT (infos->bin), tmpghost);
-  gst_pad_link (tmpghost, infos->mixer_pad);
-
-  infos->probe_id =
-      gst_pad_add_probe (infos->mixer_pad, GST_PAD_PROBE_TYPE_BUFFER,
-      (GstPadProbeCallback) parse_metadata, NULL, NULL);
+  if (self->stripes) {
+    link_to_stripes (self, infos, videoconvert);
+  } else {
+    videoconvert_srcpad = gst_element_get_static_pad (videoconvert, "src");
+    tmpghost = GST_PAD (gst_ghost_pad_new (NULL, videoconvert_srcpad));
+    gst_object_unref (videoconvert_srcpad);
+    gst_pad_set_active (tmpghost, TRUE);
+    gst_element_add_pad (GST_ELEMENT (infos->bin), tmpghost);
+    gst_pad_link (tmpghost, infos->mixer_pad);
+
+    infos->probe_id =
+        gst_pad_add_probe (infos->mixer_pad, GST_PAD_PROBE_TYPE_BUFFER,
+        (GstPadProbeCallback) parse_metadata, NULL, NULL);
+  }
 
   LOCK (self);
   g_hash_table_insert (self->pads_infos, ghost, infos);
@@ -168,11 +389,62 @@ _release_pad (GstElement * element, GstPad * pad)
 /****************************************************
  *              GObject vmethods                    *
  ****************************************************/
+static void
+ges_smart_mixer_get_property (GObject * object, guint property_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GESSmartMixer *self = GES_SMART_MIXER (object);
+
+  switch (property_id) {
+    case PROP_N_THREADS:
+      g_value_set_uint (value, self->n_threads);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+  }
+}
+
+static void
+ges_smart_mixer_set_property (GObject * object, guint property_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GESSmartMixer *self = GES_SMART_MIXER (object);
+
+  switch (property_id) {
+    case PROP_N_THREADS:
+      LOCK (self);
+      if (self->stripes)
+        GST_WARNING_OBJECT (self, "Already compositing in %u stripes, can't"
+            " change the number of threads", self->stripes->len);
+      else
+        self->n_threads = g_value_get_uint (value);
+      UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+  }
+}
+
+static void
+ges_smart_mixer_dispose (GObject * object)
+{
+  GESSmartMixer *self = GES_SMART_MIXER (object);
+
+  if (self->restriction_changed_id) {
+    g_signal_handler_disconnect (self->track, self->restriction_changed_id);
+    self->restriction_changed_id = 0;
+  }
+
+  G_OBJECT_CLASS (ges_smart_mixer_parent_class)->dispose (object);
+}
+
 static void
 ges_smart_mixer_finalize (GObject * object)
 {
   GESSmartMixer *self = GES_SMART_MIXER (object);
 
+  if (self->stripes)
+    g_ptr_array_unref (self->stripes);
   g_mutex_clear (&self->lock);
 
   G_OBJECT_CLASS (ges_smart_mixer_parent_class)->finalize (object);
@@ -199,7 +471,23 @@ ges_smart_mixer_class_init (GESSmartMixerClass * klass)
   element_class->request_new_pad = GST_DEBUG_FUNCPTR (_request_new_pad);
   element_class->release_pad = GST_DEBUG_FUNCPTR (_release_pad);
 
+  object_class->get_property = ges_smart_mixer_get_property;
+  object_class->set_property = ges_smart_mixer_set_property;
+  object_class->dispose = ges_smart_mixer_dispose;
   object_class->finalize = ges_smart_mixer_finalize;
+
+  /**
+   * GESSmartMixer:n-threads:
+   *
+   * Number of horizontal stripes the output frames are split in, each of
+   * them being blended by its own mixer running in its own thread. Stripes
+   * are only used when the height of the output is known from the track
+   * restriction caps. Can not be changed once the first pad is requested.
+   */
+  g_object_class_install_property (object_class, PROP_N_THREADS,
+      g_param_spec_uint ("n-threads", "Number of threads",
+          "Number of threads compositing horizontal stripes of the output",
+          1, 64, 1, G_PARAM_READWRITE));
 }
 
 static void
@@ -208,6 +496,9 @@ ges_smart_mixer_init (GESSmartMixer * self)
   GstPad *pad;
 
   g_mutex_init (&self->lock);
+  self->n_threads = 1;
+  self->stripes = NULL;
+  self->restriction_changed_id = 0;
 
   self->mixer = gst_element_factory_make ("videomixer", "smart-mixer-mixer");
   g_object_set (self->mixer, "background", 1, NULL);
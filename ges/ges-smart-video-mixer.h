@@ -54,6 +54,12 @@ struct _GESSmartMixer
   GstCaps *caps;
 
   GESTrack *track;
+
+  /* Stripe-s of the output blended in parallel, NULL when all the
+   * compositing is done by @mixer */
+  GPtrArray *stripes;
+  guint n_threads;
+  gulong restriction_changed_id;
 };
 
 GType         ges_smart_mixer_get_type (void) G_GNUC_CONST;
@@ -27,6 +27,7 @@
  */
 
 #include "ges-timeline-element.h"
+#include "ges-container.h"
 #include "ges-extractable.h"
 #include "ges-meta-container.h"
 #include "ges-internal.h"
@@ -63,9 +64,29 @@ enum
 
 static GParamSpec *properties[PROP_LAST] = { NULL, };
 
+typedef struct
+{
+  GESTimingFlags fields;
+  gboolean after;
+  GESTimingObserver func;
+  gpointer user_data;
+} TimingObserver;
+
 struct _GESTimelineElementPrivate
 {
-  gpointer dummy;
+  /* The TimingObserver-s of GES objects following our timings, they are
+   * called directly, avoiding the cost of a GClosure per notify */
+  GArray *observers;
+
+  /* Observers can be removed from a callback, in which case they are only
+   * marked as removed until we are done iterating */
+  guint dispatching;
+  gboolean has_removed_observers;
+
+  /* While > 0, the timing changes of @self are only accumulated in
+   * @batched_timing, and the observers called once the batch is over */
+  guint timing_batch;
+  GESTimingFlags batched_timing;
 };
 
 static void
@@ -135,14 +156,145 @@ _set_property (GObject * object, guint property_id,
 }
 
 static void
-ges_timeline_element_init (GESTimelineElement * ges_timeline_element)
+_call_timing_observers (GESTimelineElement * self, GESTimingFlags changed,
+    gboolean after)
 {
+  guint i;
+  TimingObserver *observer;
+  GESTimelineElementPrivate *priv = self->priv;
+
+  /* Observers added while dispatching get called too, the array can be
+   * reallocated so we do not keep pointers into it */
+  for (i = 0; i < priv->observers->len; i++) {
+    observer = &g_array_index (priv->observers, TimingObserver, i);
+
+    if (observer->func && observer->after == after &&
+        (observer->fields & changed))
+      observer->func (self, changed, observer->user_data);
+  }
+}
 
+static void
+_notify_timing_observers (GESTimelineElement * self, GESTimingFlags changed)
+{
+  guint i;
+  GESTimelineElementPrivate *priv = self->priv;
+
+  /* An observer might drop the last reference to @self */
+  g_object_ref (self);
+  priv->dispatching++;
+  _call_timing_observers (self, changed, FALSE);
+  _call_timing_observers (self, changed, TRUE);
+  priv->dispatching--;
+
+  if (priv->dispatching == 0 && priv->has_removed_observers) {
+    for (i = priv->observers->len; i > 0; i--) {
+      if (g_array_index (priv->observers, TimingObserver, i - 1).func == NULL)
+        g_array_remove_index (priv->observers, i - 1);
+    }
+    priv->has_removed_observers = FALSE;
+  }
+  g_object_unref (self);
+}
+
+static void
+_dispatch_properties_changed (GObject * object, guint n_pspecs,
+    GParamSpec ** pspecs)
+{
+  guint i;
+  GESTimingFlags changed = 0;
+  GESTimelineElement *self = GES_TIMELINE_ELEMENT (object);
+  GESTimelineElementPrivate *priv = self->priv;
+
+  G_OBJECT_CLASS (ges_timeline_element_parent_class)->dispatch_properties_changed
+      (object, n_pspecs, pspecs);
+
+  if (priv->observers == NULL || priv->observers->len == 0)
+    return;
+
+  for (i = 0; i < n_pspecs; i++) {
+    if (pspecs[i] == properties[PROP_START])
+      changed |= GES_TIMING_START;
+    else if (pspecs[i] == properties[PROP_INPOINT])
+      changed |= GES_TIMING_INPOINT;
+    else if (pspecs[i] == properties[PROP_DURATION])
+      changed |= GES_TIMING_DURATION;
+    else if (pspecs[i] == properties[PROP_PRIORITY])
+      changed |= GES_TIMING_PRIORITY;
+  }
+
+  if (changed == 0)
+    return;
+
+  if (priv->timing_batch) {
+    priv->batched_timing |= changed;
+    return;
+  }
+
+  _notify_timing_observers (self, changed);
+}
+
+/* Holds back the timing observers of @self and of all its descendants,
+ * collecting them in @elements so that they can be released even if the
+ * hierarchy changed meanwhile */
+static void
+_begin_timing_batch (GESTimelineElement * self, GList ** elements)
+{
+  GList *tmp;
+
+  self->priv->timing_batch++;
+  *elements = g_list_prepend (*elements, gst_object_ref (self));
+
+  if (!GES_IS_CONTAINER (self))
+    return;
+
+  for (tmp = GES_CONTAINER_CHILDREN (self); tmp; tmp = tmp->next)
+    _begin_timing_batch (tmp->data, elements);
+}
+
+static void
+_end_timing_batch (GList * elements)
+{
+  GList *tmp;
+  GESTimingFlags changed;
+  GESTimelineElementPrivate *priv;
+
+  /* Children were prepended, so they get updated before their parents as
+   * when their timings are set one by one */
+  for (tmp = elements; tmp; tmp = tmp->next) {
+    priv = GES_TIMELINE_ELEMENT (tmp->data)->priv;
+
+    if (--priv->timing_batch == 0 && priv->batched_timing) {
+      changed = priv->batched_timing;
+      priv->batched_timing = 0;
+      _notify_timing_observers (tmp->data, changed);
+    }
+  }
+
+  g_list_free_full (elements, gst_object_unref);
+}
+
+static void
+ges_timeline_element_init (GESTimelineElement * self)
+{
+  self->priv = G_TYPE_INSTANCE_GET_PRIVATE (self,
+      GES_TYPE_TIMELINE_ELEMENT, GESTimelineElementPrivate);
+
+  self->priv->observers = NULL;
+  self->priv->dispatching = 0;
+  self->priv->has_removed_observers = FALSE;
+  self->priv->timing_batch = 0;
+  self->priv->batched_timing = 0;
 }
 
 static void
 ges_timeline_element_finalize (GObject * self)
 {
+  GESTimelineElementPrivate *priv = GES_TIMELINE_ELEMENT (self)->priv;
+
+  if (priv->observers)
+    g_array_free (priv->observers, TRUE);
+
   G_OBJECT_CLASS (ges_timeline_element_parent_class)->finalize (self);
 }
 
@@ -151,8 +303,11 @@ ges_timeline_element_class_init (GESTimelineElementClass * klass)
 {
   GObjectClass *object_class = G_OBJECT_CLASS (klass);
 
+  g_type_class_add_private (klass, sizeof (GESTimelineElementPrivate));
+
   object_class->get_property = _get_property;
   object_class->set_property = _set_property;
+  object_class->dispatch_properties_changed = _dispatch_properties_changed;
 
   /**
    * GESTimelineElement:parent:
@@ -629,6 +784,187 @@ ges_timeline_element_set_priority (GESTimelineElement * self, guint32 priority)
       priority);
 }
 
+static guint64
+_get_timing_field (GESTimelineElement * self, GESTimingFlags field)
+{
+  switch (field) {
+    case GES_TIMING_START:
+      return self->start;
+    case GES_TIMING_INPOINT:
+      return self->inpoint;
+    case GES_TIMING_DURATION:
+      return self->duration;
+    case GES_TIMING_PRIORITY:
+      return self->priority;
+    default:
+      g_assert_not_reached ();
+  }
+
+  return 0;
+}
+
+/* Sets one of the timing fields of @self, as the matching setter does, and
+ * returns %FALSE if the subclass refused the value. Some subclasses set the
+ * field themselves and return %FALSE, which is not a refusal */
+static gboolean
+_set_timing_field (GESTimelineElement * self, GESTimingFlags field,
+    guint64 value)
+{
+  gboolean applied = FALSE;
+  GParamSpec *pspec = NULL;
+  guint64 old_value = _get_timing_field (self, field);
+  GESTimelineElementClass *klass = GES_TIMELINE_ELEMENT_GET_CLASS (self);
+
+  switch (field) {
+    case GES_TIMING_START:
+      if ((applied = klass->set_start (self, value)))
+        self->start = value;
+      pspec = properties[PROP_START];
+      break;
+    case GES_TIMING_INPOINT:
+      if ((applied = klass->set_inpoint (self, value)))
+        self->inpoint = value;
+      pspec = properties[PROP_INPOINT];
+      break;
+    case GES_TIMING_DURATION:
+      if ((applied = klass->set_duration (self, value)))
+        self->duration = value;
+      pspec = properties[PROP_DURATION];
+      break;
+    case GES_TIMING_PRIORITY:
+      if ((applied = klass->set_priority (self, value)))
+        self->priority = value;
+      pspec = properties[PROP_PRIORITY];
+      break;
+    default:
+      g_assert_not_reached ();
+  }
+
+  if (applied) {
+    g_object_notify_by_pspec (G_OBJECT (self), pspec);
+
+    return TRUE;
+  }
+
+  return _get_timing_field (self, field) != old_value;
+}
+
+/**
+ * ges_timeline_element_set_timing:
+ * @self: a #GESTimelineElement
+ * @start: the new start of @self, or #GST_CLOCK_TIME_NONE to keep it
+ * @inpoint: the new in-point of @self, or #GST_CLOCK_TIME_NONE to keep it
+ * @duration: the new duration of @self, or #GST_CLOCK_TIME_NONE to keep it
+ * @priority: the new priority of @self, or %G_MAXUINT32 to keep it
+ *
+ * Sets the timing properties of @self at once, as needed when trimming for
+ * example. The values are all checked before anything is changed, and if
+ * @self refuses one of them the others are reverted, so @self is never left
+ * half updated. As with ges_timeline_element_set_duration(), @duration is
+ * clamped so that @self does not go past its max duration.
+ *
+ * The notify signals of @self are only emitted once all the values have been
+ * applied, and @self, as well as its children, is only sorted again once in
+ * its tracks and timeline, however many values changed.
+ *
+ * Returns: %TRUE if the values could be set, %FALSE otherwise
+ */
+gboolean
+ges_timeline_element_set_timing (GESTimelineElement * self,
+    GstClockTime start, GstClockTime inpoint, GstClockTime duration,
+    guint32 priority)
+{
+  guint i, n_fields = 0, n_applied;
+  gboolean ret = TRUE;
+  GList *batch = NULL;
+  GESTimelineElementClass *klass;
+  GESTimelineElement *toplevel_container;
+  GESTimingFlags fields[4];
+  guint64 new_values[4], old_values[4];
+
+  g_return_val_if_fail (GES_IS_TIMELINE_ELEMENT (self), FALSE);
+
+  klass = GES_TIMELINE_ELEMENT_GET_CLASS (self);
+
+  if (!GST_CLOCK_TIME_IS_VALID (inpoint))
+    inpoint = _INPOINT (self);
+  if (!GST_CLOCK_TIME_IS_VALID (duration))
+    duration = _DURATION (self);
+  if (!GST_CLOCK_TIME_IS_VALID (start))
+    start = _START (self);
+  if (priority == G_MAXUINT32)
+    priority = _PRIORITY (self);
+
+  if (GST_CLOCK_TIME_IS_VALID (_MAXDURATION (self))) {
+    if (inpoint > _MAXDURATION (self)) {
+      GST_INFO_OBJECT (self, "In-point %" GST_TIME_FORMAT " is past the max"
+          " duration %" GST_TIME_FORMAT, GST_TIME_ARGS (inpoint),
+          GST_TIME_ARGS (_MAXDURATION (self)));
+
+      return FALSE;
+    }
+
+    if (inpoint + duration > _MAXDURATION (self))
+      duration = _MAXDURATION (self) - inpoint;
+  }
+
+  if (start != _START (self)) {
+    toplevel_container = ges_timeline_element_get_toplevel_parent (self);
+    if (((gint64) (_START (toplevel_container) + start - _START (self))) < 0) {
+      GST_INFO_OBJECT (self, "Can not move the object as it would imply its"
+          " container to have a negative start value");
+
+      gst_object_unref (toplevel_container);
+      return FALSE;
+    }
+    gst_object_unref (toplevel_container);
+  }
+
+  /* The in-point goes first so that the duration is applied against it */
+#define ADD_FIELD(flag,vmethod,new_value,old_value) G_STMT_START {          \
+  if (new_value != old_value) {                                             \
+    if (klass->vmethod == NULL) {                                           \
+      GST_WARNING_OBJECT (self, "No " #vmethod " virtual method"            \
+          " implementation on class %s", G_OBJECT_CLASS_NAME (klass));      \
+      return FALSE;                                                         \
+    }                                                                       \
+    fields[n_fields] = flag;                                                \
+    new_values[n_fields] = new_value;                                       \
+    old_values[n_fields++] = old_value;                                     \
+  }                                                                         \
+} G_STMT_END
+
+  ADD_FIELD (GES_TIMING_INPOINT, set_inpoint, inpoint, _INPOINT (self));
+  ADD_FIELD (GES_TIMING_DURATION, set_duration, duration, _DURATION (self));
+  ADD_FIELD (GES_TIMING_START, set_start, start, _START (self));
+  ADD_FIELD (GES_TIMING_PRIORITY, set_priority, priority, _PRIORITY (self));
+#undef ADD_FIELD
+
+  if (n_fields == 0)
+    return TRUE;
+
+  _begin_timing_batch (self, &batch);
+  g_object_freeze_notify (G_OBJECT (self));
+
+  for (n_applied = 0; n_applied < n_fields; n_applied++) {
+    if (!_set_timing_field (self, fields[n_applied], new_values[n_applied])) {
+      GST_INFO_OBJECT (self, "Value refused, reverting the timings");
+      ret = FALSE;
+      break;
+    }
+  }
+
+  if (ret == FALSE) {
+    for (i = n_applied; i > 0; i--)
+      _set_timing_field (self, fields[i - 1], old_values[i - 1]);
+  }
+
+  g_object_thaw_notify (G_OBJECT (self));
+  _end_timing_batch (batch);
+
+  return ret;
+}
+
 /**
  * ges_timeline_element_ripple:
  * @self: The #GESTimelineElement to ripple.
@@ -874,3 +1210,50 @@ ges_timeline_element_get_toplevel_parent (GESTimelineElement * self)
 
   return gst_object_ref (toplevel);
 }
+
+/* Internal methods */
+
+/* Makes @func be called each time one of the @fields of @self changes. As
+ * with g_signal_connect_after, observers added with @after are called after
+ * the others */
+void
+ges_timeline_element_add_timing_observer (GESTimelineElement * self,
+    GESTimingFlags fields, gboolean after, GESTimingObserver func,
+    gpointer user_data)
+{
+  TimingObserver observer = { fields, after, func, user_data };
+
+  if (self->priv->observers == NULL)
+    self->priv->observers = g_array_new (FALSE, FALSE,
+        sizeof (TimingObserver));
+
+  g_array_append_val (self->priv->observers, observer);
+}
+
+void
+ges_timeline_element_remove_timing_observer (GESTimelineElement * self,
+    GESTimingObserver func, gpointer user_data)
+{
+  guint i;
+  TimingObserver *observer;
+  GESTimelineElementPrivate *priv = self->priv;
+
+  if (priv->observers == NULL)
+    return;
+
+  for (i = 0; i < priv->observers->len; i++) {
+    observer = &g_array_index (priv->observers, TimingObserver, i);
+
+    if (observer->func != func || observer->user_data != user_data)
+      continue;
+
+    if (priv->dispatching) {
+      observer->func = NULL;
+      priv->has_removed_observers = TRUE;
+    } else {
+      g_array_remove_index (priv->observers, i);
+    }
+
+    return;
+  }
+}
@@ -195,6 +195,11 @@ void ges_timeline_element_set_inpoint                (GESTimelineElement *self,
 void ges_timeline_element_set_duration               (GESTimelineElement *self, GstClockTime duration);
 void ges_timeline_element_set_max_duration           (GESTimelineElement *self, GstClockTime maxduration);
 void ges_timeline_element_set_priority               (GESTimelineElement *self, guint32 priority);
+gboolean ges_timeline_element_set_timing            (GESTimelineElement *self,
+                                                      GstClockTime start,
+                                                      GstClockTime inpoint,
+                                                      GstClockTime duration,
+                                                      guint32 priority);
 
 GstClockTime ges_timeline_element_get_start          (GESTimelineElement *self);
 GstClockTime ges_timeline_element_get_inpoint        (GESTimelineElement *self);
@@ -0,0 +1,602 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:ges-timeline-snapshot
+ * @short_description: An immutable view of a #GESTimeline
+ *
+ * A #GESTimelineSnapshot describes the tracks, layers and clips of a
+ * #GESTimeline at the time ges_timeline_snapshot() was called. It never
+ * changes afterward and does not reference any object of the timeline, so
+ * it can be shared with and read from any number of threads without
+ * locking, while the timeline keeps being edited.
+ *
+ * Each clip is described by a #GstStructure named after the type of the
+ * clip, with the following fields:
+ * <itemizedlist>
+ * <listitem>"asset-id" (string): the ID of the asset of the clip if any</listitem>
+ * <listitem>"start", "inpoint", "duration", "max-duration" (guint64)</listitem>
+ * <listitem>"priority" (guint): the priority of the clip in its layer</listitem>
+ * <listitem>"supported-formats" (#GESTrackType)</listitem>
+ * <listitem>"children" (#GST_TYPE_ARRAY of #GstStructure): a structure for
+ * each #GESTrackElement of the clip, named after its type, with the same
+ * timing fields, its "track-type", whether it is "active", whether it is
+ * bypassed ("bypass") for effects, the values
+ * of its children properties, and if some are animated, a
+ * "control-bindings" #GST_TYPE_ARRAY with a "binding" structure per
+ * animated property, giving its "property" name and the "timestamps" and
+ * "values" of its keyframes</listitem>
+ * </itemizedlist>
+ *
+ * Snapshots are copy-on-write: the description of a clip is shared by all
+ * the snapshots taken while the clip does not change, so taking a new
+ * snapshot after an edit only describes the clips that have been edited.
+ */
+
+#include "ges-internal.h"
+#include "ges-timeline-snapshot.h"
+#include "ges.h"
+
+typedef struct
+{
+  GESTrackType type;
+  GstCaps *caps;
+} TrackSnapshot;
+
+/* The description of a clip, shared between snapshots */
+typedef struct
+{
+  gint refcount;
+  GstStructure *structure;
+
+  /* Keyframes can change without the timeline knowing, so the description
+   * of animated clips is checked every time a snapshot is taken */
+  gboolean animated;
+} ClipSnapshot;
+
+typedef struct
+{
+  guint32 priority;
+  GPtrArray *clips;
+} LayerSnapshot;
+
+/**
+ * GESTimelineSnapshot:
+ *
+ * An opaque, refcounted and immutable description of a #GESTimeline.
+ */
+struct _GESTimelineSnapshot
+{
+  gint refcount;
+
+  GstClockTime duration;
+  GArray *tracks;
+  GPtrArray *layers;
+  gboolean animated;
+};
+
+G_DEFINE_BOXED_TYPE (GESTimelineSnapshot, ges_timeline_snapshot,
+    ges_timeline_snapshot_ref, ges_timeline_snapshot_unref);
+
+static ClipSnapshot *
+_clip_snapshot_ref (ClipSnapshot * clip)
+{
+  g_atomic_int_inc (&clip->refcount);
+
+  return clip;
+}
+
+static void
+_clip_snapshot_unref (ClipSnapshot * clip)
+{
+  if (!g_atomic_int_dec_and_test (&clip->refcount))
+    return;
+
+  gst_structure_free (clip->structure);
+  g_slice_free (ClipSnapshot, clip);
+}
+
+static void
+_free_layer (LayerSnapshot * layer)
+{
+  g_ptr_array_unref (layer->clips);
+  g_slice_free (LayerSnapshot, layer);
+}
+
+static void
+_set_timing_fields (GstStructure * structure, GESTimelineElement * element)
+{
+  gst_structure_set (structure,
+      "start", G_TYPE_UINT64, _START (element),
+      "inpoint", G_TYPE_UINT64, _INPOINT (element),
+      "duration", G_TYPE_UINT64, _DURATION (element),
+      "max-duration", G_TYPE_UINT64, _MAXDURATION (element),
+      "priority", G_TYPE_UINT, _PRIORITY (element), NULL);
+}
+
+static gboolean
+_snapshot_control_bindings (GstStructure * structure,
+    GESTrackElement * element)
+{
+  GHashTableIter iter;
+  gpointer name, binding;
+  GValue bindings = { 0, };
+  GHashTable *table = ges_track_element_get_bindings_hashtable (element);
+
+  if (table == NULL || g_hash_table_size (table) == 0)
+    return FALSE;
+
+  g_value_init (&bindings, GST_TYPE_ARRAY);
+  g_hash_table_iter_init (&iter, table);
+  while (g_hash_table_iter_next (&iter, &name, &binding)) {
+    GList *values, *tmp;
+    GstControlSource *source;
+    GValue timestamps = { 0, }, vals = { 0, }, value = { 0, };
+    GstStructure *bstruct;
+
+    g_object_get (binding, "control-source", &source, NULL);
+    if (!GST_IS_TIMED_VALUE_CONTROL_SOURCE (source)) {
+      if (source)
+        gst_object_unref (source);
+      continue;
+    }
+
+    g_value_init (&timestamps, GST_TYPE_ARRAY);
+    g_value_init (&vals, GST_TYPE_ARRAY);
+    values =
+        gst_timed_value_control_source_get_all (GST_TIMED_VALUE_CONTROL_SOURCE
+        (source));
+    for (tmp = values; tmp; tmp = tmp->next) {
+      GValue v = { 0, };
+      GstTimedValue *timed = tmp->data;
+
+      g_value_init (&v, G_TYPE_UINT64);
+      g_value_set_uint64 (&v, timed->timestamp);
+      gst_value_array_append_value (&timestamps, &v);
+      g_value_unset (&v);
+
+      g_value_init (&v, G_TYPE_DOUBLE);
+      g_value_set_double (&v, timed->value);
+      gst_value_array_append_value (&vals, &v);
+      g_value_unset (&v);
+    }
+    g_list_free (values);
+    gst_object_unref (source);
+
+    bstruct = gst_structure_new ("binding", "property", G_TYPE_STRING, name,
+        NULL);
+    gst_structure_take_value (bstruct, "timestamps", &timestamps);
+    gst_structure_take_value (bstruct, "values", &vals);
+
+    g_value_init (&value, GST_TYPE_STRUCTURE);
+    g_value_take_boxed (&value, bstruct);
+    gst_value_array_append_value (&bindings, &value);
+    g_value_unset (&value);
+  }
+  gst_structure_take_value (structure, "control-bindings", &bindings);
+
+  return TRUE;
+}
+
+static GstStructure *
+_snapshot_track_element (GESTrackElement * element, gboolean * animated)
+{
+  guint i, n_specs;
+  GParamSpec **specs;
+  GstStructure *structure = gst_structure_new_empty (G_OBJECT_TYPE_NAME
+      (element));
+
+  _set_timing_fields (structure, GES_TIMELINE_ELEMENT (element));
+  gst_structure_set (structure,
+      "track-type", GES_TYPE_TRACK_TYPE,
+      ges_track_element_get_track_type (element),
+      "active", G_TYPE_BOOLEAN, ges_track_element_is_active (element), NULL);
+  if (GES_IS_EFFECT (element))
+    gst_structure_set (structure, "bypass", G_TYPE_BOOLEAN,
+        ges_effect_get_bypass (GES_EFFECT (element)), NULL);
+
+  specs = ges_track_element_list_children_properties (element, &n_specs);
+  for (i = 0; i < n_specs; i++) {
+    GValue value = { 0, };
+
+    /* Objects would let the snapshot reach into the timeline */
+    if (G_TYPE_IS_OBJECT (specs[i]->value_type) ||
+        G_TYPE_IS_INTERFACE (specs[i]->value_type) ||
+        !(specs[i]->flags & G_PARAM_READABLE))
+      continue;
+
+    g_value_init (&value, specs[i]->value_type);
+    ges_track_element_get_child_property_by_pspec (element, specs[i], &value);
+    gst_structure_take_value (structure, specs[i]->name, &value);
+  }
+
+  for (i = 0; i < n_specs; i++)
+    g_param_spec_unref (specs[i]);
+  g_free (specs);
+
+  if (_snapshot_control_bindings (structure, element))
+    *animated = TRUE;
+
+  return structure;
+}
+
+static GstStructure *
+_snapshot_clip (GESClip * clip, gboolean * animated)
+{
+  GList *tmp;
+  GValue children = { 0, };
+  GESAsset *asset = ges_extractable_get_asset (GES_EXTRACTABLE (clip));
+  GstStructure *structure = gst_structure_new_empty (G_OBJECT_TYPE_NAME
+      (clip));
+
+  _set_timing_fields (structure, GES_TIMELINE_ELEMENT (clip));
+  gst_structure_set (structure, "supported-formats", GES_TYPE_TRACK_TYPE,
+      ges_clip_get_supported_formats (clip), NULL);
+  if (asset && ges_asset_get_id (asset))
+    gst_structure_set (structure, "asset-id", G_TYPE_STRING,
+        ges_asset_get_id (asset), NULL);
+
+  g_value_init (&children, GST_TYPE_ARRAY);
+  for (tmp = GES_CONTAINER_CHILDREN (clip); tmp; tmp = tmp->next) {
+    GValue child = { 0, };
+
+    g_value_init (&child, GST_TYPE_STRUCTURE);
+    g_value_take_boxed (&child, _snapshot_track_element (tmp->data,
+            animated));
+    gst_value_array_append_value (&children, &child);
+    g_value_unset (&child);
+  }
+  gst_structure_take_value (structure, "children", &children);
+
+  return structure;
+}
+
+static ClipSnapshot *
+_get_clip_snapshot (GESClip * clip, GHashTable * previous)
+{
+  gchar *desc, *previous_desc;
+  gboolean animated = FALSE, unchanged;
+  GstStructure *structure;
+  ClipSnapshot *node = g_hash_table_lookup (previous, clip);
+
+  if (node && !node->animated)
+    return _clip_snapshot_ref (node);
+
+  structure = _snapshot_clip (clip, &animated);
+
+  /* Keep sharing the description if the keyframes did not move */
+  if (node) {
+    desc = gst_structure_to_string (structure);
+    previous_desc = gst_structure_to_string (node->structure);
+    unchanged = !g_strcmp0 (desc, previous_desc);
+    g_free (desc);
+    g_free (previous_desc);
+
+    if (unchanged) {
+      gst_structure_free (structure);
+
+      return _clip_snapshot_ref (node);
+    }
+  }
+
+  node = g_slice_new0 (ClipSnapshot);
+  node->refcount = 1;
+  node->structure = structure;
+  node->animated = animated;
+
+  return node;
+}
+
+/* Creates a table in which the descriptions of the clips of a timeline are
+ * kept between snapshots */
+GHashTable *
+ges_timeline_snapshot_new_clip_cache (void)
+{
+  return g_hash_table_new_full (g_direct_hash, g_direct_equal,
+      gst_object_unref, (GDestroyNotify) _clip_snapshot_unref);
+}
+
+/* Creates a new snapshot of the current state of @timeline, must be called
+ * from the thread editing @timeline. The clips not found in @clip_cache, or
+ * whose keyframes changed, are described again, and @clip_cache is replaced
+ * by the descriptions of the clips of @timeline */
+GESTimelineSnapshot *
+ges_timeline_snapshot_new (GESTimeline * timeline, GHashTable ** clip_cache)
+{
+  GList *tmp, *clips, *ctmp;
+  GHashTable *cache = ges_timeline_snapshot_new_clip_cache ();
+  GESTimelineSnapshot *snapshot = g_slice_new0 (GESTimelineSnapshot);
+
+  snapshot->refcount = 1;
+  snapshot->duration = ges_timeline_get_duration (timeline);
+
+  snapshot->tracks = g_array_new (FALSE, FALSE, sizeof (TrackSnapshot));
+  for (tmp = timeline->tracks; tmp; tmp = tmp->next) {
+    TrackSnapshot track;
+
+    track.type = GES_TRACK (tmp->data)->type;
+    g_object_get (tmp->data, "restriction-caps", &track.caps, NULL);
+    g_array_append_val (snapshot->tracks, track);
+  }
+
+  snapshot->layers = g_ptr_array_new_with_free_func ((GDestroyNotify)
+      _free_layer);
+  for (tmp = timeline->layers; tmp; tmp = tmp->next) {
+    LayerSnapshot *layer = g_slice_new0 (LayerSnapshot);
+
+    layer->priority = ges_layer_get_priority (tmp->data);
+    layer->clips = g_ptr_array_new_with_free_func ((GDestroyNotify)
+        _clip_snapshot_unref);
+
+    clips = ges_layer_get_clips (tmp->data);
+    for (ctmp = clips; ctmp; ctmp = ctmp->next) {
+      ClipSnapshot *node = _get_clip_snapshot (ctmp->data, *clip_cache);
+
+      snapshot->animated |= node->animated;
+      g_ptr_array_add (layer->clips, node);
+      g_hash_table_insert (cache, gst_object_ref (ctmp->data),
+          _clip_snapshot_ref (node));
+    }
+    g_list_free_full (clips, gst_object_unref);
+
+    g_ptr_array_add (snapshot->layers, layer);
+  }
+
+  g_hash_table_unref (*clip_cache);
+  *clip_cache = cache;
+
+  return snapshot;
+}
+
+/* Whether @snapshot describes animated clips, whose keyframes can change
+ * without the timeline noticing */
+gboolean
+ges_timeline_snapshot_is_animated (GESTimelineSnapshot * snapshot)
+{
+  return snapshot->animated;
+}
+
+/* Whether @snapshot and @other describe the same clips with the same
+ * tracks, and can be used in place of each other */
+gboolean
+ges_timeline_snapshot_shares_clips (GESTimelineSnapshot * snapshot,
+    GESTimelineSnapshot * other)
+{
+  guint i, j;
+
+  if (snapshot->duration != other->duration ||
+      snapshot->tracks->len != other->tracks->len ||
+      snapshot->layers->len != other->layers->len)
+    return FALSE;
+
+  for (i = 0; i < snapshot->tracks->len; i++) {
+    TrackSnapshot *track = &g_array_index (snapshot->tracks, TrackSnapshot, i);
+    TrackSnapshot *otrack = &g_array_index (other->tracks, TrackSnapshot, i);
+
+    if (track->type != otrack->type ||
+        (track->caps != otrack->caps && (track->caps == NULL ||
+                otrack->caps == NULL ||
+                !gst_caps_is_strictly_equal (track->caps, otrack->caps))))
+      return FALSE;
+  }
+
+  for (i = 0; i < snapshot->layers->len; i++) {
+    LayerSnapshot *layer = g_ptr_array_index (snapshot->layers, i);
+    LayerSnapshot *olayer = g_ptr_array_index (other->layers, i);
+
+    if (layer->priority != olayer->priority ||
+        layer->clips->len != olayer->clips->len)
+      return FALSE;
+
+    for (j = 0; j < layer->clips->len; j++)
+      if (g_ptr_array_index (layer->clips, j) !=
+          g_ptr_array_index (olayer->clips, j))
+        return FALSE;
+  }
+
+  return TRUE;
+}
+
+/**
+ * ges_timeline_snapshot_ref:
+ * @snapshot: a #GESTimelineSnapshot
+ *
+ * Increases the refcount of @snapshot, can be called from any thread.
+ *
+ * Returns: (transfer full): @snapshot
+ */
+GESTimelineSnapshot *
+ges_timeline_snapshot_ref (GESTimelineSnapshot * snapshot)
+{
+  g_return_val_if_fail (snapshot != NULL, NULL);
+
+  g_atomic_int_inc (&snapshot->refcount);
+
+  return snapshot;
+}
+
+/**
+ * ges_timeline_snapshot_unref:
+ * @snapshot: a #GESTimelineSnapshot
+ *
+ * Decreases the refcount of @snapshot, freeing it when it reaches 0. Can be
+ * called from any thread.
+ */
+void
+ges_timeline_snapshot_unref (GESTimelineSnapshot * snapshot)
+{
+  guint i;
+
+  g_return_if_fail (snapshot != NULL);
+
+  if (!g_atomic_int_dec_and_test (&snapshot->refcount))
+    return;
+
+  for (i = 0; i < snapshot->tracks->len; i++) {
+    TrackSnapshot *track = &g_array_index (snapshot->tracks, TrackSnapshot, i);
+
+    if (track->caps)
+      gst_caps_unref (track->caps);
+  }
+  g_array_free (snapshot->tracks, TRUE);
+  g_ptr_array_unref (snapshot->layers);
+
+  g_slice_free (GESTimelineSnapshot, snapshot);
+}
+
+/**
+ * ges_timeline_snapshot_get_duration:
+ * @snapshot: a #GESTimelineSnapshot
+ *
+ * Returns: The duration of the timeline when @snapshot was taken
+ */
+GstClockTime
+ges_timeline_snapshot_get_duration (GESTimelineSnapshot * snapshot)
+{
+  g_return_val_if_fail (snapshot != NULL, GST_CLOCK_TIME_NONE);
+
+  return snapshot->duration;
+}
+
+/**
+ * ges_timeline_snapshot_get_n_tracks:
+ * @snapshot: a #GESTimelineSnapshot
+ *
+ * Returns: The number of tracks the timeline had when @snapshot was taken
+ */
+guint
+ges_timeline_snapshot_get_n_tracks (GESTimelineSnapshot * snapshot)
+{
+  g_return_val_if_fail (snapshot != NULL, 0);
+
+  return snapshot->tracks->len;
+}
+
+/**
+ * ges_timeline_snapshot_get_track_type:
+ * @snapshot: a #GESTimelineSnapshot
+ * @track: the index of the track
+ *
+ * Returns: The #GESTrackType of the track at index @track
+ */
+GESTrackType
+ges_timeline_snapshot_get_track_type (GESTimelineSnapshot * snapshot,
+    guint track)
+{
+  g_return_val_if_fail (snapshot != NULL, GES_TRACK_TYPE_UNKNOWN);
+  g_return_val_if_fail (track < snapshot->tracks->len, GES_TRACK_TYPE_UNKNOWN);
+
+  return g_array_index (snapshot->tracks, TrackSnapshot, track).type;
+}
+
+/**
+ * ges_timeline_snapshot_get_track_caps:
+ * @snapshot: a #GESTimelineSnapshot
+ * @track: the index of the track
+ *
+ * Returns: (transfer none): The restriction caps of the track at index
+ * @track
+ */
+const GstCaps *
+ges_timeline_snapshot_get_track_caps (GESTimelineSnapshot * snapshot,
+    guint track)
+{
+  g_return_val_if_fail (snapshot != NULL, NULL);
+  g_return_val_if_fail (track < snapshot->tracks->len, NULL);
+
+  return g_array_index (snapshot->tracks, TrackSnapshot, track).caps;
+}
+
+/**
+ * ges_timeline_snapshot_get_n_layers:
+ * @snapshot: a #GESTimelineSnapshot
+ *
+ * Returns: The number of layers the timeline had when @snapshot was taken
+ */
+guint
+ges_timeline_snapshot_get_n_layers (GESTimelineSnapshot * snapshot)
+{
+  g_return_val_if_fail (snapshot != NULL, 0);
+
+  return snapshot->layers->len;
+}
+
+/**
+ * ges_timeline_snapshot_get_layer_priority:
+ * @snapshot: a #GESTimelineSnapshot
+ * @layer: the index of the layer
+ *
+ * Layers are sorted by priority in a snapshot.
+ *
+ * Returns: The priority of the layer at index @layer
+ */
+guint32
+ges_timeline_snapshot_get_layer_priority (GESTimelineSnapshot * snapshot,
+    guint layer)
+{
+  g_return_val_if_fail (snapshot != NULL, 0);
+  g_return_val_if_fail (layer < snapshot->layers->len, 0);
+
+  return ((LayerSnapshot *) g_ptr_array_index (snapshot->layers,
+          layer))->priority;
+}
+
+/**
+ * ges_timeline_snapshot_get_n_clips:
+ * @snapshot: a #GESTimelineSnapshot
+ * @layer: the index of the layer
+ *
+ * Returns: The number of clips of the layer at index @layer
+ */
+guint
+ges_timeline_snapshot_get_n_clips (GESTimelineSnapshot * snapshot, guint layer)
+{
+  g_return_val_if_fail (snapshot != NULL, 0);
+  g_return_val_if_fail (layer < snapshot->layers->len, 0);
+
+  return ((LayerSnapshot *) g_ptr_array_index (snapshot->layers,
+          layer))->clips->len;
+}
+
+/**
+ * ges_timeline_snapshot_get_clip:
+ * @snapshot: a #GESTimelineSnapshot
+ * @layer: the index of the layer
+ * @clip: the index of the clip in the layer
+ *
+ * Gets the description of a clip, see the #GESTimelineSnapshot
+ * documentation for its content.
+ *
+ * Returns: (transfer none): The #GstStructure describing the clip, it
+ * lives as long as @snapshot
+ */
+const GstStructure *
+ges_timeline_snapshot_get_clip (GESTimelineSnapshot * snapshot, guint layer,
+    guint clip)
+{
+  LayerSnapshot *lsnapshot;
+
+  g_return_val_if_fail (snapshot != NULL, NULL);
+  g_return_val_if_fail (layer < snapshot->layers->len, NULL);
+
+  lsnapshot = g_ptr_array_index (snapshot->layers, layer);
+  g_return_val_if_fail (clip < lsnapshot->clips->len, NULL);
+
+  return ((ClipSnapshot *) g_ptr_array_index (lsnapshot->clips,
+          clip))->structure;
+}
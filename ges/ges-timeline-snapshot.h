@@ -0,0 +1,53 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef _GES_TIMELINE_SNAPSHOT_H_
+#define _GES_TIMELINE_SNAPSHOT_H_
+
+#include <glib-object.h>
+#include <gst/gst.h>
+#include <ges/ges-types.h>
+#include <ges/ges-enums.h>
+
+G_BEGIN_DECLS
+
+#define GES_TYPE_TIMELINE_SNAPSHOT (ges_timeline_snapshot_get_type ())
+
+GType ges_timeline_snapshot_get_type                 (void);
+
+GESTimelineSnapshot * ges_timeline_snapshot_ref      (GESTimelineSnapshot *snapshot);
+void ges_timeline_snapshot_unref                     (GESTimelineSnapshot *snapshot);
+
+GstClockTime ges_timeline_snapshot_get_duration      (GESTimelineSnapshot *snapshot);
+
+guint ges_timeline_snapshot_get_n_tracks             (GESTimelineSnapshot *snapshot);
+GESTrackType ges_timeline_snapshot_get_track_type    (GESTimelineSnapshot *snapshot,
+                                                      guint track);
+const GstCaps * ges_timeline_snapshot_get_track_caps (GESTimelineSnapshot *snapshot,
+                                                      guint track);
+
+guint ges_timeline_snapshot_get_n_layers             (GESTimelineSnapshot *snapshot);
+guint32 ges_timeline_snapshot_get_layer_priority     (GESTimelineSnapshot *snapshot,
+                                                      guint layer);
+guint ges_timeline_snapshot_get_n_clips              (GESTimelineSnapshot *snapshot,
+                                                      guint layer);
+const GstStructure * ges_timeline_snapshot_get_clip  (GESTimelineSnapshot *snapshot,
+                                                      guint layer,
+                                                      guint clip);
+
+G_END_DECLS
+#endif /* _GES_TIMELINE_SNAPSHOT_H_ */
@@ -49,6 +49,8 @@
 #include "ges-auto-transition.h"
 #include "ges.h"
 
+#include <string.h>
+
 typedef struct _MoveContext MoveContext;
 
 static GPtrArray *select_tracks_for_object_default (GESTimeline * timeline,
@@ -86,7 +88,23 @@ GST_DEBUG_CATEGORY_STATIC (ges_timeline_debug);
         g_thread_self());         \
   } G_STMT_END
 
-typedef struct TrackObjIters
+typedef struct TrackObjIters TrackObjIters;
+
+/* A start or an end of a source as tracked in the starts_ends sequence,
+ * which sorts them as guint64 so @time has to come first */
+typedef struct
+{
+  guint64 time;
+  TrackObjIters *iters;
+} TimelineEdge;
+
+#define EDGE_TRACK_ELEMENT(tc) (((TimelineEdge *) (tc))->iters->trackelement)
+#define EDGE_IS_END(tc) ((tc) == &((TimelineEdge *) (tc))->iters->end.time)
+
+/* Everything the timeline keeps about a TrackElement lives in one
+ * TrackObjIters, edges included, so that tracking an element does not need
+ * any other allocation than the nodes of the sequences it is sorted in */
+struct TrackObjIters
 {
   GSequenceIter *iter_start;
   GSequenceIter *iter_end;
@@ -95,12 +113,65 @@ typedef struct TrackObjIters
 
   GESLayer *layer;
   GESTrackElement *trackelement;
-} TrackObjIters;
+
+  /* Only sources are tracked in starts_ends */
+  TimelineEdge start;
+  TimelineEdge end;
+};
+
+/* TrackObjIters are carved out of blocks of OBJ_ITERS_PER_BLOCK entries which
+ * live as long as the timeline, and freed ones are reused through a free
+ * list. Each entry then costs exactly sizeof (TrackObjIters) (80 bytes on
+ * 64 bits), without any per allocation header: we can not count on GSlice
+ * for that, since GLib 2.76 it is a plain wrapper around malloc */
+#define OBJ_ITERS_PER_BLOCK 256
+
+typedef struct
+{
+  GSList *blocks;
+  guint n_used_in_block;
+  TrackObjIters *free_list;     /* Linked through the first field */
+} ObjItersArena;
+
+static TrackObjIters *
+obj_iters_arena_alloc (ObjItersArena * arena)
+{
+  TrackObjIters *iters;
+
+  if (arena->free_list) {
+    iters = arena->free_list;
+    arena->free_list = *(TrackObjIters **) iters;
+  } else {
+    if (arena->blocks == NULL ||
+        arena->n_used_in_block == OBJ_ITERS_PER_BLOCK) {
+      arena->blocks = g_slist_prepend (arena->blocks,
+          g_new (TrackObjIters, OBJ_ITERS_PER_BLOCK));
+      arena->n_used_in_block = 0;
+    }
+
+    iters = ((TrackObjIters *) arena->blocks->data) +
+        arena->n_used_in_block++;
+  }
+
+  memset (iters, 0, sizeof (TrackObjIters));
+
+  return iters;
+}
 
 static void
-_destroy_obj_iters (TrackObjIters * iters)
+obj_iters_arena_free (ObjItersArena * arena, TrackObjIters * iters)
 {
-  g_slice_free (TrackObjIters, iters);
+  *(TrackObjIters **) iters = arena->free_list;
+  arena->free_list = iters;
+}
+
+static void
+obj_iters_arena_clear (ObjItersArena * arena)
+{
+  g_slist_free_full (arena->blocks, g_free);
+  arena->blocks = NULL;
+  arena->n_used_in_block = 0;
+  arena->free_list = NULL;
 }
 
 /*  The move context is used for the timeline editing modes functions in order to
@@ -156,10 +227,8 @@ struct _GESTimelinePrivate
    * be tracked? */
 
   /* Snapping fields */
-  GHashTable *by_start;         /* {Source: start} */
-  GHashTable *by_end;           /* {Source: end} */
-  GHashTable *by_object;        /* {timecode: Source} */
   GHashTable *obj_iters;        /* {Source: TrackObjIters} */
+  ObjItersArena obj_iters_arena;        /* Where the TrackObjIters live */
   GSequence *starts_ends;       /* Sorted list of starts/ends */
   /* We keep 1 reference to our trackelement here */
   GSequence *tracksources;      /* Source-s sorted by start/priorities */
@@ -187,6 +256,19 @@ struct _GESTimelinePrivate
   GList *groups;
 
   guint group_id;
+
+  /* The GESRenderCache-s working on us, and the range of the timeline that
+   * changed since the last commit, which they need to invalidate */
+  GList *render_caches;
+  GstClockTime dirty_start;
+  GstClockTime dirty_stop;
+  /* FALSE while a pipeline renders us */
+  gboolean use_cached_media;
+
+  /* The last snapshot taken, reused until something changes, and the
+   * descriptions of the clips it shares with the next ones */
+  GESTimelineSnapshot *snapshot;
+  GHashTable *clip_snapshots;
 };
 
 /* private structure to contain our track-related information */
@@ -222,6 +304,7 @@ enum
   SNAPING_STARTED,
   SNAPING_ENDED,
   SELECT_TRACKS_FOR_OBJECT,
+  COMMITED,
   LAST_SIGNAL
 };
 
@@ -336,11 +419,9 @@ ges_timeline_dispose (GObject * object)
     g_list_free_full (ges_container_ungroup (priv->groups->data, FALSE),
         gst_object_unref);
 
-  g_hash_table_unref (priv->by_start);
-  g_hash_table_unref (priv->by_end);
-  g_hash_table_unref (priv->by_object);
   g_hash_table_unref (priv->by_layer);
   g_hash_table_unref (priv->obj_iters);
+  obj_iters_arena_clear (&priv->obj_iters_arena);
   g_sequence_free (priv->starts_ends);
   g_sequence_free (priv->tracksources);
   g_list_free (priv->movecontext.moving_trackelements);
@@ -348,12 +429,20 @@ ges_timeline_dispose (GObject * object)
 
   g_hash_table_unref (priv->auto_transitions);
 
+  if (priv->snapshot) {
+    ges_timeline_snapshot_unref (priv->snapshot);
+    priv->snapshot = NULL;
+  }
+  g_hash_table_remove_all (priv->clip_snapshots);
+
   G_OBJECT_CLASS (ges_timeline_parent_class)->dispose (object);
 }
 
 static void
 ges_timeline_finalize (GObject * object)
 {
+  g_hash_table_unref (GES_TIMELINE (object)->priv->clip_snapshots);
+
   G_OBJECT_CLASS (ges_timeline_parent_class)->finalize (object);
 }
 
@@ -518,6 +607,18 @@ ges_timeline_class_init (GESTimelineClass * klass)
       g_signal_new ("select-tracks-for-object", G_TYPE_FROM_CLASS (klass),
       G_SIGNAL_RUN_LAST, 0, _gst_array_accumulator, NULL, NULL,
       G_TYPE_PTR_ARRAY, 2, GES_TYPE_CLIP, GES_TYPE_TRACK_ELEMENT);
+
+  /**
+   * GESTimeline::commited:
+   * @timeline: the #GESTimeline
+   *
+   * This signal will be emitted once the changes initiated by
+   * ges_timeline_commit() have been pushed to the tracks.
+   */
+  ges_timeline_signals[COMMITED] =
+      g_signal_new ("commited", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST, 0, NULL, NULL, g_cclosure_marshal_generic,
+      G_TYPE_NONE, 0);
 }
 
 static void
@@ -540,14 +641,10 @@ ges_timeline_init (GESTimeline * self)
   priv->movecontext.ignore_needs_ctx = FALSE;
 
   priv->priv_tracks = NULL;
-  priv->by_start = g_hash_table_new (g_direct_hash, g_direct_equal);
-  priv->by_end = g_hash_table_new (g_direct_hash, g_direct_equal);
-  priv->by_object = g_hash_table_new (g_direct_hash, g_direct_equal);
   priv->by_layer = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
       (GDestroyNotify) g_sequence_free);
-  priv->obj_iters = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
-      (GDestroyNotify) _destroy_obj_iters);
-  priv->starts_ends = g_sequence_new (g_free);
+  priv->obj_iters = g_hash_table_new (g_direct_hash, g_direct_equal);
+  priv->starts_ends = g_sequence_new (NULL);
   priv->tracksources = g_sequence_new (gst_object_unref);
 
   priv->auto_transitions =
@@ -556,6 +653,13 @@ ges_timeline_init (GESTimeline * self)
 
   priv->group_id = -1;
 
+  priv->render_caches = NULL;
+  priv->use_cached_media = TRUE;
+  priv->dirty_start = GST_CLOCK_TIME_NONE;
+  priv->dirty_stop = GST_CLOCK_TIME_NONE;
+  priv->snapshot = NULL;
+  priv->clip_snapshots = ges_timeline_snapshot_new_clip_cache ();
+
   g_signal_connect_after (self, "select-tracks-for-object",
       G_CALLBACK (select_tracks_for_object_default), NULL);
 }
@@ -664,10 +768,8 @@ static inline void
 sort_starts_ends_end (GESTimeline * timeline, TrackObjIters * iters)
 {
   GESTimelineElement *obj = GES_TIMELINE_ELEMENT (iters->trackelement);
-  GESTimelinePrivate *priv = timeline->priv;
-  guint64 *end = g_hash_table_lookup (priv->by_end, obj);
 
-  *end = _START (obj) + _DURATION (obj);
+  iters->end.time = _START (obj) + _DURATION (obj);
 
   g_sequence_sort_changed (iters->iter_end, (GCompareDataFunc) compare_uint64,
       NULL);
@@ -678,16 +780,34 @@ static inline void
 sort_starts_ends_start (GESTimeline * timeline, TrackObjIters * iters)
 {
   GESTimelineElement *obj = GES_TIMELINE_ELEMENT (iters->trackelement);
-  GESTimelinePrivate *priv = timeline->priv;
-  guint64 *start = g_hash_table_lookup (priv->by_start, obj);
 
-  *start = _START (obj);
+  iters->start.time = _START (obj);
 
   g_sequence_sort_changed (iters->iter_start,
       (GCompareDataFunc) compare_uint64, NULL);
   timeline_update_duration (timeline);
 }
 
+/* Returns the start of @trackelement as tracked in starts_ends, or %NULL
+ * if it is not a source */
+static inline guint64 *
+get_tracked_start (GESTimeline * timeline, GESTrackElement * trackelement)
+{
+  TrackObjIters *iters = g_hash_table_lookup (timeline->priv->obj_iters,
+      trackelement);
+
+  return iters && iters->iter_start ? &iters->start.time : NULL;
+}
+
+static inline guint64 *
+get_tracked_end (GESTimeline * timeline, GESTrackElement * trackelement)
+{
+  TrackObjIters *iters = g_hash_table_lookup (timeline->priv->obj_iters,
+      trackelement);
+
+  return iters && iters->iter_end ? &iters->end.time : NULL;
+}
+
 static void
 _destroy_auto_transition_cb (GESAutoTransition * auto_transition,
     GESTimeline * timeline)
@@ -831,9 +951,8 @@ _create_transitions_on_layer (GESTimeline * timeline, GESLayer * layer,
       iter && !g_sequence_iter_is_end (iter);
       iter = g_sequence_iter_next (iter)) {
     GList *tmp;
-    guint *start_or_end = g_sequence_get (iter);
-    GESTrackElement *next = g_hash_table_lookup (timeline->priv->by_object,
-        start_or_end);
+    guint64 *start_or_end = g_sequence_get (iter);
+    GESTrackElement *next = EDGE_TRACK_ELEMENT (start_or_end);
     GESTimelineElement *toplevel =
         ges_timeline_element_get_toplevel_parent (GES_TIMELINE_ELEMENT (next));
 
@@ -845,7 +964,7 @@ _create_transitions_on_layer (GESTimeline * timeline, GESLayer * layer,
     if (track == NULL)
       ctrack = ges_track_element_get_track (next);
 
-    if (start_or_end == g_hash_table_lookup (priv->by_end, next)) {
+    if (EDGE_IS_END (start_or_end)) {
       if (initiating_obj == next) {
         /* We passed the objects that initiated the research
          * we are now done */
@@ -936,14 +1055,60 @@ clean_movecontext (MoveContext * mv_ctx)
   init_movecontext (mv_ctx, FALSE);
 }
 
+static inline void
+timeline_drop_snapshot (GESTimeline * timeline)
+{
+  if (timeline->priv->snapshot) {
+    ges_timeline_snapshot_unref (timeline->priv->snapshot);
+    timeline->priv->snapshot = NULL;
+  }
+}
+
+/* Only the clip containing @element has to be described again */
+static inline void
+timeline_drop_element_snapshot (GESTimeline * timeline,
+    GESTimelineElement * element)
+{
+  if (GES_IS_TRACK_ELEMENT (element) && element->parent)
+    element = element->parent;
+
+  if (GES_IS_CLIP (element))
+    g_hash_table_remove (timeline->priv->clip_snapshots, element);
+  timeline_drop_snapshot (timeline);
+}
+
+static inline void
+timeline_mark_dirty (GESTimeline * timeline, GstClockTime start,
+    GstClockTime stop)
+{
+  GESTimelinePrivate *priv = timeline->priv;
+
+  timeline_drop_snapshot (timeline);
+
+  /* Nobody cares about what changed */
+  if (G_LIKELY (priv->render_caches == NULL))
+    return;
+
+  if (!GST_CLOCK_TIME_IS_VALID (priv->dirty_start) ||
+      start < priv->dirty_start)
+    priv->dirty_start = start;
+
+  if (!GST_CLOCK_TIME_IS_VALID (priv->dirty_stop) || stop > priv->dirty_stop)
+    priv->dirty_stop = stop;
+}
+
 static void
 stop_tracking_track_element (GESTimeline * timeline,
     GESTrackElement * trackelement)
 {
-  guint64 *start, *end;
   TrackObjIters *iters;
   GESTimelinePrivate *priv = timeline->priv;
 
+  timeline_drop_element_snapshot (timeline,
+      GES_TIMELINE_ELEMENT (trackelement));
+  timeline_mark_dirty (timeline, _START (trackelement),
+      _END (trackelement));
+
   iters = g_hash_table_lookup (priv->obj_iters, trackelement);
   if (G_LIKELY (iters->iter_by_layer)) {
     g_sequence_remove (iters->iter_by_layer);
@@ -953,26 +1118,19 @@ stop_tracking_track_element (GESTimeline * timeline,
   }
 
   if (GES_IS_SOURCE (trackelement)) {
-    start = g_hash_table_lookup (priv->by_start, trackelement);
-    end = g_hash_table_lookup (priv->by_end, trackelement);
-
-    g_hash_table_remove (priv->by_start, trackelement);
-    g_hash_table_remove (priv->by_end, trackelement);
-    g_hash_table_remove (priv->by_object, end);
-    g_hash_table_remove (priv->by_object, start);
     g_sequence_remove (iters->iter_start);
     g_sequence_remove (iters->iter_end);
     g_sequence_remove (iters->iter_obj);
     timeline_update_duration (timeline);
   }
   g_hash_table_remove (priv->obj_iters, trackelement);
+  obj_iters_arena_free (&priv->obj_iters_arena, iters);
 }
 
 static void
 start_tracking_track_element (GESTimeline * timeline,
     GESTrackElement * trackelement)
 {
-  guint64 *pstart, *pend;
   GSequence *by_layer_sequence;
   TrackObjIters *iters;
   GESTimelinePrivate *priv = timeline->priv;
@@ -982,7 +1140,13 @@ start_tracking_track_element (GESTimeline * timeline,
       GINT_TO_POINTER (layer_prio), (GCompareFunc) find_layer_by_prio);
   GESLayer *layer = layer_node ? layer_node->data : NULL;
 
-  iters = g_slice_new0 (TrackObjIters);
+  timeline_drop_element_snapshot (timeline,
+      GES_TIMELINE_ELEMENT (trackelement));
+  timeline_mark_dirty (timeline, _START (trackelement),
+      _END (trackelement));
+
+  iters = obj_iters_arena_alloc (&priv->obj_iters_arena);
+  iters->trackelement = trackelement;
 
   /* We add all TrackElement to obj_iters as we always follow them
    * in the by_layer Sequences */
@@ -1009,25 +1173,19 @@ start_tracking_track_element (GESTimeline * timeline,
 
   if (GES_IS_SOURCE (trackelement)) {
     /* Track only sources for timeline edition and snapping */
-    pstart = g_malloc (sizeof (guint64));
-    pend = g_malloc (sizeof (guint64));
-    *pstart = _START (trackelement);
-    *pend = *pstart + _DURATION (trackelement);
-
-    iters->iter_start = g_sequence_insert_sorted (priv->starts_ends, pstart,
-        (GCompareDataFunc) compare_uint64, NULL);
-    iters->iter_end = g_sequence_insert_sorted (priv->starts_ends, pend,
-        (GCompareDataFunc) compare_uint64, NULL);
+    iters->start.time = _START (trackelement);
+    iters->start.iters = iters;
+    iters->end.time = iters->start.time + _DURATION (trackelement);
+    iters->end.iters = iters;
+
+    iters->iter_start = g_sequence_insert_sorted (priv->starts_ends,
+        &iters->start.time, (GCompareDataFunc) compare_uint64, NULL);
+    iters->iter_end = g_sequence_insert_sorted (priv->starts_ends,
+        &iters->end.time, (GCompareDataFunc) compare_uint64, NULL);
     iters->iter_obj =
         g_sequence_insert_sorted (priv->tracksources,
         gst_object_ref (trackelement), (GCompareDataFunc) element_start_compare,
         NULL);
-    iters->trackelement = trackelement;
-
-    g_hash_table_insert (priv->by_start, trackelement, pstart);
-    g_hash_table_insert (priv->by_object, pstart, trackelement);
-    g_hash_table_insert (priv->by_end, trackelement, pend);
-    g_hash_table_insert (priv->by_object, pend, trackelement);
 
     timeline->priv->movecontext.needs_move_ctx = TRUE;
 
@@ -1062,7 +1220,7 @@ ges_timeline_emit_snappig (GESTimeline * timeline, GESTrackElement * obj1,
     return;
   }
 
-  obj2 = g_hash_table_lookup (timeline->priv->by_object, timecode);
+  obj2 = EDGE_TRACK_ELEMENT (timecode);
 
   if (last_snap_ts != *timecode) {
     g_signal_emit (timeline, ges_timeline_signals[SNAPING_ENDED], 0,
@@ -1123,7 +1281,7 @@ ges_timeline_snap_position (GESTimeline * timeline,
   nxt_iter = iter;
   while (!g_sequence_iter_is_end (nxt_iter)) {
     next_tc = g_sequence_get (iter);
-    tmp_trackelement = g_hash_table_lookup (timeline->priv->by_object, next_tc);
+    tmp_trackelement = EDGE_TRACK_ELEMENT (next_tc);
     tmp_container = get_toplevel_container (tmp_trackelement);
 
     off = timecode > *next_tc ? timecode - *next_tc : *next_tc - timecode;
@@ -1143,7 +1301,7 @@ ges_timeline_snap_position (GESTimeline * timeline,
   prev_iter = g_sequence_iter_prev (iter);
   while (!g_sequence_iter_is_begin (prev_iter)) {
     prev_tc = g_sequence_get (prev_iter);
-    tmp_trackelement = g_hash_table_lookup (timeline->priv->by_object, prev_tc);
+    tmp_trackelement = EDGE_TRACK_ELEMENT (prev_tc);
     tmp_container = get_toplevel_container (tmp_trackelement);
 
     off1 = timecode > *prev_tc ? timecode - *prev_tc : *prev_tc - timecode;
@@ -1390,7 +1548,7 @@ ges_timeline_trim_object_simple (GESTimeline * timeline,
       duration = _DURATION (track_element);
 
       if (snapping) {
-        cur = g_hash_table_lookup (timeline->priv->by_start, track_element);
+        cur = get_tracked_start (timeline, track_element);
 
         snapped = ges_timeline_snap_position (timeline, track_element, cur,
             position, TRUE);
@@ -1434,7 +1592,7 @@ ges_timeline_trim_object_simple (GESTimeline * timeline,
     }
     case GES_EDGE_END:
     {
-      cur = g_hash_table_lookup (timeline->priv->by_end, track_element);
+      cur = get_tracked_end (timeline, track_element);
       snapped = ges_timeline_snap_position (timeline, track_element, cur,
           position, TRUE);
       if (snapped)
@@ -1485,7 +1643,7 @@ timeline_ripple_object (GESTimeline * timeline, GESTrackElement * obj,
       GST_DEBUG ("Simply rippling");
 
       /* We should be smart here to avoid recalculate transitions when possible */
-      cur = g_hash_table_lookup (timeline->priv->by_end, obj);
+      cur = get_tracked_end (timeline, obj);
       snapped = ges_timeline_snap_position (timeline, obj, cur, position, TRUE);
       if (snapped)
         position = *snapped;
@@ -1512,7 +1670,7 @@ timeline_ripple_object (GESTimeline * timeline, GESTrackElement * obj,
       timeline->priv->needs_transitions_update = FALSE;
       GST_DEBUG ("Rippling end");
 
-      cur = g_hash_table_lookup (timeline->priv->by_end, obj);
+      cur = get_tracked_end (timeline, obj);
       snapped = ges_timeline_snap_position (timeline, obj, cur, position, TRUE);
       if (snapped)
         position = *snapped;
@@ -1631,7 +1789,7 @@ timeline_roll_object (GESTimeline * timeline, GESTrackElement * obj,
       if (position < mv_ctx->max_trim_pos || position > end)
         goto error;
 
-      cur = g_hash_table_lookup (timeline->priv->by_start, obj);
+      cur = get_tracked_start (timeline, obj);
       snapped = ges_timeline_snap_position (timeline, obj, cur, position, TRUE);
       if (snapped)
         position = *snapped;
@@ -1668,7 +1826,7 @@ timeline_roll_object (GESTimeline * timeline, GESTrackElement * obj,
 
       end = _START (obj) + _DURATION (obj);
 
-      cur = g_hash_table_lookup (timeline->priv->by_end, obj);
+      cur = get_tracked_end (timeline, obj);
       snapped = ges_timeline_snap_position (timeline, obj, cur, position, TRUE);
       if (snapped)
         position = *snapped;
@@ -1752,7 +1910,7 @@ ges_timeline_move_object_simple (GESTimeline * timeline,
 
   track_element = GES_TRACK_ELEMENT (element);
   end = position + _DURATION (get_toplevel_container (track_element));
-  cur = g_hash_table_lookup (timeline->priv->by_end, track_element);
+  cur = get_tracked_end (timeline, track_element);
 
   GST_DEBUG_OBJECT (timeline, "Moving %" GST_PTR_FORMAT "to %"
       GST_TIME_FORMAT " (end %" GST_TIME_FORMAT ")", element,
@@ -1765,7 +1923,7 @@ ges_timeline_move_object_simple (GESTimeline * timeline,
   else
     off1 = G_MAXUINT64;
 
-  cur = g_hash_table_lookup (timeline->priv->by_start, track_element);
+  cur = get_tracked_start (timeline, track_element);
   snap_st =
       ges_timeline_snap_position (timeline, track_element, cur, position,
       FALSE);
@@ -1878,6 +2036,261 @@ timeline_remove_group (GESTimeline * timeline, GESGroup * group)
   gst_object_unref (group);
 }
 
+static GESClip *
+_copy_clip (GESClip * clip, GESLayer * layer, GHashTable * tracks)
+{
+  GList *tmp;
+  GESClip *copy;
+  GESTimeline *timeline = ges_layer_get_timeline (layer);
+
+  g_assert (timeline);
+
+  copy = GES_CLIP (ges_timeline_element_copy (GES_TIMELINE_ELEMENT (clip),
+          FALSE));
+
+  /* The copy references the timeline of @clip, it lands in another one */
+  ges_timeline_element_set_timeline (GES_TIMELINE_ELEMENT (copy), NULL);
+
+  /* We do not want the timeline to create again TrackElement-s */
+  ges_clip_set_moving_from_layer (copy, TRUE);
+  ges_layer_add_clip (layer, copy);
+  ges_clip_set_moving_from_layer (copy, FALSE);
+
+  for (tmp = GES_CONTAINER_CHILDREN (clip); tmp; tmp = tmp->next) {
+    GESTrack *track, *new_track;
+    GESTrackElement *new_trackelement, *trackelement =
+        GES_TRACK_ELEMENT (tmp->data);
+
+    /* Elements of tracks that were not copied are not copied either */
+    track = ges_track_element_get_track (trackelement);
+    if (!track || !(new_track = g_hash_table_lookup (tracks, track)))
+      continue;
+
+    new_trackelement =
+        GES_TRACK_ELEMENT (ges_timeline_element_copy (GES_TIMELINE_ELEMENT
+            (trackelement), FALSE));
+    if (new_trackelement == NULL) {
+      GST_WARNING_OBJECT (trackelement, "Could not create a copy");
+      continue;
+    }
+
+    ges_timeline_element_set_timeline (GES_TIMELINE_ELEMENT
+        (new_trackelement), NULL);
+
+    /* We know the track the copy goes to, no need to select it */
+    timeline->priv->ignore_track_element_added = copy;
+    ges_container_add (GES_CONTAINER (copy),
+        GES_TIMELINE_ELEMENT (new_trackelement));
+    timeline->priv->ignore_track_element_added = NULL;
+
+    if (!ges_track_add_element (new_track, new_trackelement)) {
+      GST_WARNING_OBJECT (copy, "Failed to add track element to track");
+      ges_container_remove (GES_CONTAINER (copy),
+          GES_TIMELINE_ELEMENT (new_trackelement));
+      continue;
+    }
+
+    ges_track_element_copy_properties (GES_TIMELINE_ELEMENT (trackelement),
+        GES_TIMELINE_ELEMENT (new_trackelement));
+    ges_track_element_copy_bindings (trackelement, new_trackelement);
+  }
+
+  return copy;
+}
+
+/* Returns the copy of @group in which the copies of its children were
+ * added, or %NULL if none of its children has been copied */
+static GESTimelineElement *
+_copy_group (GESContainer * group, GHashTable * elements)
+{
+  GList *tmp, *children = NULL;
+  GESContainer *copy = NULL;
+
+  for (tmp = GES_CONTAINER_CHILDREN (group); tmp; tmp = tmp->next) {
+    GESTimelineElement *child_copy;
+
+    if (GES_IS_GROUP (tmp->data))
+      child_copy = _copy_group (tmp->data, elements);
+    else
+      child_copy = g_hash_table_lookup (elements, tmp->data);
+
+    if (child_copy)
+      children = g_list_prepend (children, child_copy);
+  }
+
+  if (children) {
+    copy = GES_CONTAINER (ges_group_new ());
+    for (tmp = children; tmp; tmp = tmp->next)
+      ges_container_add (copy, tmp->data);
+    g_list_free (children);
+  }
+
+  return GES_TIMELINE_ELEMENT (copy);
+}
+
+static void
+_copy_meta (const GESMetaContainer * container, const gchar * key,
+    const GValue * value, GESMetaContainer * copy)
+{
+  ges_meta_container_set_meta (copy, key, value);
+}
+
+/* When @deep, metadatas and groups are copied as well */
+static GESTimeline *
+_copy_timeline (GESTimeline * timeline, GESTrackType track_types,
+    GstClockTime start, GstClockTime stop, gboolean deep)
+{
+  GList *tmp, *clips, *ctmp;
+  GHashTable *tracks, *elements = NULL;
+  GESTimeline *copy = ges_timeline_new ();
+
+  tracks = g_hash_table_new (g_direct_hash, g_direct_equal);
+  if (deep) {
+    elements = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+    /* Layers follow their own auto-transition value, see below */
+    copy->priv->auto_transition = timeline->priv->auto_transition;
+    copy->priv->snapping_distance = timeline->priv->snapping_distance;
+    ges_meta_container_foreach (GES_META_CONTAINER (timeline),
+        (GESMetaForeachFunc) _copy_meta, copy);
+  }
+
+  for (tmp = timeline->tracks; tmp; tmp = tmp->next) {
+    GESTrack *track = GES_TRACK (tmp->data);
+
+    if (track->type & track_types) {
+      GESTrack *new_track = ges_track_copy (track);
+
+      g_hash_table_insert (tracks, track, new_track);
+      ges_timeline_add_track (copy, new_track);
+    }
+  }
+
+  for (tmp = timeline->layers; tmp; tmp = tmp->next) {
+    GESLayer *layer = GES_LAYER (tmp->data);
+    GESLayer *new_layer = ges_layer_new ();
+    gboolean auto_transition = ges_layer_get_auto_transition (layer);
+
+    ges_layer_set_priority (new_layer, ges_layer_get_priority (layer));
+    ges_layer_set_auto_transition (new_layer, auto_transition);
+    if (deep)
+      ges_meta_container_foreach (GES_META_CONTAINER (layer),
+          (GESMetaForeachFunc) _copy_meta, new_layer);
+    ges_timeline_add_layer (copy, new_layer);
+
+    clips = ges_layer_get_clips (layer);
+    for (ctmp = clips; ctmp; ctmp = ctmp->next) {
+      GESClip *new_clip, *clip = GES_CLIP (ctmp->data);
+
+      if (_START (clip) >= stop || _END (clip) <= start)
+        continue;
+
+      /* Those are recreated by the new layer itself */
+      if (auto_transition && GES_IS_BASE_TRANSITION_CLIP (clip))
+        continue;
+
+      new_clip = _copy_clip (clip, new_layer, tracks);
+      if (elements)
+        g_hash_table_insert (elements, clip, new_clip);
+    }
+    g_list_free_full (clips, gst_object_unref);
+  }
+
+  if (elements) {
+    for (tmp = timeline->priv->groups; tmp; tmp = tmp->next) {
+      /* Nested groups are recreated with their toplevel group */
+      if (GES_TIMELINE_ELEMENT_PARENT (tmp->data) == NULL)
+        _copy_group (tmp->data, elements);
+    }
+    g_hash_table_unref (elements);
+  }
+  g_hash_table_unref (tracks);
+
+  return copy;
+}
+
+/* Creates a new timeline containing a copy of the tracks of @timeline whose
+ * type is in @track_types and of the clips between @start and @stop */
+GESTimeline *
+timeline_copy (GESTimeline * timeline, GESTrackType track_types,
+    GstClockTime start, GstClockTime stop)
+{
+  return _copy_timeline (timeline, track_types, start, stop, FALSE);
+}
+
+/**
+ * ges_timeline_clone:
+ * @timeline: The #GESTimeline to clone
+ *
+ * Creates a new timeline with copies of the tracks, layers, clips, track
+ * elements (including effects and their keyframes) and groups of @timeline.
+ * The copies are made directly from the objects, without going through
+ * serialization, and share their #GESAsset-s with the original objects,
+ * which makes it a cheap way to get a timeline to modify and render
+ * independently of @timeline.
+ *
+ * Returns: (transfer floating): A new #GESTimeline
+ */
+GESTimeline *
+ges_timeline_clone (GESTimeline * timeline)
+{
+  g_return_val_if_fail (GES_IS_TIMELINE (timeline), NULL);
+
+  return _copy_timeline (timeline, GES_TRACK_TYPE_UNKNOWN |
+      GES_TRACK_TYPE_AUDIO | GES_TRACK_TYPE_VIDEO | GES_TRACK_TYPE_TEXT |
+      GES_TRACK_TYPE_CUSTOM, 0, GST_CLOCK_TIME_NONE, TRUE);
+}
+
+void
+timeline_add_render_cache (GESTimeline * timeline, GESRenderCache * cache)
+{
+  GST_DEBUG_OBJECT (timeline, "Adding render cache %" GST_PTR_FORMAT, cache);
+
+  timeline->priv->render_caches =
+      g_list_prepend (timeline->priv->render_caches, cache);
+}
+
+void
+timeline_remove_render_cache (GESTimeline * timeline, GESRenderCache * cache)
+{
+  GST_DEBUG_OBJECT (timeline, "Removing render cache %" GST_PTR_FORMAT, cache);
+
+  timeline->priv->render_caches =
+      g_list_remove (timeline->priv->render_caches, cache);
+
+  if (timeline->priv->render_caches == NULL) {
+    timeline->priv->dirty_start = GST_CLOCK_TIME_NONE;
+    timeline->priv->dirty_stop = GST_CLOCK_TIME_NONE;
+  }
+}
+
+/* Makes the tracks use the media of the render caches or go back to the
+ * original content, the cached media being lossy previews */
+void
+timeline_set_use_cached_media (GESTimeline * timeline, gboolean use)
+{
+  GList *tmp;
+
+  if (timeline->priv->use_cached_media == use)
+    return;
+
+  timeline->priv->use_cached_media = use;
+  for (tmp = timeline->tracks; tmp; tmp = tmp->next) {
+    ges_track_set_use_cached_media (tmp->data, use);
+
+    if (timeline->priv->render_caches)
+      ges_track_commit (tmp->data);
+  }
+}
+
+void
+timeline_element_changed (GESTimeline * timeline,
+    GESTimelineElement * element)
+{
+  timeline_drop_element_snapshot (timeline, element);
+  timeline_mark_dirty (timeline, _START (element), _END (element));
+}
+
 static GPtrArray *
 select_tracks_for_object_default (GESTimeline * timeline,
     GESClip * clip, GESTrackElement * tr_object, gpointer user_data)
@@ -1930,6 +2343,7 @@ static void
 layer_auto_transition_changed_cb (GESLayer * layer,
     GParamSpec * arg G_GNUC_UNUSED, GESTimeline * timeline)
 {
+  timeline_drop_snapshot (timeline);
   _create_transitions_on_layer (timeline, layer, NULL, NULL,
       _create_auto_transition_from_transitions);
 
@@ -2030,14 +2444,50 @@ clip_track_element_removed_cb (GESClip * clip,
     ges_track_remove_element (track, track_element);
 }
 
+static void
+track_restriction_caps_changed_cb (GESTrack * track,
+    GParamSpec * arg G_GNUC_UNUSED, GESTimeline * timeline)
+{
+  /* The whole output of the track changes */
+  timeline_mark_dirty (timeline, 0, timeline->priv->duration);
+}
+
+/* The timings of the clip are part of its snapshot, what it covers is
+ * marked dirty through its children */
+static void
+clip_timing_changed_cb (GESClip * clip, GESTimingFlags changed,
+    GESTimeline * timeline)
+{
+  timeline_drop_element_snapshot (timeline, GES_TIMELINE_ELEMENT (clip));
+}
+
+/* Only connected to the properties, other than timings, that the snapshot
+ * of the clip describes */
+static void
+clip_notify_cb (GESClip * clip, GParamSpec * arg G_GNUC_UNUSED,
+    GESTimeline * timeline)
+{
+  timeline_drop_element_snapshot (timeline, GES_TIMELINE_ELEMENT (clip));
+}
+
 static void
 layer_object_added_cb (GESLayer * layer, GESClip * clip, GESTimeline * timeline)
 {
+  timeline_drop_snapshot (timeline);
+
   /* We make sure not to be connected twice */
   g_signal_handlers_disconnect_by_func (clip, clip_track_element_added_cb,
       timeline);
   g_signal_handlers_disconnect_by_func (clip, clip_track_element_removed_cb,
       timeline);
+  g_signal_handlers_disconnect_by_func (clip, clip_notify_cb, timeline);
+  ges_timeline_element_remove_timing_observer (GES_TIMELINE_ELEMENT (clip),
+      (GESTimingObserver) clip_timing_changed_cb, timeline);
+  ges_timeline_element_add_timing_observer (GES_TIMELINE_ELEMENT (clip),
+      GES_TIMING_ALL, TRUE, (GESTimingObserver) clip_timing_changed_cb,
+      timeline);
+  g_signal_connect (clip, "notify::supported-formats",
+      G_CALLBACK (clip_notify_cb), timeline);
 
   /* And we connect to the object */
   g_signal_connect (clip, "child-added",
@@ -2062,6 +2512,7 @@ static void
 layer_priority_changed_cb (GESLayer * layer,
     GParamSpec * arg G_GNUC_UNUSED, GESTimeline * timeline)
 {
+  timeline_drop_snapshot (timeline);
   timeline->layers = g_list_sort (timeline->layers, (GCompareFunc)
       sort_layers);
 }
@@ -2079,6 +2530,7 @@ layer_object_removed_cb (GESLayer * layer, GESClip * clip,
   }
 
   GST_DEBUG ("Clip %p removed from layer %p", clip, layer);
+  timeline_drop_snapshot (timeline);
 
   /* Go over the clip's track element and figure out which one belongs to
    * the list of tracks we control */
@@ -2107,6 +2559,10 @@ layer_object_removed_cb (GESLayer * layer, GESClip * clip,
       timeline);
   g_signal_handlers_disconnect_by_func (clip, clip_track_element_removed_cb,
       timeline);
+  g_signal_handlers_disconnect_by_func (clip, clip_notify_cb, timeline);
+  ges_timeline_element_remove_timing_observer (GES_TIMELINE_ELEMENT (clip),
+      (GESTimingObserver) clip_timing_changed_cb, timeline);
+  g_hash_table_remove (timeline->priv->clip_snapshots, clip);
 
   g_list_free_full (trackelements, gst_object_unref);
 
@@ -2114,12 +2570,17 @@ layer_object_removed_cb (GESLayer * layer, GESClip * clip,
 }
 
 static void
-trackelement_start_changed_cb (GESTrackElement * child,
-    GParamSpec * arg G_GNUC_UNUSED, GESTimeline * timeline)
+trackelement_start_changed (GESTrackElement * child, GESTimeline * timeline)
 {
   GESTimelinePrivate *priv = timeline->priv;
   TrackObjIters *iters = g_hash_table_lookup (priv->obj_iters, child);
 
+  if (GES_IS_SOURCE (child)) {
+    /* The edges still hold the old position of @child */
+    timeline_mark_dirty (timeline, iters->start.time, iters->end.time);
+  }
+  timeline_mark_dirty (timeline, _START (child), _END (child));
+
   if (G_LIKELY (iters->iter_by_layer))
     g_sequence_sort_changed (iters->iter_by_layer,
         (GCompareDataFunc) element_start_compare, NULL);
@@ -2142,8 +2603,7 @@ trackelement_start_changed_cb (GESTrackElement * child,
 }
 
 static void
-trackelement_priority_changed_cb (GESTrackElement * child,
-    GParamSpec * arg G_GNUC_UNUSED, GESTimeline * timeline)
+trackelement_priority_changed (GESTrackElement * child, GESTimeline * timeline)
 {
   GESTimelinePrivate *priv = timeline->priv;
 
@@ -2154,6 +2614,8 @@ trackelement_priority_changed_cb (GESTrackElement * child,
   TrackObjIters *iters = g_hash_table_lookup (priv->obj_iters,
       child);
 
+  timeline_mark_dirty (timeline, _START (child), _END (child));
+
   if (G_UNLIKELY (layer == NULL)) {
     GST_ERROR_OBJECT (timeline,
         "Changing a TrackElement prio, which would not "
@@ -2188,12 +2650,15 @@ trackelement_priority_changed_cb (GESTrackElement * child,
 }
 
 static void
-trackelement_duration_changed_cb (GESTrackElement * child,
-    GParamSpec * arg G_GNUC_UNUSED, GESTimeline * timeline)
+trackelement_duration_changed (GESTrackElement * child, GESTimeline * timeline)
 {
   GESTimelinePrivate *priv = timeline->priv;
   TrackObjIters *iters = g_hash_table_lookup (priv->obj_iters, child);
 
+  if (GES_IS_SOURCE (child))
+    timeline_mark_dirty (timeline, _START (child), iters->end.time);
+  timeline_mark_dirty (timeline, _START (child), _END (child));
+
   if (GES_IS_SOURCE (child)) {
     sort_starts_ends_end (timeline, iters);
 
@@ -2210,19 +2675,38 @@ trackelement_duration_changed_cb (GESTrackElement * child,
   }
 }
 
+static void
+trackelement_inpoint_changed (GESTrackElement * child, GESTimeline * timeline)
+{
+  timeline_mark_dirty (timeline, _START (child), _END (child));
+}
+
+static void
+trackelement_timing_changed_cb (GESTrackElement * child,
+    GESTimingFlags changed, GESTimeline * timeline)
+{
+  timeline_drop_element_snapshot (timeline, GES_TIMELINE_ELEMENT (child));
+
+  if (changed & GES_TIMING_PRIORITY)
+    trackelement_priority_changed (child, timeline);
+
+  /* Handling the start also takes care of the end and in-point */
+  if (changed & GES_TIMING_START)
+    trackelement_start_changed (child, timeline);
+  else if (changed & GES_TIMING_DURATION)
+    trackelement_duration_changed (child, timeline);
+  else if (changed & GES_TIMING_INPOINT)
+    trackelement_inpoint_changed (child, timeline);
+}
+
 static void
 track_element_added_cb (GESTrack * track, GESTrackElement * track_element,
     GESTimeline * timeline)
 {
-  /* Auto transition should be updated before we receive the signal */
-  g_signal_connect_after (GES_TRACK_ELEMENT (track_element), "notify::start",
-      G_CALLBACK (trackelement_start_changed_cb), timeline);
-  g_signal_connect_after (GES_TRACK_ELEMENT (track_element),
-      "notify::duration", G_CALLBACK (trackelement_duration_changed_cb),
-      timeline);
-  g_signal_connect_after (GES_TRACK_ELEMENT (track_element),
-      "notify::priority", G_CALLBACK (trackelement_priority_changed_cb),
-      timeline);
+  /* Auto transition should be updated before we get called */
+  ges_timeline_element_add_timing_observer (GES_TIMELINE_ELEMENT
+      (track_element), GES_TIMING_ALL, TRUE,
+      (GESTimingObserver) trackelement_timing_changed_cb, timeline);
 
   start_tracking_track_element (timeline, track_element);
 }
@@ -2237,13 +2721,9 @@ track_element_removed_cb (GESTrack * track,
     timeline->priv->movecontext.needs_move_ctx = TRUE;
   }
 
-  /* Disconnect all signal handlers */
-  g_signal_handlers_disconnect_by_func (track_element,
-      trackelement_start_changed_cb, NULL);
-  g_signal_handlers_disconnect_by_func (track_element,
-      trackelement_duration_changed_cb, NULL);
-  g_signal_handlers_disconnect_by_func (track_element,
-      trackelement_priority_changed_cb, NULL);
+  ges_timeline_element_remove_timing_observer (GES_TIMELINE_ELEMENT
+      (track_element), (GESTimingObserver) trackelement_timing_changed_cb,
+      timeline);
 
   stop_tracking_track_element (timeline, track_element);
 }
@@ -2294,7 +2774,10 @@ pad_added_cb (GESTrack * track, GstPad * pad, TrackPrivate * tr_priv)
   for (tmp = tr_priv->timeline->priv->priv_tracks; tmp; tmp = g_list_next (tmp)) {
     TrackPrivate *tr_priv = (TrackPrivate *) tmp->data;
 
-    if (!tr_priv->pad) {
+    /* Tracks in locked state are left aside by the pipeline and won't
+     * get any pad */
+    if (!tr_priv->pad && !GST_OBJECT_FLAG_IS_SET (tr_priv->track,
+            GST_ELEMENT_FLAG_LOCKED_STATE)) {
       GST_LOG ("Found track without pad %p", tr_priv->track);
       no_more = FALSE;
     }
@@ -2514,6 +2997,7 @@ ges_timeline_add_layer (GESTimeline * timeline, GESLayer * layer)
   }
 
   gst_object_ref_sink (layer);
+  timeline_drop_snapshot (timeline);
   timeline->layers = g_list_insert_sorted (timeline->layers, layer,
       (GCompareFunc) sort_layers);
 
@@ -2593,6 +3077,7 @@ ges_timeline_remove_layer (GESTimeline * timeline, GESLayer * layer)
 
   g_hash_table_remove (timeline->priv->by_layer, layer);
   timeline->layers = g_list_remove (timeline->layers, layer);
+  timeline_drop_snapshot (timeline);
   ges_layer_set_timeline (layer, NULL);
 
   g_signal_emit (timeline, ges_timeline_signals[LAYER_REMOVED], 0, layer);
@@ -2648,13 +3133,17 @@ ges_timeline_add_track (GESTimeline * timeline, GESTrack * track)
       tr_priv);
   UNLOCK_DYN (timeline);
   timeline->tracks = g_list_append (timeline->tracks, track);
+  timeline_drop_snapshot (timeline);
 
   /* Listen to pad-added/-removed */
   g_signal_connect (track, "pad-added", (GCallback) pad_added_cb, tr_priv);
   g_signal_connect (track, "pad-removed", (GCallback) pad_removed_cb, tr_priv);
+  g_signal_connect (track, "notify::restriction-caps",
+      (GCallback) track_restriction_caps_changed_cb, timeline);
 
   /* Inform the track that it's currently being used by ourself */
   ges_track_set_timeline (track, timeline);
+  ges_track_set_use_cached_media (track, timeline->priv->use_cached_media);
 
   GST_DEBUG ("Done adding track, emitting 'track-added' signal");
 
@@ -2731,6 +3220,7 @@ ges_timeline_remove_track (GESTimeline * timeline, GESTrack * track)
   priv->priv_tracks = g_list_remove (priv->priv_tracks, tr_priv);
   UNLOCK_DYN (timeline);
   timeline->tracks = g_list_remove (timeline->tracks, track);
+  timeline_drop_snapshot (timeline);
 
   ges_track_set_timeline (track, NULL);
 
@@ -2745,6 +3235,8 @@ ges_timeline_remove_track (GESTimeline * timeline, GESTrack * track)
   /* Remove pad-added/-removed handlers */
   g_signal_handlers_disconnect_by_func (track, pad_added_cb, tr_priv);
   g_signal_handlers_disconnect_by_func (track, pad_removed_cb, tr_priv);
+  g_signal_handlers_disconnect_by_func (track,
+      track_restriction_caps_changed_cb, timeline);
   g_signal_handlers_disconnect_by_func (track, track_element_added_cb,
       timeline);
   g_signal_handlers_disconnect_by_func (track, track_element_removed_cb,
@@ -2860,6 +3352,7 @@ ges_timeline_commit (GESTimeline * timeline)
 {
   GList *tmp;
   gboolean res = TRUE;
+  GESTimelinePrivate *priv = timeline->priv;
 
   GST_DEBUG_OBJECT (timeline, "commiting changes");
 
@@ -2868,6 +3361,15 @@ ges_timeline_commit (GESTimeline * timeline)
         NULL, NULL, _find_transition_from_auto_transitions);
   }
 
+  if (GST_CLOCK_TIME_IS_VALID (priv->dirty_start)) {
+    for (tmp = priv->render_caches; tmp; tmp = tmp->next)
+      ges_render_cache_invalidate (tmp->data, priv->dirty_start,
+          priv->dirty_stop - priv->dirty_start);
+
+    priv->dirty_start = GST_CLOCK_TIME_NONE;
+    priv->dirty_stop = GST_CLOCK_TIME_NONE;
+  }
+
   for (tmp = timeline->tracks; tmp; tmp = tmp->next) {
     if (!ges_track_commit (GES_TRACK (tmp->data)))
       res = FALSE;
@@ -2876,6 +3378,8 @@ ges_timeline_commit (GESTimeline * timeline)
   /* Make sure we reset the context */
   timeline->priv->movecontext.needs_move_ctx = TRUE;
 
+  g_signal_emit (timeline, ges_timeline_signals[COMMITED], 0);
+
   return res;
 }
 
@@ -2895,6 +3399,48 @@ ges_timeline_get_duration (GESTimeline * timeline)
   return timeline->priv->duration;
 }
 
+/**
+ * ges_timeline_snapshot:
+ * @timeline: a #GESTimeline
+ *
+ * Takes a #GESTimelineSnapshot of the current state of @timeline. This has
+ * to be called from the thread editing @timeline, but the returned snapshot
+ * can then be read from any thread while @timeline keeps being modified.
+ *
+ * As long as @timeline does not change, the same snapshot is returned.
+ * Otherwise, the new snapshot shares the description of every clip that
+ * did not change with the previous one.
+ *
+ * Returns: (transfer full): A #GESTimelineSnapshot of @timeline
+ */
+GESTimelineSnapshot *
+ges_timeline_snapshot (GESTimeline * timeline)
+{
+  GESTimelineSnapshot *snapshot;
+  GESTimelinePrivate *priv;
+
+  g_return_val_if_fail (GES_IS_TIMELINE (timeline), NULL);
+
+  priv = timeline->priv;
+  if (priv->snapshot && !ges_timeline_snapshot_is_animated (priv->snapshot))
+    return ges_timeline_snapshot_ref (priv->snapshot);
+
+  /* Only the clips that changed are described again */
+  snapshot = ges_timeline_snapshot_new (timeline, &priv->clip_snapshots);
+  if (priv->snapshot &&
+      ges_timeline_snapshot_shares_clips (priv->snapshot, snapshot)) {
+    ges_timeline_snapshot_unref (snapshot);
+
+    return ges_timeline_snapshot_ref (priv->snapshot);
+  }
+
+  if (priv->snapshot)
+    ges_timeline_snapshot_unref (priv->snapshot);
+  priv->snapshot = snapshot;
+
+  return ges_timeline_snapshot_ref (snapshot);
+}
+
 /**
  * ges_timeline_get_auto_transition:
  * @timeline: a #GESTimeline
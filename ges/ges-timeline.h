@@ -120,6 +120,9 @@ gboolean ges_timeline_commit (GESTimeline * timeline);
 
 GstClockTime ges_timeline_get_duration (GESTimeline *timeline);
 
+GESTimelineSnapshot * ges_timeline_snapshot (GESTimeline *timeline);
+GESTimeline * ges_timeline_clone (GESTimeline *timeline);
+
 gboolean ges_timeline_get_auto_transition (GESTimeline * timeline);
 void ges_timeline_set_auto_transition (GESTimeline * timeline, gboolean auto_transition);
 GstClockTime ges_timeline_get_snapping_distance (GESTimeline * timeline);
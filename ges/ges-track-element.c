@@ -44,20 +44,23 @@ struct _GESTrackElementPrivate
 {
   GESTrackType track_type;
 
-  /* These fields are only used before the gnlobject is available */
+  /* These fields are used before the gnlobject is available, and then
+   * to hold the timings the gnlobject will get at the next commit */
   guint64 pending_start;
   guint64 pending_inpoint;
   guint64 pending_duration;
   guint32 pending_priority;
   gboolean pending_active;
 
+  /* %TRUE when the pending timings have not been set on the gnlobject yet */
+  gboolean gnlobject_dirty;
+
   GstElement *gnlobject;        /* The GnlObject */
   GstElement *element;          /* The element contained in the gnlobject (can be NULL) */
 
-  /* We keep a link between properties name and elements internally
-   * The hashtable should look like
-   * {GParamaSpec ---> element,}*/
-  GHashTable *children_props;
+  /* The ChildrenProps added through ges_track_element_add_children_props,
+   * the last ones taking precedence */
+  GArray *children_props;
 
   GESTrack *track;
 
@@ -79,6 +82,38 @@ typedef struct
   gchar *binding_type;
 } PendingBinding;
 
+typedef struct
+{
+  /* Slot of the child the property belongs to */
+  guint child;
+  GParamSpec *pspec;
+} ChildPropertyEntry;
+
+/* The children properties of a given layout of children, shared by all the
+ * elements with that layout */
+typedef struct
+{
+  /* Protected by the children_props_schemas lock */
+  gint refcount;
+  gchar *key;
+
+  /* The position in the layout of the child of each slot */
+  guint *layout;
+  guint n_children;
+
+  /* ChildPropertyEntry, a given property only appearing once */
+  GArray *entries;
+} ChildrenPropsSchema;
+
+/* The children of an element, indexed by schema slot */
+typedef struct
+{
+  ChildrenPropsSchema *schema;
+  GstElement **children;
+} ChildrenProps;
+
+static void _clear_children_props (ChildrenProps * props);
+
 enum
 {
   PROP_0,
@@ -119,6 +154,8 @@ static GParamSpec **default_list_children_properties (GESTrackElement * object,
 static void
 _update_control_bindings (GESTimelineElement * element, GstClockTime inpoint,
     GstClockTime duration);
+static void _timing_changed_cb (GESTimelineElement * element,
+    GESTimingFlags changed, gpointer unused);
 
 static void
 ges_track_element_get_property (GObject * object, guint property_id,
@@ -165,7 +202,15 @@ ges_track_element_dispose (GObject * object)
   GESTrackElement *element = GES_TRACK_ELEMENT (object);
   GESTrackElementPrivate *priv = element->priv;
 
-  g_hash_table_destroy (priv->children_props);
+  if (priv->children_props) {
+    guint i;
+
+    for (i = 0; i < priv->children_props->len; i++)
+      _clear_children_props (&g_array_index (priv->children_props,
+              ChildrenProps, i));
+    g_array_free (priv->children_props, TRUE);
+    priv->children_props = NULL;
+  }
   if (priv->bindings_hashtable)
     g_hash_table_destroy (priv->bindings_hashtable);
 
@@ -276,12 +321,16 @@ ges_track_element_init (GESTrackElement * self)
   priv->pending_duration = GST_SECOND;
   priv->pending_priority = MIN_GNL_PRIO;
   priv->pending_active = TRUE;
+  priv->gnlobject_dirty = FALSE;
   priv->bindings_hashtable = g_hash_table_new_full (g_str_hash, g_str_equal,
       g_free, NULL);
-  priv->children_props =
-      g_hash_table_new_full ((GHashFunc) pspec_hash, pspec_equal,
-      (GDestroyNotify) g_param_spec_unref, gst_object_unref);
+  priv->children_props = g_array_new (FALSE, FALSE, sizeof (ChildrenProps));
 
+  /* Keyframes only follow our timings once they are all set, so that changing
+   * the in-point and duration at once only updates them once */
+  ges_timeline_element_add_timing_observer (GES_TIMELINE_ELEMENT (self),
+      GES_TIMING_INPOINT | GES_TIMING_DURATION, FALSE, _timing_changed_cb,
+      NULL);
 }
 
 static gfloat
@@ -395,6 +444,48 @@ _update_control_bindings (GESTimelineElement * element, GstClockTime inpoint,
   g_free (specs);
 }
 
+static void
+_timing_changed_cb (GESTimelineElement * element, GESTimingFlags changed,
+    gpointer unused)
+{
+  /* The end keyframes are only moved when the duration changed */
+  _update_control_bindings (element, _INPOINT (element),
+      changed & GES_TIMING_DURATION ? _DURATION (element) :
+      GST_CLOCK_TIME_NONE);
+}
+
+/* Timings are only set on the gnlobject when the track is commited, as
+ * gnonlin does not take them into account before anyway */
+static inline void
+gnlobject_mark_dirty (GESTrackElement * object)
+{
+  if (object->priv->gnlobject_dirty)
+    return;
+
+  object->priv->gnlobject_dirty = TRUE;
+  if (object->priv->track)
+    ges_track_queue_gnlobject_update (object->priv->track, object);
+}
+
+/* Sets the pending timings on the gnlobject, called by our track when
+ * commiting */
+void
+ges_track_element_sync_gnlobject (GESTrackElement * object)
+{
+  GESTrackElementPrivate *priv = object->priv;
+
+  if (!priv->gnlobject_dirty || priv->gnlobject == NULL)
+    return;
+
+  g_object_set (priv->gnlobject,
+      "start", priv->pending_start,
+      "inpoint", priv->pending_inpoint,
+      "duration", priv->pending_duration,
+      "priority", priv->pending_priority, NULL);
+
+  priv->gnlobject_dirty = FALSE;
+}
+
 static gboolean
 _set_start (GESTimelineElement * element, GstClockTime start)
 {
@@ -404,9 +495,9 @@ _set_start (GESTimelineElement * element, GstClockTime start)
     if (G_UNLIKELY (start == _START (object)))
       return FALSE;
 
-    g_object_set (object->priv->gnlobject, "start", start, NULL);
-  } else
-    object->priv->pending_start = start;
+    gnlobject_mark_dirty (object);
+  }
+  object->priv->pending_start = start;
 
   return TRUE;
 }
@@ -421,11 +512,9 @@ _set_inpoint (GESTimelineElement * element, GstClockTime inpoint)
 
       return FALSE;
 
-    g_object_set (object->priv->gnlobject, "inpoint", inpoint, NULL);
-  } else
-    object->priv->pending_inpoint = inpoint;
-
-  _update_control_bindings (element, inpoint, GST_CLOCK_TIME_NONE);
+    gnlobject_mark_dirty (object);
+  }
+  object->priv->pending_inpoint = inpoint;
 
   return TRUE;
 }
@@ -444,12 +533,9 @@ _set_duration (GESTimelineElement * element, GstClockTime duration)
     if (G_UNLIKELY (duration == _DURATION (object)))
       return FALSE;
 
-    g_object_set (priv->gnlobject, "duration", duration, NULL);
-  } else
-    priv->pending_duration = duration;
-
-  _update_control_bindings (element, ges_timeline_element_get_inpoint (element),
-      duration);
+    gnlobject_mark_dirty (object);
+  }
+  priv->pending_duration = duration;
 
   return TRUE;
 }
@@ -471,13 +557,26 @@ _set_priority (GESTimelineElement * element, guint32 priority)
     if (G_UNLIKELY (priority == _PRIORITY (object)))
       return FALSE;
 
-    g_object_set (object->priv->gnlobject, "priority", priority, NULL);
-  } else
-    object->priv->pending_priority = priority;
+    gnlobject_mark_dirty (object);
+  }
+  object->priv->pending_priority = priority;
 
   return TRUE;
 }
 
+/* Lets the timeline and the track know the output of @object changed, they
+ * can not notice it by themselves */
+void
+ges_track_element_content_changed (GESTrackElement * object)
+{
+  GESTimeline *timeline = GES_TIMELINE_ELEMENT_TIMELINE (object);
+
+  if (timeline)
+    timeline_element_changed (timeline, GES_TIMELINE_ELEMENT (object));
+  if (object->priv->track)
+    ges_track_content_changed (object->priv->track, object);
+}
+
 /**
  * ges_track_element_set_active:
  * @object: a #GESTrackElement
@@ -499,13 +598,17 @@ ges_track_element_set_active (GESTrackElement * object, gboolean active)
     if (G_UNLIKELY (active == object->active))
       return FALSE;
 
-    g_object_set (object->priv->gnlobject, "active", active, NULL);
+    object->active = active;
 
-    if (active != object->active) {
-      object->active = active;
-      if (GES_TRACK_ELEMENT_GET_CLASS (object)->active_changed)
-        GES_TRACK_ELEMENT_GET_CLASS (object)->active_changed (object, active);
-    }
+    /* The track might keep the gnlobject inactive */
+    if (object->priv->track)
+      ges_track_update_element_activity (object->priv->track, object);
+    else
+      g_object_set (object->priv->gnlobject, "active", active, NULL);
+
+    if (GES_TRACK_ELEMENT_GET_CLASS (object)->active_changed)
+      GES_TRACK_ELEMENT_GET_CLASS (object)->active_changed (object, active);
+    ges_track_element_content_changed (object);
   } else
     object->priv->pending_active = active;
 
@@ -540,22 +643,44 @@ gst_element_prop_changed_cb (GstElement * element, GParamSpec * arg
 }
 
 static void
-connect_signal (gpointer key, gpointer value, gpointer user_data)
+connect_properties_signals (GESTrackElement * object, ChildrenProps * props)
 {
-  gchar *signame = g_strconcat ("notify::", G_PARAM_SPEC (key)->name, NULL);
+  guint i;
+  gchar *signame;
+  ChildPropertyEntry *entry;
+
+  for (i = 0; i < props->schema->entries->len; i++) {
+    entry = &g_array_index (props->schema->entries, ChildPropertyEntry, i);
+    signame = g_strconcat ("notify::", entry->pspec->name, NULL);
 
-  g_signal_connect (G_OBJECT (value),
-      signame, G_CALLBACK (gst_element_prop_changed_cb),
-      GES_TRACK_ELEMENT (user_data));
+    g_signal_connect (G_OBJECT (props->children[entry->child]),
+        signame, G_CALLBACK (gst_element_prop_changed_cb), object);
 
-  g_free (signame);
+    g_free (signame);
+  }
 }
 
-static void
-connect_properties_signals (GESTrackElement * object)
+/* Returns: (transfer none): the child of @object having @pspec, or %NULL */
+static GstElement *
+_find_child_prop (GESTrackElement * object, GParamSpec * pspec)
 {
-  g_hash_table_foreach (object->priv->children_props,
-      (GHFunc) connect_signal, object);
+  guint i, j;
+  ChildrenProps *props;
+  ChildPropertyEntry *entry;
+  GArray *children_props = object->priv->children_props;
+
+  for (i = children_props->len; i > 0; i--) {
+    props = &g_array_index (children_props, ChildrenProps, i - 1);
+
+    for (j = 0; j < props->schema->entries->len; j++) {
+      entry = &g_array_index (props->schema->entries, ChildPropertyEntry, j);
+
+      if (pspec_equal (entry->pspec, pspec))
+        return props->children[entry->child];
+    }
+  }
+
+  return NULL;
 }
 
 /* default 'create_gnl_object' virtual method implementation */
@@ -724,6 +849,197 @@ strv_find_str (const gchar ** strv, const char *str)
   return FALSE;
 }
 
+/* ChildrenPropsSchema-s indexed by a string describing the filters and the
+ * factories of the children, a schema being dropped once no element uses
+ * it anymore */
+G_LOCK_DEFINE_STATIC (children_props_schemas);
+static GHashTable *children_props_schemas = NULL;
+
+static void
+_schema_add_property (GArray * entries, guint child, GParamSpec * pspec)
+{
+  guint i;
+  ChildPropertyEntry *entry, new_entry = { child, NULL };
+
+  /* As with a table indexed by pspec, the last child having it wins */
+  for (i = 0; i < entries->len; i++) {
+    entry = &g_array_index (entries, ChildPropertyEntry, i);
+
+    if (pspec_equal (entry->pspec, pspec)) {
+      entry->child = child;
+      return;
+    }
+  }
+
+  new_entry.pspec = g_param_spec_ref (pspec);
+  g_array_append_val (entries, new_entry);
+}
+
+/* Only keeps the children having properties, the entries referring to them
+ * by @layout position until then */
+static void
+_schema_compact (ChildrenPropsSchema * schema, guint layout_size)
+{
+  guint i, *slots = g_new (guint, layout_size);
+
+  for (i = 0; i < layout_size; i++)
+    slots[i] = G_MAXUINT;
+
+  schema->layout = g_new (guint, layout_size);
+  schema->n_children = 0;
+  for (i = 0; i < schema->entries->len; i++) {
+    ChildPropertyEntry *entry = &g_array_index (schema->entries,
+        ChildPropertyEntry, i);
+
+    if (slots[entry->child] == G_MAXUINT) {
+      slots[entry->child] = schema->n_children;
+      schema->layout[schema->n_children++] = entry->child;
+    }
+    entry->child = slots[entry->child];
+  }
+
+  g_free (slots);
+}
+
+static void
+_schema_unref (ChildrenPropsSchema * schema)
+{
+  guint i;
+
+  G_LOCK (children_props_schemas);
+  if (--schema->refcount > 0) {
+    G_UNLOCK (children_props_schemas);
+    return;
+  }
+
+  g_hash_table_remove (children_props_schemas, schema->key);
+  if (g_hash_table_size (children_props_schemas) == 0) {
+    g_hash_table_unref (children_props_schemas);
+    children_props_schemas = NULL;
+  }
+  G_UNLOCK (children_props_schemas);
+
+  for (i = 0; i < schema->entries->len; i++)
+    g_param_spec_unref (g_array_index (schema->entries, ChildPropertyEntry,
+            i).pspec);
+  g_array_free (schema->entries, TRUE);
+  g_free (schema->layout);
+  g_free (schema->key);
+  g_slice_free (ChildrenPropsSchema, schema);
+}
+
+static void
+_clear_children_props (ChildrenProps * props)
+{
+  guint i;
+
+  for (i = 0; i < props->schema->n_children; i++)
+    gst_object_unref (props->children[i]);
+  g_free (props->children);
+  _schema_unref (props->schema);
+}
+
+static void
+_append_strv (GString * key, const gchar ** strv)
+{
+  guint i;
+
+  for (i = 0; strv && strv[i]; i++) {
+    g_string_append (key, strv[i]);
+    g_string_append_c (key, ',');
+  }
+  g_string_append_c (key, '|');
+}
+
+static GArray *
+_compute_children_props_entries (GPtrArray * children,
+    const gchar ** wanted_categories, const gchar ** blacklist,
+    const gchar ** whitelist)
+{
+  guint n;
+  GArray *entries = g_array_new (FALSE, FALSE, sizeof (ChildPropertyEntry));
+
+  for (n = 0; n < children->len; n++) {
+    guint i;
+    gchar **categories;
+    const gchar *klass;
+    GstElement *child = g_ptr_array_index (children, n);
+    GstElementFactory *factory = gst_element_get_factory (child);
+
+    if (factory == NULL)
+      continue;
+
+    klass = gst_element_factory_get_metadata (factory,
+        GST_ELEMENT_METADATA_KLASS);
+
+    if (strv_find_str (blacklist, GST_OBJECT_NAME (factory))) {
+      GST_DEBUG ("%s blacklisted", GST_OBJECT_NAME (factory));
+      continue;
+    }
+
+    GST_DEBUG ("Looking at element '%s' of klass '%s'",
+        GST_ELEMENT_NAME (child), klass);
+
+    categories = g_strsplit (klass, "/", 0);
+
+    for (i = 0; categories[i]; i++) {
+      if ((!wanted_categories ||
+              strv_find_str (wanted_categories, categories[i]))) {
+        guint j, nb_specs;
+        GParamSpec **parray;
+
+        parray = g_object_class_list_properties (G_OBJECT_GET_CLASS (child),
+            &nb_specs);
+        for (j = 0; j < nb_specs; j++) {
+          if ((parray[j]->flags & G_PARAM_WRITABLE) &&
+              (!whitelist || strv_find_str (whitelist, parray[j]->name)))
+            _schema_add_property (entries, n, parray[j]);
+        }
+        g_free (parray);
+
+        GST_DEBUG
+            ("%d configurable properties of '%s' added to property hashtable",
+            nb_specs, GST_ELEMENT_NAME (child));
+        break;
+      }
+    }
+
+    g_strfreev (categories);
+  }
+
+  return entries;
+}
+
+static GArray *
+_compute_element_props_entries (GstElement * element,
+    const gchar ** whitelist)
+{
+  guint i;
+  GParamSpec *pspec;
+  GObjectClass *class = G_OBJECT_GET_CLASS (element);
+  GArray *entries = g_array_new (FALSE, FALSE, sizeof (ChildPropertyEntry));
+
+  for (i = 0; whitelist[i]; i++) {
+    pspec = g_object_class_find_property (class, whitelist[i]);
+    if (!pspec) {
+      GST_WARNING ("no such property : %s in element : %s", whitelist[i],
+          GST_ELEMENT_NAME (element));
+      continue;
+    }
+
+    if (pspec->flags & G_PARAM_WRITABLE) {
+      _schema_add_property (entries, 0, pspec);
+      GST_LOG ("added property %s to controllable properties successfully !",
+          whitelist[i]);
+    } else
+      GST_WARNING
+          ("the property %s for element %s exists but is not writable",
+          whitelist[i], GST_ELEMENT_NAME (element));
+  }
+
+  return entries;
+}
+
 /**
  * ges_track_element_add_children_props:
  * @self: The #GESTrackElement to set chidlren props on
@@ -746,117 +1062,102 @@ ges_track_element_add_children_props (GESTrackElement * self,
     GstElement * element, const gchar ** wanted_categories,
     const gchar ** blacklist, const gchar ** whitelist)
 {
+  guint i;
+  GString *key;
+  gsize prefix_len;
+  ChildrenProps props;
+  ChildrenPropsSchema *schema;
+  GPtrArray *children;
   GValue item = { 0, };
   GstIterator *it;
-  GParamSpec **parray;
-  GObjectClass *class;
-  const gchar *klass;
   GstElementFactory *factory;
   gboolean done = FALSE;
 
-  if (!GST_IS_BIN (element)) {
-    guint i;
-    GParamSpec *pspec;
+  /* Which properties are added only depends on the filters and on the
+   * factories of the children, so it is computed once per layout and then
+   * shared */
+  children = g_ptr_array_new_with_free_func (gst_object_unref);
+  key = g_string_new (NULL);
+  _append_strv (key, wanted_categories);
+  _append_strv (key, blacklist);
+  _append_strv (key, whitelist);
+  prefix_len = key->len;
 
-    GObjectClass *class = G_OBJECT_GET_CLASS (element);
+  if (!GST_IS_BIN (element)) {
+    g_string_append_c (key, '=');
+    g_string_append (key, G_OBJECT_TYPE_NAME (element));
+    g_ptr_array_add (children, gst_object_ref (element));
+    done = TRUE;
+  } else {
+    it = gst_bin_iterate_recurse (GST_BIN (element));
+    while (!done) {
+      switch (gst_iterator_next (it, &item)) {
+        case GST_ITERATOR_OK:
+        {
+          GstElement *child = g_value_get_object (&item);
+
+          factory = gst_element_get_factory (child);
+          g_string_append (key, factory ? GST_OBJECT_NAME (factory) :
+              G_OBJECT_TYPE_NAME (child));
+          g_string_append_c (key, ';');
+          g_ptr_array_add (children, gst_object_ref (child));
+
+          g_value_reset (&item);
+          break;
+        }
+        case GST_ITERATOR_RESYNC:
+          GST_DEBUG ("iterator resync");
+          g_ptr_array_set_size (children, 0);
+          g_string_truncate (key, prefix_len);
+          gst_iterator_resync (it);
+          break;
 
-    for (i = 0; whitelist[i]; i++) {
+        case GST_ITERATOR_DONE:
+          GST_DEBUG ("iterator done");
+          done = TRUE;
+          break;
 
-      pspec = g_object_class_find_property (class, whitelist[i]);
-      if (!pspec) {
-        GST_WARNING ("no such property : %s in element : %s", whitelist[i],
-            gst_element_get_name (element));
-        continue;
+        default:
+          break;
       }
-
-      if (pspec->flags & G_PARAM_WRITABLE) {
-        g_hash_table_insert (self->priv->children_props,
-            g_param_spec_ref (pspec), gst_object_ref (element));
-        GST_LOG_OBJECT (self,
-            "added property %s to controllable properties successfully !",
-            whitelist[i]);
-      } else
-        GST_WARNING
-            ("the property %s for element %s exists but is not writable",
-            whitelist[i], gst_element_get_name (element));
-
+      g_value_unset (&item);
     }
-
-    connect_properties_signals (self);
-    return;
+    gst_iterator_free (it);
   }
 
-  /*  We go over child elements recursivly, and add writable properties to the
-   *  hashtable */
-  it = gst_bin_iterate_recurse (GST_BIN (element));
-  while (!done) {
-    switch (gst_iterator_next (it, &item)) {
-      case GST_ITERATOR_OK:
-      {
-        gchar **categories;
-        guint i;
-        GstElement *child = g_value_get_object (&item);
-
-        factory = gst_element_get_factory (child);
-        klass = gst_element_factory_get_metadata (factory,
-            GST_ELEMENT_METADATA_KLASS);
-
-        if (strv_find_str (blacklist, GST_OBJECT_NAME (factory))) {
-          GST_DEBUG_OBJECT (self, "%s blacklisted", GST_OBJECT_NAME (factory));
-          continue;
-        }
-
-        GST_DEBUG ("Looking at element '%s' of klass '%s'",
-            GST_ELEMENT_NAME (child), klass);
-
-        categories = g_strsplit (klass, "/", 0);
-
-        for (i = 0; categories[i]; i++) {
-          if ((!wanted_categories ||
-                  strv_find_str (wanted_categories, categories[i]))) {
-            guint i, nb_specs;
-
-            class = G_OBJECT_GET_CLASS (child);
-            parray = g_object_class_list_properties (class, &nb_specs);
-            for (i = 0; i < nb_specs; i++) {
-              if ((parray[i]->flags & G_PARAM_WRITABLE) &&
-                  (!whitelist || strv_find_str (whitelist, parray[i]->name))) {
-                g_hash_table_insert (self->priv->children_props,
-                    g_param_spec_ref (parray[i]), gst_object_ref (child));
-              }
-            }
-            g_free (parray);
-
-            GST_DEBUG
-                ("%d configurable properties of '%s' added to property hashtable",
-                nb_specs, GST_ELEMENT_NAME (child));
-            break;
-          }
-        }
-
-        g_strfreev (categories);
-        g_value_reset (&item);
-        break;
-      }
-      case GST_ITERATOR_RESYNC:
-        /* FIXME, properly restart the process */
-        GST_DEBUG ("iterator resync");
-        gst_iterator_resync (it);
-        break;
+  G_LOCK (children_props_schemas);
+  if (G_UNLIKELY (children_props_schemas == NULL))
+    children_props_schemas = g_hash_table_new (g_str_hash, g_str_equal);
+
+  schema = g_hash_table_lookup (children_props_schemas, key->str);
+  if (schema == NULL) {
+    GST_DEBUG_OBJECT (self, "New children layout: %s", key->str);
+    schema = g_slice_new0 (ChildrenPropsSchema);
+    if (GST_IS_BIN (element))
+      schema->entries = _compute_children_props_entries (children,
+          wanted_categories, blacklist, whitelist);
+    else
+      schema->entries = _compute_element_props_entries (element, whitelist);
+    _schema_compact (schema, children->len);
+    schema->key = g_string_free (key, FALSE);
+    g_hash_table_insert (children_props_schemas, schema->key, schema);
+    key = NULL;
+  }
+  schema->refcount++;
+  G_UNLOCK (children_props_schemas);
 
-      case GST_ITERATOR_DONE:
-        GST_DEBUG ("iterator done");
-        done = TRUE;
-        break;
+  props.schema = schema;
+  props.children = g_new (GstElement *, schema->n_children);
+  for (i = 0; i < schema->n_children; i++)
+    props.children[i] =
+        gst_object_ref (g_ptr_array_index (children, schema->layout[i]));
+  g_array_append_val (self->priv->children_props, props);
 
-      default:
-        break;
-    }
-    g_value_unset (&item);
-  }
-  gst_iterator_free (it);
+  if (key)
+    g_string_free (key, TRUE);
+  g_ptr_array_unref (children);
 
-  connect_properties_signals (self);
+  connect_properties_signals (self, &props);
 }
 
 /* INTERNAL USAGE */
@@ -879,6 +1180,9 @@ ges_track_element_set_track (GESTrackElement * object, GESTrack * track)
     if (object->priv->gnlobject) {
       g_object_set (object->priv->gnlobject,
           "caps", ges_track_get_caps (object->priv->track), NULL);
+
+      if (object->priv->gnlobject_dirty)
+        ges_track_queue_gnlobject_update (track, object);
     } else {
       ret = ensure_gnl_object (object);
 
@@ -1022,8 +1326,7 @@ gboolean
 ges_track_element_lookup_child (GESTrackElement * object,
     const gchar * prop_name, GstElement ** element, GParamSpec ** pspec)
 {
-  GHashTableIter iter;
-  gpointer key, value;
+  guint i;
   gchar **names, *name, *classename;
   gboolean res;
 
@@ -1039,16 +1342,24 @@ ges_track_element_lookup_child (GESTrackElement * object,
   } else
     name = names[0];
 
-  g_hash_table_iter_init (&iter, object->priv->children_props);
-  while (g_hash_table_iter_next (&iter, &key, &value)) {
-    if (g_strcmp0 (G_PARAM_SPEC (key)->name, name) == 0) {
-      if (classename == NULL ||
-          g_strcmp0 (G_OBJECT_TYPE_NAME (G_OBJECT (value)), classename) == 0) {
+  for (i = object->priv->children_props->len; i > 0 && !res; i--) {
+    guint j;
+    ChildrenProps *props = &g_array_index (object->priv->children_props,
+        ChildrenProps, i - 1);
+
+    for (j = 0; j < props->schema->entries->len; j++) {
+      ChildPropertyEntry *entry = &g_array_index (props->schema->entries,
+          ChildPropertyEntry, j);
+      GstElement *child = props->children[entry->child];
+
+      if (g_strcmp0 (entry->pspec->name, name) == 0 &&
+          (classename == NULL ||
+              g_strcmp0 (G_OBJECT_TYPE_NAME (child), classename) == 0)) {
         GST_DEBUG ("The %s property from %s has been found", name, classename);
         if (element)
-          *element = gst_object_ref (value);
+          *element = gst_object_ref (child);
 
-        *pspec = g_param_spec_ref (key);
+        *pspec = g_param_spec_ref (entry->pspec);
         res = TRUE;
         break;
       }
@@ -1077,11 +1388,12 @@ ges_track_element_set_child_property_by_pspec (GESTrackElement * object,
   g_return_if_fail (GES_IS_TRACK_ELEMENT (object));
 
 
-  element = g_hash_table_lookup (object->priv->children_props, pspec);
+  element = _find_child_prop (object, pspec);
   if (!element)
     goto not_found;
 
   g_object_set_property (G_OBJECT (element), pspec->name, value);
+  ges_track_element_content_changed (object);
 
   return;
 
@@ -1147,6 +1459,8 @@ ges_track_element_set_child_property_valist (GESTrackElement * object,
 
     name = va_arg (var_args, gchar *);
   }
+  ges_track_element_content_changed (object);
+
   return;
 
 not_found:
@@ -1319,7 +1633,7 @@ ges_track_element_get_child_property_by_pspec (GESTrackElement * object,
 
   g_return_if_fail (GES_IS_TRACK_ELEMENT (object));
 
-  element = g_hash_table_lookup (object->priv->children_props, pspec);
+  element = _find_child_prop (object, pspec);
   if (!element)
     goto not_found;
 
@@ -1361,6 +1675,7 @@ ges_track_element_set_child_property (GESTrackElement * object,
     goto not_found;
 
   g_object_set_property (G_OBJECT (element), pspec->name, value);
+  ges_track_element_content_changed (object);
 
   gst_object_unref (element);
   g_param_spec_unref (pspec);
@@ -1428,20 +1743,31 @@ static GParamSpec **
 default_list_children_properties (GESTrackElement * object,
     guint * n_properties)
 {
-  GParamSpec **pspec, *spec;
-  GHashTableIter iter;
-  gpointer key, value;
+  GParamSpec **pspec;
+  guint i, j, k, n = 0;
+  GArray *children_props = object->priv->children_props;
+
+  for (i = 0; i < children_props->len; i++)
+    n += g_array_index (children_props, ChildrenProps, i).schema->entries->len;
+  pspec = g_new (GParamSpec *, n);
+
+  /* Properties added several times are only listed once */
+  *n_properties = 0;
+  for (i = 0; i < children_props->len; i++) {
+    GArray *entries = g_array_index (children_props, ChildrenProps,
+        i).schema->entries;
 
-  guint i = 0;
+    for (j = 0; j < entries->len; j++) {
+      GParamSpec *spec = g_array_index (entries, ChildPropertyEntry, j).pspec;
 
-  *n_properties = g_hash_table_size (object->priv->children_props);
-  pspec = g_new (GParamSpec *, *n_properties);
+      for (k = 0; k < *n_properties; k++) {
+        if (pspec_equal (pspec[k], spec))
+          break;
+      }
 
-  g_hash_table_iter_init (&iter, object->priv->children_props);
-  while (g_hash_table_iter_next (&iter, &key, &value)) {
-    spec = G_PARAM_SPEC (key);
-    pspec[i] = g_param_spec_ref (spec);
-    i++;
+      if (k == *n_properties)
+        pspec[(*n_properties)++] = g_param_spec_ref (spec);
+    }
   }
 
   return pspec;
@@ -1544,6 +1870,59 @@ ges_track_element_split_bindings (GESTrackElement * element,
   g_free (specs);
 }
 
+void
+ges_track_element_copy_bindings (GESTrackElement * element,
+    GESTrackElement * new_element)
+{
+  GParamSpec **specs;
+  guint n, n_specs;
+  GstControlBinding *binding;
+  GstTimedValueControlSource *source, *new_source;
+
+  specs =
+      ges_track_element_list_children_properties (GES_TRACK_ELEMENT (element),
+      &n_specs);
+  for (n = 0; n < n_specs; ++n) {
+    GList *values, *tmp;
+    GstInterpolationMode mode;
+
+    binding = ges_track_element_get_control_binding (element, specs[n]->name);
+    if (!binding)
+      continue;
+
+    g_object_get (binding, "control_source", &source, NULL);
+
+    /* FIXME : this should work as well with other types of control sources */
+    if (!GST_IS_TIMED_VALUE_CONTROL_SOURCE (source)) {
+      gst_object_unref (source);
+      continue;
+    }
+
+    new_source =
+        GST_TIMED_VALUE_CONTROL_SOURCE (gst_interpolation_control_source_new
+        ());
+
+    g_object_get (source, "mode", &mode, NULL);
+    g_object_set (new_source, "mode", mode, NULL);
+
+    values = gst_timed_value_control_source_get_all (source);
+    for (tmp = values; tmp; tmp = tmp->next) {
+      GstTimedValue *value = tmp->data;
+
+      gst_timed_value_control_source_set (new_source, value->timestamp,
+          value->value);
+    }
+    g_list_free (values);
+    gst_object_unref (source);
+
+    /* We only manage direct bindings, see TODO in set_control_source */
+    ges_track_element_set_control_source (new_element,
+        GST_CONTROL_SOURCE (new_source), specs[n]->name, "direct");
+  }
+
+  g_free (specs);
+}
+
 /**
  * ges_track_element_edit:
  * @object: the #GESTrackElement to edit
@@ -1681,6 +2060,8 @@ ges_track_element_set_control_source (GESTrackElement * object,
     gst_object_add_control_binding (GST_OBJECT (element), binding);
     g_hash_table_insert (priv->bindings_hashtable, g_strdup (property_name),
         binding);
+    ges_track_element_content_changed (object);
+
     return TRUE;
   }
 
@@ -29,12 +29,19 @@
  * Wraps GNonLin's 'gnlcomposition' element.
  */
 
+#include <gst/video/video.h>
+
 #include "ges-internal.h"
 #include "ges-track.h"
 #include "ges-track-element.h"
 #include "ges-meta-container.h"
 #include "ges-video-track.h"
 #include "ges-audio-track.h"
+#include "ges-video-uri-source.h"
+#include "ges-uri-asset.h"
+#include "ges-video-test-source.h"
+#include "ges-audio-source.h"
+#include "ges-video-source.h"
 
 G_DEFINE_TYPE_WITH_CODE (GESTrack, ges_track, GST_TYPE_BIN,
     G_IMPLEMENT_INTERFACE (GES_TYPE_META_CONTAINER, NULL));
@@ -50,14 +57,75 @@ typedef struct
   GESTrack *track;
 } Gap;
 
+/* Structure keeping track of a GESTrackElement of the track */
+typedef struct
+{
+  GSequenceIter *iter;
+
+  /* The range @element covered when it was last seen */
+  GstClockTime start;
+  GstClockTime end;
+} TrackElementEntry;
+
+/* Structure that represents a range of the track for which
+ * a GESRenderCache provides pre-rendered media */
+typedef struct
+{
+  GstElement *gnlobj;
+
+  GstClockTime start;
+  GstClockTime duration;
+
+  /* The TrackElement-s that the cached media replaces */
+  GList *elements;
+} CachedRange;
+
+/* Range of a video track entirely covered by opaque sources */
+typedef struct
+{
+  GstClockTime start;
+  GstClockTime end;
+} OpaqueRange;
+
 struct _GESTrackPrivate
 {
   /*< private > */
   GESTimeline *timeline;
   GSequence *trackelements_by_start;
-  GHashTable *trackelements_iter;
+  /* GESTrackElement -> TrackElementEntry */
+  GHashTable *trackelement_entries;
   GList *gaps;
 
+  /* Range in which the gaps have to be computed again, dirty_start being
+   * GST_CLOCK_TIME_NONE when nothing changed since last time, and the
+   * timeline duration the gaps were last computed for */
+  GstClockTime dirty_start;
+  GstClockTime dirty_stop;
+  GstClockTime gaps_duration;
+  /* Upper bound of the duration of the elements, only reset when the track
+   * gets empty, so that gaps can be computed from the elements that may
+   * reach the dirty range only */
+  GstClockTime max_element_duration;
+  GList *cached_ranges;
+  /* Whether the cached ranges replace the content they cover, which is
+   * only the case while previewing */
+  gboolean use_cached_media;
+
+  /* The TrackElement-s deactivated at the GNL level because sources of
+   * higher layers fully hide them, used as a set */
+  GHashTable *culled;
+  /* The opaque full frame sources, used as a set, watched so that what they
+   * hide shows up again as soon as they stop being opaque */
+  GHashTable *occluders;
+  /* Range in which what is culled has to be computed again, cull_dirty_start
+   * being GST_CLOCK_TIME_NONE when nothing changed since last time */
+  GstClockTime cull_dirty_start;
+  GstClockTime cull_dirty_stop;
+  /* Set of the sources contributing nothing, taken out of the composition
+   * and watched so that they come back as soon as they are heard or seen
+   * again */
+  GHashTable *silent_sources;
+
   guint64 duration;
 
   GstCaps *caps;
@@ -68,8 +136,14 @@ struct _GESTrackPrivate
 
   gboolean updating;
 
+  /* The TrackElement-s whose gnlobject needs to be updated at next commit */
+  GList *gnlobject_updates;
+
   gboolean mixing;
   GstElement *mixing_operation;
+
+  /* Factor by which the output is downscaled, used by preview pipelines */
+  guint preview_scale;
   GstElement *capsfilter;
 
   /* Virtual method to create GstElement that fill gaps */
@@ -98,6 +172,11 @@ static void
 pad_removed_cb (GstElement * element, GstPad * pad, GESTrack * track);
 static void composition_duration_cb (GstElement * composition, GParamSpec * arg
     G_GNUC_UNUSED, GESTrack * obj);
+static void free_cached_range (CachedRange * range, GESTrack * track);
+static void update_culled_elements (GESTrack * track);
+static void set_occluder (GESTrack * track, GESTrackElement * element,
+    gboolean occluder);
+static void forget_silent_source (GESTrack * track, GESTrackElement * source);
 
 /* Private methods/functions/callbacks */
 static void
@@ -174,15 +253,168 @@ free_gap (Gap * gap)
   g_slice_free (Gap, gap);
 }
 
+static void
+fill_gap (GESTrack * track, GstClockTime start, GstClockTime end)
+{
+  Gap *gap;
+  GList *tmp;
+
+  /* Cached ranges already provide media, do not cover them */
+  for (tmp = track->priv->use_cached_media ? track->priv->cached_ranges : NULL;
+      tmp; tmp = tmp->next) {
+    CachedRange *range = tmp->data;
+
+    if (range->start < end && range->start + range->duration > start) {
+      if (range->start > start)
+        fill_gap (track, start, range->start);
+      if (range->start + range->duration < end)
+        fill_gap (track, range->start + range->duration, end);
+
+      return;
+    }
+  }
+
+  gap = gap_new (track, start, end - start);
+  if (G_LIKELY (gap != NULL))
+    track->priv->gaps = g_list_prepend (track->priv->gaps, gap);
+}
+
+static void
+update_restriction_filter (GESTrack * track)
+{
+  guint i;
+  GstCaps *caps;
+  GESTrackPrivate *priv = track->priv;
+
+  if (priv->restriction_caps == NULL)
+    return;
+
+  caps = gst_caps_copy (priv->restriction_caps);
+  if (priv->preview_scale > 1) {
+    for (i = 0; i < gst_caps_get_size (caps); i++) {
+      gint width, height;
+      GstStructure *structure = gst_caps_get_structure (caps, i);
+
+      if (gst_structure_get_int (structure, "width", &width))
+        gst_structure_set (structure, "width", G_TYPE_INT,
+            MAX (width / (gint) priv->preview_scale, 1), NULL);
+      if (gst_structure_get_int (structure, "height", &height))
+        gst_structure_set (structure, "height", G_TYPE_INT,
+            MAX (height / (gint) priv->preview_scale, 1), NULL);
+    }
+  }
+
+  g_object_set (priv->capsfilter, "caps", caps, NULL);
+  gst_caps_unref (caps);
+}
+
+static inline void
+extend_range (GstClockTime * range_start, GstClockTime * range_stop,
+    GstClockTime start, GstClockTime stop)
+{
+  if (!GST_CLOCK_TIME_IS_VALID (*range_start)) {
+    *range_start = start;
+    *range_stop = stop;
+  } else {
+    *range_start = MIN (*range_start, start);
+    *range_stop = MAX (*range_stop, stop);
+  }
+}
+
+/* Only marks the range as needing what is culled to be computed again, for
+ * changes that can not affect gaps */
+static inline void
+mark_cull_dirty_range (GESTrack * track, GstClockTime start, GstClockTime stop)
+{
+  extend_range (&track->priv->cull_dirty_start, &track->priv->cull_dirty_stop,
+      start, stop);
+}
+
+/* Only marks the range as needing its gaps to be recreated, for changes
+ * that come from culling */
+static inline void
+mark_gaps_dirty_range (GESTrack * track, GstClockTime start, GstClockTime stop)
+{
+  extend_range (&track->priv->dirty_start, &track->priv->dirty_stop, start,
+      stop);
+}
+
+static inline void
+mark_dirty_range (GESTrack * track, GstClockTime start, GstClockTime stop)
+{
+  mark_gaps_dirty_range (track, start, stop);
+  mark_cull_dirty_range (track, start, stop);
+}
+
+#define mark_all_dirty(track) mark_dirty_range (track, 0, G_MAXUINT64)
+#define mark_all_cull_dirty(track) mark_cull_dirty_range (track, 0, G_MAXUINT64)
+
+/* Orders the elements by start, the searched position, passed as a %NULL
+ * item, going before the elements starting at @start */
+static gint
+element_start_search (GESTimelineElement * a, GESTimelineElement * b,
+    GstClockTime * start)
+{
+  GstClockTime start_a = a ? _START (a) : *start;
+  GstClockTime start_b = b ? _START (b) : *start;
+
+  if (start_a < start_b)
+    return -1;
+  if (start_a > start_b)
+    return 1;
+  if (a == NULL)
+    return -1;
+  if (b == NULL)
+    return 1;
+
+  return 0;
+}
+
+/* Returns the first element of @track that can end after @start, the ones
+ * before can not reach it */
+static GSequenceIter *
+first_element_reaching (GESTrack * track, GstClockTime start)
+{
+  GstClockTime first_start = start > track->priv->max_element_duration ?
+      start - track->priv->max_element_duration : 0;
+
+  return g_sequence_search (track->priv->trackelements_by_start, NULL,
+      (GCompareDataFunc) element_start_search, &first_start);
+}
+
+/* Extends [@start, @stop[ to the elements of @track overlapping it */
+static void
+expand_range (GESTrack * track, GstClockTime * start, GstClockTime * stop)
+{
+  GSequenceIter *it;
+  GstClockTime range_start = *start, range_stop = *stop;
+
+  for (it = first_element_reaching (track, range_start);
+      g_sequence_iter_is_end (it) == FALSE; it = g_sequence_iter_next (it)) {
+    GESTimelineElement *element = g_sequence_get (it);
+
+    if (_START (element) >= range_stop)
+      break;
+
+    if (_END (element) > range_start) {
+      *start = MIN (*start, _START (element));
+      *stop = MAX (*stop, _END (element));
+    }
+  }
+}
+
+/* Only the gaps of the dirty range are recreated, so that the composition
+ * does not have to update (and if playing, possibly rebuild its current
+ * stack) for gaps that did not change */
 static inline void
 update_gaps (GESTrack * track)
 {
-  Gap *gap;
-  GList *gaps;
+  GList *tmp, *gaps = NULL;
   GSequenceIter *it;
 
   GESTrackElement *trackelement;
-  GstClockTime start, end, duration = 0, timeline_duration;
+  GstClockTime start, end, dirty_start, dirty_stop, duration = 0,
+      timeline_duration = 0;
 
   GESTrackPrivate *priv = track->priv;
 
@@ -192,44 +424,83 @@ update_gaps (GESTrack * track)
     return;
   }
 
-  gaps = priv->gaps;
-  priv->gaps = NULL;
+  /* The gap at the end of the track follows the duration of the timeline */
+  if (priv->timeline)
+    g_object_get (priv->timeline, "duration", &timeline_duration, NULL);
+  if (timeline_duration != priv->gaps_duration) {
+    mark_dirty_range (track, MIN (timeline_duration, priv->gaps_duration),
+        MAX (timeline_duration, priv->gaps_duration));
+    priv->gaps_duration = timeline_duration;
+  }
 
-  /* 1- And recalculate gaps */
-  for (it = g_sequence_get_begin_iter (priv->trackelements_by_start);
+  if (!GST_CLOCK_TIME_IS_VALID (priv->dirty_start)) {
+    GST_LOG_OBJECT (track, "Gaps are up to date");
+    return;
+  }
+
+  dirty_start = priv->dirty_start;
+  dirty_stop = priv->dirty_stop;
+  priv->dirty_start = priv->dirty_stop = GST_CLOCK_TIME_NONE;
+
+  /* 1- Take the gaps of the dirty range out, extending the range to the
+   * gaps it touches so they get merged with the new ones */
+  for (tmp = priv->gaps; tmp;) {
+    Gap *gap = tmp->data;
+    GList *next = tmp->next;
+
+    if (gap->start <= dirty_stop && gap->start + gap->duration >= dirty_start) {
+      dirty_start = MIN (dirty_start, gap->start);
+      dirty_stop = MAX (dirty_stop, gap->start + gap->duration);
+      priv->gaps = g_list_delete_link (priv->gaps, tmp);
+      gaps = g_list_prepend (gaps, gap);
+    }
+    tmp = next;
+  }
+
+  GST_DEBUG_OBJECT (track, "Updating gaps between %" GST_TIME_FORMAT
+      " and %" GST_TIME_FORMAT, GST_TIME_ARGS (dirty_start),
+      GST_TIME_ARGS (dirty_stop));
+
+  /* 2- And recalculate gaps in that range, starting from the first element
+   * that can end after dirty_start, the ones before can not cover it */
+  for (it = first_element_reaching (track, dirty_start);
       g_sequence_iter_is_end (it) == FALSE; it = g_sequence_iter_next (it)) {
     trackelement = g_sequence_get (it);
 
     start = _START (trackelement);
     end = start + _DURATION (trackelement);
 
-    if (start > duration) {
-      /* 2- Fill gap */
-      gap = gap_new (track, duration, start - duration);
+    /* Silent sources are out of the composition, what they hide has to
+     * be filled */
+    if (start < dirty_stop &&
+        g_hash_table_contains (priv->silent_sources, trackelement))
+      continue;
 
-      if (G_LIKELY (gap != NULL))
-        priv->gaps = g_list_prepend (priv->gaps, gap);
+    if (start > duration && start > dirty_start && duration < dirty_stop) {
+      /* 3- Fill gap */
+      fill_gap (track, MAX (duration, dirty_start), MIN (start, dirty_stop));
+    }
+
+    /* Nothing past dirty_stop changes, the track goes on at least until
+     * @start anyway */
+    if (start >= dirty_stop) {
+      duration = MAX (duration, start);
+      break;
     }
 
     duration = MAX (duration, end);
   }
 
   /* 4- Add a gap at the end of the timeline if needed */
-  if (priv->timeline) {
-    g_object_get (priv->timeline, "duration", &timeline_duration, NULL);
-
-    if (duration < timeline_duration) {
-      gap = gap_new (track, duration, timeline_duration - duration);
+  if (priv->timeline && duration < timeline_duration) {
+    if (timeline_duration > dirty_start && duration < dirty_stop)
+      fill_gap (track, MAX (duration, dirty_start),
+          MIN (timeline_duration, dirty_stop));
 
-      if (G_LIKELY (gap != NULL)) {
-        priv->gaps = g_list_prepend (priv->gaps, gap);
-      }
-
-      priv->duration = timeline_duration;
-    }
+    priv->duration = timeline_duration;
   }
 
-  /* 4- Remove old gaps */
+  /* 5- Remove old gaps */
   g_list_free_full (gaps, (GDestroyNotify) free_gap);
 }
 
@@ -246,13 +517,50 @@ resort_and_fill_gaps (GESTrack * track)
 
 /* callbacks */
 static void
-sort_track_elements_cb (GESTrackElement * child,
-    GParamSpec * arg G_GNUC_UNUSED, GESTrack * track)
+sort_track_elements_cb (GESTimelineElement * child,
+    GESTimingFlags changed G_GNUC_UNUSED, GESTrack * track)
 {
-  g_sequence_sort (track->priv->trackelements_by_start,
+  TrackElementEntry *entry =
+      g_hash_table_lookup (track->priv->trackelement_entries, child);
+
+  if (entry == NULL)
+    return;
+
+  /* Gaps may change where @child was and where it is now */
+  mark_dirty_range (track, entry->start, entry->end);
+  entry->start = _START (child);
+  entry->end = _END (child);
+  mark_dirty_range (track, entry->start, entry->end);
+  track->priv->max_element_duration = MAX (track->priv->max_element_duration,
+      entry->end - entry->start);
+
+  /* Only @child moved, no need to sort everything again */
+  g_sequence_sort_changed (entry->iter,
       (GCompareDataFunc) element_start_compare, NULL);
 }
 
+static void
+track_element_entry_free (TrackElementEntry * entry)
+{
+  g_slice_free (TrackElementEntry, entry);
+}
+
+static void
+insert_track_element (GESTrack * track, GESTrackElement * object)
+{
+  TrackElementEntry *entry = g_slice_new (TrackElementEntry);
+
+  entry->iter = g_sequence_insert_sorted (track->priv->trackelements_by_start,
+      object, (GCompareDataFunc) element_start_compare, NULL);
+  entry->start = _START (object);
+  entry->end = _END (object);
+  g_hash_table_insert (track->priv->trackelement_entries, object, entry);
+
+  mark_dirty_range (track, entry->start, entry->end);
+  track->priv->max_element_duration = MAX (track->priv->max_element_duration,
+      entry->end - entry->start);
+}
+
 static void
 pad_added_cb (GstElement * element, GstPad * pad, GESTrack * track)
 {
@@ -343,10 +651,18 @@ remove_object_internal (GESTrack * track, GESTrackElement * object)
     }
 
     gst_element_set_state (gnlobject, GST_STATE_NULL);
+
+    set_occluder (track, object, FALSE);
+    forget_silent_source (track, object);
+    if (g_hash_table_remove (priv->culled, object))
+      g_object_set (gnlobject, "active", ges_track_element_is_active (object),
+          NULL);
   }
 
-  g_signal_handlers_disconnect_by_func (object, sort_track_elements_cb, NULL);
+  ges_timeline_element_remove_timing_observer (GES_TIMELINE_ELEMENT (object),
+      (GESTimingObserver) sort_track_elements_cb, track);
 
+  priv->gnlobject_updates = g_list_remove (priv->gnlobject_updates, object);
   ges_track_element_set_track (object, NULL);
   ges_timeline_element_set_timeline (GES_TIMELINE_ELEMENT (object), NULL);
 
@@ -417,11 +733,23 @@ ges_track_dispose (GObject * object)
   GESTrackPrivate *priv = track->priv;
 
   /* Remove all TrackElements and drop our reference */
-  g_hash_table_unref (priv->trackelements_iter);
   g_sequence_foreach (track->priv->trackelements_by_start,
       (GFunc) dispose_trackelements_foreach, track);
+  g_hash_table_unref (priv->trackelement_entries);
   g_sequence_free (priv->trackelements_by_start);
+  g_hash_table_unref (priv->culled);
+  g_hash_table_unref (priv->occluders);
+  g_hash_table_unref (priv->silent_sources);
   g_list_free_full (priv->gaps, (GDestroyNotify) free_gap);
+  g_list_free (priv->gnlobject_updates);
+  priv->gnlobject_updates = NULL;
+  while (priv->cached_ranges) {
+    CachedRange *range = priv->cached_ranges->data;
+
+    priv->cached_ranges = g_list_delete_link (priv->cached_ranges,
+        priv->cached_ranges);
+    free_cached_range (range, track);
+  }
 
   if (priv->composition) {
     gst_bin_remove (GST_BIN (object), priv->composition);
@@ -597,13 +925,29 @@ ges_track_init (GESTrack * self)
   self->priv->composition = gst_element_factory_make ("gnlcomposition", NULL);
   self->priv->capsfilter = gst_element_factory_make ("capsfilter", NULL);
   self->priv->updating = TRUE;
+  self->priv->gnlobject_updates = NULL;
   self->priv->trackelements_by_start = g_sequence_new (NULL);
-  self->priv->trackelements_iter =
-      g_hash_table_new (g_direct_hash, g_direct_equal);
+  self->priv->trackelement_entries =
+      g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
+      (GDestroyNotify) track_element_entry_free);
+  self->priv->dirty_start = GST_CLOCK_TIME_NONE;
+  self->priv->dirty_stop = GST_CLOCK_TIME_NONE;
+  self->priv->gaps_duration = 0;
+  self->priv->max_element_duration = 0;
   self->priv->create_element_for_gaps = NULL;
   self->priv->gaps = NULL;
+  self->priv->cached_ranges = NULL;
+  self->priv->use_cached_media = TRUE;
+  self->priv->culled = g_hash_table_new_full (g_direct_hash,
+      g_direct_equal, gst_object_unref, NULL);
+  self->priv->occluders = g_hash_table_new (g_direct_hash, g_direct_equal);
+  self->priv->cull_dirty_start = GST_CLOCK_TIME_NONE;
+  self->priv->cull_dirty_stop = GST_CLOCK_TIME_NONE;
+  self->priv->silent_sources = g_hash_table_new_full (g_direct_hash,
+      g_direct_equal, gst_object_unref, NULL);
   self->priv->mixing = TRUE;
   self->priv->restriction_caps = NULL;
+  self->priv->preview_scale = 1;
 
   g_signal_connect (G_OBJECT (self->priv->composition), "notify::duration",
       G_CALLBACK (composition_duration_cb), self);
@@ -677,6 +1021,7 @@ ges_track_set_timeline (GESTrack * track, GESTimeline * timeline)
   GST_DEBUG ("track:%p, timeline:%p", track, timeline);
 
   track->priv->timeline = timeline;
+  mark_all_dirty (track);
   resort_and_fill_gaps (track);
 }
 
@@ -730,7 +1075,9 @@ ges_track_set_restriction_caps (GESTrack * track, const GstCaps * caps)
     gst_caps_unref (priv->restriction_caps);
   priv->restriction_caps = gst_caps_copy (caps);
 
-  g_object_set (priv->capsfilter, "caps", caps, NULL);
+  /* Which sources cover the whole frame depends on its size */
+  mark_all_cull_dirty (track);
+  update_restriction_filter (track);
 
   g_object_notify (G_OBJECT (track), "restriction-caps");
 }
@@ -750,6 +1097,7 @@ ges_track_set_mixing (GESTrack * track, gboolean mixing)
   if (!track->priv->mixing_operation) {
     GST_DEBUG_OBJECT (track, "Track will be set to mixing = %d", mixing);
     track->priv->mixing = mixing;
+    mark_all_cull_dirty (track);
     return;
   }
 
@@ -773,6 +1121,7 @@ ges_track_set_mixing (GESTrack * track, gboolean mixing)
   }
 
   track->priv->mixing = mixing;
+  mark_all_cull_dirty (track);
 
   GST_DEBUG_OBJECT (track, "The track has been set to mixing = %d", mixing);
 }
@@ -819,23 +1168,16 @@ ges_track_add_element (GESTrack * track, GESTrackElement * object)
   }
 
   gst_object_ref_sink (object);
-  g_hash_table_insert (track->priv->trackelements_iter, object,
-      g_sequence_insert_sorted (track->priv->trackelements_by_start, object,
-          (GCompareDataFunc) element_start_compare, NULL));
+  insert_track_element (track, object);
 
   ges_timeline_element_set_timeline (GES_TIMELINE_ELEMENT (object),
       track->priv->timeline);
   g_signal_emit (track, ges_track_signals[TRACK_ELEMENT_ADDED], 0,
       GES_TRACK_ELEMENT (object));
 
-  g_signal_connect (GES_TRACK_ELEMENT (object), "notify::start",
-      G_CALLBACK (sort_track_elements_cb), track);
-
-  g_signal_connect (GES_TRACK_ELEMENT (object), "notify::duration",
-      G_CALLBACK (sort_track_elements_cb), track);
-
-  g_signal_connect (GES_TRACK_ELEMENT (object), "notify::priority",
-      G_CALLBACK (sort_track_elements_cb), track);
+  ges_timeline_element_add_timing_observer (GES_TIMELINE_ELEMENT (object),
+      GES_TIMING_START | GES_TIMING_DURATION | GES_TIMING_PRIORITY, FALSE,
+      (GESTimingObserver) sort_track_elements_cb, track);
 
   return TRUE;
 }
@@ -879,7 +1221,7 @@ ges_track_get_elements (GESTrack * track)
 gboolean
 ges_track_remove_element (GESTrack * track, GESTrackElement * object)
 {
-  GSequenceIter *it;
+  TrackElementEntry *entry;
   GESTrackPrivate *priv;
 
   g_return_val_if_fail (GES_IS_TRACK (track), FALSE);
@@ -889,8 +1231,12 @@ ges_track_remove_element (GESTrack * track, GESTrackElement * object)
 
   GST_DEBUG_OBJECT (track, "Removing %" GST_PTR_FORMAT, object);
 
-  it = g_hash_table_lookup (priv->trackelements_iter, object);
-  g_sequence_remove (it);
+  entry = g_hash_table_lookup (priv->trackelement_entries, object);
+  mark_dirty_range (track, entry->start, entry->end);
+  g_sequence_remove (entry->iter);
+  g_hash_table_remove (priv->trackelement_entries, object);
+  if (g_hash_table_size (priv->trackelement_entries) == 0)
+    priv->max_element_duration = 0;
   resort_and_fill_gaps (track);
 
   if (remove_object_internal (track, object) == TRUE) {
@@ -899,9 +1245,7 @@ ges_track_remove_element (GESTrack * track, GESTrackElement * object)
     return TRUE;
   }
 
-  g_hash_table_insert (track->priv->trackelements_iter, object,
-      g_sequence_insert_sorted (track->priv->trackelements_by_start, object,
-          (GCompareDataFunc) element_start_compare, NULL));
+  insert_track_element (track, object);
 
   return FALSE;
 }
@@ -976,6 +1320,15 @@ ges_track_commit (GESTrack * track)
 
   g_return_val_if_fail (GES_IS_TRACK (track), FALSE);
 
+  GST_DEBUG_OBJECT (track, "Updating %u gnlobjects",
+      g_list_length (track->priv->gnlobject_updates));
+  g_list_free_full (track->priv->gnlobject_updates,
+      (GDestroyNotify) ges_track_element_sync_gnlobject);
+  track->priv->gnlobject_updates = NULL;
+
+  /* Elements are kept sorted as they move and which sources are silent
+   * changes where gaps are needed, so cull first */
+  update_culled_elements (track);
   resort_and_fill_gaps (track);
   g_signal_emit_by_name (track->priv->composition, "commit", TRUE, &ret);
 
@@ -1000,4 +1353,848 @@ ges_track_set_create_element_for_gap_func (GESTrack * track,
   g_return_if_fail (GES_IS_TRACK (track));
 
   track->priv->create_element_for_gaps = func;
+  mark_all_dirty (track);
+}
+
+/* Internal methods */
+
+/* ges_track_copy:
+ * @track: a #GESTrack
+ *
+ * Creates a new, empty, #GESTrack of the same type as @track, with the same
+ * caps, restriction caps, mixing setting and subclass properties (like
+ * #GESVideoTrack:mixing-threads) as @track.
+ */
+GESTrack *
+ges_track_copy (GESTrack * track)
+{
+  guint i, n_specs;
+  GParamSpec **specs;
+  GESTrack *copy;
+  GESTrackPrivate *priv = track->priv;
+
+  copy = g_object_new (G_OBJECT_TYPE (track), "track-type", track->type,
+      "caps", priv->caps, NULL);
+
+  /* Only the properties of subclasses are copied this way, ours are handled
+   * below and the GstElement ones, like the name, must not be copied */
+  specs = g_object_class_list_properties (G_OBJECT_GET_CLASS (track),
+      &n_specs);
+  for (i = 0; i < n_specs; i++) {
+    GValue value = { 0, };
+
+    if (g_type_is_a (GES_TYPE_TRACK, specs[i]->owner_type) ||
+        (specs[i]->flags & G_PARAM_READWRITE) != G_PARAM_READWRITE ||
+        (specs[i]->flags & G_PARAM_CONSTRUCT_ONLY))
+      continue;
+
+    g_value_init (&value, specs[i]->value_type);
+    g_object_get_property (G_OBJECT (track), specs[i]->name, &value);
+    g_object_set_property (G_OBJECT (copy), specs[i]->name, &value);
+    g_value_unset (&value);
+  }
+  g_free (specs);
+
+  if (priv->restriction_caps)
+    ges_track_set_restriction_caps (copy, priv->restriction_caps);
+  if (priv->create_element_for_gaps)
+    ges_track_set_create_element_for_gap_func (copy,
+        priv->create_element_for_gaps);
+  ges_track_set_mixing (copy, priv->mixing);
+
+  return copy;
+}
+
+/* ges_track_add_cached_media:
+ * @track: a #GESTrack
+ * @gnlobject: (transfer floating): the gnlobject producing the cached media
+ * @start: start of the range @gnlobject replaces
+ * @duration: duration of the range @gnlobject replaces
+ *
+ * Makes @gnlobject provide the media of @track between @start and
+ * @start + @duration. The #GESTrackElement-s of that range are deactivated
+ * at the GNL level so they are not processed anymore, and gaps are not
+ * filled inside the range. Changes only take effect once the track is
+ * commited.
+ *
+ * Returns: %FALSE if some #GESTrackElement of @track only partially overlaps
+ * the range, in which case it can not be replaced, %TRUE otherwise.
+ */
+gboolean
+ges_track_add_cached_media (GESTrack * track, GstElement * gnlobject,
+    GstClockTime start, GstClockTime duration)
+{
+  GList *tmp;
+  GSequenceIter *it;
+  CachedRange *range;
+  GESTrackElement *trackelement;
+
+  GList *elements = NULL;
+  GstClockTime stop = start + duration;
+  GESTrackPrivate *priv = track->priv;
+
+  for (it = g_sequence_get_begin_iter (priv->trackelements_by_start);
+      g_sequence_iter_is_end (it) == FALSE; it = g_sequence_iter_next (it)) {
+    trackelement = g_sequence_get (it);
+
+    if (_START (trackelement) >= stop)
+      break;
+
+    if (_END (trackelement) <= start)
+      continue;
+
+    if (_START (trackelement) < start || _END (trackelement) > stop) {
+      GST_DEBUG_OBJECT (track, "%" GST_PTR_FORMAT " is not fully inside the"
+          " cached range, can not use it", trackelement);
+      g_list_free_full (elements, gst_object_unref);
+
+      return FALSE;
+    }
+
+    elements = g_list_prepend (elements, gst_object_ref (trackelement));
+  }
+
+  g_object_set (gnlobject, "start", start, "duration", duration,
+      "inpoint", (guint64) 0, "priority", 1, "active", priv->use_cached_media,
+      NULL);
+
+  gst_object_ref (gnlobject);
+  if (G_UNLIKELY (gst_bin_add (GST_BIN (priv->composition),
+              gnlobject) == FALSE)) {
+    GST_WARNING_OBJECT (track, "Could not add cached media to the composition");
+    gst_object_unref (gnlobject);
+    g_list_free_full (elements, gst_object_unref);
+
+    return FALSE;
+  }
+
+  range = g_slice_new (CachedRange);
+  range->gnlobj = gnlobject;
+  range->start = start;
+  range->duration = duration;
+  range->elements = elements;
+  priv->cached_ranges = g_list_prepend (priv->cached_ranges, range);
+
+  for (tmp = elements; tmp; tmp = tmp->next)
+    ges_track_update_element_activity (track, tmp->data);
+  mark_dirty_range (track, start, stop);
+
+  GST_DEBUG_OBJECT (track, "Using cached media from %" GST_TIME_FORMAT
+      " to %" GST_TIME_FORMAT, GST_TIME_ARGS (start), GST_TIME_ARGS (stop));
+
+  return TRUE;
+}
+
+/* @range must not be in the cached ranges of @track anymore */
+static void
+free_cached_range (CachedRange * range, GESTrack * track)
+{
+  GList *tmp;
+
+  for (tmp = range->elements; tmp; tmp = tmp->next) {
+    if (ges_track_element_get_track (tmp->data) == track)
+      ges_track_update_element_activity (track, tmp->data);
+  }
+  g_list_free_full (range->elements, gst_object_unref);
+
+  gst_bin_remove (GST_BIN (track->priv->composition), range->gnlobj);
+  gst_element_set_state (range->gnlobj, GST_STATE_NULL);
+  gst_object_unref (range->gnlobj);
+
+  g_slice_free (CachedRange, range);
+}
+
+/* ges_track_remove_cached_media:
+ * @track: a #GESTrack
+ * @gnlobject: a gnlobject previously passed to ges_track_add_cached_media
+ *
+ * Stops using @gnlobject and reactivates the #GESTrackElement-s it was
+ * replacing. Changes only take effect once the track is commited.
+ */
+void
+ges_track_remove_cached_media (GESTrack * track, GstElement * gnlobject)
+{
+  GList *tmp;
+  GESTrackPrivate *priv = track->priv;
+
+  for (tmp = priv->cached_ranges; tmp; tmp = tmp->next) {
+    CachedRange *range = tmp->data;
+
+    if (range->gnlobj == gnlobject) {
+      priv->cached_ranges = g_list_delete_link (priv->cached_ranges, tmp);
+      mark_dirty_range (track, range->start, range->start + range->duration);
+      free_cached_range (range, track);
+
+      return;
+    }
+  }
+
+  GST_WARNING_OBJECT (track, "%" GST_PTR_FORMAT " is not a cached media of"
+      " ours", gnlobject);
+}
+
+/* ges_track_set_use_cached_media:
+ * @track: a #GESTrack
+ * @use: whether to use the cached media
+ *
+ * Makes the cached media replace the #GESTrackElement-s they cover, or
+ * makes them go back to the original content, which is what final renders
+ * use. Changes only take effect once the track is commited.
+ */
+void
+ges_track_set_use_cached_media (GESTrack * track, gboolean use)
+{
+  GList *tmp, *etmp;
+  GESTrackPrivate *priv = track->priv;
+
+  if (priv->use_cached_media == use)
+    return;
+
+  GST_DEBUG_OBJECT (track, "%s cached media", use ? "Using" : "Not using");
+  priv->use_cached_media = use;
+  for (tmp = priv->cached_ranges; tmp; tmp = tmp->next) {
+    CachedRange *range = tmp->data;
+
+    g_object_set (range->gnlobj, "active", use, NULL);
+    for (etmp = range->elements; etmp; etmp = etmp->next)
+      ges_track_update_element_activity (track, etmp->data);
+
+    mark_dirty_range (track, range->start, range->start + range->duration);
+  }
+}
+
+static gboolean
+is_cached (GESTrack * track, GESTrackElement * element)
+{
+  GList *tmp;
+
+  if (!track->priv->use_cached_media)
+    return FALSE;
+
+  for (tmp = track->priv->cached_ranges; tmp; tmp = tmp->next) {
+    if (g_list_find (((CachedRange *) tmp->data)->elements, element))
+      return TRUE;
+  }
+
+  return FALSE;
+}
+
+/* ges_track_update_element_activity:
+ * @track: a #GESTrack
+ * @element: a #GESTrackElement of @track
+ *
+ * Sets whether the gnlobject of @element is used by the composition, which
+ * is the case if @element is active and neither culled, silent nor replaced
+ * by cached media. The "active" property of the gnlobjects of the elements of
+ * @track is only ever set from here, so those states can not overwrite
+ * each other. Changes only take effect once the track is commited.
+ */
+void
+ges_track_update_element_activity (GESTrack * track, GESTrackElement * element)
+{
+  GstElement *gnlobject = ges_track_element_get_gnlobject (element);
+
+  if (gnlobject == NULL)
+    return;
+
+  g_object_set (gnlobject, "active", ges_track_element_is_active (element) &&
+      !g_hash_table_contains (track->priv->culled, element) &&
+      !g_hash_table_contains (track->priv->silent_sources, element) &&
+      !is_cached (track, element), NULL);
+}
+
+/* Encoded video formats which have no way to carry an alpha channel */
+static const gchar *opaque_video_codecs[] = {
+  "video/x-h264", "video/x-h265", "video/mpeg", "video/x-theora",
+  "video/x-dv", "image/jpeg"
+};
+
+/* Whether the stream @source decodes is known to have no alpha channel */
+static gboolean
+has_opaque_stream (GESTrackElement * source)
+{
+  guint i;
+  GstCaps *caps;
+  const gchar *name;
+  GstStructure *structure;
+  GstDiscovererStreamInfo *info;
+  gboolean opaque = FALSE;
+  GESAsset *asset = ges_extractable_get_asset (GES_EXTRACTABLE (source));
+
+  if (!GES_IS_URI_SOURCE_ASSET (asset))
+    return FALSE;
+
+  info = ges_uri_source_asset_get_stream_info (GES_URI_SOURCE_ASSET (asset));
+  if (info == NULL || (caps = gst_discoverer_stream_info_get_caps (info)) ==
+      NULL)
+    return FALSE;
+
+  if (gst_caps_get_size (caps) == 0)
+    goto done;
+
+  structure = gst_caps_get_structure (caps, 0);
+  name = gst_structure_get_name (structure);
+  if (g_strcmp0 (name, "video/x-raw") == 0) {
+    const GstVideoFormatInfo *finfo;
+    GstVideoFormat format = GST_VIDEO_FORMAT_UNKNOWN;
+    const gchar *format_name = gst_structure_get_string (structure, "format");
+
+    if (format_name)
+      format = gst_video_format_from_string (format_name);
+
+    /* Unknown formats might as well have alpha */
+    if (format != GST_VIDEO_FORMAT_UNKNOWN) {
+      finfo = gst_video_format_get_info (format);
+      opaque = finfo && !GST_VIDEO_FORMAT_INFO_HAS_ALPHA (finfo);
+    }
+    goto done;
+  }
+
+  /* PNG, ProRes 4444 or VP8 can carry alpha, so only trust codecs which
+   * can not */
+  for (i = 0; i < G_N_ELEMENTS (opaque_video_codecs); i++) {
+    if (g_strcmp0 (name, opaque_video_codecs[i]) == 0) {
+      opaque = TRUE;
+      break;
+    }
+  }
+
+done:
+  gst_caps_unref (caps);
+
+  return opaque;
+}
+
+/* Whether @element outputs opaque frames covering the whole output of
+ * @track during its whole duration */
+static gboolean
+is_opaque_full_frame (GESTrack * track, GESTrackElement * element)
+{
+  guint i;
+  gdouble alpha;
+  GstStructure *structure;
+  gint posx, posy, width, height, track_width, track_height;
+  const gchar *props[] = { "alpha", "posx", "posy", "width", "height" };
+
+  /* Images, titles or nested timelines can be transparent */
+  if (!GES_IS_VIDEO_URI_SOURCE (element) &&
+      !GES_IS_VIDEO_TEST_SOURCE (element))
+    return FALSE;
+
+  if (GES_IS_VIDEO_URI_SOURCE (element) && !has_opaque_stream (element))
+    return FALSE;
+
+  if (track->priv->restriction_caps == NULL ||
+      gst_caps_get_size (track->priv->restriction_caps) == 0)
+    return FALSE;
+
+  structure = gst_caps_get_structure (track->priv->restriction_caps, 0);
+  if (!gst_structure_get_int (structure, "width", &track_width) ||
+      !gst_structure_get_int (structure, "height", &track_height))
+    return FALSE;
+
+  for (i = 0; i < G_N_ELEMENTS (props); i++) {
+    if (ges_track_element_get_control_binding (element, props[i]))
+      return FALSE;
+  }
+
+  ges_track_element_get_child_properties (element, "alpha", &alpha,
+      "posx", &posx, "posy", &posy, "width", &width, "height", &height, NULL);
+
+  return alpha >= 1.0 && posx <= 0 && posy <= 0 &&
+      posx + width >= track_width && posy + height >= track_height;
+}
+
+static gboolean
+range_is_covered (GArray * ranges, GstClockTime start, GstClockTime end)
+{
+  guint low = 0, high = ranges->len;
+
+  /* Look for the last range starting before @start, ranges being sorted
+   * and not touching each other */
+  while (low < high) {
+    guint middle = (low + high) / 2;
+
+    if (g_array_index (ranges, OpaqueRange, middle).start <= start)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+
+  return low > 0 && g_array_index (ranges, OpaqueRange, low - 1).end >= end;
+}
+
+/* Merges the sorted @added ranges into @ranges, consuming both */
+static GArray *
+merge_ranges (GArray * ranges, GArray * added)
+{
+  guint i = 0, j = 0;
+  OpaqueRange next, *last;
+  GArray *merged = g_array_sized_new (FALSE, FALSE, sizeof (OpaqueRange),
+      ranges->len + added->len);
+
+  while (i < ranges->len || j < added->len) {
+    if (j >= added->len || (i < ranges->len &&
+            g_array_index (ranges, OpaqueRange, i).start <=
+            g_array_index (added, OpaqueRange, j).start))
+      next = g_array_index (ranges, OpaqueRange, i++);
+    else
+      next = g_array_index (added, OpaqueRange, j++);
+
+    last = merged->len ?
+        &g_array_index (merged, OpaqueRange, merged->len - 1) : NULL;
+    if (last && last->end >= next.start)
+      last->end = MAX (last->end, next.end);
+    else
+      g_array_append_val (merged, next);
+  }
+
+  g_array_unref (ranges);
+  g_array_unref (added);
+
+  return merged;
+}
+
+static gint
+compare_layer_priorities (gconstpointer a, gconstpointer b)
+{
+  guint prio_a = GPOINTER_TO_UINT (a), prio_b = GPOINTER_TO_UINT (b);
+
+  return prio_a < prio_b ? -1 : (prio_a > prio_b ? 1 : 0);
+}
+
+/* Whether @element is a source that contributes nothing to the output of
+ * its track during its whole duration */
+static gboolean
+is_silent (GESTrackElement * element)
+{
+  if (GES_IS_AUDIO_SOURCE (element)) {
+    gdouble volume;
+    gboolean mute;
+
+    if (ges_track_element_get_control_binding (element, "volume") ||
+        ges_track_element_get_control_binding (element, "mute"))
+      return FALSE;
+
+    ges_track_element_get_child_properties (element, "volume", &volume,
+        "mute", &mute, NULL);
+
+    return mute || volume <= 0.0;
+  }
+
+  if (GES_IS_VIDEO_SOURCE (element)) {
+    gdouble alpha;
+
+    if (ges_track_element_get_control_binding (element, "alpha"))
+      return FALSE;
+
+    ges_track_element_get_child_properties (element, "alpha", &alpha, NULL);
+
+    return alpha <= 0.0;
+  }
+
+  return FALSE;
+}
+
+/* Whether elements of other clips overlap @element in @elements, the
+ * elements of its layer sorted by start, as transitions would then use it */
+static gboolean
+overlaps_other_clips (GQueue * elements, GESTrackElement * element)
+{
+  GList *tmp;
+  GESTimelineElement *parent = GES_TIMELINE_ELEMENT_PARENT (element);
+
+  for (tmp = elements->head; tmp; tmp = tmp->next) {
+    GESTrackElement *other = tmp->data;
+
+    if (_START (other) >= _END (element))
+      break;
+
+    if (GES_TIMELINE_ELEMENT_PARENT (other) != parent &&
+        _END (other) > _START (element))
+      return TRUE;
+  }
+
+  return FALSE;
+}
+
+/* Computes again which of the elements of @track overlapping [@start, @stop[
+ * sources of higher layers fully hide during their whole duration, adding
+ * them to @culled, and which opaque full frame sources hide others, adding
+ * them to @occluders. The sources which are not culled but contribute
+ * nothing are added to @silent.
+ *
+ * Whether an element is hidden only depends on the elements overlapping it,
+ * and whether those are opaque full frame sources on the elements of their
+ * layer overlapping them, so only the elements around the range are
+ * looked at */
+static void
+compute_culled_elements (GESTrack * track, GstClockTime start,
+    GstClockTime stop, GHashTable * culled, GHashTable * occluders,
+    GHashTable * silent)
+{
+  GList *prios, *tmp;
+  GArray *ranges;
+  GSequenceIter *it;
+  GHashTable *layers;
+  GstClockTime window_start = start, window_stop = stop;
+
+  /* Without mixing, only the highest layer is output, so taking an element
+   * out could let lower layers through */
+  if (!track->priv->mixing)
+    return;
+
+  expand_range (track, &window_start, &window_stop);
+  expand_range (track, &window_start, &window_stop);
+
+  /* Group the elements by layer, keeping them sorted by start */
+  layers = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
+      (GDestroyNotify) g_queue_free);
+  for (it = first_element_reaching (track, window_start);
+      g_sequence_iter_is_end (it) == FALSE; it = g_sequence_iter_next (it)) {
+    GESTrackElement *element = g_sequence_get (it);
+    gpointer prio;
+    GQueue *elements;
+
+    if (_START (element) >= window_stop)
+      break;
+
+    if (_END (element) <= window_start ||
+        !ges_track_element_is_active (element) || is_cached (track, element))
+      continue;
+
+    prio = GUINT_TO_POINTER (_ges_track_element_get_layer_priority (element));
+    if (!(elements = g_hash_table_lookup (layers, prio))) {
+      elements = g_queue_new ();
+      g_hash_table_insert (layers, prio, elements);
+    }
+    g_queue_push_tail (elements, element);
+  }
+
+  /* Go down the layers, accumulating the ranges hidden by opaque sources */
+  ranges = g_array_new (FALSE, FALSE, sizeof (OpaqueRange));
+  prios = g_list_sort (g_hash_table_get_keys (layers),
+      compare_layer_priorities);
+  for (tmp = prios; tmp; tmp = tmp->next) {
+    GList *l;
+    GstClockTime max_end = 0;
+    GQueue *elements = g_hash_table_lookup (layers, tmp->data);
+    GArray *added = g_array_new (FALSE, FALSE, sizeof (OpaqueRange));
+
+    for (l = elements->head; l; l = l->next) {
+      GESTrackElement *element = l->data;
+      OpaqueRange range = { _START (element), _END (element) };
+      gboolean in_range = range.start < stop && range.end > start;
+
+      if (in_range && range_is_covered (ranges, range.start, range.end))
+        g_hash_table_add (culled, element);
+
+      /* Sources overlapping other elements of their layer go through
+       * effects or transitions, which might let lower layers show */
+      if (range.start >= max_end &&
+          (l->next == NULL || _START (l->next->data) >= range.end) &&
+          is_opaque_full_frame (track, element)) {
+        g_array_append_val (added, range);
+        if (in_range)
+          g_hash_table_add (occluders, element);
+      }
+
+      max_end = MAX (max_end, range.end);
+    }
+
+    ranges = merge_ranges (ranges, added);
+  }
+
+  /* Then look for the sources that contribute nothing */
+  for (tmp = prios; tmp; tmp = tmp->next) {
+    GList *l;
+    GQueue *elements = g_hash_table_lookup (layers, tmp->data);
+
+    for (l = elements->head; l; l = l->next) {
+      GESTrackElement *element = l->data;
+
+      if (_START (element) < stop && _END (element) > start &&
+          !g_hash_table_contains (culled, element) && is_silent (element) &&
+          !overlaps_other_clips (elements, element))
+        g_hash_table_add (silent, element);
+    }
+  }
+
+  g_list_free (prios);
+  g_array_unref (ranges);
+  g_hash_table_unref (layers);
+}
+
+static void
+silent_source_notify_cb (GESTrackElement * source, GstElement * child,
+    GParamSpec * pspec, GESTrack * track)
+{
+  gboolean ret;
+
+  if (is_silent (source))
+    return;
+
+  GST_DEBUG_OBJECT (track, "%" GST_PTR_FORMAT " contributes again, bringing "
+      "it back", source);
+
+  /* Without waiting for the track to be commited, the gap filling its
+   * place is taken out on next commit */
+  forget_silent_source (track, source);
+  g_signal_emit_by_name (track->priv->composition, "commit", TRUE, &ret);
+}
+
+static void
+forget_silent_source (GESTrack * track, GESTrackElement * source)
+{
+  TrackElementEntry *entry;
+
+  if (!g_hash_table_contains (track->priv->silent_sources, source))
+    return;
+
+  g_signal_handlers_disconnect_by_func (source, silent_source_notify_cb,
+      track);
+  g_hash_table_remove (track->priv->silent_sources, source);
+  ges_track_update_element_activity (track, source);
+
+  entry = g_hash_table_lookup (track->priv->trackelement_entries, source);
+  if (entry)
+    mark_gaps_dirty_range (track, entry->start, entry->end);
+}
+
+/* ges_track_is_source_silent:
+ * @track: a #GESTrack
+ * @source: a #GESTrackElement of @track
+ *
+ * Returns: %TRUE if @source is taken out of the composition because it
+ * contributes nothing to @track
+ */
+gboolean
+ges_track_is_source_silent (GESTrack * track, GESTrackElement * source)
+{
+  return g_hash_table_contains (track->priv->silent_sources, source);
+}
+
+static void
+set_culled (GESTrack * track, GESTrackElement * element, gboolean culled)
+{
+  if (culled == g_hash_table_contains (track->priv->culled, element))
+    return;
+
+  if (culled) {
+    GST_LOG_OBJECT (track, "%" GST_PTR_FORMAT " is culled", element);
+    g_hash_table_add (track->priv->culled, gst_object_ref (element));
+  } else {
+    GST_LOG_OBJECT (track, "%" GST_PTR_FORMAT " is needed again", element);
+    g_hash_table_remove (track->priv->culled, element);
+  }
+
+  ges_track_update_element_activity (track, element);
+}
+
+/* Brings back what @occluder hid now that it is not opaque anymore, without
+ * waiting for the track to be commited. What other sources still hide gets
+ * culled again on next commit */
+static void
+uncull_hidden_by (GESTrack * track, GESTrackElement * occluder)
+{
+  GList *tmp, *hidden = NULL;
+  GHashTableIter iter;
+  GESTrackElement *element;
+  gboolean ret;
+
+  g_hash_table_iter_init (&iter, track->priv->culled);
+  while (g_hash_table_iter_next (&iter, (gpointer *) & element, NULL)) {
+    if (_START (element) < _END (occluder) && _END (element) >
+        _START (occluder))
+      hidden = g_list_prepend (hidden, element);
+  }
+
+  if (hidden == NULL)
+    return;
+
+  GST_DEBUG_OBJECT (track, "%" GST_PTR_FORMAT " is not opaque anymore, "
+      "bringing back the %u sources it hid", occluder, g_list_length (hidden));
+
+  for (tmp = hidden; tmp; tmp = tmp->next)
+    set_culled (track, tmp->data, FALSE);
+  g_list_free (hidden);
+
+  g_signal_emit_by_name (track->priv->composition, "commit", TRUE, &ret);
+}
+
+static void
+element_output_changed (GESTrack * track, GESTrackElement * element)
+{
+  TrackElementEntry *entry =
+      g_hash_table_lookup (track->priv->trackelement_entries, element);
+
+  if (entry == NULL)
+    return;
+
+  mark_cull_dirty_range (track, entry->start, entry->end);
+
+  if (g_hash_table_contains (track->priv->occluders, element) &&
+      !is_opaque_full_frame (track, element)) {
+    set_occluder (track, element, FALSE);
+    uncull_hidden_by (track, element);
+  }
+}
+
+static void
+occluder_notify_cb (GESTrackElement * occluder, GstElement * child,
+    GParamSpec * pspec, GESTrack * track)
+{
+  guint i;
+  const gchar *props[] = { "alpha", "posx", "posy", "width", "height" };
+
+  for (i = 0; i < G_N_ELEMENTS (props); i++) {
+    if (g_strcmp0 (pspec->name, props[i]) == 0) {
+      element_output_changed (track, occluder);
+      return;
+    }
+  }
+}
+
+static void
+set_occluder (GESTrack * track, GESTrackElement * element, gboolean occluder)
+{
+  if (occluder == g_hash_table_contains (track->priv->occluders, element))
+    return;
+
+  if (occluder) {
+    g_signal_connect (element, "deep-notify",
+        G_CALLBACK (occluder_notify_cb), track);
+    g_hash_table_add (track->priv->occluders, element);
+  } else {
+    g_signal_handlers_disconnect_by_func (element, occluder_notify_cb, track);
+    g_hash_table_remove (track->priv->occluders, element);
+  }
+}
+
+static void
+set_silent (GESTrack * track, GESTrackElement * source, gboolean silent)
+{
+  if (silent == g_hash_table_contains (track->priv->silent_sources, source))
+    return;
+
+  if (!silent) {
+    forget_silent_source (track, source);
+    return;
+  }
+
+  GST_LOG_OBJECT (track, "%" GST_PTR_FORMAT " contributes nothing, "
+      "taking it out", source);
+  g_signal_connect (source, "deep-notify",
+      G_CALLBACK (silent_source_notify_cb), track);
+  g_hash_table_add (track->priv->silent_sources, gst_object_ref (source));
+  ges_track_update_element_activity (track, source);
+  mark_gaps_dirty_range (track, _START (source), _END (source));
+}
+
+/* ges_track_content_changed:
+ * @track: a #GESTrack
+ * @element: a #GESTrackElement of @track
+ *
+ * Lets @track know that what @element outputs changed, so that what is
+ * culled around it gets computed again on next commit. The sources it hid
+ * are brought back right away if it stopped being opaque.
+ */
+void
+ges_track_content_changed (GESTrack * track, GESTrackElement * element)
+{
+  element_output_changed (track, element);
+}
+
+/* Deactivates at the GNL level the TrackElement-s that are fully hidden by
+ * opaque full frame sources of higher layers, so that they are not even
+ * decoded, and reactivates the ones that are needed again. Sources
+ * contributing nothing are deactivated the same way, gaps filling their
+ * place, as long as no transition uses them.
+ *
+ * Only the elements around the range that changed since last time are
+ * looked at. */
+static void
+update_culled_elements (GESTrack * track)
+{
+  GSequenceIter *it;
+  GHashTable *culled, *occluders, *silent;
+  GESTrackPrivate *priv = track->priv;
+  GstClockTime start = priv->cull_dirty_start, stop = priv->cull_dirty_stop;
+
+  if (!GST_CLOCK_TIME_IS_VALID (start))
+    return;
+
+  priv->cull_dirty_start = priv->cull_dirty_stop = GST_CLOCK_TIME_NONE;
+
+  /* Elements overlapping the range might be hidden by the ones which
+   * changed, and the other way around */
+  expand_range (track, &start, &stop);
+
+  GST_DEBUG_OBJECT (track, "Culling between %" GST_TIME_FORMAT " and %"
+      GST_TIME_FORMAT, GST_TIME_ARGS (start), GST_TIME_ARGS (stop));
+
+  culled = g_hash_table_new (g_direct_hash, g_direct_equal);
+  occluders = g_hash_table_new (g_direct_hash, g_direct_equal);
+  silent = g_hash_table_new (g_direct_hash, g_direct_equal);
+  compute_culled_elements (track, start, stop, culled, occluders, silent);
+
+  for (it = first_element_reaching (track, start);
+      g_sequence_iter_is_end (it) == FALSE; it = g_sequence_iter_next (it)) {
+    GESTrackElement *element = g_sequence_get (it);
+
+    if (_START (element) >= stop)
+      break;
+
+    if (_END (element) <= start)
+      continue;
+
+    set_culled (track, element, g_hash_table_contains (culled, element));
+    set_occluder (track, element, g_hash_table_contains (occluders, element));
+    set_silent (track, element, g_hash_table_contains (silent, element));
+  }
+
+  g_hash_table_unref (culled);
+  g_hash_table_unref (occluders);
+  g_hash_table_unref (silent);
+}
+
+/* ges_track_set_preview_scale:
+ * @track: a #GESTrack
+ * @scale: the factor by which to divide the size of the output
+ *
+ * Makes @track output video downscaled by @scale compared to its restriction
+ * caps. The video sources of @track follow, so frames get scaled before
+ * being composited.
+ */
+void
+ges_track_set_preview_scale (GESTrack * track, guint scale)
+{
+  g_return_if_fail (GES_IS_TRACK (track));
+  g_return_if_fail (scale > 0);
+
+  if (track->priv->preview_scale == scale)
+    return;
+
+  GST_DEBUG_OBJECT (track, "Setting preview scale to %u", scale);
+
+  track->priv->preview_scale = scale;
+  update_restriction_filter (track);
+
+  /* Let the sources resync their size with ours */
+  g_object_notify (G_OBJECT (track), "restriction-caps");
+}
+
+guint
+ges_track_get_preview_scale (GESTrack * track)
+{
+  g_return_val_if_fail (GES_IS_TRACK (track), 1);
+
+  return track->priv->preview_scale;
+}
+
+void
+ges_track_queue_gnlobject_update (GESTrack * track, GESTrackElement * element)
+{
+  track->priv->gnlobject_updates =
+      g_list_prepend (track->priv->gnlobject_updates, element);
 }
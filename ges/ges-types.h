@@ -71,6 +71,9 @@ typedef struct _GESTransitionClipClass GESTransitionClipClass;
 typedef struct _GESTestClip GESTestClip;
 typedef struct _GESTestClipClass GESTestClipClass;
 
+typedef struct _GESNestedTimelineClip GESNestedTimelineClip;
+typedef struct _GESNestedTimelineClipClass GESNestedTimelineClipClass;
+
 typedef struct _GESTitleClip GESTitleClip;
 typedef struct _GESTitleClipClass GESTitleClipClass;
 
@@ -86,6 +89,11 @@ typedef struct _GESEffectClipClass GESEffectClipClass;
 typedef struct _GESGroup GESGroup;
 typedef struct _GESGroupClass GESGroupClass;
 
+typedef struct _GESRenderCache GESRenderCache;
+typedef struct _GESRenderCacheClass GESRenderCacheClass;
+
+typedef struct _GESTimelineSnapshot GESTimelineSnapshot;
+
 typedef struct _GESTrack GESTrack;
 typedef struct _GESTrackClass GESTrackClass;
 
@@ -116,6 +124,9 @@ typedef struct _GESVideoUriSourceClass GESVideoUriSourceClass;
 typedef struct _GESAudioUriSource GESAudioUriSource;
 typedef struct _GESAudioUriSourceClass GESAudioUriSourceClass;
 
+typedef struct _GESNestedTimelineSource GESNestedTimelineSource;
+typedef struct _GESNestedTimelineSourceClass GESNestedTimelineSourceClass;
+
 typedef struct _GESImageSource GESImageSource;
 typedef struct _GESImageSourceClass GESImageSourceClass;
 
@@ -27,12 +27,15 @@
  * let you get information about the medias. Also, the tags found in the media file are
  * set as Metadatas of the Asser.
  */
+#include <string.h>
 #include <gst/pbutils/pbutils.h>
 #include "ges.h"
 #include "ges-internal.h"
 #include "ges-track-element-asset.h"
 
 static GHashTable *parent_newparent_table = NULL;
+G_LOCK_DEFINE_STATIC (peaks);
+
 static void
 initable_iface_init (GInitableIface * initable_iface)
 {
@@ -51,6 +54,7 @@ enum
 {
   PROP_0,
   PROP_DURATION,
+  PROP_STREAM_LAYOUT,
   PROP_LAST
 };
 static GParamSpec *properties[PROP_LAST];
@@ -65,6 +69,13 @@ struct _GESUriClipAssetPrivate
   gboolean is_image;
 
   GList *asset_trackfilesources;
+  /* Stream assets created from the saved metadatas for streams the file
+   * turned out not to have, the clips extracted so far still use them */
+  GList *stale_stream_assets;
+
+  /* Protected by the peaks lock as they are computed in a worker thread */
+  GESAudioPeaks *peaks;
+  gboolean peaks_cache_checked;
 };
 
 struct _GESUriSourceAssetPrivate
@@ -72,9 +83,15 @@ struct _GESUriSourceAssetPrivate
   GstDiscovererStreamInfo *sinfo;
   GESUriClipAsset *parent_asset;
 
-  const gchar *uri;
+  gchar *uri;
+  gboolean is_image;
 };
 
+static gchar *_get_stream_layout (GESUriClipAsset * self);
+static void _free_stream_assets (GList * assets);
+static void _clear_stream_assets (GESUriClipAsset * self);
+static void _set_stream_layout (GESUriClipAsset * self, const gchar * layout);
+
 
 static void
 ges_uri_clip_asset_get_property (GObject * object, guint property_id,
@@ -86,6 +103,10 @@ ges_uri_clip_asset_get_property (GObject * object, guint property_id,
     case PROP_DURATION:
       g_value_set_uint64 (value, priv->duration);
       break;
+    case PROP_STREAM_LAYOUT:
+      g_value_take_string (value,
+          _get_stream_layout (GES_URI_CLIP_ASSET (object)));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
   }
@@ -101,6 +122,10 @@ ges_uri_clip_asset_set_property (GObject * object, guint property_id,
     case PROP_DURATION:
       priv->duration = g_value_get_uint64 (value);
       break;
+    case PROP_STREAM_LAYOUT:
+      _set_stream_layout (GES_URI_CLIP_ASSET (object),
+          g_value_get_string (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
   }
@@ -171,6 +196,24 @@ _asset_proxied (GESAsset * self, const gchar * new_uri)
   gst_object_unref (new_file);
 }
 
+static void
+ges_uri_clip_asset_finalize (GObject * object)
+{
+  GESUriClipAssetPrivate *priv = GES_URI_CLIP_ASSET (object)->priv;
+
+  if (priv->peaks)
+    ges_audio_peaks_free (priv->peaks);
+
+  if (priv->info)
+    gst_object_unref (priv->info);
+
+  /* The stream assets can outlive us in the asset cache */
+  _clear_stream_assets (GES_URI_CLIP_ASSET (object));
+  _free_stream_assets (priv->stale_stream_assets);
+
+  G_OBJECT_CLASS (ges_uri_clip_asset_parent_class)->finalize (object);
+}
+
 static void
 ges_uri_clip_asset_class_init (GESUriClipAssetClass * klass)
 {
@@ -179,6 +222,7 @@ ges_uri_clip_asset_class_init (GESUriClipAssetClass * klass)
 
   object_class->get_property = ges_uri_clip_asset_get_property;
   object_class->set_property = ges_uri_clip_asset_set_property;
+  object_class->finalize = ges_uri_clip_asset_finalize;
 
   GES_ASSET_CLASS (klass)->start_loading = _start_loading;
   GES_ASSET_CLASS (klass)->request_id_update = _request_id_update;
@@ -196,6 +240,21 @@ ges_uri_clip_asset_class_init (GESUriClipAssetClass * klass)
   g_object_class_install_property (object_class, PROP_DURATION,
       properties[PROP_DURATION]);
 
+  /**
+   * GESUriClipAsset:stream-layout:
+   *
+   * The streams of the media file, as a semicolon separated list of
+   * kind:stream-id where kind is one of audio, video or image, semicolons
+   * and backslashes being escaped with a backslash in the stream IDs. It is
+   * saved in projects so assets can be created without discovering the
+   * file, see ges_project_set_trust_saved_metadata().
+   */
+  properties[PROP_STREAM_LAYOUT] =
+      g_param_spec_string ("stream-layout", "Stream layout",
+      "The streams of the media file", NULL, G_PARAM_READWRITE);
+  g_object_class_install_property (object_class, PROP_STREAM_LAYOUT,
+      properties[PROP_STREAM_LAYOUT]);
+
   klass->discoverer = gst_discoverer_new (GST_SECOND, NULL);
   klass->sync_discoverer = gst_discoverer_new (GST_SECOND, NULL);
   g_signal_connect (klass->discoverer, "discovered",
@@ -220,23 +279,38 @@ ges_uri_clip_asset_init (GESUriClipAsset * self)
   priv->info = NULL;
   priv->duration = GST_CLOCK_TIME_NONE;
   priv->is_image = FALSE;
+  priv->peaks = NULL;
+  priv->peaks_cache_checked = FALSE;
 }
 
+/* Takes ownership of @tck_filesource_asset */
 static void
-_create_uri_source_asset (GESUriClipAsset * asset,
-    GstDiscovererStreamInfo * sinfo, GESTrackType type)
+_add_uri_source_asset (GESUriClipAsset * asset, GESAsset * tck_filesource_asset,
+    GstDiscovererStreamInfo * sinfo, GESTrackType type, gboolean is_image)
 {
-  GESAsset *tck_filesource_asset;
   GESUriSourceAssetPrivate *priv_tckasset;
   GESUriClipAssetPrivate *priv = asset->priv;
-  gchar *stream_id =
-      g_strdup (gst_discoverer_stream_info_get_stream_id (sinfo));
 
-  if (stream_id == NULL) {
-    GST_WARNING ("No stream ID found, using the pointer instead");
+  priv_tckasset = GES_URI_SOURCE_ASSET (tck_filesource_asset)->priv;
+  g_free (priv_tckasset->uri);
+  priv_tckasset->uri = g_strdup (ges_asset_get_id (GES_ASSET (asset)));
+  if (priv_tckasset->sinfo)
+    gst_object_unref (priv_tckasset->sinfo);
+  priv_tckasset->sinfo = sinfo ? gst_object_ref (sinfo) : NULL;
+  priv_tckasset->is_image = is_image;
+  priv_tckasset->parent_asset = asset;
+  ges_track_element_asset_set_track_type (GES_TRACK_ELEMENT_ASSET
+      (tck_filesource_asset), type);
+
+  priv->asset_trackfilesources = g_list_append (priv->asset_trackfilesources,
+      tck_filesource_asset);
+}
 
-    stream_id = g_strdup_printf ("%i", GPOINTER_TO_INT (sinfo));
-  }
+static void
+_create_uri_source_asset (GESUriClipAsset * asset, const gchar * stream_id,
+    GstDiscovererStreamInfo * sinfo, GESTrackType type, gboolean is_image)
+{
+  GESAsset *tck_filesource_asset;
 
   if (type == GES_TRACK_TYPE_VIDEO)
     tck_filesource_asset = ges_asset_request (GES_TYPE_VIDEO_URI_SOURCE,
@@ -244,30 +318,185 @@ _create_uri_source_asset (GESUriClipAsset * asset,
   else
     tck_filesource_asset = ges_asset_request (GES_TYPE_AUDIO_URI_SOURCE,
         stream_id, NULL);
-  g_free (stream_id);
 
-  priv_tckasset = GES_URI_SOURCE_ASSET (tck_filesource_asset)->priv;
-  priv_tckasset->uri = ges_asset_get_id (GES_ASSET (asset));
-  priv_tckasset->sinfo = gst_object_ref (sinfo);
-  priv_tckasset->parent_asset = asset;
-  ges_track_element_asset_set_track_type (GES_TRACK_ELEMENT_ASSET
-      (tck_filesource_asset), type);
+  /* We own the reference we got from the request */
+  _add_uri_source_asset (asset, tck_filesource_asset, sinfo, type, is_image);
+}
 
-  priv->asset_trackfilesources = g_list_append (priv->asset_trackfilesources,
-      gst_object_ref (tck_filesource_asset));
+/* Removes from @assets the stream asset to use for the @stream_id stream,
+ * the one with that ID or else the first one of the same kind */
+static GESAsset *
+_take_stream_asset (GList ** assets, const gchar * stream_id,
+    GESTrackType type, gboolean is_image)
+{
+  GList *tmp, *found = NULL;
+  GESAsset *asset;
+
+  for (tmp = *assets; tmp; tmp = tmp->next) {
+    if (g_strcmp0 (ges_asset_get_id (tmp->data), stream_id) == 0) {
+      found = tmp;
+      break;
+    }
+
+    if (found == NULL && GES_URI_SOURCE_ASSET (tmp->data)->priv->is_image ==
+        is_image && ges_track_element_asset_get_track_type (tmp->data) == type)
+      found = tmp;
+  }
+
+  if (found == NULL)
+    return NULL;
+
+  asset = found->data;
+  *assets = g_list_delete_link (*assets, found);
+
+  return asset;
+}
+
+static void
+_drop_stream_info (GESUriSourceAsset * asset)
+{
+  GESUriSourceAssetPrivate *priv = asset->priv;
+
+  if (priv->sinfo) {
+    gst_object_unref (priv->sinfo);
+    priv->sinfo = NULL;
+  }
+}
+
+static void
+_free_stream_assets (GList * assets)
+{
+  GList *tmp;
+
+  for (tmp = assets; tmp; tmp = tmp->next)
+    GES_URI_SOURCE_ASSET (tmp->data)->priv->parent_asset = NULL;
+  g_list_free_full (assets, gst_object_unref);
+}
+
+static void
+_clear_stream_assets (GESUriClipAsset * self)
+{
+  GESUriClipAssetPrivate *priv = self->priv;
+
+  _free_stream_assets (priv->asset_trackfilesources);
+  priv->asset_trackfilesources = NULL;
+}
+
+static gchar *
+_get_stream_layout (GESUriClipAsset * self)
+{
+  GList *tmp;
+  GString *layout = g_string_new (NULL);
+
+  for (tmp = self->priv->asset_trackfilesources; tmp; tmp = tmp->next) {
+    const gchar *id, *kind = "audio";
+
+    if (GES_URI_SOURCE_ASSET (tmp->data)->priv->is_image)
+      kind = "image";
+    else if (ges_track_element_asset_get_track_type (tmp->data) ==
+        GES_TRACK_TYPE_VIDEO)
+      kind = "video";
+
+    if (layout->len)
+      g_string_append_c (layout, ';');
+    g_string_append_printf (layout, "%s:", kind);
+
+    /* Stream IDs are free form, escape the separator */
+    for (id = ges_asset_get_id (tmp->data); *id; id++) {
+      if (*id == ';' || *id == '\\')
+        g_string_append_c (layout, '\\');
+      g_string_append_c (layout, *id);
+    }
+  }
+
+  return g_string_free (layout, FALSE);
+}
+
+/* Creates the stream assets described by @layout, as returned by
+ * _get_stream_layout, without any #GstDiscovererStreamInfo */
+static void
+_set_stream_layout (GESUriClipAsset * self, const gchar * layout)
+{
+  const gchar *c;
+  GString *stream;
+  GESTrackType supportedformats = GES_TRACK_TYPE_UNKNOWN;
+  GESUriClipAssetPrivate *priv = self->priv;
+
+  _clear_stream_assets (self);
+  priv->is_image = FALSE;
+
+  if (layout == NULL)
+    return;
+
+  stream = g_string_new (NULL);
+  for (c = layout;; c++) {
+    GESTrackType type;
+    gboolean is_image = FALSE;
+    gchar *stream_id;
+
+    if (*c == '\\' && c[1] != '\0') {
+      g_string_append_c (stream, *(++c));
+      continue;
+    } else if (*c != ';' && *c != '\0') {
+      g_string_append_c (stream, *c);
+      continue;
+    }
+
+    stream_id = strchr (stream->str, ':');
+    if (stream_id == NULL)
+      goto next;
+    *(stream_id++) = '\0';
+
+    if (g_strcmp0 (stream->str, "audio") == 0) {
+      type = GES_TRACK_TYPE_AUDIO;
+    } else if (g_strcmp0 (stream->str, "video") == 0) {
+      type = GES_TRACK_TYPE_VIDEO;
+    } else if (g_strcmp0 (stream->str, "image") == 0) {
+      type = GES_TRACK_TYPE_VIDEO;
+      is_image = priv->is_image = TRUE;
+    } else {
+      GST_WARNING_OBJECT (self, "Unknown stream kind %s", stream->str);
+      goto next;
+    }
+
+    if (supportedformats == GES_TRACK_TYPE_UNKNOWN)
+      supportedformats = type;
+    else
+      supportedformats |= type;
+
+    _create_uri_source_asset (self, stream_id, NULL, type, is_image);
+
+  next:
+    if (*c == '\0')
+      break;
+    g_string_truncate (stream, 0);
+  }
+  g_string_free (stream, TRUE);
+
+  ges_clip_asset_set_supported_formats (GES_CLIP_ASSET (self),
+      supportedformats);
 }
 
 static void
 ges_uri_clip_asset_set_info (GESUriClipAsset * self, GstDiscovererInfo * info)
 {
-  GList *tmp, *stream_list;
+  GList *tmp, *stream_list, *previous;
 
   GESTrackType supportedformats = GES_TRACK_TYPE_UNKNOWN;
   GESUriClipAssetPrivate *priv = GES_URI_CLIP_ASSET (self)->priv;
 
+  /* The streams might have been created from saved metadatas, and the
+   * clips extracted so far use them, so they are reused */
+  previous = priv->asset_trackfilesources;
+  priv->asset_trackfilesources = NULL;
+  priv->is_image = FALSE;
+
   /* Extract infos from the GstDiscovererInfo */
   stream_list = gst_discoverer_info_get_stream_list (info);
   for (tmp = stream_list; tmp; tmp = tmp->next) {
+    gchar *stream_id;
+    GESAsset *stream_asset;
+    gboolean is_image = FALSE;
     GESTrackType type = GES_TRACK_TYPE_UNKNOWN;
     GstDiscovererStreamInfo *sinf = (GstDiscovererStreamInfo *) tmp->data;
 
@@ -285,17 +514,36 @@ ges_uri_clip_asset_set_info (GESUriClipAsset * self, GstDiscovererInfo * info)
         supportedformats |= GES_TRACK_TYPE_VIDEO;
       if (gst_discoverer_video_info_is_image ((GstDiscovererVideoInfo *)
               sinf))
-        priv->is_image = TRUE;
+        is_image = priv->is_image = TRUE;
       type = GES_TRACK_TYPE_VIDEO;
     }
 
     GST_DEBUG_OBJECT (self, "Creating GESUriSourceAsset for stream: %s",
         gst_discoverer_stream_info_get_stream_id (sinf));
-    _create_uri_source_asset (self, sinf, type);
+
+    stream_id = g_strdup (gst_discoverer_stream_info_get_stream_id (sinf));
+    if (stream_id == NULL) {
+      GST_WARNING ("No stream ID found, using the pointer instead");
+
+      stream_id = g_strdup_printf ("%i", GPOINTER_TO_INT (sinf));
+    }
+    stream_asset = _take_stream_asset (&previous, stream_id, type, is_image);
+    if (stream_asset)
+      _add_uri_source_asset (self, stream_asset, sinf, type, is_image);
+    else
+      _create_uri_source_asset (self, stream_id, sinf, type, is_image);
+    g_free (stream_id);
   }
   ges_clip_asset_set_supported_formats (GES_CLIP_ASSET
       (self), supportedformats);
 
+  if (previous) {
+    GST_INFO_OBJECT (self, "%i saved streams not found in the file",
+        g_list_length (previous));
+    priv->stale_stream_assets = g_list_concat (priv->stale_stream_assets,
+        previous);
+  }
+
   if (stream_list)
     gst_discoverer_stream_info_list_free (stream_list);
 
@@ -303,6 +551,8 @@ ges_uri_clip_asset_set_info (GESUriClipAsset * self, GstDiscovererInfo * info)
     priv->duration = gst_discoverer_info_get_duration (info);
   /* else we keep #GST_CLOCK_TIME_NONE */
 
+  if (priv->info)
+    gst_object_unref (priv->info);
   priv->info = gst_object_ref (info);
 }
 
@@ -317,6 +567,44 @@ _set_meta_foreach (const GstTagList * tags, const gchar * tag,
   g_value_unset (&value);
 }
 
+static void
+_set_file_size_from_info (GESUriClipAsset * self, GFileInfo * info)
+{
+  if (info) {
+    ges_meta_container_set_uint64 (GES_META_CONTAINER (self),
+        GES_META_FILE_SIZE, g_file_info_get_size (info));
+    g_object_unref (info);
+  }
+}
+
+static void
+_file_size_queried_cb (GFile * file, GAsyncResult * res,
+    GESUriClipAsset * self)
+{
+  _set_file_size_from_info (self, g_file_query_info_finish (file, res, NULL));
+  gst_object_unref (self);
+}
+
+/* Records the size of the file so it can be found back if it is moved,
+ * see ges_project_add_search_root(). The file is queried asynchronously
+ * unless @sync, not to block the main thread for each asset */
+static void
+_set_file_size (GESUriClipAsset * self, gboolean sync)
+{
+  GFile *file = g_file_new_for_uri (ges_asset_get_id (GES_ASSET (self)));
+
+  if (sync) {
+    _set_file_size_from_info (self, g_file_query_info (file,
+            G_FILE_ATTRIBUTE_STANDARD_SIZE, G_FILE_QUERY_INFO_NONE, NULL,
+            NULL));
+  } else {
+    g_file_query_info_async (file, G_FILE_ATTRIBUTE_STANDARD_SIZE,
+        G_FILE_QUERY_INFO_NONE, G_PRIORITY_LOW, NULL,
+        (GAsyncReadyCallback) _file_size_queried_cb, gst_object_ref (self));
+  }
+  g_object_unref (file);
+}
+
 static void
 discoverer_discovered_cb (GstDiscoverer * discoverer,
     GstDiscovererInfo * info, GError * err, gpointer user_data)
@@ -331,9 +619,158 @@ discoverer_discovered_cb (GstDiscoverer * discoverer,
   if (tags)
     gst_tag_list_foreach (tags, (GstTagForeachFunc) _set_meta_foreach, mfs);
 
-  if (err == NULL)
+  if (err == NULL) {
     ges_uri_clip_asset_set_info (mfs, info);
+    _set_file_size (mfs, FALSE);
+  }
   ges_asset_cache_set_loaded (GES_TYPE_URI_CLIP, uri, err);
+  gst_object_unref (mfs);
+}
+
+/* Internal API */
+
+/* Creates the asset of @uri from the @properties and @metadatas saved in a
+ * project, without discovering the file. Returns %NULL if @properties do
+ * not describe the file well enough, or if the asset already exists */
+GESAsset *
+ges_uri_clip_asset_new_trusted (const gchar * uri,
+    const GstStructure * properties, const gchar * metadatas)
+{
+  const gchar *layout;
+  const GValue *duration;
+  GESAsset *cached;
+  GESUriClipAsset *asset;
+
+  layout = gst_structure_get_string (properties, "stream-layout");
+  if (layout == NULL || *layout == '\0')
+    return NULL;
+
+  if ((cached = ges_asset_cache_lookup (GES_TYPE_URI_CLIP, uri))) {
+    gst_object_unref (cached);
+    return NULL;
+  }
+
+  asset = g_object_new (GES_TYPE_URI_CLIP_ASSET, "id", uri,
+      "extractable-type", GES_TYPE_URI_CLIP, NULL);
+  _set_stream_layout (asset, layout);
+
+  if (!asset->priv->is_image) {
+    duration = gst_structure_get_value (properties, "duration");
+    if (duration == NULL || !G_VALUE_HOLDS_UINT64 (duration) ||
+        !GST_CLOCK_TIME_IS_VALID (g_value_get_uint64 (duration))) {
+      gst_object_unref (asset);
+
+      return NULL;
+    }
+    asset->priv->duration = g_value_get_uint64 (duration);
+  }
+
+  if (metadatas)
+    ges_meta_container_add_metas_from_string (GES_META_CONTAINER (asset),
+        metadatas);
+
+  GST_DEBUG_OBJECT (asset, "Created from saved metadatas, layout: %s", layout);
+  ges_asset_cache_put (gst_object_ref (asset), NULL);
+  ges_asset_cache_set_loaded (GES_TYPE_URI_CLIP, uri, NULL);
+
+  return GES_ASSET (asset);
+}
+
+static void
+_validate_thread (GSimpleAsyncResult * simple, GObject * object,
+    GCancellable * cancellable)
+{
+  GstClockTime timeout;
+  GstDiscoverer *discoverer;
+  GError *error = NULL;
+  GstDiscovererInfo *info = NULL;
+
+  /* The class discoverers are used from the main thread */
+  g_object_get (GES_URI_CLIP_ASSET_GET_CLASS (object)->discoverer, "timeout",
+      &timeout, NULL);
+  discoverer = gst_discoverer_new (timeout, &error);
+  if (discoverer) {
+    info = gst_discoverer_discover_uri (discoverer,
+        ges_asset_get_id (GES_ASSET (object)), &error);
+    gst_object_unref (discoverer);
+  }
+
+  if (error) {
+    if (info)
+      gst_object_unref (info);
+    g_simple_async_result_take_error (simple, error);
+
+    return;
+  }
+
+  g_simple_async_result_set_op_res_gpointer (simple, info, gst_object_unref);
+}
+
+/* Discovers the file of @self in a low priority thread, to check the
+ * metadatas it has been created from with ges_uri_clip_asset_new_trusted */
+void
+ges_uri_clip_asset_validate_async (GESUriClipAsset * self,
+    GAsyncReadyCallback callback, gpointer user_data)
+{
+  GSimpleAsyncResult *simple;
+
+  simple = g_simple_async_result_new (G_OBJECT (self), callback, user_data,
+      ges_uri_clip_asset_validate_async);
+  g_simple_async_result_run_in_thread (simple, _validate_thread,
+      G_PRIORITY_LOW, NULL);
+  g_object_unref (simple);
+}
+
+/* Updates @self with what has been discovered. Returns %FALSE if the file
+ * could not be discovered or if it did not match the saved metadatas, in
+ * which case @self now matches the file */
+gboolean
+ges_uri_clip_asset_validate_finish (GESUriClipAsset * self,
+    GAsyncResult * res, GError ** error)
+{
+  gboolean matches;
+  GstClockTime duration;
+  GESTrackType formats;
+  gchar *layout, *new_layout;
+  const GstTagList *tags;
+  GstDiscovererInfo *info;
+  GSimpleAsyncResult *simple = G_SIMPLE_ASYNC_RESULT (res);
+
+  g_return_val_if_fail (g_simple_async_result_is_valid (res, G_OBJECT (self),
+          ges_uri_clip_asset_validate_async), FALSE);
+
+  if (g_simple_async_result_propagate_error (simple, error))
+    return FALSE;
+
+  info = g_simple_async_result_get_op_res_gpointer (simple);
+  duration = self->priv->duration;
+  formats = ges_clip_asset_get_supported_formats (GES_CLIP_ASSET (self));
+  layout = _get_stream_layout (self);
+
+  tags = gst_discoverer_info_get_tags (info);
+  if (tags)
+    gst_tag_list_foreach (tags, (GstTagForeachFunc) _set_meta_foreach, self);
+  ges_uri_clip_asset_set_info (self, info);
+  _set_file_size (self, FALSE);
+
+  new_layout = _get_stream_layout (self);
+  matches = duration == self->priv->duration && formats ==
+      ges_clip_asset_get_supported_formats (GES_CLIP_ASSET (self)) &&
+      g_strcmp0 (layout, new_layout) == 0;
+
+  if (!matches) {
+    GST_INFO_OBJECT (self, "Saved metadatas did not match: duration %"
+        GST_TIME_FORMAT " -> %" GST_TIME_FORMAT ", layout %s -> %s",
+        GST_TIME_ARGS (duration), GST_TIME_ARGS (self->priv->duration),
+        layout, new_layout);
+    g_set_error (error, GES_ERROR, GES_ERROR_ASSET_METADATA_MISMATCH,
+        "The saved metadatas of %s did not match the file",
+        ges_asset_get_id (GES_ASSET (self)));
+  }
+  g_free (layout);
+  g_free (new_layout);
+
+  return matches;
 }
 
 /* API implementation */
@@ -343,7 +780,8 @@ discoverer_discovered_cb (GstDiscoverer * discoverer,
  *
  * Gets #GstDiscovererInfo about the file
  *
- * Returns: (transfer none): #GstDiscovererInfo of specified asset
+ * Returns: (transfer none) (allow-none): #GstDiscovererInfo of specified
+ * asset, %NULL if it has been dropped with #ges_uri_clip_asset_drop_info
  */
 GstDiscovererInfo *
 ges_uri_clip_asset_get_info (const GESUriClipAsset * self)
@@ -353,6 +791,38 @@ ges_uri_clip_asset_get_info (const GESUriClipAsset * self)
   return self->priv->info;
 }
 
+/**
+ * ges_uri_clip_asset_drop_info:
+ * @self: Target asset
+ *
+ * Releases the #GstDiscovererInfo of @self, with the tags and stream
+ * topology it holds, for applications that keep many assets around and do
+ * not need it. The duration of @self, whether it is an image, the formats
+ * it supports and its stream assets are kept, but
+ * #ges_uri_clip_asset_get_info and #ges_uri_source_asset_get_stream_info
+ * will return %NULL afterward.
+ */
+void
+ges_uri_clip_asset_drop_info (GESUriClipAsset * self)
+{
+  GList *tmp;
+  GESUriClipAssetPrivate *priv;
+
+  g_return_if_fail (GES_IS_URI_CLIP_ASSET (self));
+
+  priv = self->priv;
+  if (priv->info) {
+    gst_object_unref (priv->info);
+    priv->info = NULL;
+  }
+
+  /* The stream infos reference the GstDiscovererInfo topology too */
+  for (tmp = priv->asset_trackfilesources; tmp; tmp = tmp->next)
+    _drop_stream_info (tmp->data);
+  for (tmp = priv->stale_stream_assets; tmp; tmp = tmp->next)
+    _drop_stream_info (tmp->data);
+}
+
 /**
  * ges_uri_clip_asset_get_duration:
  * @self: a #GESUriClipAsset
@@ -475,6 +945,9 @@ ges_uri_clip_asset_request_sync (const gchar * uri, GError ** error)
 
   ges_asset_cache_put (gst_object_ref (asset), NULL);
   ges_uri_clip_asset_set_info (asset, info);
+  /* The caller expects to be blocked anyway */
+  _set_file_size (asset, TRUE);
+  gst_object_unref (info);
   ges_asset_cache_set_loaded (GES_TYPE_URI_CLIP, uri, lerror);
 
   return asset;
@@ -514,6 +987,198 @@ ges_uri_clip_asset_get_stream_assets (GESUriClipAsset * self)
   return self->priv->asset_trackfilesources;
 }
 
+static void
+_generate_peaks_thread (GSimpleAsyncResult * simple, GObject * object,
+    GCancellable * cancellable)
+{
+  GError *error = NULL;
+  GESAudioPeaks *peaks;
+  GESUriClipAssetPrivate *priv = GES_URI_CLIP_ASSET (object)->priv;
+  const gchar *uri = ges_asset_get_id (GES_ASSET (object));
+
+  peaks = ges_audio_peaks_compute (uri, cancellable, &error);
+  if (peaks == NULL) {
+    g_simple_async_result_take_error (simple, error);
+
+    return;
+  }
+
+  if (!ges_audio_peaks_save (peaks, uri, &error)) {
+    GST_WARNING_OBJECT (object, "Could not cache peaks: %s", error->message);
+    g_clear_error (&error);
+  }
+
+  G_LOCK (peaks);
+  if (priv->peaks)
+    ges_audio_peaks_free (priv->peaks);
+  priv->peaks = peaks;
+  priv->peaks_cache_checked = TRUE;
+  G_UNLOCK (peaks);
+
+  g_simple_async_result_set_op_res_gboolean (simple, TRUE);
+}
+
+/* Takes the peaks lock and returns the peaks of @self, loading them from
+ * the disk cache first if needed, without holding the lock meanwhile */
+static GESAudioPeaks *
+_lock_peaks (GESUriClipAsset * self)
+{
+  GESAudioPeaks *loaded;
+  GESUriClipAssetPrivate *priv = self->priv;
+
+  G_LOCK (peaks);
+  if (priv->peaks || priv->peaks_cache_checked)
+    return priv->peaks;
+  G_UNLOCK (peaks);
+
+  loaded = ges_audio_peaks_load (ges_asset_get_id (GES_ASSET (self)));
+
+  G_LOCK (peaks);
+  if (priv->peaks == NULL)
+    priv->peaks = loaded;
+  else if (loaded)
+    ges_audio_peaks_free (loaded);
+  priv->peaks_cache_checked = TRUE;
+
+  return priv->peaks;
+}
+
+/**
+ * ges_uri_clip_asset_generate_peaks:
+ * @self: A #GESUriClipAsset
+ * @cancellable: (allow-none): optional %GCancellable object, %NULL to ignore.
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the peaks
+ * are ready
+ * @user_data: The user data to pass when @callback is called
+ *
+ * Decodes the audio of @self in a background thread to compute the peaks
+ * used to draw its waveform, and stores them in the user cache directory so
+ * they are available right away the next time the media is used. Once done
+ * ges_uri_clip_asset_get_peaks() can be used to retrieve them.
+ *
+ * You do not need to call that method if ges_uri_clip_asset_has_peaks()
+ * returns %TRUE.
+ */
+void
+ges_uri_clip_asset_generate_peaks (GESUriClipAsset * self,
+    GCancellable * cancellable, GAsyncReadyCallback callback,
+    gpointer user_data)
+{
+  GSimpleAsyncResult *simple;
+
+  g_return_if_fail (GES_IS_URI_CLIP_ASSET (self));
+
+  simple = g_simple_async_result_new (G_OBJECT (self), callback, user_data,
+      ges_uri_clip_asset_generate_peaks);
+
+  if (!(ges_clip_asset_get_supported_formats (GES_CLIP_ASSET (self)) &
+          GES_TRACK_TYPE_AUDIO)) {
+    g_simple_async_result_set_error (simple, GES_ERROR,
+        GES_ERROR_ASSET_LOADING, "%s does not contain any audio stream",
+        ges_asset_get_id (GES_ASSET (self)));
+    g_simple_async_result_complete_in_idle (simple);
+  } else {
+    g_simple_async_result_run_in_thread (simple, _generate_peaks_thread,
+        G_PRIORITY_LOW, cancellable);
+  }
+
+  g_object_unref (simple);
+}
+
+/**
+ * ges_uri_clip_asset_generate_peaks_finish:
+ * @self: A #GESUriClipAsset
+ * @res: The #GAsyncResult from which to get the result
+ * @error: (allow-none): An error to be set in case something wrong happens
+ * or %NULL
+ *
+ * Finishes an operation started with ges_uri_clip_asset_generate_peaks().
+ *
+ * Returns: %TRUE if the peaks of @self have been computed, %FALSE otherwise
+ */
+gboolean
+ges_uri_clip_asset_generate_peaks_finish (GESUriClipAsset * self,
+    GAsyncResult * res, GError ** error)
+{
+  GSimpleAsyncResult *simple = G_SIMPLE_ASYNC_RESULT (res);
+
+  g_return_val_if_fail (g_simple_async_result_is_valid (res, G_OBJECT (self),
+          ges_uri_clip_asset_generate_peaks), FALSE);
+
+  if (g_simple_async_result_propagate_error (simple, error))
+    return FALSE;
+
+  return g_simple_async_result_get_op_res_gboolean (simple);
+}
+
+/**
+ * ges_uri_clip_asset_has_peaks:
+ * @self: A #GESUriClipAsset
+ *
+ * Checks whether the peaks of @self have already been computed, either
+ * in this session or in a previous one.
+ *
+ * Returns: %TRUE if ges_uri_clip_asset_get_peaks() can be used, %FALSE
+ * otherwise
+ */
+gboolean
+ges_uri_clip_asset_has_peaks (GESUriClipAsset * self)
+{
+  gboolean ret;
+
+  g_return_val_if_fail (GES_IS_URI_CLIP_ASSET (self), FALSE);
+
+  ret = _lock_peaks (self) != NULL;
+  G_UNLOCK (peaks);
+
+  return ret;
+}
+
+/**
+ * ges_uri_clip_asset_get_peaks:
+ * @self: A #GESUriClipAsset
+ * @start: The position in the media of the first peak to get
+ * @duration: The duration of media covered by the peaks
+ * @n_peaks: The number of peaks to get, usually the width in pixels of the
+ * waveform to draw
+ * @mins: (out caller-allocates) (array length=n_peaks) (allow-none): Array
+ * to fill with the minimum value of each peak
+ * @maxs: (out caller-allocates) (array length=n_peaks) (allow-none): Array
+ * to fill with the maximum value of each peak
+ * @rms: (out caller-allocates) (array length=n_peaks) (allow-none): Array
+ * to fill with the RMS value of each peak
+ *
+ * Gets @n_peaks audio peaks evenly covering the [@start, @start + @duration]
+ * range of the media, without decoding it. The precomputed resolution that
+ * best matches the requested one is used, values are between -1.0 and 1.0.
+ *
+ * Note that @start is a position in the media, not in the timeline, so the
+ * in-point of the clip has to be taken into account.
+ *
+ * Returns: The number of peaks that have been set, 0 if the peaks of @self
+ * have not been computed yet, see ges_uri_clip_asset_generate_peaks()
+ */
+guint
+ges_uri_clip_asset_get_peaks (GESUriClipAsset * self, GstClockTime start,
+    GstClockTime duration, guint n_peaks, gfloat * mins, gfloat * maxs,
+    gfloat * rms)
+{
+  guint ret = 0;
+  GESAudioPeaks *peaks;
+
+  g_return_val_if_fail (GES_IS_URI_CLIP_ASSET (self), 0);
+  g_return_val_if_fail (GST_CLOCK_TIME_IS_VALID (start), 0);
+  g_return_val_if_fail (GST_CLOCK_TIME_IS_VALID (duration), 0);
+
+  peaks = _lock_peaks (self);
+  if (peaks)
+    ret = ges_audio_peaks_get_range (peaks, start, duration, n_peaks, mins,
+        maxs, rms);
+  G_UNLOCK (peaks);
+
+  return ret;
+}
+
 /*****************************************************************
  *            GESUriSourceAsset implementation             *
  *****************************************************************/
@@ -534,11 +1199,8 @@ _extract (GESAsset * asset, GError ** error)
   GESTrackElement *trackelement;
   GESUriSourceAssetPrivate *priv = GES_URI_SOURCE_ASSET (asset)->priv;
 
-  if (GST_IS_DISCOVERER_STREAM_INFO (priv->sinfo) == FALSE) {
-    GST_WARNING_OBJECT (asset, "Can not extract as no strean info set");
-
-    return NULL;
-  }
+  GESTrackType type =
+      ges_track_element_asset_get_track_type (GES_TRACK_ELEMENT_ASSET (asset));
 
   if (priv->uri == NULL) {
     GST_WARNING_OBJECT (asset, "Can not extract as no uri set");
@@ -546,29 +1208,41 @@ _extract (GESAsset * asset, GError ** error)
     return NULL;
   }
 
-  if (GST_IS_DISCOVERER_VIDEO_INFO (priv->sinfo) &&
-      gst_discoverer_video_info_is_image ((GstDiscovererVideoInfo *)
-          priv->sinfo))
+  /* The stream info is not set when the asset was created from the
+   * metadatas saved in a project, so only rely on the track type */
+  if (priv->is_image)
     trackelement =
         GES_TRACK_ELEMENT (ges_image_source_new (g_strdup (priv->uri)));
-  else if (GST_IS_DISCOVERER_VIDEO_INFO (priv->sinfo))
+  else if (type == GES_TRACK_TYPE_VIDEO)
     trackelement =
         GES_TRACK_ELEMENT (ges_video_uri_source_new (g_strdup (priv->uri)));
   else
     trackelement =
         GES_TRACK_ELEMENT (ges_audio_uri_source_new (g_strdup (priv->uri)));
 
-  ges_track_element_set_track_type (trackelement,
-      ges_track_element_asset_get_track_type (GES_TRACK_ELEMENT_ASSET (asset)));
+  ges_track_element_set_track_type (trackelement, type);
 
   return GES_EXTRACTABLE (trackelement);
 }
 
+static void
+ges_uri_source_asset_finalize (GObject * object)
+{
+  GESUriSourceAssetPrivate *priv = GES_URI_SOURCE_ASSET (object)->priv;
+
+  if (priv->sinfo)
+    gst_object_unref (priv->sinfo);
+  g_free (priv->uri);
+
+  G_OBJECT_CLASS (ges_uri_source_asset_parent_class)->finalize (object);
+}
+
 static void
 ges_uri_source_asset_class_init (GESUriSourceAssetClass * klass)
 {
   g_type_class_add_private (klass, sizeof (GESUriSourceAssetPrivate));
 
+  G_OBJECT_CLASS (klass)->finalize = ges_uri_source_asset_finalize;
   GES_ASSET_CLASS (klass)->extract = _extract;
 }
 
@@ -583,15 +1257,19 @@ ges_uri_source_asset_init (GESUriSourceAsset * self)
   priv->sinfo = NULL;
   priv->parent_asset = NULL;
   priv->uri = NULL;
+  priv->is_image = FALSE;
 }
 
 /**
  * ges_uri_source_asset_get_stream_info:
  * @asset: A #GESUriClipAsset
  *
- * Get the #GstDiscovererStreamInfo user by @asset
+ * Get the #GstDiscovererStreamInfo user by @asset, %NULL if the asset of
+ * the file it comes from has been created from the metadatas saved in a
+ * project and has not been validated yet, or if its info has been dropped
+ * with #ges_uri_clip_asset_drop_info.
  *
- * Returns: (transfer none): a #GESUriClipAsset
+ * Returns: (transfer none) (allow-none): a #GstDiscovererStreamInfo
  */
 GstDiscovererStreamInfo *
 ges_uri_source_asset_get_stream_info (GESUriSourceAsset * asset)
@@ -68,6 +68,7 @@ struct _GESUriClipAssetClass
 };
 
 GstDiscovererInfo *ges_uri_clip_asset_get_info      (const GESUriClipAsset * self);
+void ges_uri_clip_asset_drop_info                   (GESUriClipAsset *self);
 GstClockTime ges_uri_clip_asset_get_duration        (GESUriClipAsset *self);
 gboolean ges_uri_clip_asset_is_image                (GESUriClipAsset *self);
 void ges_uri_clip_asset_new                         (const gchar *uri,
@@ -78,6 +79,21 @@ GESUriClipAsset* ges_uri_clip_asset_request_sync    (const gchar *uri, GError **
 void ges_uri_clip_asset_class_set_timeout           (GESUriClipAssetClass *class,
                                                      GstClockTime timeout);
 const GList * ges_uri_clip_asset_get_stream_assets  (GESUriClipAsset *self);
+void ges_uri_clip_asset_generate_peaks              (GESUriClipAsset *self,
+                                                     GCancellable *cancellable,
+                                                     GAsyncReadyCallback callback,
+                                                     gpointer user_data);
+gboolean ges_uri_clip_asset_generate_peaks_finish   (GESUriClipAsset *self,
+                                                     GAsyncResult *res,
+                                                     GError **error);
+gboolean ges_uri_clip_asset_has_peaks               (GESUriClipAsset *self);
+guint ges_uri_clip_asset_get_peaks                  (GESUriClipAsset *self,
+                                                     GstClockTime start,
+                                                     GstClockTime duration,
+                                                     guint n_peaks,
+                                                     gfloat *mins,
+                                                     gfloat *maxs,
+                                                     gfloat *rms);
 
 #define GES_TYPE_URI_SOURCE_ASSET ges_uri_source_asset_get_type()
 #define GES_URI_SOURCE_ASSET(obj) \
@@ -24,6 +24,7 @@
  */
 
 #include <string.h>
+#include <glib/gstdio.h>
 
 #include "ges-internal.h"
 #include "ges-timeline.h"
@@ -122,3 +123,24 @@ pspec_hash (gconstpointer key_spec)
 
   return h;
 }
+
+/* Returns the directory in which GES caches the data of @subdir, which is
+ * either under $GES_CACHE_DIRECTORY if set, or under the user cache
+ * directory, making sure it exists */
+gchar *
+ges_get_cache_directory (const gchar * subdir)
+{
+  gchar *directory;
+  const gchar *root = g_getenv ("GES_CACHE_DIRECTORY");
+
+  if (root && *root)
+    directory = g_build_filename (root, subdir, NULL);
+  else
+    directory = g_build_filename (g_get_user_cache_dir (),
+        "gstreamer-editing-services", subdir, NULL);
+
+  if (g_mkdir_with_parents (directory, 0755))
+    GST_WARNING ("Could not create %s", directory);
+
+  return directory;
+}
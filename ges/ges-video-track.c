@@ -27,7 +27,15 @@
 
 struct _GESVideoTrackPrivate
 {
-  gpointer nothing;
+  /* The GESSmartMixer compositing the layers */
+  GstElement *mixer;
+  guint mixing_threads;
+};
+
+enum
+{
+  PROP_0,
+  PROP_MIXING_THREADS,
 };
 
 #define GES_VIDEO_TRACK_GET_PRIVATE(o)  (G_TYPE_INSTANCE_GET_PRIVATE ((o), GES_TYPE_VIDEO_TRACK, GESVideoTrackPrivate))
@@ -42,19 +50,68 @@ create_element_for_raw_video_gap (GESTrack * track)
       NULL);
 }
 
+static GstElement *
+get_mixing_element (GESTrack * track)
+{
+  GESVideoTrackPrivate *priv = GES_VIDEO_TRACK (track)->priv;
+
+  priv->mixer = ges_smart_mixer_new (track);
+  g_object_add_weak_pointer (G_OBJECT (priv->mixer),
+      (gpointer *) & priv->mixer);
+  g_object_set (priv->mixer, "n-threads", priv->mixing_threads, NULL);
+
+  return priv->mixer;
+}
+
+static void
+ges_video_track_get_property (GObject * object, guint property_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GESVideoTrackPrivate *priv = GES_VIDEO_TRACK (object)->priv;
+
+  switch (property_id) {
+    case PROP_MIXING_THREADS:
+      g_value_set_uint (value, priv->mixing_threads);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+  }
+}
+
+static void
+ges_video_track_set_property (GObject * object, guint property_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GESVideoTrackPrivate *priv = GES_VIDEO_TRACK (object)->priv;
+
+  switch (property_id) {
+    case PROP_MIXING_THREADS:
+      priv->mixing_threads = g_value_get_uint (value);
+      if (priv->mixer)
+        g_object_set (priv->mixer, "n-threads", priv->mixing_threads, NULL);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+  }
+}
+
 static void
 ges_video_track_init (GESVideoTrack * ges_video_track)
 {
-/*   GESVideoTrackPrivate *priv = GES_VIDEO_TRACK_GET_PRIVATE (ges_video_track);
- */
+  ges_video_track->priv = GES_VIDEO_TRACK_GET_PRIVATE (ges_video_track);
 
-  /* TODO: Add initialization code here */
+  ges_video_track->priv->mixer = NULL;
+  ges_video_track->priv->mixing_threads = 1;
 }
 
 static void
 ges_video_track_finalize (GObject * object)
 {
-  /* TODO: Add deinitalization code here */
+  GESVideoTrackPrivate *priv = GES_VIDEO_TRACK (object)->priv;
+
+  if (priv->mixer)
+    g_object_remove_weak_pointer (G_OBJECT (priv->mixer),
+        (gpointer *) & priv->mixer);
 
   G_OBJECT_CLASS (ges_video_track_parent_class)->finalize (object);
 }
@@ -68,9 +125,24 @@ ges_video_track_class_init (GESVideoTrackClass * klass)
 
   g_type_class_add_private (klass, sizeof (GESVideoTrackPrivate));
 
+  object_class->get_property = ges_video_track_get_property;
+  object_class->set_property = ges_video_track_set_property;
   object_class->finalize = ges_video_track_finalize;
 
-  GES_TRACK_CLASS (klass)->get_mixing_element = ges_smart_mixer_new;
+  /**
+   * GESVideoTrack:mixing-threads:
+   *
+   * Number of threads compositing the layers of the track, each of them
+   * blending an horizontal stripe of the output frames. Stripes are only
+   * used when the restriction caps of the track specify a height. This has
+   * to be set before the track starts being played.
+   */
+  g_object_class_install_property (object_class, PROP_MIXING_THREADS,
+      g_param_spec_uint ("mixing-threads", "Mixing threads",
+          "Number of threads compositing the layers", 1, 64, 1,
+          G_PARAM_READWRITE));
+
+  GES_TRACK_CLASS (klass)->get_mixing_element = get_mixing_element;
 }
 
 /**
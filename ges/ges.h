@@ -45,6 +45,10 @@
 #include <ges/ges-base-effect-clip.h>
 #include <ges/ges-uri-clip.h>
 #include <ges/ges-group.h>
+#include <ges/ges-render-cache.h>
+#include <ges/ges-nested-timeline-clip.h>
+#include <ges/ges-nested-timeline-source.h>
+#include <ges/ges-timeline-snapshot.h>
 #include <ges/ges-screenshot.h>
 #include <ges/ges-asset.h>
 #include <ges/ges-clip-asset.h>
@@ -25,6 +25,7 @@
 #include <gst/video/video.h>
 
 #include "gstframepositionner.h"
+#include "ges-internal.h"
 
 static void gst_frame_positionner_set_property (GObject * object,
     guint property_id, const GValue * value, GParamSpec * pspec);
@@ -84,6 +85,13 @@ gst_frame_positionner_update_size (GstFramePositionner * pos)
   final_width = (pos->width > 0) ? pos->width : pos->track_width;
   final_height = (pos->height > 0) ? pos->height : pos->track_height;
 
+  if (pos->scale > 1) {
+    if (final_width > 0)
+      final_width = MAX (final_width / (gint) pos->scale, 1);
+    if (final_height > 0)
+      final_height = MAX (final_height / (gint) pos->scale, 1);
+  }
+
   if (final_width == 0 && final_height == 0)
     size_caps = gst_caps_new_empty_simple ("video/x-raw");
   else if (final_width == 0)
@@ -137,6 +145,8 @@ sync_size_with_track (GstFramePositionner * pos, GESTrack * track)
 {
   GstCaps *caps;
 
+  pos->scale = ges_track_get_preview_scale (track);
+
   g_object_get (track, "restriction-caps", &caps, NULL);
   sync_size_from_caps (pos, caps);
 }
@@ -304,6 +314,7 @@ gst_frame_positionner_init (GstFramePositionner * framepositionner)
   framepositionner->height = 0;
   framepositionner->track_width = 0;
   framepositionner->track_height = 0;
+  framepositionner->scale = 1;
   framepositionner->capsfilter = NULL;
   framepositionner->track_source = NULL;
   framepositionner->current_track = NULL;
@@ -450,8 +461,8 @@ gst_frame_positionner_transform_ip (GstBaseTransform * trans, GstBuffer * buf)
 
   GST_OBJECT_LOCK (framepositionner);
   meta->alpha = framepositionner->alpha;
-  meta->posx = framepositionner->posx;
-  meta->posy = framepositionner->posy;
+  meta->posx = framepositionner->posx / (gint) framepositionner->scale;
+  meta->posy = framepositionner->posy / (gint) framepositionner->scale;
   meta->zorder = framepositionner->zorder;
   GST_OBJECT_UNLOCK (framepositionner);
 
@@ -53,6 +53,9 @@ struct _GstFramePositionner
   gint height;
   gint track_width;
   gint track_height;
+
+  /* Factor by which the track currently downscales its output for preview */
+  guint scale;
 };
 
 struct _GstFramePositionnerClass
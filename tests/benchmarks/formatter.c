@@ -0,0 +1,306 @@
+/* Gstreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Times saving and loading synthetic projects through the xges formatter.
+ *
+ * For each requested size, a timeline is built (clips spread over layers,
+ * effects with children properties and keyframes), saved to a temporary
+ * .xges file and loaded back. The clips use the media files found in
+ * --media-dir if any, one asset per file, and test clips otherwise.
+ *
+ * The loading phases are measured by the formatter itself, see
+ * ges_project_get_load_timings():
+ *  - read: reading the file
+ *  - parse: parsing it, without the time spent handling its elements
+ *  - asset-resolution: requesting the assets and waiting for them
+ *  - clip-creation: creating the clips and setting their properties
+ *  - track-element-creation: adding the clips to their layers, which
+ *    creates their track elements, and adding their effects and keyframes
+ *  - first-commit: the timeline commit done before emitting "loaded"
+ * Along with them are printed:
+ *  - load-sync: the ges_project_load() call, which reads and parses the
+ *    file, handling its elements
+ *  - load-total: from calling ges_project_load() to "loaded" being emitted
+ *
+ * One JSON object is printed per line and per project size, times are in
+ * nanoseconds.
+ */
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <glib/gstdio.h>
+#include <ges/ges.h>
+#include <gst/controller/gstinterpolationcontrolsource.h>
+
+static gchar *sizes = NULL;
+static guint n_layers = 4;
+static guint n_effects = 1;
+static guint n_keyframes = 10;
+static gchar *media_dir = NULL;
+static gchar *effect_desc = NULL;
+static gchar *effect_property = NULL;
+
+static GOptionEntry options[] = {
+  {"clips", 'n', 0, G_OPTION_ARG_STRING, &sizes,
+      "Comma separated numbers of clips (default: 1000,10000,200000)", "N,..."},
+  {"layers", 'l', 0, G_OPTION_ARG_INT, &n_layers,
+      "Number of layers the clips are spread over", "M"},
+  {"effects", 'e', 0, G_OPTION_ARG_INT, &n_effects,
+      "Number of effects per clip", "K"},
+  {"keyframes", 'k', 0, G_OPTION_ARG_INT, &n_keyframes,
+      "Number of keyframes per effect", "N"},
+  {"media-dir", 'm', 0, G_OPTION_ARG_FILENAME, &media_dir,
+      "Directory containing the media files to use as assets", "DIR"},
+  {"effect", 0, 0, G_OPTION_ARG_STRING, &effect_desc,
+      "Bin description of the effects (default: agingtv)", "DESC"},
+  {"effect-property", 0, 0, G_OPTION_ARG_STRING, &effect_property,
+      "Child property of the effects to set and to set keyframes on "
+        "(default: scratch-lines)", "NAME"},
+  {NULL}
+};
+
+static void
+loaded_cb (GESProject * project, GESTimeline * timeline, GMainLoop * loop)
+{
+  g_main_loop_quit (loop);
+}
+
+static GList *
+request_assets (void)
+{
+  GDir *dir;
+  GList *assets = NULL;
+  const gchar *name;
+
+  if (media_dir == NULL || (dir = g_dir_open (media_dir, 0, NULL)) == NULL)
+    return g_list_prepend (NULL, ges_asset_request (GES_TYPE_TEST_CLIP, NULL,
+            NULL));
+
+  while ((name = g_dir_read_name (dir))) {
+    gchar *path = g_build_filename (media_dir, name, NULL);
+    gchar *uri = gst_filename_to_uri (path, NULL);
+    GESUriClipAsset *asset = ges_uri_clip_asset_request_sync (uri, NULL);
+
+    if (asset)
+      assets = g_list_prepend (assets, asset);
+    g_free (uri);
+    g_free (path);
+  }
+  g_dir_close (dir);
+
+  if (assets == NULL)
+    assets = g_list_prepend (NULL, ges_asset_request (GES_TYPE_TEST_CLIP,
+            NULL, NULL));
+
+  return assets;
+}
+
+static void
+add_effect (GESClip * clip)
+{
+  guint i;
+  GstControlSource *source;
+  GESEffect *effect = ges_effect_new (effect_desc);
+
+  if (effect == NULL || !ges_container_add (GES_CONTAINER (clip),
+          GES_TIMELINE_ELEMENT (effect))) {
+    if (effect)
+      gst_object_unref (effect);
+
+    return;
+  }
+
+  ges_track_element_set_child_properties (GES_TRACK_ELEMENT (effect),
+      effect_property, 5, NULL);
+
+  if (n_keyframes == 0)
+    return;
+
+  source = gst_interpolation_control_source_new ();
+  if (ges_track_element_set_control_source (GES_TRACK_ELEMENT (effect),
+          source, effect_property, "direct")) {
+    for (i = 0; i < n_keyframes; i++)
+      gst_timed_value_control_source_set (GST_TIMED_VALUE_CONTROL_SOURCE
+          (source), i * 10 * GST_MSECOND, (gdouble) (i % 2));
+  }
+  gst_object_unref (source);
+}
+
+static GESTimeline *
+create_timeline (guint n_clips, GList * assets)
+{
+  guint i, j;
+  GList *tmp = assets;
+  GESLayer **layers = g_new (GESLayer *, n_layers);
+  GESTimeline *timeline = ges_timeline_new_audio_video ();
+
+  for (i = 0; i < n_layers; i++)
+    layers[i] = ges_timeline_append_layer (timeline);
+
+  for (i = 0; i < n_clips; i++) {
+    GESClip *clip = ges_layer_add_asset (layers[i % n_layers], tmp->data,
+        (i / n_layers) * GST_SECOND, 0, GST_SECOND, GES_TRACK_TYPE_UNKNOWN);
+
+    for (j = 0; clip && j < n_effects; j++)
+      add_effect (clip);
+
+    tmp = tmp->next ? tmp->next : assets;
+  }
+  g_free (layers);
+
+  return timeline;
+}
+
+static gboolean
+run (guint n_clips, GList * assets, const gchar * path, const gchar * uri)
+{
+  GMainLoop *loop;
+  GStatBuf stat_buf;
+  GESProject *project;
+  GESTimeline *timeline;
+  GError *err = NULL;
+  GstStructure *timings;
+  GstClockTime start, save, load_sync, load_total, read, parse,
+      asset_resolution, clip_creation, track_element_creation, first_commit;
+
+  timeline = create_timeline (n_clips, assets);
+  start = gst_util_get_timestamp ();
+  if (!ges_timeline_save_to_uri (timeline, uri, NULL, TRUE, &err)) {
+    g_printerr ("Could not save to %s: %s\n", uri, err->message);
+    g_clear_error (&err);
+    gst_object_unref (timeline);
+
+    return FALSE;
+  }
+  save = gst_util_get_timestamp () - start;
+  gst_object_unref (timeline);
+
+  loop = g_main_loop_new (NULL, FALSE);
+  project = ges_project_new (uri);
+  timeline = ges_timeline_new ();
+  g_signal_connect (project, "loaded", G_CALLBACK (loaded_cb), loop);
+
+  start = gst_util_get_timestamp ();
+  if (!ges_project_load (project, timeline, &err)) {
+    g_printerr ("Could not load %s: %s\n", uri, err->message);
+    g_clear_error (&err);
+    g_main_loop_unref (loop);
+    gst_object_unref (timeline);
+    gst_object_unref (project);
+
+    return FALSE;
+  }
+  load_sync = gst_util_get_timestamp () - start;
+  g_main_loop_run (loop);
+  load_total = gst_util_get_timestamp () - start;
+
+  if (g_stat (path, &stat_buf) != 0)
+    stat_buf.st_size = 0;
+
+  timings = ges_project_get_load_timings (project);
+  gst_structure_get (timings, "read", G_TYPE_UINT64, &read,
+      "parse", G_TYPE_UINT64, &parse,
+      "asset-resolution", G_TYPE_UINT64, &asset_resolution,
+      "clip-creation", G_TYPE_UINT64, &clip_creation,
+      "track-element-creation", G_TYPE_UINT64, &track_element_creation,
+      "first-commit", G_TYPE_UINT64, &first_commit, NULL);
+  gst_structure_free (timings);
+  g_print ("{\"clips\": %u, \"layers\": %u, \"effects\": %u, "
+      "\"keyframes\": %u, \"assets\": %u, \"size\": %" G_GINT64_FORMAT ", "
+      "\"save\": %" G_GUINT64_FORMAT ", \"read\": %" G_GUINT64_FORMAT ", "
+      "\"parse\": %" G_GUINT64_FORMAT ", \"load-sync\": %" G_GUINT64_FORMAT
+      ", \"asset-resolution\": %" G_GUINT64_FORMAT ", "
+      "\"clip-creation\": %" G_GUINT64_FORMAT ", "
+      "\"track-element-creation\": %" G_GUINT64_FORMAT ", "
+      "\"first-commit\": %" G_GUINT64_FORMAT ", "
+      "\"load-total\": %" G_GUINT64_FORMAT "}\n", n_clips, n_layers,
+      n_effects, n_keyframes, g_list_length (assets),
+      (gint64) stat_buf.st_size, save, read, parse, load_sync,
+      asset_resolution, clip_creation, track_element_creation, first_commit,
+      load_total);
+
+  g_signal_handlers_disconnect_by_func (project, loaded_cb, loop);
+  gst_object_unref (timeline);
+  gst_object_unref (project);
+  g_main_loop_unref (loop);
+
+  return TRUE;
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  gint fd;
+  guint i;
+  gchar *path, *uri, **n_clips;
+  GList *assets;
+  GOptionContext *ctx;
+  GError *err = NULL;
+  gint ret = 0;
+
+  ctx = g_option_context_new ("- time saving and loading xges projects");
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_printerr ("Error initializing: %s\n", err->message);
+    g_option_context_free (ctx);
+    g_clear_error (&err);
+
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  if (effect_desc == NULL)
+    effect_desc = g_strdup ("agingtv");
+  if (effect_property == NULL)
+    effect_property = g_strdup ("scratch-lines");
+  n_layers = MAX (n_layers, 1);
+
+  ges_init ();
+
+  fd = g_file_open_tmp ("ges-formatter-XXXXXX.xges", &path, &err);
+  if (fd < 0) {
+    g_printerr ("Could not create a temporary file: %s\n", err->message);
+    g_clear_error (&err);
+
+    return 1;
+  }
+  close (fd);
+  uri = gst_filename_to_uri (path, NULL);
+
+  assets = request_assets ();
+  n_clips = g_strsplit (sizes ? sizes : "1000,10000,200000", ",", -1);
+  for (i = 0; n_clips[i]; i++) {
+    if (!run (strtoul (n_clips[i], NULL, 10), assets, path, uri)) {
+      ret = 1;
+      break;
+    }
+  }
+
+  g_strfreev (n_clips);
+  g_list_free_full (assets, gst_object_unref);
+  g_unlink (path);
+  g_free (path);
+  g_free (uri);
+  g_free (sizes);
+  g_free (media_dir);
+  g_free (effect_desc);
+  g_free (effect_property);
+
+  return ret;
+}
@@ -0,0 +1,447 @@
+/* Gstreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Measures the memory GES uses per object while building a synthetic
+ * project: assets, clips spread over layers, effects on those clips and
+ * keyframes on those effects, up to the preroll of a pipeline playing the
+ * timeline.
+ *
+ * Three numbers are recorded at each stage:
+ *  - the resident set size, read from /proc/self/statm, so only on Linux;
+ *  - the heap in use as reported by mallinfo2(), so only with glibc 2.33 or
+ *    newer. It only covers the main malloc arena, so the allocations of
+ *    streaming threads during the preroll are only partially seen;
+ *  - with --count-allocations, the number of allocations, counted by
+ *    wrapping malloc and friends, so only with glibc. GLib older than 2.76
+ *    needs G_SLICE=always-malloc for GSlice allocations to be counted.
+ *
+ * The cost of each track element, everything included (GObjects,
+ * gnlobjects and the bookkeeping of tracks and timeline), is derived from
+ * the clips stage; with --element-budget the program fails when it goes
+ * over the given number of bytes, so that it can be used to catch
+ * regressions.
+ *
+ * With --json, one JSON object is printed per line and per stage instead of
+ * the human readable report, sizes are in bytes.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <unistd.h>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include <ges/ges.h>
+#include <gst/controller/gstinterpolationcontrolsource.h>
+
+#if defined (__GLIBC__) && \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#define HAVE_MALLINFO2 1
+#endif
+
+typedef struct
+{
+  gint64 rss;
+  gint64 heap;
+  gint64 n_allocs;
+} MemoryStats;
+
+static guint n_assets = 100;
+static guint n_clips = 1000;
+static guint n_layers = 4;
+static guint n_effects = 1;
+static guint n_keyframes = 10;
+static gchar *effect_desc = NULL;
+static gchar *effect_property = NULL;
+static gboolean no_preroll = FALSE;
+static gboolean count_allocations = FALSE;
+static gint element_budget = 0;
+static gboolean json = FALSE;
+
+static GOptionEntry options[] = {
+  {"assets", 'a', 0, G_OPTION_ARG_INT, &n_assets,
+      "Number of effect assets to request", "N"},
+  {"clips", 'n', 0, G_OPTION_ARG_INT, &n_clips, "Number of clips", "N"},
+  {"layers", 'l', 0, G_OPTION_ARG_INT, &n_layers,
+      "Number of layers the clips are spread over", "M"},
+  {"effects", 'e', 0, G_OPTION_ARG_INT, &n_effects,
+      "Number of effects per clip", "K"},
+  {"keyframes", 'k', 0, G_OPTION_ARG_INT, &n_keyframes,
+      "Number of keyframes per effect", "N"},
+  {"effect", 0, 0, G_OPTION_ARG_STRING, &effect_desc,
+      "Bin description of the effects (default: agingtv)", "DESC"},
+  {"effect-property", 0, 0, G_OPTION_ARG_STRING, &effect_property,
+      "Child property of the effects to set keyframes on "
+        "(default: scratch-lines)", "NAME"},
+  {"no-preroll", 0, 0, G_OPTION_ARG_NONE, &no_preroll,
+      "Do not preroll a pipeline with the timeline", NULL},
+  {"count-allocations", 0, 0, G_OPTION_ARG_NONE, &count_allocations,
+      "Count the allocations (needs glibc)", NULL},
+  {"element-budget", 0, 0, G_OPTION_ARG_INT, &element_budget,
+      "Fail if a track element costs more than BYTES", "BYTES"},
+  {"json", 0, 0, G_OPTION_ARG_NONE, &json,
+      "Print one JSON object per stage", NULL},
+  {NULL}
+};
+
+/* Allocation counting. The program is linked with -export-dynamic so those
+ * definitions take precedence over the glibc ones for every library. They
+ * count as soon as the program starts, --count-allocations only decides
+ * whether the numbers are reported */
+static volatile gsize n_allocs = 0;
+
+#ifdef __GLIBC__
+extern void *__libc_malloc (size_t size);
+extern void *__libc_calloc (size_t n_blocks, size_t size);
+extern void *__libc_realloc (void *mem, size_t size);
+extern void *__libc_memalign (size_t alignment, size_t size);
+
+void *
+malloc (size_t size)
+{
+  g_atomic_pointer_add (&n_allocs, 1);
+
+  return __libc_malloc (size);
+}
+
+void *
+calloc (size_t n_blocks, size_t size)
+{
+  g_atomic_pointer_add (&n_allocs, 1);
+
+  return __libc_calloc (n_blocks, size);
+}
+
+void *
+realloc (void *mem, size_t size)
+{
+  if (mem == NULL)
+    g_atomic_pointer_add (&n_allocs, 1);
+
+  return __libc_realloc (mem, size);
+}
+
+void *
+memalign (size_t alignment, size_t size)
+{
+  g_atomic_pointer_add (&n_allocs, 1);
+
+  return __libc_memalign (alignment, size);
+}
+
+void *
+aligned_alloc (size_t alignment, size_t size)
+{
+  return memalign (alignment, size);
+}
+
+int
+posix_memalign (void **mem, size_t alignment, size_t size)
+{
+  if (alignment % sizeof (void *) || (alignment & (alignment - 1)))
+    return EINVAL;
+
+  *mem = memalign (alignment, size);
+
+  return *mem ? 0 : ENOMEM;
+}
+#endif
+
+static gint64
+get_rss (void)
+{
+  FILE *statm;
+  unsigned long size, resident;
+
+  statm = fopen ("/proc/self/statm", "r");
+  if (statm == NULL)
+    return 0;
+
+  if (fscanf (statm, "%lu %lu", &size, &resident) != 2)
+    resident = 0;
+  fclose (statm);
+
+  return (gint64) resident * sysconf (_SC_PAGESIZE);
+}
+
+static gint64
+get_heap (void)
+{
+#ifdef HAVE_MALLINFO2
+  struct mallinfo2 info = mallinfo2 ();
+
+  /* Chunks in use and mmap()ed blocks */
+  return info.uordblks + info.hblkhd;
+#else
+  return 0;
+#endif
+}
+
+static void
+get_stats (MemoryStats * stats)
+{
+  stats->rss = get_rss ();
+  stats->heap = get_heap ();
+  stats->n_allocs = (gint64) (gsize) g_atomic_pointer_get (&n_allocs);
+}
+
+/* Prints @diff, and its share per @n_objects @objects */
+static void
+print_stats (const gchar * stage, const MemoryStats * diff, guint n_objects,
+    const gchar * objects)
+{
+  if (json) {
+    g_print ("{\"stage\": \"%s\", \"objects\": %u, \"object\": \"%s\", "
+        "\"rss\": %" G_GINT64_FORMAT ", \"heap\": %" G_GINT64_FORMAT,
+        stage, n_objects, objects ? objects : "", diff->rss, diff->heap);
+    if (count_allocations)
+      g_print (", \"allocations\": %" G_GINT64_FORMAT, diff->n_allocs);
+    if (n_objects) {
+      g_print (", \"rss-per-object\": %" G_GINT64_FORMAT ", "
+          "\"heap-per-object\": %" G_GINT64_FORMAT, diff->rss / n_objects,
+          diff->heap / n_objects);
+      if (count_allocations)
+        g_print (", \"allocations-per-object\": %" G_GINT64_FORMAT,
+            diff->n_allocs / n_objects);
+    }
+    g_print ("}\n");
+
+    return;
+  }
+
+  g_print ("%-28s RSS: %+9" G_GINT64_FORMAT " KiB", stage, diff->rss / 1024);
+#ifdef HAVE_MALLINFO2
+  g_print (", heap: %+9" G_GINT64_FORMAT " KiB", diff->heap / 1024);
+#endif
+  if (count_allocations)
+    g_print (", %" G_GINT64_FORMAT " allocations", diff->n_allocs);
+
+  if (n_objects) {
+    g_print (" (per %s: %" G_GINT64_FORMAT " bytes of RSS", objects,
+        diff->rss / n_objects);
+#ifdef HAVE_MALLINFO2
+    g_print (", %" G_GINT64_FORMAT " bytes of heap", diff->heap / n_objects);
+#endif
+    if (count_allocations)
+      g_print (", %" G_GINT64_FORMAT " allocations",
+          diff->n_allocs / n_objects);
+    g_print (")");
+  }
+  g_print ("\n");
+}
+
+/* Prints what changed since @previous, per @n_objects @objects, updates
+ * @previous and returns the difference in @diff if not %NULL */
+static void
+report (MemoryStats * previous, const gchar * stage, guint n_objects,
+    const gchar * objects, MemoryStats * diff)
+{
+  MemoryStats current, tmp;
+
+  get_stats (&current);
+  tmp.rss = current.rss - previous->rss;
+  tmp.heap = current.heap - previous->heap;
+  tmp.n_allocs = current.n_allocs - previous->n_allocs;
+
+  print_stats (stage, &tmp, n_objects, objects);
+
+  *previous = current;
+  if (diff)
+    *diff = tmp;
+}
+
+static guint
+add_keyframes (GESTrackElement * effect)
+{
+  guint i;
+  GstControlSource *source;
+
+  if (n_keyframes == 0)
+    return 0;
+
+  source = gst_interpolation_control_source_new ();
+  if (!ges_track_element_set_control_source (effect, source, effect_property,
+          "direct")) {
+    gst_object_unref (source);
+
+    return 0;
+  }
+
+  for (i = 0; i < n_keyframes; i++)
+    gst_timed_value_control_source_set (GST_TIMED_VALUE_CONTROL_SOURCE
+        (source), i * 10 * GST_MSECOND, (gdouble) (i % 2));
+  gst_object_unref (source);
+
+  return n_keyframes;
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  guint j, n_added_effects = 0, n_added_keyframes = 0, n_elements = 0;
+  gint64 element_cost;
+  gboolean over_budget = FALSE;
+  GList *assets = NULL, *clips = NULL, *tmp;
+  GESAsset *asset;
+  GESProject *project;
+  GESTimeline *timeline;
+  GESLayer **layers;
+  GESPipeline *pipeline;
+  MemoryStats stats, clips_diff;
+  GOptionContext *ctx;
+  GError *err = NULL;
+
+  ctx = g_option_context_new ("- measure the memory used by GES objects");
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_printerr ("Error initializing: %s\n", err->message);
+    g_option_context_free (ctx);
+    g_clear_error (&err);
+
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  if (effect_desc == NULL)
+    effect_desc = g_strdup ("agingtv");
+  if (effect_property == NULL)
+    effect_property = g_strdup ("scratch-lines");
+  n_layers = MAX (n_layers, 1);
+
+#ifndef __GLIBC__
+  if (count_allocations) {
+    g_printerr ("Allocations can only be counted with glibc\n");
+    count_allocations = FALSE;
+  }
+#endif
+
+  get_stats (&stats);
+  ges_init ();
+  report (&stats, "Initialization", 0, NULL, NULL);
+
+  /* Effect assets are the cheapest way to get many different assets without
+   * any media file */
+  for (j = 0; j < n_assets; j++) {
+    gchar *id = g_strdup_printf ("identity name=asset%u", j);
+
+    asset = ges_asset_request (GES_TYPE_EFFECT, id, NULL);
+    if (asset)
+      assets = g_list_prepend (assets, asset);
+    g_free (id);
+  }
+  report (&stats, "Assets", g_list_length (assets), "asset", NULL);
+
+  project = ges_project_new (NULL);
+  timeline = GES_TIMELINE (ges_asset_extract (GES_ASSET (project), NULL));
+  ges_timeline_add_track (timeline, GES_TRACK (ges_audio_track_new ()));
+  ges_timeline_add_track (timeline, GES_TRACK (ges_video_track_new ()));
+  layers = g_new (GESLayer *, n_layers);
+  for (j = 0; j < n_layers; j++)
+    layers[j] = ges_timeline_append_layer (timeline);
+  report (&stats, "Empty timeline", 0, NULL, NULL);
+
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+  for (j = 0; j < n_clips; j++) {
+    GESClip *clip = ges_layer_add_asset (layers[j % n_layers], asset,
+        (j / n_layers) * GST_SECOND, 0, GST_SECOND, GES_TRACK_TYPE_UNKNOWN);
+
+    clips = g_list_prepend (clips, clip);
+    n_elements += g_list_length (GES_CONTAINER_CHILDREN (clip));
+  }
+  report (&stats, "Clips", n_clips, "clip", &clips_diff);
+  if (n_elements) {
+    print_stats ("Track elements", &clips_diff, n_elements, "track element");
+
+#ifdef HAVE_MALLINFO2
+    element_cost = clips_diff.heap / n_elements;
+#else
+    element_cost = clips_diff.rss / n_elements;
+#endif
+    if (element_budget > 0 && element_cost > element_budget) {
+      g_printerr ("A track element costs %" G_GINT64_FORMAT " bytes, over "
+          "the budget of %i bytes\n", element_cost, element_budget);
+      over_budget = TRUE;
+    }
+  }
+
+  for (tmp = clips; tmp; tmp = tmp->next) {
+    for (j = 0; j < n_effects; j++) {
+      GESEffect *effect = ges_effect_new (effect_desc);
+
+      if (effect == NULL || !ges_container_add (tmp->data,
+              GES_TIMELINE_ELEMENT (effect))) {
+        g_printerr ("Could not add effect %s\n", effect_desc);
+        if (effect)
+          gst_object_unref (effect);
+
+        goto effects_done;
+      }
+      n_added_effects++;
+    }
+  }
+effects_done:
+  report (&stats, "Effects", n_added_effects, "effect", NULL);
+
+  for (tmp = clips; tmp; tmp = tmp->next) {
+    GList *effects = ges_clip_get_top_effects (tmp->data), *etmp;
+
+    for (etmp = effects; etmp; etmp = etmp->next)
+      n_added_keyframes += add_keyframes (etmp->data);
+    g_list_free_full (effects, gst_object_unref);
+  }
+  report (&stats, "Keyframes", n_added_keyframes, "keyframe", NULL);
+
+  ges_timeline_commit (timeline);
+  report (&stats, "Commit", n_clips, "clip", NULL);
+
+  if (!no_preroll) {
+    pipeline = ges_pipeline_new ();
+    ges_pipeline_preview_set_video_sink (pipeline,
+        gst_element_factory_make ("fakesink", NULL));
+    ges_pipeline_preview_set_audio_sink (pipeline,
+        gst_element_factory_make ("fakesink", NULL));
+    ges_pipeline_add_timeline (pipeline, timeline);
+
+    if (gst_element_set_state (GST_ELEMENT (pipeline),
+            GST_STATE_PAUSED) == GST_STATE_CHANGE_FAILURE ||
+        gst_element_get_state (GST_ELEMENT (pipeline), NULL, NULL,
+            60 * GST_SECOND) != GST_STATE_CHANGE_SUCCESS)
+      g_printerr ("Could not preroll the pipeline\n");
+    report (&stats, "Pipeline preroll", n_clips, "clip", NULL);
+
+    gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_NULL);
+    gst_object_unref (pipeline);
+  }
+
+  g_list_free (clips);
+  g_free (layers);
+  gst_object_unref (timeline);
+  gst_object_unref (asset);
+  gst_object_unref (project);
+  g_list_free_full (assets, gst_object_unref);
+  report (&stats, "Freeing", 0, NULL, NULL);
+
+  g_free (effect_desc);
+  g_free (effect_property);
+
+  return over_budget ? 1 : 0;
+}
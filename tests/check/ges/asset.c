@@ -129,6 +129,7 @@ GST_START_TEST (test_proxy_asset)
   fail_unless (nothing != NULL);
 
   fail_unless (ges_asset_set_proxy (nothing, "identity"));
+  gst_object_unref (nothing);
 
   nothing_at_all = ges_asset_request (GES_TYPE_EFFECT, "nothing_at_all", NULL);
   fail_if (nothing_at_all);
@@ -138,6 +139,7 @@ GST_START_TEST (test_proxy_asset)
 
   /* Now we proxy nothing_at_all to nothing which is itself proxied to identity */
   fail_unless (ges_asset_set_proxy (nothing_at_all, "nothing"));
+  gst_object_unref (nothing_at_all);
 
   /* If we request nothing_at_all we should get the good proxied identity */
   nothing_at_all = ges_asset_request (GES_TYPE_EFFECT, "nothing_at_all", NULL);
@@ -149,6 +151,100 @@ GST_START_TEST (test_proxy_asset)
 
 GST_END_TEST;
 
+GST_START_TEST (test_cache_max_size)
+{
+  GList *assets;
+  GESAsset *identity, *queue, *lookup;
+
+  fail_unless (ges_init ());
+
+  identity = ges_asset_request (GES_TYPE_EFFECT, "identity", NULL);
+  fail_unless (identity != NULL);
+  queue = ges_asset_request (GES_TYPE_EFFECT, "queue", NULL);
+  fail_unless (queue != NULL);
+
+  /* Both are referenced, nothing can be evicted */
+  ges_asset_cache_set_max_size (1);
+  fail_unless_equals_int (ges_asset_cache_get_max_size (), 1);
+  lookup = ges_asset_cache_lookup (GES_TYPE_EFFECT, "identity");
+  fail_unless (lookup == identity);
+  gst_object_unref (lookup);
+  lookup = ges_asset_cache_lookup (GES_TYPE_EFFECT, "queue");
+  fail_unless (lookup == queue);
+  gst_object_unref (lookup);
+
+  /* The least recently used unreferenced asset goes away */
+  gst_object_unref (identity);
+  ges_asset_cache_set_max_size (1);
+  fail_if (ges_asset_cache_lookup (GES_TYPE_EFFECT, "identity"));
+  lookup = ges_asset_cache_lookup (GES_TYPE_EFFECT, "queue");
+  fail_unless (lookup == queue);
+  gst_object_unref (lookup);
+
+  /* Assets registered by GES are always kept */
+  assets = ges_list_assets (GES_TYPE_TRANSITION_CLIP);
+  fail_unless (assets != NULL);
+  g_list_free (assets);
+
+  /* And evicted assets can be requested again */
+  identity = ges_asset_request (GES_TYPE_EFFECT, "identity", NULL);
+  fail_unless (identity != NULL);
+
+  ges_asset_cache_set_max_size (0);
+  gst_object_unref (identity);
+  gst_object_unref (queue);
+}
+
+GST_END_TEST;
+
+static void
+cached_asset_requested (GObject * source, GAsyncResult * res, gpointer udata)
+{
+  GError *error = NULL;
+  GESAsset *asset = ges_asset_request_finish (res, &error);
+
+  fail_unless (asset != NULL);
+  fail_unless (error == NULL);
+  fail_unless (asset == udata);
+  gst_object_unref (asset);
+
+  g_main_loop_quit (mainloop);
+}
+
+GST_START_TEST (test_cache_evict_after_async_request)
+{
+  GESAsset *identity, *queue, *lookup;
+
+  fail_unless (ges_init ());
+
+  identity = ges_asset_request (GES_TYPE_EFFECT, "identity", NULL);
+  fail_unless (identity != NULL);
+
+  /* Request it again asynchronously while it is in the cache */
+  mainloop = g_main_loop_new (NULL, FALSE);
+  ges_asset_request_async (GES_TYPE_EFFECT, "identity", NULL,
+      cached_asset_requested, identity);
+  g_main_loop_run (mainloop);
+  g_main_loop_unref (mainloop);
+
+  queue = ges_asset_request (GES_TYPE_EFFECT, "queue", NULL);
+  fail_unless (queue != NULL);
+
+  /* The async request did not leave any reference behind */
+  ASSERT_OBJECT_REFCOUNT (identity, "identity", 2);
+  gst_object_unref (identity);
+  ges_asset_cache_set_max_size (1);
+  fail_if (ges_asset_cache_lookup (GES_TYPE_EFFECT, "identity"));
+  lookup = ges_asset_cache_lookup (GES_TYPE_EFFECT, "queue");
+  fail_unless (lookup == queue);
+  gst_object_unref (lookup);
+
+  ges_asset_cache_set_max_size (0);
+  gst_object_unref (queue);
+}
+
+GST_END_TEST;
+
 static Suite *
 ges_suite (void)
 {
@@ -163,6 +259,8 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_basic);
   tcase_add_test (tc_chain, test_change_asset);
   tcase_add_test (tc_chain, test_proxy_asset);
+  tcase_add_test (tc_chain, test_cache_max_size);
+  tcase_add_test (tc_chain, test_cache_evict_after_async_request);
 
   return s;
 }
@@ -250,8 +250,8 @@ GST_START_TEST (test_gap_filling_basic)
   GESTrack *track;
   GESTimeline *timeline;
   GstElement *composition;
-  GESLayer *layer;
-  GESClip *clip, *clip1, *clip2;
+  GESLayer *layer, *layer1;
+  GESClip *clip, *clip1, *clip2, *clip3;
 
   GstElement *gnlsrc, *gnlsrc1, *gap = NULL;
   GESTrackElement *trackelement, *trackelement1, *trackelement2;
@@ -345,6 +345,25 @@ GST_START_TEST (test_gap_filling_basic)
   assert_equals_uint64 (_DURATION (trackelement2), 5);
   assert_equals_int (g_list_length (GST_BIN_CHILDREN (composition)), 6);
 
+  /* Gaps far from the changes are left untouched */
+  fail_unless (g_list_find (GST_BIN_CHILDREN (composition), gap) != NULL);
+  ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (clip2), 36);
+  fail_unless (ges_timeline_commit (timeline));
+  assert_equals_int (g_list_length (GST_BIN_CHILDREN (composition)), 6);
+  fail_unless (g_list_find (GST_BIN_CHILDREN (composition), gap) != NULL);
+  gap_object_check (gap, 5, 10, 1);
+
+  /* An element starting long before the changes still covers them */
+  layer1 = ges_timeline_append_layer (timeline);
+  clip3 = GES_CLIP (ges_test_clip_new ());
+  g_object_set (clip3, "start", (guint64) 0, "duration", (guint64) 50, NULL);
+  fail_unless (ges_layer_add_clip (layer1, clip3));
+  fail_unless (ges_timeline_commit (timeline));
+  assert_equals_int (g_list_length (GST_BIN_CHILDREN (composition)), 5);
+  ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (clip2), 38);
+  fail_unless (ges_timeline_commit (timeline));
+  assert_equals_int (g_list_length (GST_BIN_CHILDREN (composition)), 5);
+
   gst_object_unref (timeline);
 }
 
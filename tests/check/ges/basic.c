@@ -706,6 +706,516 @@ GST_START_TEST (test_ges_pipeline_change_state)
 
 GST_END_TEST;
 
+GST_START_TEST (test_ges_pipeline_unused_tracks)
+{
+  GstState state;
+  GESAsset *asset;
+  GESLayer *layer;
+  GESTimeline *timeline;
+  GESPipeline *pipeline;
+  GESTrack *audio_track, *video_track;
+
+  ges_init ();
+
+  layer = ges_layer_new ();
+  timeline = ges_timeline_new ();
+  audio_track = GES_TRACK (ges_audio_track_new ());
+  video_track = GES_TRACK (ges_video_track_new ());
+  fail_unless (ges_timeline_add_track (timeline, audio_track));
+  fail_unless (ges_timeline_add_track (timeline, video_track));
+  fail_unless (ges_timeline_add_layer (timeline, layer));
+
+  pipeline = ges_test_create_pipeline (timeline);
+  fail_unless (ges_pipeline_set_mode (pipeline, TIMELINE_MODE_PREVIEW_AUDIO));
+
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+  ges_layer_add_asset (layer, asset, 0, 0, 10, GES_TRACK_TYPE_UNKNOWN);
+  gst_object_unref (asset);
+
+  ges_timeline_commit (timeline);
+  ASSERT_SET_STATE (GST_ELEMENT (pipeline), GST_STATE_PAUSED,
+      GST_STATE_CHANGE_ASYNC);
+  fail_unless (gst_element_get_state (GST_ELEMENT (pipeline), &state, NULL,
+          GST_CLOCK_TIME_NONE) == GST_STATE_CHANGE_SUCCESS);
+  fail_unless (state == GST_STATE_PAUSED);
+
+  /* The video track is not composited in audio only preview */
+  fail_unless (gst_element_is_locked_state (GST_ELEMENT (video_track)));
+  fail_unless (GST_STATE (video_track) == GST_STATE_NULL);
+  fail_if (gst_element_is_locked_state (GST_ELEMENT (audio_track)));
+  fail_unless (GST_STATE (audio_track) == GST_STATE_PAUSED);
+
+  /* And gets reactivated when it is needed again */
+  fail_unless (ges_pipeline_set_mode (pipeline, TIMELINE_MODE_PREVIEW));
+  ASSERT_SET_STATE (GST_ELEMENT (pipeline), GST_STATE_PAUSED,
+      GST_STATE_CHANGE_ASYNC);
+  fail_unless (gst_element_get_state (GST_ELEMENT (pipeline), &state, NULL,
+          GST_CLOCK_TIME_NONE) == GST_STATE_CHANGE_SUCCESS);
+  fail_if (gst_element_is_locked_state (GST_ELEMENT (video_track)));
+  fail_unless (GST_STATE (video_track) == GST_STATE_PAUSED);
+
+  ASSERT_SET_STATE (GST_ELEMENT (pipeline), GST_STATE_NULL,
+      GST_STATE_CHANGE_SUCCESS);
+
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
+static gint
+get_track_width (GESTrack * track)
+{
+  gint width = 0;
+  GstCaps *caps;
+  GstPad *pad = gst_element_get_static_pad (GST_ELEMENT (track), "src");
+
+  if ((caps = gst_pad_get_current_caps (pad))) {
+    gst_structure_get_int (gst_caps_get_structure (caps, 0), "width", &width);
+    gst_caps_unref (caps);
+  }
+  gst_object_unref (pad);
+
+  return width;
+}
+
+GST_START_TEST (test_ges_pipeline_preview_quality)
+{
+  guint i;
+  GstCaps *caps;
+  GESAsset *asset;
+  GESLayer *layer;
+  GESTimeline *timeline;
+  GESPipeline *pipeline;
+  GESTrack *video_track;
+  GstElement *sink;
+  gint64 end_time;
+
+  ges_init ();
+
+  layer = ges_layer_new ();
+  timeline = ges_timeline_new ();
+  video_track = GES_TRACK (ges_video_track_new ());
+  caps = gst_caps_from_string ("video/x-raw,width=320,height=240");
+  ges_track_set_restriction_caps (video_track, caps);
+  gst_caps_unref (caps);
+  fail_unless (ges_timeline_add_track (timeline, video_track));
+  fail_unless (ges_timeline_add_layer (timeline, layer));
+
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+  ges_layer_add_asset (layer, asset, 0, 0, 10 * GST_SECOND,
+      GES_TRACK_TYPE_UNKNOWN);
+  gst_object_unref (asset);
+  ges_timeline_commit (timeline);
+
+  /* Play in realtime so that the clip lasts longer than the test */
+  pipeline = ges_test_create_pipeline (timeline);
+  g_object_get (pipeline, "video-sink", &sink, NULL);
+  g_object_set (sink, "sync", TRUE, NULL);
+  gst_object_unref (sink);
+  ges_pipeline_preview_set_quality (pipeline, GES_PREVIEW_QUALITY_HALF);
+  assert_equals_int (ges_pipeline_preview_get_quality (pipeline),
+      GES_PREVIEW_QUALITY_HALF);
+
+  /* The track outputs frames downscaled by 2 */
+  ASSERT_SET_STATE (GST_ELEMENT (pipeline), GST_STATE_PAUSED,
+      GST_STATE_CHANGE_ASYNC);
+  fail_unless (gst_element_get_state (GST_ELEMENT (pipeline), NULL, NULL,
+          GST_CLOCK_TIME_NONE) == GST_STATE_CHANGE_SUCCESS);
+  assert_equals_int (get_track_width (video_track), 160);
+
+  /* When adaptive, it goes down a step once enough QoS messages are posted
+   * while playing */
+  ges_pipeline_preview_set_adaptive_quality (pipeline, TRUE);
+  ASSERT_SET_STATE (GST_ELEMENT (pipeline), GST_STATE_PLAYING,
+      GST_STATE_CHANGE_ASYNC);
+  fail_unless (gst_element_get_state (GST_ELEMENT (pipeline), NULL, NULL,
+          GST_CLOCK_TIME_NONE) == GST_STATE_CHANGE_SUCCESS);
+  for (i = 0; i < 10; i++)
+    gst_element_post_message (GST_ELEMENT (video_track),
+        gst_message_new_qos (GST_OBJECT (video_track), TRUE, 0, 0, 0, 0));
+
+  end_time = g_get_monotonic_time () + 5 * G_TIME_SPAN_SECOND;
+  while (get_track_width (video_track) != 80 &&
+      g_get_monotonic_time () < end_time)
+    g_main_context_iteration (NULL, FALSE);
+  assert_equals_int (get_track_width (video_track), 80);
+  assert_equals_int (ges_pipeline_preview_get_quality (pipeline),
+      GES_PREVIEW_QUALITY_HALF);
+
+  ASSERT_SET_STATE (GST_ELEMENT (pipeline), GST_STATE_NULL,
+      GST_STATE_CHANGE_SUCCESS);
+
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_ges_timeline_snapshot)
+{
+  guint64 start;
+  GESLayer *layer;
+  GESTimeline *timeline;
+  GESClip *clip;
+  const GstStructure *structure;
+  GESTimelineSnapshot *snapshot, *snapshot2;
+
+  ges_init ();
+
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+  clip = GES_CLIP (ges_test_clip_new ());
+  ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (clip), 10);
+  ges_timeline_element_set_duration (GES_TIMELINE_ELEMENT (clip), 20);
+  fail_unless (ges_layer_add_clip (layer, clip));
+
+  snapshot = ges_timeline_snapshot (timeline);
+  fail_unless_equals_int (ges_timeline_snapshot_get_n_tracks (snapshot), 2);
+  fail_unless_equals_int (ges_timeline_snapshot_get_n_layers (snapshot), 1);
+  fail_unless_equals_int (ges_timeline_snapshot_get_n_clips (snapshot, 0), 1);
+  fail_unless_equals_uint64 (ges_timeline_snapshot_get_duration (snapshot), 30);
+
+  /* Nothing changed, the same snapshot is shared */
+  snapshot2 = ges_timeline_snapshot (timeline);
+  fail_unless (snapshot2 == snapshot);
+  ges_timeline_snapshot_unref (snapshot2);
+
+  /* Editing the timeline does not change the snapshot */
+  ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (clip), 50);
+  structure = ges_timeline_snapshot_get_clip (snapshot, 0, 0);
+  fail_unless (gst_structure_get_uint64 (structure, "start", &start));
+  fail_unless_equals_uint64 (start, 10);
+
+  snapshot2 = ges_timeline_snapshot (timeline);
+  fail_unless (snapshot2 != snapshot);
+  structure = ges_timeline_snapshot_get_clip (snapshot2, 0, 0);
+  fail_unless (gst_structure_get_uint64 (structure, "start", &start));
+  fail_unless_equals_uint64 (start, 50);
+  ges_timeline_snapshot_unref (snapshot2);
+
+  /* Children properties are part of the snapshot too */
+  ges_test_clip_set_volume (GES_TEST_CLIP (clip), 0.5);
+  snapshot2 = ges_timeline_snapshot (timeline);
+  fail_unless (snapshot2 != snapshot);
+  ges_timeline_snapshot_unref (snapshot2);
+
+  gst_object_unref (timeline);
+  ges_timeline_snapshot_unref (snapshot);
+}
+
+GST_END_TEST;
+
+static GESTrackElement *
+get_child_for_track_type (GESClip * clip, GESTrackType type)
+{
+  GList *tmp;
+
+  for (tmp = GES_CONTAINER_CHILDREN (clip); tmp; tmp = tmp->next)
+    if (ges_track_element_get_track_type (tmp->data) == type)
+      return tmp->data;
+
+  return NULL;
+}
+
+static gboolean
+get_child_active (const GstStructure * structure, GESTrackType type)
+{
+  guint i;
+  gboolean active;
+  GESTrackType track_type;
+  const GValue *children = gst_structure_get_value (structure, "children");
+
+  for (i = 0; i < gst_value_array_get_size (children); i++) {
+    const GstStructure *child =
+        gst_value_get_structure (gst_value_array_get_value (children, i));
+
+    fail_unless (gst_structure_get (child, "track-type", GES_TYPE_TRACK_TYPE,
+            &track_type, "active", G_TYPE_BOOLEAN, &active, NULL));
+    if (track_type == type)
+      return active;
+  }
+
+  fail ("No child of type %s", ges_track_type_name (type));
+
+  return FALSE;
+}
+
+static guint
+count_animated_children (const GstStructure * structure)
+{
+  guint i, animated = 0;
+  const GValue *children = gst_structure_get_value (structure, "children");
+
+  for (i = 0; i < gst_value_array_get_size (children); i++)
+    if (gst_structure_has_field (gst_value_get_structure
+            (gst_value_array_get_value (children, i)), "control-bindings"))
+      animated++;
+
+  return animated;
+}
+
+GST_START_TEST (test_ges_timeline_snapshot_copy_on_write)
+{
+  GList *tmp;
+  GstCaps *caps;
+  GESLayer *layer;
+  GESTrack *video_track = NULL;
+  GESTimeline *timeline;
+  GESClip *clip, *clip2;
+  GESTrackElement *audio_source;
+  GstControlSource *source;
+  GESTimelineSnapshot *snapshot, *snapshot2, *snapshot3;
+
+  ges_init ();
+
+  timeline = ges_timeline_new_audio_video ();
+  for (tmp = timeline->tracks; tmp; tmp = tmp->next)
+    if (GES_TRACK (tmp->data)->type == GES_TRACK_TYPE_VIDEO)
+      video_track = tmp->data;
+  layer = ges_timeline_append_layer (timeline);
+  clip = GES_CLIP (ges_test_clip_new ());
+  ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (clip), 10);
+  ges_timeline_element_set_duration (GES_TIMELINE_ELEMENT (clip), 20);
+  fail_unless (ges_layer_add_clip (layer, clip));
+  clip2 = GES_CLIP (ges_test_clip_new ());
+  ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (clip2), 100);
+  ges_timeline_element_set_duration (GES_TIMELINE_ELEMENT (clip2), 20);
+  fail_unless (ges_layer_add_clip (layer, clip2));
+
+  snapshot = ges_timeline_snapshot (timeline);
+
+  /* Only the edited clip is described again */
+  ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (clip), 50);
+  snapshot2 = ges_timeline_snapshot (timeline);
+  fail_unless (snapshot2 != snapshot);
+  fail_unless (ges_timeline_snapshot_get_clip (snapshot2, 0, 0) !=
+      ges_timeline_snapshot_get_clip (snapshot, 0, 0));
+  fail_unless (ges_timeline_snapshot_get_clip (snapshot2, 0, 1) ==
+      ges_timeline_snapshot_get_clip (snapshot, 0, 1));
+  ges_timeline_snapshot_unref (snapshot);
+
+  /* Restriction caps are part of the snapshot */
+  caps = gst_caps_from_string ("video/x-raw,width=320,height=240");
+  ges_track_set_restriction_caps (video_track, caps);
+  snapshot = ges_timeline_snapshot (timeline);
+  fail_unless (snapshot != snapshot2);
+  for (tmp = timeline->tracks; tmp; tmp = tmp->next) {
+    guint i = g_list_position (timeline->tracks, tmp);
+
+    if (tmp->data == video_track)
+      fail_unless (gst_caps_is_equal (ges_timeline_snapshot_get_track_caps
+              (snapshot, i), caps));
+  }
+  gst_caps_unref (caps);
+  fail_unless (ges_timeline_snapshot_get_clip (snapshot, 0, 0) ==
+      ges_timeline_snapshot_get_clip (snapshot2, 0, 0));
+  ges_timeline_snapshot_unref (snapshot2);
+
+  /* And so is whether track elements are active */
+  fail_unless (ges_track_element_set_active (get_child_for_track_type (clip2,
+              GES_TRACK_TYPE_VIDEO), FALSE));
+  snapshot2 = ges_timeline_snapshot (timeline);
+  fail_unless (snapshot2 != snapshot);
+  fail_unless (get_child_active (ges_timeline_snapshot_get_clip (snapshot, 0,
+              1), GES_TRACK_TYPE_VIDEO));
+  fail_if (get_child_active (ges_timeline_snapshot_get_clip (snapshot2, 0,
+              1), GES_TRACK_TYPE_VIDEO));
+  fail_unless (ges_timeline_snapshot_get_clip (snapshot2, 0, 0) ==
+      ges_timeline_snapshot_get_clip (snapshot, 0, 0));
+  ges_timeline_snapshot_unref (snapshot);
+
+  /* Keyframes can be edited behind the timeline's back */
+  audio_source = get_child_for_track_type (clip, GES_TRACK_TYPE_AUDIO);
+  source = gst_interpolation_control_source_new ();
+  fail_unless (ges_track_element_set_control_source (audio_source, source,
+          "volume", "direct"));
+  gst_timed_value_control_source_set (GST_TIMED_VALUE_CONTROL_SOURCE (source),
+      0, 0.5);
+  snapshot = ges_timeline_snapshot (timeline);
+  fail_unless (snapshot != snapshot2);
+  assert_equals_int (count_animated_children (ges_timeline_snapshot_get_clip
+          (snapshot, 0, 0)), 1);
+
+  snapshot3 = ges_timeline_snapshot (timeline);
+  fail_unless (snapshot3 == snapshot);
+  ges_timeline_snapshot_unref (snapshot3);
+
+  gst_timed_value_control_source_set (GST_TIMED_VALUE_CONTROL_SOURCE (source),
+      10, 1.0);
+  snapshot3 = ges_timeline_snapshot (timeline);
+  fail_unless (snapshot3 != snapshot);
+  fail_unless (ges_timeline_snapshot_get_clip (snapshot3, 0, 0) !=
+      ges_timeline_snapshot_get_clip (snapshot, 0, 0));
+  fail_unless (ges_timeline_snapshot_get_clip (snapshot3, 0, 1) ==
+      ges_timeline_snapshot_get_clip (snapshot, 0, 1));
+
+  gst_object_unref (source);
+  gst_object_unref (timeline);
+  ges_timeline_snapshot_unref (snapshot);
+  ges_timeline_snapshot_unref (snapshot2);
+  ges_timeline_snapshot_unref (snapshot3);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_ges_timeline_clone)
+{
+  GList *layers, *clips, *tmp, *tmp2, *values;
+  GESLayer *layer;
+  GESTimeline *timeline, *clone;
+  GESClip *clip, *clip2, *cloned;
+  GESContainer *group;
+  GESEffect *effect;
+  GESTrackElement *element, *audio_source;
+  GESTrack *track;
+  GstControlSource *source, *cloned_source;
+  GstControlBinding *binding;
+  GstTimedValue *value;
+  gchar *description;
+
+  ges_init ();
+
+  timeline = ges_timeline_new_audio_video ();
+  ges_timeline_set_snapping_distance (timeline, 5);
+  for (tmp = timeline->tracks; tmp; tmp = tmp->next) {
+    if (GES_IS_VIDEO_TRACK (tmp->data))
+      g_object_set (tmp->data, "mixing-threads", 3, NULL);
+  }
+  layer = ges_timeline_append_layer (timeline);
+  clip = GES_CLIP (ges_test_clip_new ());
+  ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (clip), 10);
+  ges_timeline_element_set_duration (GES_TIMELINE_ELEMENT (clip), 20);
+  fail_unless (ges_layer_add_clip (layer, clip));
+  clip2 = GES_CLIP (ges_test_clip_new ());
+  ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (clip2), 40);
+  ges_timeline_element_set_duration (GES_TIMELINE_ELEMENT (clip2), 10);
+  fail_unless (ges_layer_add_clip (layer, clip2));
+  ges_test_clip_set_volume (GES_TEST_CLIP (clip), 0.5);
+
+  effect = ges_effect_new ("agingtv");
+  fail_unless (ges_container_add (GES_CONTAINER (clip),
+          GES_TIMELINE_ELEMENT (effect)));
+
+  audio_source = get_child_for_track_type (clip, GES_TRACK_TYPE_AUDIO);
+  source = gst_interpolation_control_source_new ();
+  fail_unless (ges_track_element_set_control_source (audio_source, source,
+          "volume", "direct"));
+  gst_timed_value_control_source_set (GST_TIMED_VALUE_CONTROL_SOURCE (source),
+      0, 0.0);
+  gst_timed_value_control_source_set (GST_TIMED_VALUE_CONTROL_SOURCE (source),
+      10, 1.0);
+
+  clips = g_list_append (NULL, clip);
+  clips = g_list_append (clips, clip2);
+  group = ges_container_group (clips);
+  g_list_free (clips);
+  fail_unless (GES_IS_GROUP (group));
+
+  clone = ges_timeline_clone (timeline);
+  fail_unless (clone != timeline);
+  fail_unless_equals_uint64 (ges_timeline_get_snapping_distance (clone), 5);
+  fail_unless_equals_int (g_list_length (clone->tracks), 2);
+
+  /* Tracks keep their type and the properties of their subclass */
+  for (tmp = clone->tracks; tmp; tmp = tmp->next) {
+    guint mixing_threads;
+
+    track = tmp->data;
+    if (track->type == GES_TRACK_TYPE_AUDIO) {
+      fail_unless (GES_IS_AUDIO_TRACK (track));
+      continue;
+    }
+
+    fail_unless (GES_IS_VIDEO_TRACK (track));
+    g_object_get (track, "mixing-threads", &mixing_threads, NULL);
+    fail_unless_equals_int (mixing_threads, 3);
+  }
+
+  layers = ges_timeline_get_layers (clone);
+  fail_unless_equals_int (g_list_length (layers), 1);
+  fail_unless (layers->data != layer);
+  fail_unless (ges_layer_get_timeline (layers->data) == clone);
+  clips = ges_layer_get_clips (layers->data);
+  fail_unless_equals_int (g_list_length (clips), 2);
+
+  cloned = clips->data;
+  fail_unless (cloned != clip);
+  fail_unless_equals_uint64 (_START (cloned), 10);
+  fail_unless_equals_uint64 (_DURATION (cloned), 20);
+  fail_unless (ges_extractable_get_asset (GES_EXTRACTABLE (cloned)) ==
+      ges_extractable_get_asset (GES_EXTRACTABLE (clip)));
+  fail_unless (ges_test_clip_get_volume (GES_TEST_CLIP (cloned)) == 0.5);
+
+  /* The track elements land in the tracks of the clone and share no
+   * object with the original ones */
+  fail_unless_equals_int (g_list_length (GES_CONTAINER_CHILDREN (cloned)), 3);
+  for (tmp = GES_CONTAINER_CHILDREN (cloned); tmp; tmp = tmp->next) {
+    element = tmp->data;
+    track = ges_track_element_get_track (element);
+    fail_unless (track != NULL);
+    fail_unless (g_list_find (clone->tracks, track) != NULL);
+    fail_if (g_list_find (timeline->tracks, track) != NULL);
+
+    for (tmp2 = GES_CONTAINER_CHILDREN (clip); tmp2; tmp2 = tmp2->next) {
+      fail_unless (element != tmp2->data);
+      fail_unless (ges_track_element_get_gnlobject (element) !=
+          ges_track_element_get_gnlobject (tmp2->data));
+      fail_unless (ges_track_element_get_element (element) !=
+          ges_track_element_get_element (tmp2->data));
+    }
+  }
+
+  /* The effect is cloned with its description */
+  for (tmp = GES_CONTAINER_CHILDREN (cloned); tmp; tmp = tmp->next) {
+    if (GES_IS_EFFECT (tmp->data))
+      break;
+  }
+  fail_unless (tmp != NULL);
+  fail_unless (tmp->data != effect);
+  fail_unless (ges_track_element_get_track_type (tmp->data) ==
+      GES_TRACK_TYPE_VIDEO);
+  g_object_get (tmp->data, "bin-description", &description, NULL);
+  fail_unless_equals_string (description, "agingtv");
+  g_free (description);
+
+  /* And so are the keyframes, in a new control source */
+  element = get_child_for_track_type (cloned, GES_TRACK_TYPE_AUDIO);
+  fail_unless (element != audio_source);
+  binding = ges_track_element_get_control_binding (element, "volume");
+  fail_unless (binding != NULL);
+  g_object_get (binding, "control-source", &cloned_source, NULL);
+  fail_unless (GST_IS_TIMED_VALUE_CONTROL_SOURCE (cloned_source));
+  fail_unless (cloned_source != source);
+
+  values =
+      gst_timed_value_control_source_get_all (GST_TIMED_VALUE_CONTROL_SOURCE
+      (cloned_source));
+  fail_unless_equals_int (g_list_length (values), 2);
+  value = values->data;
+  fail_unless_equals_uint64 (value->timestamp, 0);
+  fail_unless (value->value == 0.0);
+  value = values->next->data;
+  fail_unless_equals_uint64 (value->timestamp, 10);
+  fail_unless (value->value == 1.0);
+  g_list_free (values);
+  gst_object_unref (cloned_source);
+
+  /* And the group is recreated around the cloned clips */
+  fail_unless (GES_IS_GROUP (GES_TIMELINE_ELEMENT_PARENT (cloned)));
+  fail_unless (GES_TIMELINE_ELEMENT_PARENT (cloned) ==
+      GES_TIMELINE_ELEMENT_PARENT (clips->next->data));
+  fail_unless (GES_TIMELINE_ELEMENT_PARENT (cloned) !=
+      GES_TIMELINE_ELEMENT (group));
+
+  g_list_free_full (clips, gst_object_unref);
+  g_list_free_full (layers, gst_object_unref);
+
+  gst_object_unref (source);
+  gst_object_unref (clone);
+  gst_object_unref (timeline);
+}
+
+GST_END_TEST;
+
 static Suite *
 ges_suite (void)
 {
@@ -721,6 +1231,11 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_ges_timeline_remove_track);
   tcase_add_test (tc_chain, test_ges_timeline_multiple_tracks);
   tcase_add_test (tc_chain, test_ges_pipeline_change_state);
+  tcase_add_test (tc_chain, test_ges_pipeline_unused_tracks);
+  tcase_add_test (tc_chain, test_ges_pipeline_preview_quality);
+  tcase_add_test (tc_chain, test_ges_timeline_snapshot);
+  tcase_add_test (tc_chain, test_ges_timeline_snapshot_copy_on_write);
+  tcase_add_test (tc_chain, test_ges_timeline_clone);
 
   return s;
 }
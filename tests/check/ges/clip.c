@@ -88,9 +88,13 @@ GST_START_TEST (test_object_properties)
   /* This time, we move the trackelement to see if the changes move
    * along to the parent and the gnonlin clip */
   g_object_set (trackelement, "start", (guint64) 400, NULL);
-  ges_timeline_commit (timeline);
   assert_equals_uint64 (_START (clip), 400);
   assert_equals_uint64 (_START (trackelement), 400);
+
+  /* GNonLin only gets the new values when commiting */
+  gnl_object_check (ges_track_element_get_gnlobject (trackelement), 420, 510,
+      120, 510, MIN_GNL_PRIO + 0, TRUE);
+  ges_timeline_commit (timeline);
   gnl_object_check (ges_track_element_get_gnlobject (trackelement), 400, 510,
       120, 510, MIN_GNL_PRIO + 0, TRUE);
 
@@ -357,6 +361,134 @@ GST_START_TEST (test_clip_refcount_remove_child)
 
 GST_END_TEST;
 
+static void
+start_changed_cb (GESTimelineElement * element, GParamSpec * arg,
+    guint * nb_calls)
+{
+  /* Everything has been set by the time we are notified */
+  assert_equals_uint64 (_START (element), 20);
+  assert_equals_uint64 (_INPOINT (element), 5);
+  assert_equals_uint64 (_DURATION (element), 30);
+
+  *nb_calls += 1;
+}
+
+GST_START_TEST (test_set_timing)
+{
+  GESClip *clip;
+  GESLayer *layer;
+  GESTimeline *timeline;
+  GESTrackElement *trackelement;
+  guint nb_calls = 0;
+
+  ges_init ();
+
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+
+  clip = GES_CLIP (ges_test_clip_new ());
+  g_object_set (clip, "start", (guint64) 10, "duration", (guint64) 50, NULL);
+  fail_unless (ges_layer_add_clip (layer, clip));
+  trackelement = GES_CONTAINER_CHILDREN (clip)->data;
+
+  g_signal_connect (clip, "notify::start",
+      G_CALLBACK (start_changed_cb), &nb_calls);
+  fail_unless (ges_timeline_element_set_timing (GES_TIMELINE_ELEMENT (clip),
+          20, 5, 30, G_MAXUINT32));
+  assert_equals_int (nb_calls, 1);
+  CHECK_OBJECT_PROPS (clip, 20, 5, 30);
+  CHECK_OBJECT_PROPS (trackelement, 20, 5, 30);
+
+  /* Nothing is changed if any value is invalid */
+  ges_timeline_element_set_max_duration (GES_TIMELINE_ELEMENT (clip), 40);
+  nb_calls = 0;
+  fail_if (ges_timeline_element_set_timing (GES_TIMELINE_ELEMENT (clip),
+          0, 50, 30, G_MAXUINT32));
+  assert_equals_int (nb_calls, 0);
+  CHECK_OBJECT_PROPS (clip, 20, 5, 30);
+
+  gst_object_unref (timeline);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_set_timing_clamp_and_revert)
+{
+  GList *clips;
+  GESGroup *group;
+  GESLayer *layer;
+  GESTimeline *timeline;
+  GESClip *clip, *clip1;
+  GstControlSource *source;
+  GESTrackElement *audio_source;
+  GList *values;
+  GstTimedValue *value;
+
+  ges_init ();
+
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+
+  clip = GES_CLIP (ges_test_clip_new ());
+  g_object_set (clip, "start", (guint64) 0, "duration", (guint64) 100, NULL);
+  fail_unless (ges_layer_add_clip (layer, clip));
+  clip1 = GES_CLIP (ges_test_clip_new ());
+  g_object_set (clip1, "start", (guint64) 200, "duration", (guint64) 50,
+      NULL);
+  fail_unless (ges_layer_add_clip (layer, clip1));
+
+  /* Keyframes follow the new in-point and duration */
+  audio_source = ges_clip_find_track_element (clip, NULL, GES_TYPE_AUDIO_SOURCE);
+  fail_unless (audio_source != NULL);
+  source = gst_interpolation_control_source_new ();
+  g_object_set (source, "mode", GST_INTERPOLATION_MODE_LINEAR, NULL);
+  fail_unless (ges_track_element_set_control_source (audio_source, source,
+          "volume", "direct"));
+  gst_timed_value_control_source_set (GST_TIMED_VALUE_CONTROL_SOURCE (source),
+      0, 0.0);
+  gst_timed_value_control_source_set (GST_TIMED_VALUE_CONTROL_SOURCE (source),
+      100, 1.0);
+
+  fail_unless (ges_timeline_element_set_timing (GES_TIMELINE_ELEMENT (clip),
+          GST_CLOCK_TIME_NONE, 10, 50, G_MAXUINT32));
+  CHECK_OBJECT_PROPS (clip, 0, 10, 50);
+  CHECK_OBJECT_PROPS (audio_source, 0, 10, 50);
+
+  values =
+      gst_timed_value_control_source_get_all (GST_TIMED_VALUE_CONTROL_SOURCE
+      (source));
+  assert_equals_int (g_list_length (values), 2);
+  value = values->data;
+  assert_equals_uint64 (value->timestamp, 10);
+  value = values->next->data;
+  assert_equals_uint64 (value->timestamp, 60);
+  g_list_free (values);
+  gst_object_unref (source);
+  gst_object_unref (audio_source);
+
+  /* The duration is clamped to the max duration as the setter does */
+  ges_timeline_element_set_max_duration (GES_TIMELINE_ELEMENT (clip), 40);
+  fail_unless (ges_timeline_element_set_timing (GES_TIMELINE_ELEMENT (clip),
+          5, GST_CLOCK_TIME_NONE, 50, G_MAXUINT32));
+  CHECK_OBJECT_PROPS (clip, 5, 10, 30);
+
+  /* Groups do not have any in-point, so nothing is moved */
+  clips = g_list_append (NULL, clip);
+  clips = g_list_append (clips, clip1);
+  group = GES_GROUP (ges_container_group (clips));
+  g_list_free (clips);
+  fail_unless (GES_IS_GROUP (group));
+  fail_if (ges_timeline_element_set_timing (GES_TIMELINE_ELEMENT (group),
+          100, 10, GST_CLOCK_TIME_NONE, G_MAXUINT32));
+  CHECK_OBJECT_PROPS (group, 5, 0, 245);
+  CHECK_OBJECT_PROPS (clip, 5, 10, 30);
+  CHECK_OBJECT_PROPS (clip1, 200, 0, 50);
+
+  gst_object_unref (timeline);
+}
+
+GST_END_TEST;
+
 static Suite *
 ges_suite (void)
 {
@@ -369,6 +501,8 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_split_object);
   tcase_add_test (tc_chain, test_clip_group_ungroup);
   tcase_add_test (tc_chain, test_clip_refcount_remove_child);
+  tcase_add_test (tc_chain, test_set_timing);
+  tcase_add_test (tc_chain, test_set_timing_clamp_and_revert);
 
   return s;
 }
@@ -423,6 +423,102 @@ GST_START_TEST (test_effect_set_properties)
 
 GST_END_TEST;
 
+/* Whether the effect of the only clip of @snapshot is bypassed in it */
+static gboolean
+snapshot_effect_bypassed (GESTimelineSnapshot * snapshot)
+{
+  guint i;
+  gboolean bypass = FALSE;
+  const GValue *children =
+      gst_structure_get_value (ges_timeline_snapshot_get_clip (snapshot, 0, 0),
+      "children");
+
+  for (i = 0; i < gst_value_array_get_size (children); i++) {
+    const GstStructure *child =
+        gst_value_get_structure (gst_value_array_get_value (children, i));
+
+    if (gst_structure_has_name (child, "GESEffect"))
+      fail_unless (gst_structure_get_boolean (child, "bypass", &bypass));
+  }
+
+  return bypass;
+}
+
+GST_START_TEST (test_effect_bypass)
+{
+  GESTimelineSnapshot *snapshot, *snapshot2;
+  GESTimeline *timeline;
+  GESLayer *layer;
+  GESTrack *track_video;
+  GESClip *clip;
+  GESEffect *effect;
+  GstElement *selector;
+  GstPad *effect_pad, *bypass_pad, *peer;
+  GstObject *funnel;
+
+  ges_init ();
+
+  timeline = ges_timeline_new ();
+  track_video = GES_TRACK (ges_video_track_new ());
+  ges_timeline_add_track (timeline, track_video);
+  layer = ges_timeline_append_layer (timeline);
+
+  clip = GES_CLIP (ges_test_clip_new ());
+  g_object_set (clip, "duration", 10 * GST_SECOND, NULL);
+  ges_layer_add_clip (layer, clip);
+
+  effect = ges_effect_new ("agingtv");
+  fail_unless (ges_container_add (GES_CONTAINER (clip),
+          GES_TIMELINE_ELEMENT (effect)));
+  fail_if (ges_effect_get_bypass (effect));
+
+  selector = gst_bin_get_by_name (GST_BIN (ges_track_element_get_element
+          (GES_TRACK_ELEMENT (effect))), "bypass-selector");
+  fail_unless (selector != NULL);
+  g_object_get (selector, "active-pad", &effect_pad, NULL);
+  snapshot = ges_timeline_snapshot (timeline);
+  fail_if (snapshot_effect_bypassed (snapshot));
+
+  /* The selector sends the data straight to the funnel, the effect staying
+   * active in the composition */
+  g_object_set (effect, "bypass", TRUE, NULL);
+  fail_unless (ges_effect_get_bypass (effect));
+  fail_unless (ges_track_element_is_active (GES_TRACK_ELEMENT (effect)));
+  g_object_get (selector, "active-pad", &bypass_pad, NULL);
+  fail_if (bypass_pad == effect_pad);
+  peer = gst_pad_get_peer (bypass_pad);
+  funnel = gst_pad_get_parent (peer);
+  assert_equals_string (GST_OBJECT_NAME (funnel), "bypass-funnel");
+  gst_object_unref (funnel);
+  gst_object_unref (peer);
+  gst_object_unref (bypass_pad);
+
+  /* What the timeline renders changed */
+  snapshot2 = ges_timeline_snapshot (timeline);
+  fail_unless (snapshot2 != snapshot);
+  fail_unless (ges_timeline_snapshot_get_clip (snapshot2, 0, 0) !=
+      ges_timeline_snapshot_get_clip (snapshot, 0, 0));
+  fail_unless (snapshot_effect_bypassed (snapshot2));
+  ges_timeline_snapshot_unref (snapshot);
+  snapshot = snapshot2;
+
+  ges_effect_set_bypass (effect, FALSE);
+  g_object_get (selector, "active-pad", &bypass_pad, NULL);
+  fail_unless (bypass_pad == effect_pad);
+  snapshot2 = ges_timeline_snapshot (timeline);
+  fail_unless (snapshot2 != snapshot);
+  fail_if (snapshot_effect_bypassed (snapshot2));
+  ges_timeline_snapshot_unref (snapshot2);
+  ges_timeline_snapshot_unref (snapshot);
+
+  gst_object_unref (bypass_pad);
+  gst_object_unref (effect_pad);
+  gst_object_unref (selector);
+  gst_object_unref (timeline);
+}
+
+GST_END_TEST;
+
 static void
 effect_added_cb (GESClip * clip, GESBaseEffect * trop, gboolean * effect_added)
 {
@@ -510,6 +606,7 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_effect_clip);
   tcase_add_test (tc_chain, test_priorities_clip);
   tcase_add_test (tc_chain, test_effect_set_properties);
+  tcase_add_test (tc_chain, test_effect_bypass);
   tcase_add_test (tc_chain, test_clip_signals);
 
   return s;
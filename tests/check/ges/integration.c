@@ -70,6 +70,8 @@ static const gchar *testfilename1 = NULL;
 static const gchar *testfilename2 = NULL;
 static const gchar *test_image_filename = NULL;
 static EncodingProfileName current_profile = PROFILE_NONE;
+static gboolean render_second_output = FALSE;
+static gboolean audio_only_master = FALSE;
 
 #define DURATION_TOLERANCE 0.1 * GST_SECOND
 
@@ -314,13 +316,38 @@ check_rendered_file_properties (const gchar * render_file,
   gst_object_unref (info);
 }
 
+static void
+check_rendered_streams (const gchar * render_file, gboolean has_audio,
+    gboolean has_video)
+{
+  GList *streams;
+  GESUriClipAsset *asset;
+  GstDiscovererInfo *info;
+
+  get_asset (render_file, asset);
+  info = ges_uri_clip_asset_get_info (GES_URI_CLIP_ASSET (asset));
+  fail_unless (GST_IS_DISCOVERER_INFO (info), "Could not discover file %s",
+      render_file);
+
+  streams = gst_discoverer_info_get_audio_streams (info);
+  fail_unless ((streams != NULL) == has_audio);
+  gst_discoverer_stream_info_list_free (streams);
+
+  streams = gst_discoverer_info_get_video_streams (info);
+  fail_unless ((streams != NULL) == has_video);
+  gst_discoverer_stream_info_list_free (streams);
+
+  gst_object_unref (asset);
+}
+
 static gboolean
 check_timeline (GESTimeline * timeline)
 {
   GstBus *bus;
   static gboolean ret;
   GstEncodingProfile *profile;
-  gchar *render_uri = NULL;
+  gchar *render_uri = NULL, *second_uri = NULL;
+  EncodingProfileName second_profile = PROFILE_NONE;
 
   ret = FALSE;
 
@@ -329,12 +356,26 @@ check_timeline (GESTimeline * timeline)
   if (current_profile != PROFILE_NONE) {
     render_uri = ges_test_file_name (profile_specs[current_profile][3]);
 
-    profile = create_audio_video_profile (current_profile);
+    if (audio_only_master)
+      profile = create_profile (profile_specs[current_profile][0], NULL,
+          profile_specs[current_profile][1], NULL, NULL, NULL);
+    else
+      profile = create_audio_video_profile (current_profile);
     ges_pipeline_set_render_settings (pipeline, render_uri, profile);
-    ges_pipeline_set_mode (pipeline, TIMELINE_MODE_RENDER);
+    gst_object_unref (profile);
 
+    if (render_second_output) {
+      /* Render to the next container format at the same time */
+      second_profile = (current_profile + 1) % G_N_ELEMENTS (profile_specs);
+      second_uri = ges_test_file_name (profile_specs[second_profile][3]);
 
-    gst_object_unref (profile);
+      profile = create_audio_video_profile (second_profile);
+      fail_unless (ges_pipeline_add_render_settings (pipeline, second_uri,
+              profile));
+      gst_object_unref (profile);
+    }
+
+    ges_pipeline_set_mode (pipeline, TIMELINE_MODE_RENDER);
   } else if (g_getenv ("GES_MUTE_TESTS")) {
     GstElement *sink = gst_element_factory_make ("fakesink", NULL);
 
@@ -351,6 +392,14 @@ check_timeline (GESTimeline * timeline)
   gst_object_unref (bus);
 
   ges_pipeline_add_timeline (pipeline, timeline);
+
+  if (second_profile != PROFILE_NONE) {
+    /* The tracks are linked to the outputs by now, make sure they can be
+     * linked again after leaving the render mode */
+    fail_unless (ges_pipeline_set_mode (pipeline, TIMELINE_MODE_PREVIEW));
+    fail_unless (ges_pipeline_set_mode (pipeline, TIMELINE_MODE_RENDER));
+  }
+
   gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_PLAYING);
   gst_element_get_state (GST_ELEMENT (pipeline), NULL, NULL, -1);
   GST_DEBUG_BIN_TO_DOT_FILE_WITH_TS (GST_BIN (pipeline),
@@ -369,6 +418,18 @@ check_timeline (GESTimeline * timeline)
     g_free (render_uri);
   }
 
+  if (second_profile != PROFILE_NONE) {
+    check_rendered_file_properties (profile_specs[second_profile][3],
+        ges_timeline_get_duration (timeline));
+    g_free (second_uri);
+  }
+
+  if (audio_only_master) {
+    /* The video track went to the second output only */
+    check_rendered_streams (profile_specs[current_profile][3], TRUE, FALSE);
+    check_rendered_streams (profile_specs[second_profile][3], TRUE, TRUE);
+  }
+
   gst_object_unref (pipeline);
 
   return ret;
@@ -693,6 +754,25 @@ test_basic_video (void)
   run_basic (timeline);
 }
 
+static void
+test_basic_two_outputs (void)
+{
+  render_second_output = TRUE;
+  run_basic (ges_timeline_new_audio_video ());
+  render_second_output = FALSE;
+}
+
+static void
+test_basic_audio_master_two_outputs (void)
+{
+  /* The video track is only rendered to the second output */
+  render_second_output = TRUE;
+  audio_only_master = TRUE;
+  run_basic (ges_timeline_new_audio_video ());
+  audio_only_master = FALSE;
+  render_second_output = FALSE;
+}
+
 static void
 test_image (void)
 {
@@ -997,6 +1077,9 @@ CREATE_TEST_FULL(effect)
 CREATE_TEST_FULL(mixing)
 CREATE_TEST_FULL(title)
 
+CREATE_RENDERING_TEST(basic_two_outputs, func)
+CREATE_RENDERING_TEST(basic_audio_master_two_outputs, func)
+
 CREATE_PLAYBACK_TEST(seeking)
 CREATE_PLAYBACK_TEST(seeking_audio)
 CREATE_PLAYBACK_TEST(seeking_video)
@@ -1028,6 +1111,9 @@ ges_suite (void)
 
   ADD_TESTS (title);
 
+  ADD_RENDERING_TESTS (basic_two_outputs);
+  ADD_RENDERING_TESTS (basic_audio_master_two_outputs);
+
   ADD_PLAYBACK_TESTS (image);
 
   ADD_PLAYBACK_TESTS (seeking);
@@ -23,6 +23,7 @@
 #include <gst/check/gstcheck.h>
 
 #include <ges/ges-smart-adder.h>
+#include "../../../ges/ges-internal.h"
 
 static GMainLoop *main_loop;
 
@@ -194,6 +195,311 @@ done:
 
 GST_END_TEST;
 
+GST_START_TEST (striped_video_mixed_with_pipeline)
+{
+  GstBus *bus;
+  GESAsset *asset;
+  GESClip *tmpclip;
+  GstMessage *message;
+  GESLayer *layer, *layer1;
+  GESTrack *track = GES_TRACK (ges_video_track_new ());
+  GESTimeline *timeline = ges_timeline_new ();
+  GESPipeline *pipeline = ges_test_create_pipeline (timeline);
+  GstCaps *caps = gst_caps_from_string ("video/x-raw,width=320,height=240");
+
+  g_object_set (track, "mixing-threads", 3, NULL);
+  ges_track_set_restriction_caps (track, caps);
+  gst_caps_unref (caps);
+  ges_timeline_add_track (timeline, track);
+  layer = ges_timeline_append_layer (timeline);
+  layer1 = ges_timeline_append_layer (timeline);
+
+  asset = GES_ASSET (ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL));
+
+  /* A picture in picture spanning several stripes */
+  tmpclip =
+      ges_layer_add_asset (layer, asset, 0 * GST_SECOND, 0, 2 * GST_SECOND,
+      GES_TRACK_TYPE_UNKNOWN);
+  ges_test_clip_set_vpattern (GES_TEST_CLIP (tmpclip), 18);
+  ges_track_element_set_child_properties (GES_CONTAINER_CHILDREN
+      (tmpclip)->data, "posx", 100, "posy", 50, "width", 160, "height", 120,
+      NULL);
+
+  ges_layer_add_asset (layer1, asset, 0 * GST_SECOND, 0, 2 * GST_SECOND,
+      GES_TRACK_TYPE_UNKNOWN);
+  gst_object_unref (asset);
+  ges_timeline_commit (timeline);
+
+  bus = gst_pipeline_get_bus (GST_PIPELINE (pipeline));
+  main_loop = g_main_loop_new (NULL, FALSE);
+
+  gst_bus_add_signal_watch_full (bus, G_PRIORITY_HIGH);
+  g_signal_connect (bus, "message", (GCallback) message_received_cb, pipeline);
+  fail_if (gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_PLAYING)
+      == GST_STATE_CHANGE_FAILURE);
+
+  message = gst_bus_timed_pop_filtered (bus, 5 * GST_SECOND,
+      GST_MESSAGE_ASYNC_DONE | GST_MESSAGE_ERROR);
+
+  if (message == NULL) {
+    fail_unless ("No message after 5 seconds" == NULL);
+    goto done;
+  } else if (GST_MESSAGE_TYPE (message) == GST_MESSAGE_ERROR)
+    fail_error_message (message);
+
+  GST_INFO ("running main loop");
+  g_main_loop_run (main_loop);
+  g_main_loop_unref (main_loop);
+
+done:
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_NULL);
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
+static gboolean
+gnlobject_is_active (GstElement * gnlobject)
+{
+  gboolean active;
+
+  g_object_get (gnlobject, "active", &active, NULL);
+
+  return active;
+}
+
+GST_START_TEST (occluded_layers)
+{
+  GESAsset *asset;
+  GESLayer *layer, *layer1;
+  GESClip *top, *hidden, *visible;
+  GESTrackElement *top_source, *hidden_source, *visible_source;
+  GESTrack *track = GES_TRACK (ges_video_track_new ());
+  GESTimeline *timeline = ges_timeline_new ();
+  GstCaps *caps = gst_caps_from_string ("video/x-raw,width=320,height=240");
+
+  ges_track_set_restriction_caps (track, caps);
+  gst_caps_unref (caps);
+  ges_timeline_add_track (timeline, track);
+  layer = ges_timeline_append_layer (timeline);
+  layer1 = ges_timeline_append_layer (timeline);
+
+  asset = GES_ASSET (ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL));
+  top = ges_layer_add_asset (layer, asset, 0, 0, 4 * GST_SECOND,
+      GES_TRACK_TYPE_UNKNOWN);
+  hidden = ges_layer_add_asset (layer1, asset, GST_SECOND, 0, 2 * GST_SECOND,
+      GES_TRACK_TYPE_UNKNOWN);
+  visible = ges_layer_add_asset (layer1, asset, 3 * GST_SECOND, 0,
+      2 * GST_SECOND, GES_TRACK_TYPE_UNKNOWN);
+  gst_object_unref (asset);
+
+  top_source = ges_clip_find_track_element (top, track, G_TYPE_NONE);
+  hidden_source = ges_clip_find_track_element (hidden, track, G_TYPE_NONE);
+  visible_source = ges_clip_find_track_element (visible, track, G_TYPE_NONE);
+
+  /* Only the source fully under the top one is left aside */
+  ges_timeline_commit (timeline);
+  fail_unless (gnlobject_is_active (ges_track_element_get_gnlobject
+          (top_source)));
+  fail_if (gnlobject_is_active (ges_track_element_get_gnlobject
+          (hidden_source)));
+  fail_unless (gnlobject_is_active (ges_track_element_get_gnlobject
+          (visible_source)));
+  fail_unless (ges_track_element_is_active (hidden_source));
+
+  /* Toggling it does not bring it back while it is hidden */
+  ges_track_element_set_active (hidden_source, FALSE);
+  ges_track_element_set_active (hidden_source, TRUE);
+  fail_if (gnlobject_is_active (ges_track_element_get_gnlobject
+          (hidden_source)));
+
+  /* It shows up again as soon as the top one is not opaque, without
+   * waiting for the timeline to be commited */
+  ges_track_element_set_child_properties (top_source, "alpha", 0.5, NULL);
+  fail_unless (gnlobject_is_active (ges_track_element_get_gnlobject
+          (hidden_source)));
+  ges_timeline_commit (timeline);
+  fail_unless (gnlobject_is_active (ges_track_element_get_gnlobject
+          (hidden_source)));
+
+  ges_track_element_set_child_properties (top_source, "alpha", 1.0, NULL);
+  ges_timeline_commit (timeline);
+  fail_if (gnlobject_is_active (ges_track_element_get_gnlobject
+          (hidden_source)));
+
+  /* Changes far from it leave it culled */
+  ges_timeline_element_set_start (GES_TIMELINE_ELEMENT (visible),
+      10 * GST_SECOND);
+  ges_timeline_commit (timeline);
+  fail_if (gnlobject_is_active (ges_track_element_get_gnlobject
+          (hidden_source)));
+
+  /* Or does not cover the whole frame */
+  ges_track_element_set_child_properties (top_source, "posx", 10, NULL);
+  fail_unless (gnlobject_is_active (ges_track_element_get_gnlobject
+          (hidden_source)));
+  ges_timeline_commit (timeline);
+  fail_unless (gnlobject_is_active (ges_track_element_get_gnlobject
+          (hidden_source)));
+
+  gst_object_unref (top_source);
+  gst_object_unref (hidden_source);
+  gst_object_unref (visible_source);
+  gst_object_unref (timeline);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (silent_sources_culled)
+{
+  GESAsset *asset;
+  GESLayer *layer, *layer1;
+  GESClip *muted, *alone, *below;
+  GESTrackElement *muted_source, *alone_source, *below_source;
+  GESTrack *track = GES_TRACK (ges_audio_track_new ());
+  GESTimeline *timeline = ges_timeline_new ();
+
+  ges_timeline_add_track (timeline, track);
+  layer = ges_timeline_append_layer (timeline);
+  layer1 = ges_timeline_append_layer (timeline);
+
+  asset = GES_ASSET (ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL));
+  muted = ges_layer_add_asset (layer, asset, 0, 0, 2 * GST_SECOND,
+      GES_TRACK_TYPE_UNKNOWN);
+  alone = ges_layer_add_asset (layer, asset, 5 * GST_SECOND, 0, GST_SECOND,
+      GES_TRACK_TYPE_UNKNOWN);
+  below = ges_layer_add_asset (layer1, asset, 0, 0, 4 * GST_SECOND,
+      GES_TRACK_TYPE_UNKNOWN);
+  gst_object_unref (asset);
+
+  muted_source = ges_clip_find_track_element (muted, track, G_TYPE_NONE);
+  alone_source = ges_clip_find_track_element (alone, track, G_TYPE_NONE);
+  below_source = ges_clip_find_track_element (below, track, G_TYPE_NONE);
+  ges_track_element_set_child_properties (muted_source, "mute", TRUE, NULL);
+  ges_track_element_set_child_properties (alone_source, "volume", 0.0, NULL);
+
+  /* The silent sources are taken out of the composition */
+  ges_timeline_commit (timeline);
+  fail_unless (ges_track_is_source_silent (track, muted_source));
+  fail_unless (ges_track_is_source_silent (track, alone_source));
+  fail_if (ges_track_is_source_silent (track, below_source));
+  fail_if (gnlobject_is_active (ges_track_element_get_gnlobject
+          (muted_source)));
+  fail_if (gnlobject_is_active (ges_track_element_get_gnlobject
+          (alone_source)));
+  fail_unless (gnlobject_is_active (ges_track_element_get_gnlobject
+          (below_source)));
+  fail_unless (ges_track_element_is_active (muted_source));
+
+  /* And come back without the timeline being committed */
+  ges_track_element_set_child_properties (muted_source, "mute", FALSE, NULL);
+  fail_if (ges_track_is_source_silent (track, muted_source));
+  fail_unless (gnlobject_is_active (ges_track_element_get_gnlobject
+          (muted_source)));
+  fail_unless (ges_track_is_source_silent (track, alone_source));
+  fail_if (gnlobject_is_active (ges_track_element_get_gnlobject
+          (alone_source)));
+
+  gst_object_unref (muted_source);
+  gst_object_unref (alone_source);
+  gst_object_unref (below_source);
+  gst_object_unref (timeline);
+}
+
+GST_END_TEST;
+
+static GstPadProbeReturn
+count_buffers_probe (GstPad * pad, GstPadProbeInfo * info, guint * count)
+{
+  g_atomic_int_inc (count);
+
+  return GST_PAD_PROBE_OK;
+}
+
+static gulong
+count_source_buffers (GESTrackElement * source, guint * count)
+{
+  gulong id;
+  GstPad *pad =
+      gst_element_get_static_pad (ges_track_element_get_element (source),
+      "src");
+
+  fail_unless (pad != NULL);
+  id = gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+      (GstPadProbeCallback) count_buffers_probe, count, NULL);
+  gst_object_unref (pad);
+
+  return id;
+}
+
+GST_START_TEST (silent_sources_not_decoded)
+{
+  GstBus *bus;
+  GESAsset *asset;
+  GESLayer *layer, *layer1;
+  GESClip *muted, *below;
+  GstMessage *message;
+  GESTrackElement *muted_source, *below_source;
+  guint muted_buffers = 0, below_buffers = 0;
+  GESTrack *track = GES_TRACK (ges_audio_track_new ());
+  GESTimeline *timeline = ges_timeline_new ();
+  GESPipeline *pipeline = ges_test_create_pipeline (timeline);
+
+  ges_timeline_add_track (timeline, track);
+  layer = ges_timeline_append_layer (timeline);
+  layer1 = ges_timeline_append_layer (timeline);
+
+  asset = GES_ASSET (ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL));
+  muted = ges_layer_add_asset (layer, asset, 0, 0, GST_SECOND,
+      GES_TRACK_TYPE_UNKNOWN);
+  below = ges_layer_add_asset (layer1, asset, 0, 0, 2 * GST_SECOND,
+      GES_TRACK_TYPE_UNKNOWN);
+  gst_object_unref (asset);
+
+  muted_source = ges_clip_find_track_element (muted, track, G_TYPE_NONE);
+  below_source = ges_clip_find_track_element (below, track, G_TYPE_NONE);
+  ges_track_element_set_child_properties (muted_source, "mute", TRUE, NULL);
+  ges_timeline_commit (timeline);
+  fail_unless (ges_track_is_source_silent (track, muted_source));
+
+  count_source_buffers (muted_source, &muted_buffers);
+  count_source_buffers (below_source, &below_buffers);
+
+  bus = gst_pipeline_get_bus (GST_PIPELINE (pipeline));
+  main_loop = g_main_loop_new (NULL, FALSE);
+
+  gst_bus_add_signal_watch_full (bus, G_PRIORITY_HIGH);
+  g_signal_connect (bus, "message", (GCallback) message_received_cb, pipeline);
+  fail_if (gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_PLAYING)
+      == GST_STATE_CHANGE_FAILURE);
+  message = gst_bus_timed_pop_filtered (bus, 5 * GST_SECOND,
+      GST_MESSAGE_ASYNC_DONE | GST_MESSAGE_ERROR);
+
+  if (message == NULL) {
+    fail_unless ("No message after 5 seconds" == NULL);
+    goto done;
+  } else if (GST_MESSAGE_TYPE (message) == GST_MESSAGE_ERROR)
+    fail_error_message (message);
+  gst_message_unref (message);
+
+  GST_INFO ("running main loop");
+  g_main_loop_run (main_loop);
+  g_main_loop_unref (main_loop);
+
+  /* Nothing was produced for the muted source, it was not even running */
+  fail_unless_equals_int (g_atomic_int_get (&muted_buffers), 0);
+  fail_unless (g_atomic_int_get (&below_buffers) > 0);
+
+done:
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_NULL);
+  gst_object_unref (bus);
+  gst_object_unref (pipeline);
+  gst_object_unref (muted_source);
+  gst_object_unref (below_source);
+}
+
+GST_END_TEST;
+
 static Suite *
 ges_suite (void)
 {
@@ -206,6 +512,10 @@ ges_suite (void)
   tcase_add_test (tc_chain, simple_smart_adder_test);
   tcase_add_test (tc_chain, simple_audio_mixed_with_pipeline);
   tcase_add_test (tc_chain, audio_video_mixed_with_pipeline);
+  tcase_add_test (tc_chain, striped_video_mixed_with_pipeline);
+  tcase_add_test (tc_chain, occluded_layers);
+  tcase_add_test (tc_chain, silent_sources_culled);
+  tcase_add_test (tc_chain, silent_sources_not_decoded);
 
   return s;
 }
@@ -0,0 +1,316 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "test-utils.h"
+#include <ges/ges.h>
+#include <gst/check/gstcheck.h>
+#include <glib/gstdio.h>
+
+static GESTimeline *
+_create_nested_timeline (void)
+{
+  GESClip *clip;
+  GESLayer *layer;
+  GESTimeline *timeline = ges_timeline_new ();
+
+  fail_unless (ges_timeline_add_track (timeline,
+          GES_TRACK (ges_video_track_new ())));
+  layer = ges_timeline_append_layer (timeline);
+  clip = GES_CLIP (ges_test_clip_new ());
+  g_object_set (clip, "start", (guint64) 0, "duration", GST_SECOND, NULL);
+  fail_unless (ges_layer_add_clip (layer, clip));
+  ges_timeline_commit (timeline);
+
+  return timeline;
+}
+
+static GESClip *
+_get_first_clip (GESTimeline * timeline)
+{
+  GList *clips;
+  GESClip *clip;
+
+  fail_unless (timeline->layers != NULL);
+  clips = ges_layer_get_clips (timeline->layers->data);
+  fail_unless (clips != NULL);
+  clip = clips->data;
+  g_list_free_full (clips, gst_object_unref);
+
+  return clip;
+}
+
+GST_START_TEST (test_nested_timeline_clip)
+{
+  GList *tmp;
+  GESLayer *layer, *nested_layer;
+  GESClip *clip;
+  GESTimeline *timeline, *nested;
+  GESNestedTimelineClip *nested_clip;
+
+  ges_init ();
+
+  /* Only has a video track */
+  nested = ges_timeline_new ();
+  fail_unless (ges_timeline_add_track (nested,
+          GES_TRACK (ges_video_track_new ())));
+  nested_layer = ges_timeline_append_layer (nested);
+  clip = GES_CLIP (ges_test_clip_new ());
+  g_object_set (clip, "start", (guint64) 0, "duration", GST_SECOND, NULL);
+  fail_unless (ges_layer_add_clip (nested_layer, clip));
+  ges_timeline_commit (nested);
+
+  nested_clip = ges_nested_timeline_clip_new (nested);
+  fail_unless (GES_IS_NESTED_TIMELINE_CLIP (nested_clip));
+  fail_unless (ges_nested_timeline_clip_get_timeline (nested_clip) == nested);
+  fail_unless (ges_nested_timeline_clip_get_render_cache (nested_clip) ==
+      NULL);
+  assert_equals_int (ges_clip_get_supported_formats (GES_CLIP (nested_clip)),
+      GES_TRACK_TYPE_VIDEO);
+
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+  g_object_set (nested_clip, "start", (guint64) 0, "duration", GST_SECOND,
+      NULL);
+  fail_unless (ges_layer_add_clip (layer, GES_CLIP (nested_clip)));
+
+  /* Only a video source is created */
+  assert_equals_int (g_list_length (GES_CONTAINER_CHILDREN (nested_clip)), 1);
+  for (tmp = GES_CONTAINER_CHILDREN (nested_clip); tmp; tmp = tmp->next) {
+    fail_unless (GES_IS_NESTED_TIMELINE_SOURCE (tmp->data));
+    assert_equals_int (ges_track_element_get_track_type (tmp->data),
+        GES_TRACK_TYPE_VIDEO);
+    fail_if (ges_nested_timeline_source_is_cached (tmp->data));
+  }
+
+  gst_object_unref (timeline);
+  gst_object_unref (nested);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_nested_timeline_cycle)
+{
+  GESTimeline *a, *b;
+  GESNestedTimelineClip *nested_a, *nested_b, *nested_self;
+
+  ges_init ();
+
+  a = _create_nested_timeline ();
+  b = _create_nested_timeline ();
+
+  /* B in A is fine */
+  nested_b = ges_nested_timeline_clip_new (b);
+  fail_unless (ges_layer_add_clip (a->layers->data, GES_CLIP (nested_b)));
+  assert_equals_int (g_list_length (GES_CONTAINER_CHILDREN (nested_b)), 1);
+
+  /* A in B would nest A in itself through B */
+  nested_a = ges_nested_timeline_clip_new (a);
+  ges_layer_add_clip (b->layers->data, GES_CLIP (nested_a));
+  assert_equals_int (g_list_length (GES_CONTAINER_CHILDREN (nested_a)), 0);
+
+  /* And so would A in A */
+  nested_self = ges_nested_timeline_clip_new (a);
+  ges_layer_add_clip (a->layers->data, GES_CLIP (nested_self));
+  assert_equals_int (g_list_length (GES_CONTAINER_CHILDREN (nested_self)), 0);
+
+  /* Break the cycles before disposing */
+  ges_layer_remove_clip (b->layers->data, GES_CLIP (nested_a));
+  ges_layer_remove_clip (a->layers->data, GES_CLIP (nested_self));
+
+  gst_object_unref (a);
+  gst_object_unref (b);
+}
+
+GST_END_TEST;
+
+static void
+project_loaded_cb (GESProject * project, GESTimeline * timeline,
+    GMainLoop * mainloop)
+{
+  g_main_loop_quit (mainloop);
+}
+
+static gchar *
+get_tmp_uri (const gchar * filename)
+{
+  gchar *location, *uri;
+
+  location = g_build_filename (g_get_tmp_dir (), filename, NULL);
+  uri = g_strconcat ("file://", location, NULL);
+  g_free (location);
+
+  return uri;
+}
+
+GST_START_TEST (test_nested_timeline_asset)
+{
+  gchar *id, *nested_uri, *uri, *location;
+  GESAsset *asset;
+  GESProject *project;
+  GESTimeline *timeline, *nested;
+  GESNestedTimelineClip *nested_clip, *extracted;
+  GMainLoop *mainloop;
+
+  ges_init ();
+
+  mainloop = g_main_loop_new (NULL, FALSE);
+  nested_uri = get_tmp_uri ("test-nested-timeline-nested.xges");
+  uri = get_tmp_uri ("test-nested-timeline.xges");
+
+  nested = _create_nested_timeline ();
+  fail_unless (ges_timeline_save_to_uri (nested, nested_uri, NULL, TRUE,
+          NULL));
+
+  timeline = ges_timeline_new_audio_video ();
+  nested_clip = ges_nested_timeline_clip_new (nested);
+  fail_unless (ges_layer_add_clip (ges_timeline_append_layer (timeline),
+          GES_CLIP (nested_clip)));
+
+  /* The asset is the nested project, and is shared by the clips */
+  asset = ges_extractable_get_asset (GES_EXTRACTABLE (nested_clip));
+  fail_unless (asset != NULL);
+  assert_equals_string (ges_asset_get_id (asset), nested_uri);
+  id = ges_extractable_get_id (GES_EXTRACTABLE (nested_clip));
+  assert_equals_string (id, nested_uri);
+  g_free (id);
+
+  extracted = GES_NESTED_TIMELINE_CLIP (ges_asset_extract (asset, NULL));
+  fail_unless (GES_IS_NESTED_TIMELINE_CLIP (extracted));
+  fail_unless (ges_nested_timeline_clip_get_timeline (extracted) == nested);
+  gst_object_unref (gst_object_ref_sink (extracted));
+
+  fail_unless (ges_timeline_save_to_uri (timeline, uri, NULL, TRUE, NULL));
+  gst_object_unref (timeline);
+  gst_object_unref (nested);
+
+  /* Loading it back loads the nested project */
+  project = ges_project_new (uri);
+  g_signal_connect (project, "loaded", (GCallback) project_loaded_cb,
+      mainloop);
+  timeline = GES_TIMELINE (ges_asset_extract (GES_ASSET (project), NULL));
+  fail_unless (GES_IS_TIMELINE (timeline));
+  g_main_loop_run (mainloop);
+
+  nested_clip = GES_NESTED_TIMELINE_CLIP (_get_first_clip (timeline));
+  fail_unless (GES_IS_NESTED_TIMELINE_CLIP (nested_clip));
+  nested = ges_nested_timeline_clip_get_timeline (nested_clip);
+  fail_unless (GES_IS_TIMELINE (nested));
+  assert_equals_int (g_list_length (nested->tracks), 1);
+  fail_unless (GES_IS_TEST_CLIP (_get_first_clip (nested)));
+
+  g_signal_handlers_disconnect_by_func (project, (GCallback) project_loaded_cb,
+      mainloop);
+  gst_object_unref (timeline);
+  gst_object_unref (project);
+  g_main_loop_unref (mainloop);
+
+  location = gst_uri_get_location (uri);
+  g_unlink (location);
+  g_free (location);
+  location = gst_uri_get_location (nested_uri);
+  g_unlink (location);
+  g_free (location);
+  g_free (nested_uri);
+  g_free (uri);
+}
+
+GST_END_TEST;
+
+static gboolean
+bus_cb (GstBus * bus, GstMessage * message, GMainLoop * mainloop)
+{
+  if (GST_MESSAGE_TYPE (message) == GST_MESSAGE_ERROR)
+    fail_error_message (message);
+  else if (GST_MESSAGE_TYPE (message) == GST_MESSAGE_EOS)
+    g_main_loop_quit (mainloop);
+
+  return TRUE;
+}
+
+static gboolean
+edit_nested_timeline (GESTimeline * nested)
+{
+  g_object_set (_get_first_clip (nested), "vpattern",
+      GES_VIDEO_TEST_PATTERN_SNOW, NULL);
+  ges_timeline_commit (nested);
+
+  return FALSE;
+}
+
+GST_START_TEST (test_nested_timeline_update_while_playing)
+{
+  GstBus *bus;
+  GstElement *sink;
+  GESTimeline *timeline, *nested;
+  GESNestedTimelineClip *nested_clip;
+  GESPipeline *pipeline;
+  GMainLoop *mainloop;
+
+  ges_init ();
+
+  nested = _create_nested_timeline ();
+  timeline = ges_timeline_new ();
+  fail_unless (ges_timeline_add_track (timeline,
+          GES_TRACK (ges_video_track_new ())));
+  nested_clip = ges_nested_timeline_clip_new (nested);
+  fail_unless (ges_layer_add_clip (ges_timeline_append_layer (timeline),
+          GES_CLIP (nested_clip)));
+  ges_timeline_commit (timeline);
+
+  mainloop = g_main_loop_new (NULL, FALSE);
+  pipeline = ges_test_create_pipeline (timeline);
+  g_object_get (pipeline, "video-sink", &sink, NULL);
+  g_object_set (sink, "sync", TRUE, NULL);
+  gst_object_unref (sink);
+
+  bus = gst_pipeline_get_bus (GST_PIPELINE (pipeline));
+  gst_bus_add_watch (bus, (GstBusFunc) bus_cb, mainloop);
+  gst_object_unref (bus);
+
+  /* The nested timeline is replaced halfway through, and playback goes on
+   * until the end */
+  g_timeout_add (500, (GSourceFunc) edit_nested_timeline, nested);
+  fail_if (gst_element_set_state (GST_ELEMENT (pipeline),
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE);
+  g_main_loop_run (mainloop);
+
+  gst_element_set_state (GST_ELEMENT (pipeline), GST_STATE_NULL);
+  gst_object_unref (pipeline);
+  gst_object_unref (nested);
+  g_main_loop_unref (mainloop);
+}
+
+GST_END_TEST;
+
+static Suite *
+ges_suite (void)
+{
+  Suite *s = suite_create ("ges-nested-timeline");
+  TCase *tc_chain = tcase_create ("nestedtimeline");
+
+  suite_add_tcase (s, tc_chain);
+
+  tcase_add_test (tc_chain, test_nested_timeline_clip);
+  tcase_add_test (tc_chain, test_nested_timeline_cycle);
+  tcase_add_test (tc_chain, test_nested_timeline_asset);
+  tcase_add_test (tc_chain, test_nested_timeline_update_while_playing);
+
+  return s;
+}
+
+GST_CHECK_MAIN (ges);
@@ -21,6 +21,7 @@
 #include "test-utils.h"
 #include <ges/ges.h>
 #include <gst/check/gstcheck.h>
+#include <glib/gstdio.h>
 #include <gst/controller/gstdirectcontrolbinding.h>
 #include <gst/controller/gstinterpolationcontrolsource.h>
 
@@ -85,6 +86,7 @@ asset_removed_add_cb (GESProject * project, GESAsset * asset, gboolean * called)
 
 GST_START_TEST (test_project_add_assets)
 {
+  GList *assets;
   GESProject *project;
   GESAsset *asset;
   gboolean added_cb_called = FALSE;
@@ -110,8 +112,19 @@ GST_START_TEST (test_project_add_assets)
   ASSERT_OBJECT_REFCOUNT (asset, "The asset (1 for project and one for "
       "us + 1 cache)", 3);
 
+  /* Assets are listed per extractable type, subtypes included */
+  assets = ges_project_list_assets (project, GES_TYPE_TEST_CLIP);
+  fail_unless_equals_int (g_list_length (assets), 1);
+  fail_unless (assets->data == asset);
+  g_list_free_full (assets, gst_object_unref);
+  assets = ges_project_list_assets (project, GES_TYPE_CLIP);
+  fail_unless_equals_int (g_list_length (assets), 1);
+  g_list_free_full (assets, gst_object_unref);
+  fail_if (ges_project_list_assets (project, GES_TYPE_EFFECT));
+
   fail_unless (ges_project_remove_asset (project, asset));
   fail_unless (removed_cb_called);
+  fail_if (ges_project_list_assets (project, GES_TYPE_TEST_CLIP));
   gst_object_unref (asset);
   gst_object_unref (project);
 
@@ -465,6 +478,58 @@ GST_START_TEST (test_project_add_keyframes)
 
 GST_END_TEST;
 
+GST_START_TEST (test_project_compressed)
+{
+  GMainLoop *mainloop;
+  GESProject *project;
+  GESTimeline *timeline;
+  GESAsset *formatter_asset;
+  gchar *content, *location;
+  gsize length;
+  gchar *uri = ges_test_file_uri ("test-keyframes.xges");
+
+  project = ges_project_new (uri);
+  mainloop = g_main_loop_new (NULL, FALSE);
+  g_signal_connect (project, "loaded", (GCallback) project_loaded_cb, mainloop);
+  g_signal_connect (project, "missing-uri", (GCallback) _set_new_uri, NULL);
+  timeline = GES_TIMELINE (ges_asset_extract (GES_ASSET (project), NULL));
+  g_main_loop_run (mainloop);
+  g_free (uri);
+
+  _add_keyframes (timeline);
+
+  uri = get_tmp_uri ("test-compressed-save.xges.gz");
+  formatter_asset = ges_asset_request (GES_TYPE_FORMATTER, "ges", NULL);
+  fail_unless (ges_project_save (project, timeline, uri, formatter_asset, TRUE,
+          NULL));
+  gst_object_unref (timeline);
+  gst_object_unref (project);
+
+  /* Saved gzip compressed */
+  location = g_filename_from_uri (uri, NULL, NULL);
+  fail_unless (g_file_get_contents (location, &content, &length, NULL));
+  fail_unless (length > 2);
+  fail_unless ((guint8) content[0] == 0x1f && (guint8) content[1] == 0x8b);
+  g_free (content);
+  g_free (location);
+
+  fail_unless (ges_formatter_can_load_uri (uri, NULL));
+  project = ges_project_new (uri);
+  g_signal_connect (project, "loaded", (GCallback) project_loaded_cb, mainloop);
+  timeline = GES_TIMELINE (ges_asset_extract (GES_ASSET (project), NULL));
+  fail_unless (GES_IS_TIMELINE (timeline));
+  g_main_loop_run (mainloop);
+
+  _check_keyframes (timeline);
+
+  gst_object_unref (timeline);
+  gst_object_unref (project);
+  g_free (uri);
+  g_main_loop_unref (mainloop);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_project_load_xges)
 {
   gboolean saved;
@@ -472,6 +537,8 @@ GST_START_TEST (test_project_load_xges)
   GESProject *project;
   GESTimeline *timeline;
   GESAsset *formatter_asset;
+  GstStructure *timings;
+  GstClockTime timing;
   gchar *uri = ges_test_file_uri ("test-project.xges");
 
   project = ges_project_new (uri);
@@ -497,6 +564,15 @@ GST_START_TEST (test_project_load_xges)
   _test_project (project, timeline);
   g_free (uri);
 
+  timings = ges_project_get_load_timings (project);
+  fail_unless (gst_structure_has_name (timings, "load-timings"));
+  fail_unless (gst_structure_get (timings, "read", G_TYPE_UINT64, &timing,
+          "parse", G_TYPE_UINT64, &timing, "asset-resolution", G_TYPE_UINT64,
+          &timing, "clip-creation", G_TYPE_UINT64, &timing,
+          "track-element-creation", G_TYPE_UINT64, &timing, "first-commit",
+          G_TYPE_UINT64, &timing, NULL));
+  gst_structure_free (timings);
+
   uri = get_tmp_uri ("test-project_TMP.xges");
   formatter_asset = ges_asset_request (GES_TYPE_FORMATTER, "ges", NULL);
   saved =
@@ -784,6 +860,224 @@ GST_START_TEST (test_load_xges_and_play)
 GST_END_TEST;
 #endif
 
+static void
+_trusted_project_loaded_cb (GESProject * project, GESTimeline * timeline,
+    GESAsset ** asset)
+{
+  GList *clips;
+  gchar *layout;
+  gchar *uri = ges_test_file_uri ("audio_video.ogg");
+
+  *asset = ges_project_get_asset (project, uri, GES_TYPE_URI_CLIP);
+  fail_unless (GES_IS_URI_CLIP_ASSET (*asset));
+  g_free (uri);
+
+  /* The separator in the stream ID has been unescaped, and is escaped
+   * back when serializing */
+  g_object_get (*asset, "stream-layout", &layout, NULL);
+  assert_equals_string (layout, "video:trusted\\;video;audio:trusted-audio");
+  g_free (layout);
+
+  /* Created from what has been saved, without discovering the file */
+  fail_unless (ges_uri_clip_asset_get_info (GES_URI_CLIP_ASSET (*asset)) ==
+      NULL);
+  assert_equals_uint64 (ges_uri_clip_asset_get_duration (GES_URI_CLIP_ASSET
+          (*asset)), GST_SECOND);
+  assert_equals_int (g_list_length ((GList *)
+          ges_uri_clip_asset_get_stream_assets (GES_URI_CLIP_ASSET (*asset))),
+      2);
+
+  clips = ges_layer_get_clips (GES_LAYER (timeline->layers->data));
+  assert_equals_int (g_list_length (clips), 1);
+  assert_equals_int (g_list_length (GES_CONTAINER_CHILDREN (clips->data)), 2);
+  g_list_free_full (clips, gst_object_unref);
+}
+
+static void
+_trusted_asset_error_cb (GESProject * project, GError * error,
+    const gchar * id, GType extractable_type)
+{
+  fail_unless (g_error_matches (error, GES_ERROR,
+          GES_ERROR_ASSET_METADATA_MISMATCH));
+  g_main_loop_quit (mainloop);
+}
+
+GST_START_TEST (test_project_trust_saved_metadata)
+{
+  gchar *uri, *media_uri, *content, *location;
+  GList *clips, *tmp;
+  GESAsset *asset = NULL;
+  GESProject *project;
+  GESTimeline *timeline;
+
+  /* The duration saved does not match the file */
+  media_uri = ges_test_file_uri ("audio_video.ogg");
+  content = g_strdup_printf ("<ges version='0.1'>\n"
+      "  <project>\n"
+      "    <resources>\n"
+      "      <asset id='%s' extractable-type-name='GESUriClip' "
+      "properties='properties, duration=(guint64)1000000000, "
+      "stream-layout=(string)\"video:trusted\\\\;video;audio:trusted-audio\";' "
+      "metadatas='metadatas;'/>\n"
+      "    </resources>\n"
+      "    <timeline>\n"
+      "      <track track-type='2' caps='audio/x-raw' track-id='0'/>\n"
+      "      <track track-type='4' caps='video/x-raw' track-id='1'/>\n"
+      "      <layer priority='0'>\n"
+      "        <clip id='0' asset-id='%s' type-name='GESUriClip' "
+      "layer-priority='0' track-types='6' start='0' "
+      "duration='1000000000'/>\n"
+      "      </layer>\n"
+      "    </timeline>\n"
+      "  </project>\n"
+      "</ges>\n", media_uri, media_uri);
+  location = g_build_filename (g_get_tmp_dir (), "test-trusted.xges", NULL);
+  fail_unless (g_file_set_contents (location, content, -1, NULL));
+  uri = get_tmp_uri ("test-trusted.xges");
+
+  mainloop = g_main_loop_new (NULL, FALSE);
+  project = ges_project_new (uri);
+  ges_project_set_trust_saved_metadata (project, TRUE);
+  fail_unless (ges_project_get_trust_saved_metadata (project));
+  g_signal_connect (project, "loaded",
+      (GCallback) _trusted_project_loaded_cb, &asset);
+  g_signal_connect (project, "error-loading-asset",
+      (GCallback) _trusted_asset_error_cb, NULL);
+
+  timeline = GES_TIMELINE (ges_asset_extract (GES_ASSET (project), NULL));
+  fail_unless (GES_IS_TIMELINE (timeline));
+  g_main_loop_run (mainloop);
+
+  /* The file has been discovered in the background and the asset updated */
+  fail_unless (asset != NULL);
+  fail_unless (GST_IS_DISCOVERER_INFO (ges_uri_clip_asset_get_info
+          (GES_URI_CLIP_ASSET (asset))));
+  fail_if (ges_uri_clip_asset_get_duration (GES_URI_CLIP_ASSET (asset)) ==
+      GST_SECOND);
+  assert_equals_int (g_list_length ((GList *)
+          ges_uri_clip_asset_get_stream_assets (GES_URI_CLIP_ASSET (asset))),
+      2);
+
+  /* The sources of the clip still use the stream assets of the asset */
+  clips = ges_layer_get_clips (GES_LAYER (timeline->layers->data));
+  for (tmp = GES_CONTAINER_CHILDREN (clips->data); tmp; tmp = tmp->next) {
+    GESAsset *stream_asset = ges_extractable_get_asset (tmp->data);
+
+    fail_unless (g_list_find ((GList *)
+            ges_uri_clip_asset_get_stream_assets (GES_URI_CLIP_ASSET (asset)),
+            stream_asset));
+    fail_unless (ges_uri_source_asset_get_filesource_asset
+        (GES_URI_SOURCE_ASSET (stream_asset)) == GES_URI_CLIP_ASSET (asset));
+  }
+  g_list_free_full (clips, gst_object_unref);
+
+  g_unlink (location);
+  g_free (location);
+  g_free (content);
+  g_free (media_uri);
+  g_free (uri);
+  gst_object_unref (asset);
+  gst_object_unref (timeline);
+  gst_object_unref (project);
+  g_main_loop_unref (mainloop);
+}
+
+GST_END_TEST;
+
+static void
+_relocated_project_loaded_cb (GESProject * project, GESTimeline * timeline,
+    GMainLoop * loop)
+{
+  GList *clips;
+  gchar *media_uri = ges_test_file_uri ("audio_video.ogg");
+
+  clips = ges_layer_get_clips (GES_LAYER (timeline->layers->data));
+  assert_equals_int (g_list_length (clips), 1);
+  assert_equals_string (ges_asset_get_id (ges_extractable_get_asset
+          (GES_EXTRACTABLE (clips->data))), media_uri);
+  g_list_free_full (clips, gst_object_unref);
+  g_free (media_uri);
+
+  g_main_loop_quit (loop);
+}
+
+GST_START_TEST (test_project_search_roots)
+{
+  GFile *media, *dir, *cycle, *link;
+  GMainLoop *loop;
+  GESProject *project;
+  GESTimeline *timeline;
+  gchar *uri, *media_uri, *dir_uri, *content, *location;
+  gchar *cycle_path, *cycle_uri;
+
+  content = g_strdup ("<ges version='0.1'>\n"
+      "  <project>\n"
+      "    <resources>\n"
+      "      <asset id='file:///moved/away/audio_video.ogg' "
+      "extractable-type-name='GESUriClip'/>\n"
+      "    </resources>\n"
+      "    <timeline>\n"
+      "      <track track-type='2' caps='audio/x-raw' track-id='0'/>\n"
+      "      <track track-type='4' caps='video/x-raw' track-id='1'/>\n"
+      "      <layer priority='0'>\n"
+      "        <clip id='0' asset-id='file:///moved/away/audio_video.ogg' "
+      "type-name='GESUriClip' layer-priority='0' track-types='6' start='0' "
+      "duration='1000000000'/>\n"
+      "      </layer>\n"
+      "    </timeline>\n"
+      "  </project>\n"
+      "</ges>\n");
+  location = g_build_filename (g_get_tmp_dir (), "test-relocated.xges", NULL);
+  fail_unless (g_file_set_contents (location, content, -1, NULL));
+  uri = get_tmp_uri ("test-relocated.xges");
+
+  media_uri = ges_test_file_uri ("audio_video.ogg");
+  media = g_file_new_for_uri (media_uri);
+  dir = g_file_get_parent (media);
+  dir_uri = g_file_get_uri (dir);
+
+  /* A directory with a symbolic link to itself, which must be walked
+   * only once */
+  cycle_path = g_dir_make_tmp ("ges-search-root-XXXXXX", NULL);
+  fail_unless (cycle_path != NULL);
+  cycle = g_file_new_for_path (cycle_path);
+  link = g_file_get_child (cycle, "loop");
+  fail_unless (g_file_make_symbolic_link (link, cycle_path, NULL, NULL));
+  cycle_uri = g_file_get_uri (cycle);
+
+  project = ges_project_new (uri);
+  fail_if (ges_project_add_search_root (project, media_uri));
+  fail_unless (ges_project_add_search_root (project, cycle_uri));
+  fail_unless (ges_project_add_search_root (project, dir_uri));
+
+  loop = g_main_loop_new (NULL, FALSE);
+  g_signal_connect (project, "loaded",
+      (GCallback) _relocated_project_loaded_cb, loop);
+  timeline = GES_TIMELINE (ges_asset_extract (GES_ASSET (project), NULL));
+  fail_unless (GES_IS_TIMELINE (timeline));
+  g_main_loop_run (loop);
+
+  g_file_delete (link, NULL, NULL);
+  g_file_delete (cycle, NULL, NULL);
+  g_unlink (location);
+  g_free (location);
+  g_free (content);
+  g_free (media_uri);
+  g_free (dir_uri);
+  g_free (cycle_uri);
+  g_free (cycle_path);
+  g_free (uri);
+  g_object_unref (link);
+  g_object_unref (cycle);
+  g_object_unref (media);
+  g_object_unref (dir);
+  gst_object_unref (timeline);
+  gst_object_unref (project);
+  g_main_loop_unref (loop);
+}
+
+GST_END_TEST;
+
 static Suite *
 ges_suite (void)
 {
@@ -797,10 +1091,13 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_project_add_assets);
   tcase_add_test (tc_chain, test_project_load_xges);
   tcase_add_test (tc_chain, test_project_add_keyframes);
+  tcase_add_test (tc_chain, test_project_compressed);
   tcase_add_test (tc_chain, test_project_auto_transition);
   tcase_add_test (tc_chain, test_project_proxy_editing);
   /*tcase_add_test (tc_chain, test_load_xges_and_play); */
   tcase_add_test (tc_chain, test_project_unexistant_effect);
+  tcase_add_test (tc_chain, test_project_trust_saved_metadata);
+  tcase_add_test (tc_chain, test_project_search_roots);
 
   return s;
 }
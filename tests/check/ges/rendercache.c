@@ -0,0 +1,204 @@
+/* GStreamer Editing Services
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "test-utils.h"
+#include <ges/ges.h>
+#include <gst/check/gstcheck.h>
+#include <glib/gstdio.h>
+
+static GstEncodingProfile *
+_create_profile (void)
+{
+  GstCaps *caps;
+  GstEncodingContainerProfile *container;
+
+  caps = gst_caps_from_string ("application/ogg");
+  container = gst_encoding_container_profile_new ("ogg", NULL, caps, NULL);
+  gst_caps_unref (caps);
+
+  caps = gst_caps_from_string ("video/x-theora");
+  gst_encoding_container_profile_add_profile (container,
+      (GstEncodingProfile *) gst_encoding_video_profile_new (caps, NULL,
+          NULL, 0));
+  gst_caps_unref (caps);
+
+  return (GstEncodingProfile *) container;
+}
+
+GST_START_TEST (test_render_cache_ranges)
+{
+  GESLayer *layer;
+  GESClip *clip;
+  gchar *directory;
+  GESTimeline *timeline;
+  GESRenderCache *cache;
+  GstEncodingProfile *profile;
+
+  ges_init ();
+
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+  clip = GES_CLIP (ges_test_clip_new ());
+  g_object_set (clip, "start", (guint64) 0, "duration", (guint64) 10, NULL);
+  fail_unless (ges_layer_add_clip (layer, clip));
+
+  profile = _create_profile ();
+  directory = g_dir_make_tmp ("ges-render-cache-XXXXXX", NULL);
+  fail_unless (directory != NULL);
+
+  cache = ges_render_cache_new (timeline, profile, directory);
+  fail_unless (GES_IS_RENDER_CACHE (cache));
+
+  fail_unless (ges_render_cache_add_range (cache, 0, 5));
+  /* Overlapping ranges are refused */
+  fail_if (ges_render_cache_add_range (cache, 4, 5));
+  fail_unless (ges_render_cache_add_range (cache, 20, 5));
+
+  /* Nothing has been rendered as no main loop is running */
+  fail_if (ges_render_cache_is_cached (cache, 0));
+  fail_if (ges_render_cache_is_cached (cache, 20));
+
+  /* Changes are reported to the cache on commit */
+  g_object_set (clip, "start", (guint64) 2, NULL);
+  ges_timeline_commit (timeline);
+  ges_render_cache_invalidate (cache, 0, GST_CLOCK_TIME_NONE);
+  fail_if (ges_render_cache_is_cached (cache, 0));
+
+  g_object_unref (cache);
+  gst_encoding_profile_unref (profile);
+  gst_object_unref (timeline);
+  g_rmdir (directory);
+  g_free (directory);
+}
+
+GST_END_TEST;
+
+static void
+_range_cached_cb (GESRenderCache * cache, guint64 start, guint64 duration,
+    GMainLoop * loop)
+{
+  g_main_loop_quit (loop);
+}
+
+static gboolean
+_timeout_cb (GMainLoop * loop)
+{
+  g_main_loop_quit (loop);
+
+  return FALSE;
+}
+
+GST_START_TEST (test_render_cache_fills)
+{
+  GESLayer *layer;
+  GESClip *clip;
+  GMainLoop *loop;
+  gchar *directory, *location, *uri;
+  GESTimeline *timeline;
+  GESPipeline *pipeline;
+  GESRenderCache *cache;
+  GstEncodingProfile *profile;
+  GList *tmp;
+  GESTrackElement *source = NULL;
+  gboolean active;
+  guint timeout_id;
+
+  ges_init ();
+
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+  clip = GES_CLIP (ges_test_clip_new ());
+  g_object_set (clip, "start", (guint64) 0, "duration", GST_SECOND / 2, NULL);
+  fail_unless (ges_layer_add_clip (layer, clip));
+  ges_timeline_commit (timeline);
+  for (tmp = timeline->tracks; tmp; tmp = tmp->next) {
+    if (GES_TRACK (tmp->data)->type == GES_TRACK_TYPE_VIDEO)
+      source = ges_clip_find_track_element (clip, tmp->data, G_TYPE_NONE);
+  }
+  fail_unless (source != NULL);
+
+  profile = _create_profile ();
+  directory = g_dir_make_tmp ("ges-render-cache-XXXXXX", NULL);
+  fail_unless (directory != NULL);
+  cache = ges_render_cache_new (timeline, profile, directory);
+
+  loop = g_main_loop_new (NULL, FALSE);
+  g_signal_connect (cache, "range-cached", G_CALLBACK (_range_cached_cb),
+      loop);
+  fail_unless (ges_render_cache_add_range (cache, 0, GST_SECOND / 2));
+  timeout_id = g_timeout_add_seconds (30, (GSourceFunc) _timeout_cb, loop);
+  g_main_loop_run (loop);
+  g_source_remove (timeout_id);
+
+  /* The rendered media replaces the video source */
+  fail_unless (ges_render_cache_is_cached (cache, 0));
+  fail_unless (ges_render_cache_is_cached (cache, GST_SECOND / 4));
+  fail_if (ges_render_cache_is_cached (cache, GST_SECOND));
+  g_object_get (ges_track_element_get_gnlobject (source), "active", &active,
+      NULL);
+  fail_if (active);
+
+  /* But final renders use the original content */
+  pipeline = ges_pipeline_new ();
+  fail_unless (ges_pipeline_add_timeline (pipeline, timeline));
+  location = g_build_filename (directory, "render.ogg", NULL);
+  uri = g_filename_to_uri (location, NULL, NULL);
+  fail_unless (ges_pipeline_set_render_settings (pipeline, uri, profile));
+  fail_unless (ges_pipeline_set_mode (pipeline, TIMELINE_MODE_RENDER));
+  g_object_get (ges_track_element_get_gnlobject (source), "active", &active,
+      NULL);
+  fail_unless (active);
+
+  fail_unless (ges_pipeline_set_mode (pipeline, TIMELINE_MODE_PREVIEW));
+  g_object_get (ges_track_element_get_gnlobject (source), "active", &active,
+      NULL);
+  fail_if (active);
+
+  /* Editing the cached range stops using it */
+  g_object_set (clip, "duration", GST_SECOND / 4, NULL);
+  ges_timeline_commit (timeline);
+  fail_if (ges_render_cache_is_cached (cache, 0));
+
+  gst_object_unref (pipeline);
+  g_object_unref (cache);
+  gst_object_unref (source);
+  g_main_loop_unref (loop);
+  gst_encoding_profile_unref (profile);
+  g_rmdir (directory);
+  g_free (directory);
+  g_free (location);
+  g_free (uri);
+}
+
+GST_END_TEST;
+
+static Suite *
+ges_suite (void)
+{
+  Suite *s = suite_create ("ges-render-cache");
+  TCase *tc_chain = tcase_create ("rendercache");
+
+  suite_add_tcase (s, tc_chain);
+
+  tcase_add_test (tc_chain, test_render_cache_ranges);
+  tcase_add_test (tc_chain, test_render_cache_fills);
+
+  return s;
+}
+
+GST_CHECK_MAIN (ges);
@@ -1481,6 +1481,54 @@ GST_START_TEST (test_scaling)
 
 GST_END_TEST;
 
+GST_START_TEST (test_many_elements)
+{
+  guint i;
+  GList *tmp, *clips = NULL;
+  GESAsset *asset;
+  GESLayer *layer;
+  GESClip *first;
+  GESTimeline *timeline;
+
+  ges_init ();
+
+  timeline = ges_timeline_new_audio_video ();
+  layer = ges_timeline_append_layer (timeline);
+  asset = ges_asset_request (GES_TYPE_TEST_CLIP, NULL, NULL);
+
+  /* Enough track elements for the timeline to use several blocks to keep
+   * track of them */
+  for (i = 0; i < 300; i++)
+    clips = g_list_append (clips, ges_layer_add_asset (layer, asset, i * 20,
+            0, 10, GES_TRACK_TYPE_UNKNOWN));
+  first = clips->data;
+
+  /* Every other clip goes away, and new ones take their place in the
+   * timeline bookkeeping */
+  for (tmp = clips->next; tmp; tmp = tmp->next ? tmp->next->next : NULL)
+    fail_unless (ges_layer_remove_clip (layer, tmp->data));
+  g_list_free (clips);
+
+  for (i = 0; i < 150; i++)
+    fail_unless (ges_layer_add_asset (layer, asset, i * 40 + 20, 0, 5,
+            GES_TRACK_TYPE_UNKNOWN) != NULL);
+  clips = ges_layer_get_clips (layer);
+  assert_equals_int (g_list_length (clips), 300);
+  g_list_free_full (clips, gst_object_unref);
+  assert_equals_uint64 (ges_timeline_get_duration (timeline), 5985);
+
+  /* The edges of the new clips can be snapped to */
+  g_object_set (timeline, "snapping-distance", (guint64) 3, NULL);
+  fail_unless (ges_container_edit (GES_CONTAINER (first), NULL, -1,
+          GES_EDIT_MODE_NORMAL, GES_EDGE_NONE, 26));
+  CHECK_OBJECT_PROPS (first, 25, 0, 10);
+
+  gst_object_unref (asset);
+  gst_object_unref (timeline);
+}
+
+GST_END_TEST;
+
 static Suite *
 ges_suite (void)
 {
@@ -1496,6 +1544,7 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_groups);
   tcase_add_test (tc_chain, test_snapping_groups);
   tcase_add_test (tc_chain, test_scaling);
+  tcase_add_test (tc_chain, test_many_elements);
 
   return s;
 }
@@ -20,6 +20,8 @@
 #include "test-utils.h"
 #include <ges/ges.h>
 #include <gst/check/gstcheck.h>
+#include <glib/gstdio.h>
+#include <string.h>
 
 /* This test uri will eventually have to be fixed */
 #define TEST_URI "http://nowhere/blahblahblah"
@@ -264,6 +266,218 @@ GST_START_TEST (test_filesource_images)
 
 GST_END_TEST;
 
+static void
+peaks_generated_cb (GESUriClipAsset * asset, GAsyncResult * res,
+    gpointer udata)
+{
+  GError *error = NULL;
+
+  fail_unless (ges_uri_clip_asset_generate_peaks_finish (asset, res, &error));
+  fail_unless (error == NULL);
+  g_main_loop_quit (mainloop);
+}
+
+GST_START_TEST (test_filesource_peaks)
+{
+  guint i;
+  GESAsset *asset;
+  AssetUri asset_uri;
+  gfloat mins[32], maxs[32], rms[32];
+  gchar *cache_dir, *peaks_dir;
+  const gchar *name;
+  GDir *dir;
+
+  /* Keep the generated peaks out of the user cache */
+  cache_dir = g_dir_make_tmp ("ges-test-XXXXXX", NULL);
+  fail_unless (cache_dir != NULL);
+  g_setenv ("GES_CACHE_DIRECTORY", cache_dir, TRUE);
+
+  ges_init ();
+
+  mainloop = g_main_loop_new (NULL, FALSE);
+  asset_uri.uri = av_uri;
+  g_timeout_add (1, (GSourceFunc) create_asset, &asset_uri);
+  g_main_loop_run (mainloop);
+
+  asset = asset_uri.asset;
+  fail_unless (GES_IS_URI_CLIP_ASSET (asset));
+
+  ges_uri_clip_asset_generate_peaks (GES_URI_CLIP_ASSET (asset), NULL,
+      (GAsyncReadyCallback) peaks_generated_cb, NULL);
+  g_main_loop_run (mainloop);
+  g_main_loop_unref (mainloop);
+
+  fail_unless (ges_uri_clip_asset_has_peaks (GES_URI_CLIP_ASSET (asset)));
+  assert_equals_int (ges_uri_clip_asset_get_peaks (GES_URI_CLIP_ASSET
+          (asset), 0, GST_SECOND, 32, mins, maxs, rms), 32);
+  for (i = 0; i < 32; i++) {
+    fail_unless (mins[i] >= -1.0 && mins[i] <= maxs[i] && maxs[i] <= 1.0);
+    fail_unless (rms[i] >= 0.0 && rms[i] <= 1.0);
+  }
+
+  /* Past the end of the media, we get silence */
+  assert_equals_int (ges_uri_clip_asset_get_peaks (GES_URI_CLIP_ASSET
+          (asset), 10 * GST_SECOND, GST_SECOND, 32, mins, maxs, rms), 32);
+  for (i = 0; i < 32; i++)
+    fail_unless (mins[i] == 0.0 && maxs[i] == 0.0 && rms[i] == 0.0);
+
+  gst_object_unref (asset);
+
+  peaks_dir = g_build_filename (cache_dir, "peaks", NULL);
+  dir = g_dir_open (peaks_dir, 0, NULL);
+  fail_unless (dir != NULL);
+  i = 0;
+  while ((name = g_dir_read_name (dir))) {
+    gchar *filename = g_build_filename (peaks_dir, name, NULL);
+
+    g_unlink (filename);
+    g_free (filename);
+    i++;
+  }
+  g_dir_close (dir);
+  /* The peaks were saved in the directory we asked for */
+  assert_equals_int (i, 1);
+
+  g_rmdir (peaks_dir);
+  g_rmdir (cache_dir);
+  g_unsetenv ("GES_CACHE_DIRECTORY");
+  g_free (peaks_dir);
+  g_free (cache_dir);
+}
+
+GST_END_TEST;
+
+/* Writes a peaks cache file for @uri announcing @n_peaks peaks per level,
+ * followed by @size bytes of peaks, and checks it is not used */
+static void
+check_invalid_peaks_cache (const gchar * uri, const guint64 * n_peaks,
+    gsize size)
+{
+  GFile *file;
+  GFileInfo *info;
+  GByteArray *contents;
+  GESUriClipAsset *asset;
+  gchar *cache_dir, *peaks_dir, *key, *checksum, *basename, *filename;
+  guint32 header[] = { 1, 48000, 256, 8, 4 };
+
+  GError *error = NULL;
+
+  cache_dir = g_dir_make_tmp ("ges-test-XXXXXX", NULL);
+  fail_unless (cache_dir != NULL);
+  g_setenv ("GES_CACHE_DIRECTORY", cache_dir, TRUE);
+  peaks_dir = g_build_filename (cache_dir, "peaks", NULL);
+  fail_unless (g_mkdir_with_parents (peaks_dir, 0755) == 0);
+
+  /* Same key as the one the peaks are cached with */
+  file = g_file_new_for_uri (uri);
+  info = g_file_query_info (file, G_FILE_ATTRIBUTE_STANDARD_SIZE ","
+      G_FILE_ATTRIBUTE_TIME_MODIFIED, G_FILE_QUERY_INFO_NONE, NULL, NULL);
+  fail_unless (info != NULL);
+  key = g_strdup_printf ("%s:%" G_GUINT64_FORMAT ":%" G_GUINT64_FORMAT, uri,
+      (guint64) g_file_info_get_size (info),
+      g_file_info_get_attribute_uint64 (info, G_FILE_ATTRIBUTE_TIME_MODIFIED));
+  checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA1, key, -1);
+  basename = g_strdup_printf ("%s.peaks", checksum);
+  filename = g_build_filename (peaks_dir, basename, NULL);
+
+  contents = g_byte_array_new ();
+  g_byte_array_append (contents, (const guint8 *) "GESPEAKS", 8);
+  g_byte_array_append (contents, (const guint8 *) header, sizeof (header));
+  g_byte_array_append (contents, (const guint8 *) n_peaks,
+      4 * sizeof (guint64));
+  g_byte_array_set_size (contents, contents->len + size);
+  memset (contents->data + contents->len - size, 0, size);
+  fail_unless (g_file_set_contents (filename, (const gchar *) contents->data,
+          contents->len, NULL));
+
+  ges_init ();
+  asset = ges_uri_clip_asset_request_sync (uri, &error);
+  fail_unless (GES_IS_URI_CLIP_ASSET (asset));
+  fail_unless (error == NULL);
+
+  fail_if (ges_uri_clip_asset_has_peaks (asset));
+
+  gst_object_unref (asset);
+  g_unlink (filename);
+  g_rmdir (peaks_dir);
+  g_rmdir (cache_dir);
+  g_unsetenv ("GES_CACHE_DIRECTORY");
+  g_byte_array_unref (contents);
+  g_object_unref (info);
+  g_object_unref (file);
+  g_free (filename);
+  g_free (basename);
+  g_free (checksum);
+  g_free (key);
+  g_free (peaks_dir);
+  g_free (cache_dir);
+}
+
+GST_START_TEST (test_filesource_truncated_peaks)
+{
+  guint64 n_peaks[] = { 10, 2, 0, 0 };
+
+  /* 12 peaks of 3 values announced, only 10 present */
+  check_invalid_peaks_cache (av_uri, n_peaks, 10 * 3 * sizeof (gint16));
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_filesource_overflowing_peaks)
+{
+  /* The size of the first level wraps around to 0 on 64 bits */
+  guint64 n_peaks[] = { G_GUINT64_CONSTANT (1) << 63, 0, 0, 0 };
+
+  check_invalid_peaks_cache (av_uri, n_peaks, 0);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_filesource_drop_info)
+{
+  const GList *tmp;
+  GESUriClipAsset *asset;
+  GstClockTime duration;
+  GESExtractable *clip;
+  GError *error = NULL;
+
+  ges_init ();
+
+  asset = ges_uri_clip_asset_request_sync (av_uri, &error);
+  fail_unless (GES_IS_URI_CLIP_ASSET (asset));
+  fail_unless (error == NULL);
+  fail_unless (ges_uri_clip_asset_get_info (asset) != NULL);
+  duration = ges_uri_clip_asset_get_duration (asset);
+
+  tmp = ges_uri_clip_asset_get_stream_assets (asset);
+  fail_unless (tmp != NULL);
+  for (; tmp; tmp = tmp->next)
+    fail_unless (ges_uri_source_asset_get_stream_info (tmp->data) != NULL);
+
+  /* The infos go away but what was extracted from them is kept */
+  ges_uri_clip_asset_drop_info (asset);
+  fail_unless (ges_uri_clip_asset_get_info (asset) == NULL);
+  fail_unless_equals_uint64 (ges_uri_clip_asset_get_duration (asset),
+      duration);
+
+  tmp = ges_uri_clip_asset_get_stream_assets (asset);
+  fail_unless (tmp != NULL);
+  for (; tmp; tmp = tmp->next) {
+    fail_unless (ges_uri_source_asset_get_stream_info (tmp->data) == NULL);
+    fail_unless (ges_uri_source_asset_get_stream_uri (tmp->data) != NULL);
+  }
+
+  /* Dropping twice is harmless, and clips can still be extracted */
+  ges_uri_clip_asset_drop_info (asset);
+  clip = ges_asset_extract (GES_ASSET (asset), &error);
+  fail_unless (GES_IS_URI_CLIP (clip));
+  fail_unless (error == NULL);
+
+  gst_object_unref (clip);
+  gst_object_unref (asset);
+}
+
+GST_END_TEST;
 
 static Suite *
 ges_suite (void)
@@ -276,6 +490,10 @@ ges_suite (void)
   tcase_add_test (tc_chain, test_filesource_basic);
   tcase_add_test (tc_chain, test_filesource_images);
   tcase_add_test (tc_chain, test_filesource_properties);
+  tcase_add_test (tc_chain, test_filesource_peaks);
+  tcase_add_test (tc_chain, test_filesource_truncated_peaks);
+  tcase_add_test (tc_chain, test_filesource_overflowing_peaks);
+  tcase_add_test (tc_chain, test_filesource_drop_info);
 
   return s;
 }
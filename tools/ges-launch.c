@@ -36,6 +36,7 @@ static guint repeat = 0;
 static GESPipeline *pipeline = NULL;
 static gboolean seenerrors = FALSE;
 static gchar **new_paths = NULL;
+static gboolean recurse_paths = FALSE;
 static GMainLoop *mainloop;
 
 static gchar *
@@ -130,10 +131,19 @@ create_timeline (int nbargs, gchar ** argv, const gchar * proj_uri)
   guint i;
   GESProject *project = ges_project_new (proj_uri);
 
-  if (new_paths)
+  if (new_paths && !recurse_paths)
     g_signal_connect (project, "missing-uri",
         G_CALLBACK (source_moved_cb), NULL);
 
+  for (i = 0; recurse_paths && new_paths && new_paths[i]; i++) {
+    gchar *uri = gst_uri_is_valid (new_paths[i]) ? g_strdup (new_paths[i]) :
+        gst_filename_to_uri (new_paths[i], NULL);
+
+    if (uri == NULL || !ges_project_add_search_root (project, uri))
+      g_printerr ("Can not look for moved files in %s\n", new_paths[i]);
+    g_free (uri);
+  }
+
   g_signal_connect (project, "error-loading-asset",
       G_CALLBACK (error_loading_asset_cb), NULL);
 
@@ -574,6 +584,9 @@ main (int argc, gchar ** argv)
         "Do not output status information of TYPE", "TYPE1,TYPE2,..."},
     {"sample-paths", 'P', 0, G_OPTION_ARG_STRING_ARRAY, &new_paths,
         "List of pathes to look assets in if they were moved"},
+    {"sample-paths-recurse", 'R', 0, G_OPTION_ARG_NONE, &recurse_paths,
+        "Look for moved assets in the subdirectories of the sample paths too",
+        NULL},
     {NULL}
   };
   GOptionContext *ctx;